@@ -34,6 +34,7 @@
 #include "guilib/TextureManager.h"
 #include "cores/IPlayer.h"
 #include "cores/VideoPlayer/DVDFileInfo.h"
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemuxProbeCache.h"
 #include "cores/AudioEngine/Engines/ActiveAE/AudioDSPAddons/ActiveAEDSP.h"
 #include "cores/AudioEngine/Interfaces/AE.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
@@ -3931,6 +3932,18 @@ bool CApplication::OnMessage(CGUIMessage& message)
       if (m_itemCurrentFile->IsVideo())
       {
         CJobManager::GetInstance().AddJob(new CVideoLibrarySetFileItemJob(*m_itemCurrentFile), nullptr);
+
+        // probe the next item of the playlist while this one plays so it starts from the probe cache
+        if (g_advancedSettings.m_videoProbeCache && g_advancedSettings.m_videoProbeNextItem)
+        {
+          int iNext = CServiceBroker::GetPlaylistPlayer().GetNextSong(1);
+          if (iNext >= 0 && iNext < playList.size() && iNext != CServiceBroker::GetPlaylistPlayer().GetCurrentSong())
+          {
+            CFileItemPtr nextItem = playList[iNext];
+            if (nextItem->IsVideo() && CDVDDemuxProbeCache::IsCacheable(*nextItem))
+              CJobManager::GetInstance().AddJob(new CDVDDemuxProbeJob(*nextItem), nullptr);
+          }
+        }
       }
 
       CVariant param;
@@ -19,7 +19,12 @@
  */
 
 #include "DatabaseManager.h"
+
+#include <algorithm>
+
+#include "dbwrappers/dataset.h"
 #include "utils/log.h"
+#include "utils/URIUtils.h"
 #include "addons/AddonDatabase.h"
 #include "view/ViewDatabase.h"
 #include "TextureDatabase.h"
@@ -42,7 +47,10 @@ CDatabaseManager::CDatabaseManager() :
   UpdateDatabase(db);
 }
 
-CDatabaseManager::~CDatabaseManager() = default;
+CDatabaseManager::~CDatabaseManager()
+{
+  ClearConnections();
+}
 
 void CDatabaseManager::Initialize()
 {
@@ -50,6 +58,10 @@ void CDatabaseManager::Initialize()
 
   m_dbStatus.clear();
 
+  // the databases may be updated or belong to another profile now
+  ClearConnections();
+  m_librarySnapshot.Clear();
+
   CLog::Log(LOGDEBUG, "%s, updating databases...", __FUNCTION__);
 
   // NOTE: Order here is important. In particular, CTextureDatabase has to be updated
@@ -211,3 +223,83 @@ void CDatabaseManager::UpdateStatus(const std::string &name, DB_STATUS status)
   CSingleLock lock(m_section);
   m_dbStatus[name] = status;
 }
+
+std::unique_ptr<dbiplus::Database> CDatabaseManager::AcquireReadConnection(const std::string &host, const std::string &name)
+{
+  CSingleLock lock(m_poolSection);
+  auto it = m_readConnections.find(URIUtils::AddFileToFolder(host, name));
+  if (it == m_readConnections.end() || it->second.empty())
+    return std::unique_ptr<dbiplus::Database>();
+
+  std::unique_ptr<dbiplus::Database> connection = std::move(it->second.back());
+  it->second.pop_back();
+  return connection;
+}
+
+void CDatabaseManager::ReleaseReadConnection(std::unique_ptr<dbiplus::Database> connection, unsigned int maxIdle)
+{
+  if (!connection)
+    return;
+
+  // connections that aren't kept are closed as they go out of scope
+  CSingleLock lock(m_poolSection);
+  std::vector<std::unique_ptr<dbiplus::Database>> &idle = m_readConnections[URIUtils::AddFileToFolder(connection->getHostName(), connection->getDatabase())];
+  if (idle.size() < maxIdle && connection->isActive())
+    idle.push_back(std::move(connection));
+}
+
+std::unique_ptr<dbiplus::Database> CDatabaseManager::AcquireConnection(const std::string &key)
+{
+  CSingleLock lock(m_poolSection);
+  auto it = m_connections.find(key);
+  if (it == m_connections.end())
+    return std::unique_ptr<dbiplus::Database>();
+
+  ExpireConnections(it->second);
+  if (it->second.empty())
+    return std::unique_ptr<dbiplus::Database>();
+
+  std::unique_ptr<dbiplus::Database> connection = std::move(it->second.back().connection);
+  it->second.pop_back();
+  return connection;
+}
+
+void CDatabaseManager::ReleaseConnection(const std::string &key, std::unique_ptr<dbiplus::Database> connection, unsigned int maxIdle, unsigned int idleTimeout)
+{
+  if (!connection)
+    return;
+
+  // the next user has to get the session a new login would give it
+  if (maxIdle == 0 || idleTimeout == 0 || !connection->isActive() || connection->reset() != DB_COMMAND_OK)
+  {
+    connection->disconnect();
+    return;
+  }
+
+  CSingleLock lock(m_poolSection);
+  std::vector<IdleConnection> &idle = m_connections[key];
+  ExpireConnections(idle);
+  if (idle.size() < maxIdle)
+    idle.push_back({ std::move(connection), XbmcThreads::EndTime(idleTimeout) });
+  else
+    connection->disconnect();
+}
+
+void CDatabaseManager::ExpireConnections(std::vector<IdleConnection> &idle)
+{
+  // the server drops sessions that are idle for too long, the connection would only fail on its next query
+  idle.erase(std::remove_if(idle.begin(), idle.end(), [](IdleConnection &entry)
+  {
+    if (!entry.expiry.IsTimePast())
+      return false;
+    entry.connection->disconnect();
+    return true;
+  }), idle.end());
+}
+
+void CDatabaseManager::ClearConnections()
+{
+  CSingleLock lock(m_poolSection);
+  m_readConnections.clear();
+  m_connections.clear();
+}
@@ -22,12 +22,21 @@
 
 #include <atomic>
 #include <map>
+#include <memory>
 #include <string>
+#include <vector>
+#include "dbwrappers/LibrarySnapshot.h"
 #include "threads/CriticalSection.h"
+#include "threads/SystemClock.h"
 
 class CDatabase;
 class DatabaseSettings;
 
+namespace dbiplus
+{
+  class Database;
+}
+
 /*!
  \ingroup database
  \brief Database manager class for handling database updating
@@ -62,6 +71,43 @@ public:
 
   bool IsUpgrading() const { return m_bIsUpgrading; }
 
+  /*! \brief Take an idle read-only connection from the pool.
+   \param host the folder of the database.
+   \param name the versioned name of the database.
+   \return the connection, or an empty pointer if there is no idle connection to this database.
+   \sa ReleaseReadConnection
+   */
+  std::unique_ptr<dbiplus::Database> AcquireReadConnection(const std::string &host, const std::string &name);
+
+  /*! \brief Hand a read-only connection back to the pool.
+   \param connection the connection taken with AcquireReadConnection() or newly opened.
+   \param maxIdle the number of idle connections to keep for this database, the connection is closed if exceeded.
+   \sa AcquireReadConnection
+   */
+  void ReleaseReadConnection(std::unique_ptr<dbiplus::Database> connection, unsigned int maxIdle);
+
+  /*! \brief Take an idle connection to a database server from the pool.
+   Connections idle for longer than their timeout are closed instead.
+   \param key identifies the server, credentials and database the connection was opened with.
+   \return the connection, or an empty pointer if there is no idle connection for key.
+   \sa ReleaseConnection
+   */
+  std::unique_ptr<dbiplus::Database> AcquireConnection(const std::string &key);
+
+  /*! \brief Hand a connection to a database server back to the pool.
+   The session of the connection is reset first, the connection is closed if that fails.
+   \param key identifies the server, credentials and database the connection was opened with.
+   \param connection the connection.
+   \param maxIdle the number of idle connections to keep for key, the connection is closed if exceeded.
+   \param idleTimeout milliseconds the connection is kept, it has to be below the time the server drops idle sessions after.
+   \sa AcquireConnection
+   */
+  void ReleaseConnection(const std::string &key, std::unique_ptr<dbiplus::Database> connection, unsigned int maxIdle, unsigned int idleTimeout);
+
+  /*! \brief Get the cached order of the libraries for recently used sorts.
+   */
+  CLibrarySnapshot& GetLibrarySnapshot() { return m_librarySnapshot; }
+
 private:
   std::atomic<bool> m_bIsUpgrading;
 
@@ -73,4 +119,19 @@ private:
 
   CCriticalSection            m_section;     ///< Critical section protecting m_dbStatus.
   std::map<std::string, DB_STATUS> m_dbStatus;    ///< Our database status map.
+
+  struct IdleConnection
+  {
+    std::unique_ptr<dbiplus::Database> connection;
+    XbmcThreads::EndTime expiry;
+  };
+
+  void ClearConnections();
+  static void ExpireConnections(std::vector<IdleConnection> &idle);
+
+  CCriticalSection m_poolSection; ///< Critical section protecting m_readConnections and m_connections.
+  std::map<std::string, std::vector<std::unique_ptr<dbiplus::Database>>> m_readConnections; ///< Idle read-only connections by database path.
+  std::map<std::string, std::vector<IdleConnection>> m_connections; ///< Idle server connections by connection key.
+
+  CLibrarySnapshot m_librarySnapshot;
 };
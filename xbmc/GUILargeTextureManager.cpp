@@ -27,8 +27,10 @@
 #include "utils/JobManager.h"
 #include "guilib/GraphicContext.h"
 #include "utils/log.h"
+#include "utils/StringUtils.h"
 #include "TextureCache.h"
 
+#include <algorithm>
 #include <cassert>
 
 CImageLoader::CImageLoader(const std::string &path, const bool useCache):
@@ -86,11 +88,16 @@ bool CImageLoader::DoWork()
   return (m_texture != NULL);
 }
 
-CGUILargeTextureManager::CLargeTexture::CLargeTexture(const std::string &path):
+// maximum number of prefetched textures that may be waiting to be loaded at any time
+#define MAX_PREFETCH_QUEUED 64
+
+CGUILargeTextureManager::CLargeTexture::CLargeTexture(const std::string &path, bool prefetch):
   m_path(path)
 {
-  m_refCount = 1;
+  m_refCount = prefetch ? 0 : 1;
   m_timeToDelete = 0;
+  m_prefetch = prefetch;
+  m_requestTime = prefetch ? 0 : XbmcThreads::SystemClockMillis();
 }
 
 CGUILargeTextureManager::CLargeTexture::~CLargeTexture()
@@ -101,6 +108,11 @@ CGUILargeTextureManager::CLargeTexture::~CLargeTexture()
 
 void CGUILargeTextureManager::CLargeTexture::AddRef()
 {
+  if (m_prefetch)
+  { // first request from a control for a texture we loaded ahead of time
+    m_prefetch = false;
+    m_requestTime = XbmcThreads::SystemClockMillis();
+  }
   m_refCount++;
 }
 
@@ -134,6 +146,10 @@ void CGUILargeTextureManager::CLargeTexture::SetTexture(CBaseTexture* texture)
   assert(!m_texture.size());
   if (texture)
     m_texture.Set(texture, texture->GetWidth(), texture->GetHeight());
+
+  // nobody has asked for this prefetched texture as yet - keep it around for a while
+  if (m_refCount == 0)
+    m_timeToDelete = CTimeUtils::GetFrameTime() + PREFETCH_TIME_TO_DELETE;
 }
 
 CGUILargeTextureManager::CGUILargeTextureManager() = default;
@@ -166,14 +182,22 @@ bool CGUILargeTextureManager::GetImage(const std::string &path, CTextureArray &t
     if (image->GetPath() == path)
     {
       if (firstRequest)
+      {
+        m_stats.requests++;
+        if (image->IsPrefetch())
+          m_stats.prefetchHits++;
         image->AddRef();
+      }
       texture = image->GetTexture();
       return texture.size() > 0;
     }
   }
 
   if (firstRequest)
+  {
+    m_stats.requests++;
     QueueImage(path, useCache);
+  }
 
   return true;
 }
@@ -217,6 +241,12 @@ void CGUILargeTextureManager::QueueImage(const std::string &path, bool useCache)
     CLargeTexture *image = it->second;
     if (image->GetPath() == path)
     {
+      // a control is now waiting on a prefetched image, so load it ahead of other prefetches
+      if (image->IsPrefetch())
+      {
+        CJobManager::GetInstance().ChangeJobPriority(it->first, CJob::PRIORITY_NORMAL);
+        m_stats.prefetchHits++;
+      }
       image->AddRef();
       return; // already queued
     }
@@ -240,9 +270,73 @@ void CGUILargeTextureManager::OnJobComplete(unsigned int jobID, bool success, CJ
       CLargeTexture *image = it->second;
       image->SetTexture(loader->m_texture);
       loader->m_texture = NULL; // we want to keep the texture, and jobs are auto-deleted.
+      if (image->IsReferenced())
+      {
+        unsigned int timeToFirstPixel = XbmcThreads::SystemClockMillis() - image->GetRequestTime();
+        m_stats.loaded++;
+        m_stats.totalTimeToFirstPixel += timeToFirstPixel;
+        m_stats.maxTimeToFirstPixel = std::max(m_stats.maxTimeToFirstPixel, timeToFirstPixel);
+      }
       m_queued.erase(it);
       m_allocated.push_back(image);
       return;
     }
   }
 }
+
+bool CGUILargeTextureManager::PrefetchImage(const std::string &path, bool useCache)
+{
+  // images the texture manager can load directly don't go through us
+  if (path.empty() || g_TextureManager.CanLoad(path) || StringUtils::EndsWithNoCase(path, ".gif"))
+    return false;
+
+  CSingleLock lock(m_listSection);
+  for (listIterator it = m_allocated.begin(); it != m_allocated.end(); ++it)
+  {
+    if ((*it)->GetPath() == path)
+      return false; // already loaded
+  }
+
+  unsigned int prefetchQueued = 0;
+  for (queueIterator it = m_queued.begin(); it != m_queued.end(); ++it)
+  {
+    if (it->second->GetPath() == path)
+      return false; // already queued
+    if (it->second->IsPrefetch())
+      prefetchQueued++;
+  }
+  if (prefetchQueued >= MAX_PREFETCH_QUEUED)
+    return false;
+
+  CLargeTexture *image = new CLargeTexture(path, true);
+  unsigned int jobID = CJobManager::GetInstance().AddJob(new CImageLoader(path, useCache), this, CJob::PRIORITY_LOW);
+  m_queued.push_back(std::make_pair(jobID, image));
+  m_stats.prefetched++;
+  return true;
+}
+
+void CGUILargeTextureManager::CancelPrefetch(const std::string &path)
+{
+  CSingleLock lock(m_listSection);
+  for (queueIterator it = m_queued.begin(); it != m_queued.end(); ++it)
+  {
+    CLargeTexture *image = it->second;
+    if (image->GetPath() == path)
+    {
+      if (image->IsPrefetch())
+      {
+        CJobManager::GetInstance().CancelJob(it->first);
+        m_queued.erase(it);
+        delete image;
+        m_stats.prefetchCancelled++;
+      }
+      return;
+    }
+  }
+}
+
+CGUILargeTextureManager::Statistics CGUILargeTextureManager::GetStatistics() const
+{
+  CSingleLock lock(m_listSection);
+  return m_stats;
+}
@@ -20,6 +20,7 @@
  *
  */
 
+#include <stdint.h>
 #include <utility>
 #include <vector>
 
@@ -115,11 +116,53 @@ public:
    */
   void CleanupUnusedImages(bool immediately = false);
 
+  /*!
+   \brief Request a texture to be loaded ahead of it being displayed.
+
+   Prefetched textures are loaded at low priority and are not referenced until a GUI control
+   requests them via GetImage().  If a control requests the texture while it is still being loaded,
+   the load is promoted to normal priority.  Prefetched textures that are never requested are
+   unloaded after a delay, in the same way as released textures.
+
+   \param path path of the image to prefetch.
+   \param useCache whether or not to use the texture cache for this image.
+   \return true if the image was queued for loading, false if it is already loaded or queued, or the
+           prefetch queue is full.
+   \sa CancelPrefetch
+   */
+  bool PrefetchImage(const std::string &path, bool useCache = true);
+
+  /*!
+   \brief Cancel a prefetch request.
+
+   The pending load is cancelled only if no GUI control has requested the texture in the meantime.
+
+   \param path path of the image that was prefetched.
+   \sa PrefetchImage
+   */
+  void CancelPrefetch(const std::string &path);
+
+  /*!
+   \brief Time-to-first-pixel statistics for textures requested by GUI controls.
+   */
+  struct Statistics
+  {
+    unsigned int requests = 0;         ///< number of textures requested by GUI controls
+    unsigned int prefetchHits = 0;     ///< requested textures that a prefetch had already loaded or queued
+    unsigned int prefetched = 0;       ///< number of prefetch requests queued
+    unsigned int prefetchCancelled = 0;///< prefetch requests cancelled before completion
+    unsigned int loaded = 0;           ///< requested textures that completed loading
+    uint64_t totalTimeToFirstPixel = 0;///< sum of request-to-loaded times, in ms
+    unsigned int maxTimeToFirstPixel = 0; ///< worst request-to-loaded time, in ms
+  };
+
+  Statistics GetStatistics() const;
+
 private:
   class CLargeTexture
   {
   public:
-    explicit CLargeTexture(const std::string &path);
+    CLargeTexture(const std::string &path, bool prefetch = false);
     virtual ~CLargeTexture();
 
     void AddRef();
@@ -129,14 +172,20 @@ private:
 
     const std::string &GetPath() const { return m_path; };
     const CTextureArray &GetTexture() const { return m_texture; };
+    bool IsReferenced() const { return m_refCount > 0; };
+    bool IsPrefetch() const { return m_prefetch; };
+    unsigned int GetRequestTime() const { return m_requestTime; };
 
   private:
     static const unsigned int TIME_TO_DELETE = 2000;
+    static const unsigned int PREFETCH_TIME_TO_DELETE = 10000;
 
     unsigned int m_refCount;
     std::string m_path;
     CTextureArray m_texture;
     unsigned int m_timeToDelete;
+    bool m_prefetch;            ///< loaded ahead of time, and not yet requested by a control
+    unsigned int m_requestTime; ///< time the texture was first requested by a control
   };
 
   void QueueImage(const std::string &path, bool useCache = true);
@@ -146,7 +195,9 @@ private:
   typedef std::vector<CLargeTexture *>::iterator listIterator;
   typedef std::vector< std::pair<unsigned int, CLargeTexture *> >::iterator queueIterator;
 
-  CCriticalSection m_listSection;
+  Statistics m_stats;
+
+  mutable CCriticalSection m_listSection;
 };
 
 extern CGUILargeTextureManager g_largeTextureManager;
@@ -22,7 +22,10 @@
 #include "URL.h"
 #include "Util.h"
 #include "filesystem/File.h"
+#include "guilib/LocalizeStrings.h"
+#include "threads/SystemClock.h"
 #include "utils/log.h"
+#include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 
 bool CInfoScanner::HasNoMedia(const std::string &strDirectory) const
@@ -43,3 +46,25 @@ bool CInfoScanner::IsExcluded(const std::string& strDirectory, const std::vector
   }
   return false;
 }
+
+void CInfoScanner::StartScanRate()
+{
+  m_scanRateStart = XbmcThreads::SystemClockMillis();
+  m_scannedItems = 0;
+}
+
+float CInfoScanner::GetScanRate() const
+{
+  unsigned int elapsed = XbmcThreads::SystemClockMillis() - m_scanRateStart;
+  if (elapsed == 0)
+    return 0.0f;
+  return m_scannedItems * 1000.0f / elapsed;
+}
+
+std::string CInfoScanner::FormatScanRate(const std::string& text) const
+{
+  // wait for a meaningful sample before showing a rate
+  if (m_scannedItems == 0 || XbmcThreads::SystemClockMillis() - m_scanRateStart < 1000)
+    return text;
+  return StringUtils::Format(g_localizeStrings.Get(20472), text, GetScanRate());
+}
@@ -78,12 +78,29 @@ protected:
   //! \brief Protected constructor to only allow subclass instances.
   CInfoScanner() = default;
 
+  //! \brief Restart measuring the number of items written to the library per second.
+  void StartScanRate();
+
+  //! \brief Account items that were written to the library since StartScanRate().
+  void AddScannedItems(unsigned int items) { m_scannedItems += items; }
+
+  //! \brief Items written to the library per second since StartScanRate().
+  float GetScanRate() const;
+
+  /*! \brief Append the current scan rate to a progress text.
+   \param text the progress text, usually the directory being scanned.
+   \return the text with the scan rate, or the text itself if there is no rate yet.
+   */
+  std::string FormatScanRate(const std::string& text) const;
+
   std::set<std::string> m_pathsToScan; //!< Set of paths to scan
   bool m_showDialog = false; //!< Whether or not to show progress bar dialog
   CGUIDialogProgressBarHandle* m_handle = nullptr; //!< Progress bar handle
   bool m_bRunning = false; //!< Whether or not scanner is running
   bool m_bCanInterrupt = false; //!< Whether or not scanner is currently interruptable
   bool m_bClean = false; //!< Whether or not to perform cleaning during scanning
+  unsigned int m_scanRateStart = 0; //!< Time the scan rate is measured from
+  unsigned int m_scannedItems = 0; //!< Items written to the library since m_scanRateStart
 
 private:
   bool HasNoMedia(const std::string& strDirectory) const;
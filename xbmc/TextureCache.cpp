@@ -39,7 +39,8 @@ CTextureCache &CTextureCache::GetInstance()
   return s_cache;
 }
 
-CTextureCache::CTextureCache() : CJobQueue(false, 1, CJob::PRIORITY_LOW_PAUSABLE)
+// caching is dominated by image decoding and scaling, so work on a couple of images at once
+CTextureCache::CTextureCache() : CJobQueue(false, 2, CJob::PRIORITY_LOW_PAUSABLE)
 {
 }
 
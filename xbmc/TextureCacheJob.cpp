@@ -33,6 +33,9 @@
 #include "FileItem.h"
 #include "music/MusicThumbLoader.h"
 #include "music/tags/MusicInfoTag.h"
+
+#include <algorithm>
+
 #if defined(TARGET_RASPBERRY_PI)
 #include "cores/omxplayer/OMXImage.h"
 #endif
@@ -90,7 +93,8 @@ bool CTextureCacheJob::CacheTexture(CBaseTexture **out_texture)
     return true;
 
 #if defined(TARGET_RASPBERRY_PI)
-  if (COMXImage::CreateThumb(image, width, height, additional_info, CTextureCache::GetCachedPath(m_cachePath + ".jpg")))
+  if (!g_advancedSettings.m_imageCacheDDS &&
+      COMXImage::CreateThumb(image, width, height, additional_info, CTextureCache::GetCachedPath(m_cachePath + ".jpg")))
   {
     m_details.width = width;
     m_details.height = height;
@@ -103,10 +107,26 @@ bool CTextureCacheJob::CacheTexture(CBaseTexture **out_texture)
     return true;
   }
 #endif
-  CBaseTexture *texture = LoadImage(image, width, height, additional_info, true);
+  // we never cache larger than the fanart/image resolution, so let the jpeg decoder know the size we
+  // need - large jpegs are then decoded at a fraction of their size in the DCT domain, but never
+  // resampled. Other decoders may resample to the size they are given, and CPicture::CacheTexture
+  // scales to the cached size below, so they are given the requested size only to scale just once.
+  unsigned int loadWidth = width;
+  unsigned int loadHeight = height;
+  if (IsJpeg(image, additional_info))
+  {
+    if (!loadHeight)
+      loadHeight = std::max(g_advancedSettings.m_imageRes, g_advancedSettings.m_fanartRes);
+    if (!loadWidth)
+      loadWidth = loadHeight * 16 / 9;
+  }
+
+  CBaseTexture *texture = LoadImage(image, loadWidth, loadHeight, additional_info, true);
   if (texture)
   {
-    if (texture->HasAlpha())
+    if (g_advancedSettings.m_imageCacheDDS)
+      m_details.file = m_cachePath + ".dds";
+    else if (texture->HasAlpha())
       m_details.file = m_cachePath + ".png";
     else
       m_details.file = m_cachePath + ".jpg";
@@ -230,6 +250,14 @@ CBaseTexture *CTextureCacheJob::LoadImage(const std::string &image, unsigned int
   return texture;
 }
 
+bool CTextureCacheJob::IsJpeg(const std::string &image, const std::string &additional_info)
+{
+  // embedded art only has a type once it's extracted
+  if (additional_info == "music" || StringUtils::StartsWith(additional_info, "video_"))
+    return false;
+  return URIUtils::HasExtension(image, ".jpg|.jpeg|.tbn");
+}
+
 bool CTextureCacheJob::UpdateableURL(const std::string &url) const
 {
   // we don't constantly check online images
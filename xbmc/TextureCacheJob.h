@@ -124,6 +124,11 @@ private:
    */
   static CBaseTexture *LoadImage(const std::string &image, unsigned int width, unsigned int height, const std::string &additional_info, bool requirePixels = false);
 
+  /*! \brief Whether an image is decoded by the jpeg decoder, which only uses the desired size to decode
+   at a fraction of the full size.
+   */
+  static bool IsJpeg(const std::string &image, const std::string &additional_info);
+
   std::string    m_cachePath;
 };
 
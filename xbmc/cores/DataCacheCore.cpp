@@ -45,6 +45,7 @@ void CDataCacheCore::Reset()
   m_stateInfo.m_stateSeeking = false;
   m_stateInfo.m_renderGuiLayer = false;
   m_stateInfo.m_renderVideoLayer = false;
+  m_stateInfo.m_timeToFirstFrame = 0;
   m_playerStateChanged = false;
 }
 
@@ -338,6 +339,18 @@ void CDataCacheCore::SetPlayTimes(time_t start, int64_t current, int64_t min, in
   m_timeInfo.m_timeMax = max;
 }
 
+void CDataCacheCore::SetTimeToFirstFrame(int64_t time)
+{
+  CSingleLock lock(m_stateSection);
+  m_stateInfo.m_timeToFirstFrame = time;
+}
+
+int64_t CDataCacheCore::GetTimeToFirstFrame()
+{
+  CSingleLock lock(m_stateSection);
+  return m_stateInfo.m_timeToFirstFrame;
+}
+
 time_t CDataCacheCore::GetStartTime()
 {
   CSingleLock lock(m_stateSection);
@@ -79,6 +79,15 @@ public:
   bool GetVideoRender();
   void SetPlayTimes(time_t start, int64_t current, int64_t min, int64_t max);
 
+  /*!
+   * \brief Set the time to first frame
+   *
+   * This is the time, in ms, from opening the file until playback started,
+   * zero until playback of the current file has started.
+   */
+  void SetTimeToFirstFrame(int64_t time);
+  int64_t GetTimeToFirstFrame();
+
   /*!
    * \brief Get the start time
    *
@@ -154,6 +163,7 @@ protected:
     bool m_renderVideoLayer;
     float m_tempo;
     float m_speed;
+    int64_t m_timeToFirstFrame;
   } m_stateInfo;
 
   struct STimeInfo
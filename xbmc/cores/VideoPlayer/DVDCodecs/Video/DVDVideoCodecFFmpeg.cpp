@@ -35,6 +35,7 @@
 #include "cores/VideoPlayer/VideoRenderers/RenderManager.h"
 #include "cores/VideoPlayer/VideoRenderers/RenderInfo.h"
 #include "utils/StringUtils.h"
+#include <cinttypes>
 #include <memory>
 
 extern "C" {
@@ -44,6 +45,7 @@ extern "C" {
 #include "libavfilter/buffersink.h"
 #include "libavfilter/buffersrc.h"
 #include "libavutil/pixdesc.h"
+#include "libavutil/imgutils.h"
 }
 
 #ifndef TARGET_POSIX
@@ -280,7 +282,7 @@ enum AVPixelFormat CDVDVideoCodecFFmpeg::GetFormat(struct AVCodecContext * avctx
   if (ctx->HasHardware())
   {
     ctx->SetHardware(nullptr);
-    avctx->get_buffer2 = avcodec_default_get_buffer2;
+    avctx->get_buffer2 = GetBuffer;
     avctx->slice_flags = 0;
     av_buffer_unref(&avctx->hw_frames_ctx);
   }
@@ -314,6 +316,68 @@ enum AVPixelFormat CDVDVideoCodecFFmpeg::GetFormat(struct AVCodecContext * avctx
   return avcodec_default_get_format(avctx, fmt);
 }
 
+int CDVDVideoCodecFFmpeg::GetBuffer(struct AVCodecContext *avctx, AVFrame *frame, int flags)
+{
+  ICallbackHWAccel *cb = static_cast<ICallbackHWAccel*>(avctx->opaque);
+  CDVDVideoCodecFFmpeg* ctx  = dynamic_cast<CDVDVideoCodecFFmpeg*>(cb);
+
+  // decode into recycled memory of the video buffer manager instead of the codec's
+  // own buffer pool, which ffmpeg drops on every resolution change and codec reopen
+  AVPixelFormat format = static_cast<AVPixelFormat>(frame->format);
+  const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(format);
+  if (!ctx || !ctx->m_memPool || !desc ||
+      !(avctx->codec->capabilities & AV_CODEC_CAP_DR1) ||
+      (desc->flags & (AV_PIX_FMT_FLAG_HWACCEL | AV_PIX_FMT_FLAG_PAL)))
+    return avcodec_default_get_buffer2(avctx, frame, flags);
+
+#if defined(AV_PIX_FMT_FLAG_PSEUDOPAL)
+  if (desc->flags & AV_PIX_FMT_FLAG_PSEUDOPAL)
+    return avcodec_default_get_buffer2(avctx, frame, flags);
+#endif
+
+  // same layout as avcodec_default_get_buffer2: padded dimensions and
+  // line sizes that are a multiple of the widest simd alignment
+  static const int linesizeAlign = 64;
+  int width = frame->width;
+  int height = frame->height;
+  int dimensionAlign[AV_NUM_DATA_POINTERS];
+  avcodec_align_dimensions2(avctx, &width, &height, dimensionAlign);
+
+  int linesizes[4];
+  bool unaligned;
+  do
+  {
+    if (av_image_fill_linesizes(linesizes, format, width) < 0)
+      return avcodec_default_get_buffer2(avctx, frame, flags);
+
+    // increase the width by its lowest set bit until every line size is aligned
+    width += width & ~(width - 1);
+    unaligned = false;
+    for (int i = 0; i < 4; i++)
+      unaligned |= (linesizes[i] % linesizeAlign) != 0;
+  } while (unaligned);
+
+  uint8_t *data[4];
+  int size = av_image_fill_pointers(data, format, height, nullptr, linesizes);
+  if (size < 0)
+    return avcodec_default_get_buffer2(avctx, frame, flags);
+
+  AVBufferRef *buffer = ctx->m_memPool->Get(size + 16 + linesizeAlign - 1);
+  if (!buffer)
+    return AVERROR(ENOMEM);
+
+  av_image_fill_pointers(data, format, height, buffer->data, linesizes);
+  for (int i = 0; i < 4; i++)
+  {
+    frame->data[i] = data[i];
+    frame->linesize[i] = linesizes[i];
+  }
+  frame->buf[0] = buffer;
+  frame->extended_data = frame->data;
+
+  return 0;
+}
+
 CDVDVideoCodecFFmpeg::CDVDVideoCodecFFmpeg(CProcessInfo &processInfo)
 : CDVDVideoCodec(processInfo), m_postProc(processInfo)
 {
@@ -359,6 +423,7 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
   AVCodec* pCodec;
 
   m_iOrientation = hints.orientation;
+  m_memPool = m_processInfo.GetVideoBufferManager().GetMemPool();
 
   m_formats.clear();
   m_formats = m_processInfo.GetPixFormats();
@@ -384,8 +449,14 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
   m_pCodecContext->debug = 0;
   m_pCodecContext->workaround_bugs = FF_BUG_AUTODETECT;
   m_pCodecContext->get_format = GetFormat;
+  m_pCodecContext->get_buffer2 = GetBuffer;
   m_pCodecContext->codec_tag = hints.codec_tag;
 
+  // decoding for thumbnails only needs keyframes
+  m_keyframesOnly = (hints.codecOptions & CODEC_KEYFRAMES_ONLY) != 0;
+  if (m_keyframesOnly)
+    m_pCodecContext->skip_frame = AVDISCARD_NONKEY;
+
   // setup threading model
   if (!(hints.codecOptions & CODEC_FORCE_SOFTWARE))
   {
@@ -480,6 +551,14 @@ void CDVDVideoCodecFFmpeg::Dispose()
   avcodec_free_context(&m_pCodecContext);
   SAFE_RELEASE(m_pHardware);
 
+  if (m_memPool)
+  {
+    CVideoBufferMemPool::Stats stats = m_memPool->GetStats();
+    CLog::Log(LOGDEBUG, "CDVDVideoCodecFFmpeg::Dispose - frame pool: %" PRIu64 " allocated, %" PRIu64 " reused, %" PRIu64 " freed, %zu bytes in use, %zu bytes idle",
+              stats.allocated, stats.reused, stats.freed, stats.bytesInUse, stats.bytesIdle);
+    m_memPool.reset();
+  }
+
   FilterClose();
 }
 
@@ -1284,7 +1363,7 @@ void CDVDVideoCodecFFmpeg::SetCodecControl(int flags)
     }
     else
     {
-      m_pCodecContext->skip_frame = AVDISCARD_DEFAULT;
+      m_pCodecContext->skip_frame = m_keyframesOnly ? AVDISCARD_NONKEY : AVDISCARD_DEFAULT;
       m_pCodecContext->skip_idct = AVDISCARD_DEFAULT;
       m_pCodecContext->skip_loop_filter = AVDISCARD_DEFAULT;
     }
@@ -61,6 +61,7 @@ public:
 protected:
   void Dispose();
   static enum AVPixelFormat GetFormat(struct AVCodecContext * avctx, const AVPixelFormat * fmt);
+  static int GetBuffer(struct AVCodecContext *avctx, AVFrame *frame, int flags);
 
   int  FilterOpen(const std::string& filters, bool scale);
   void FilterClose();
@@ -76,6 +77,7 @@ protected:
   AVFrame* m_pDecodedFrame;
   AVCodecContext* m_pCodecContext;
   std::shared_ptr<CVideoBufferPoolFFmpeg> m_videoBufferPool;
+  std::shared_ptr<CVideoBufferMemPool> m_memPool;
 
   std::string m_filters;
   std::string m_filters_next;
@@ -101,6 +103,7 @@ protected:
   int m_iLastKeyframe;
   double m_dts;
   bool m_started = false;
+  bool m_keyframesOnly = false;
   std::vector<AVPixelFormat> m_formats;
   double m_decoderPts;
   int    m_skippedDeint;
@@ -26,6 +26,7 @@
 #include "commons/Exception.h"
 #include "cores/FFmpeg.h"
 #include "cores/VideoPlayer/Interface/Addon/TimingConstants.h" // for DVD_TIME_BASE
+#include "DVDDemuxProbeCache.h"
 #include "DVDDemuxUtils.h"
 #include "DVDInputStreams/DVDInputStream.h"
 #include "DVDInputStreams/DVDInputStreamFFmpeg.h"
@@ -464,6 +465,19 @@ bool CDVDDemuxFFmpeg::Open(std::shared_ptr<CDVDInputStream> pInput, bool streami
     if(m_pInput->IsStreamType(DVDSTREAM_TYPE_DVD))
       av_opt_set_int(m_pFormatContext, "analyzeduration", 500000, 0);
 
+    // regular files that were probed before get their stream parameters from
+    // the probe cache, the stream info then only needs a very short analysis
+    bool probeCacheable = g_advancedSettings.m_videoProbeCache &&
+                          m_pInput->IsStreamType(DVDSTREAM_TYPE_FILE) &&
+                          m_ioContext && m_ioContext->seekable &&
+                          CDVDDemuxProbeCache::IsCacheable(CFileItem(strFile, false));
+    bool probeCached = probeCacheable && CDVDDemuxProbeCache::Apply(strFile, m_pFormatContext);
+    if (probeCached)
+    {
+      CLog::Log(LOGDEBUG, "%s - using cached stream info", __FUNCTION__);
+      av_opt_set_int(m_pFormatContext, "analyzeduration", 500000, 0);
+    }
+
     CLog::Log(LOGDEBUG, "%s - avformat_find_stream_info starting", __FUNCTION__);
     int iErr = avformat_find_stream_info(m_pFormatContext, NULL);
     if (iErr < 0)
@@ -485,6 +499,9 @@ bool CDVDDemuxFFmpeg::Open(std::shared_ptr<CDVDInputStream> pInput, bool streami
     }
     CLog::Log(LOGDEBUG, "%s - av_find_stream_info finished", __FUNCTION__);
 
+    if (probeCacheable && !probeCached && iErr >= 0)
+      CDVDDemuxProbeCache::Store(strFile, m_pFormatContext);
+
     if (m_checkvideo)
     {
       // make sure we start video with an i-frame
@@ -0,0 +1,482 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DVDDemuxProbeCache.h"
+
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "DVDDemux.h"
+#include "DVDFactoryDemuxer.h"
+#include "DVDInputStreams/DVDFactoryInputStream.h"
+#include "DVDInputStreams/DVDInputStream.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "URL.h"
+#include "utils/Archive.h"
+#include "utils/Crc32.h"
+#include "utils/JobManager.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+
+extern "C" {
+#include "libavformat/avformat.h"
+}
+
+#define PROBE_CACHE_PATH "special://temp/probe_cache/"
+#define PROBE_CACHE_VERSION 2
+// written after the last stream. A truncated entry reads back zeros instead of throwing
+#define PROBE_CACHE_END_MARKER 0x50524f42
+// entries are a few hundred bytes, the oldest ones are removed above this count
+#define PROBE_CACHE_MAX_ENTRIES 2000
+#define PROBE_CACHE_MAX_STREAMS 1024
+
+namespace
+{
+
+CCriticalSection cacheSection;
+bool cacheCreated = false;
+
+struct SProbeStream
+{
+  int codecType = AVMEDIA_TYPE_UNKNOWN;
+  int codecId = AV_CODEC_ID_NONE;
+  unsigned int codecTag = 0;
+  int profile = FF_PROFILE_UNKNOWN;
+  int level = FF_LEVEL_UNKNOWN;
+  int format = -1;
+  int64_t bitRate = 0;
+  int bitsPerCodedSample = 0;
+  int bitsPerRawSample = 0;
+  int width = 0;
+  int height = 0;
+  int sarNum = 0;
+  int sarDen = 1;
+  int fieldOrder = AV_FIELD_UNKNOWN;
+  int colorRange = AVCOL_RANGE_UNSPECIFIED;
+  int colorPrimaries = AVCOL_PRI_UNSPECIFIED;
+  int colorTrc = AVCOL_TRC_UNSPECIFIED;
+  int colorSpace = AVCOL_SPC_UNSPECIFIED;
+  int chromaLocation = AVCHROMA_LOC_UNSPECIFIED;
+  int videoDelay = 0;
+  uint64_t channelLayout = 0;
+  int channels = 0;
+  int sampleRate = 0;
+  int blockAlign = 0;
+  int frameSize = 0;
+  int initialPadding = 0;
+  int seekPreroll = 0;
+  int timeBaseNum = 0;
+  int timeBaseDen = 1;
+  int avgFrameRateNum = 0;
+  int avgFrameRateDen = 1;
+  int rFrameRateNum = 0;
+  int rFrameRateDen = 1;
+  int64_t duration = AV_NOPTS_VALUE;
+  std::string extradata;
+
+  void FromStream(const AVStream *stream);
+  void ApplyTo(AVStream *stream) const;
+  void Save(CArchive &ar) const;
+  void Load(CArchive &ar);
+};
+
+void SProbeStream::FromStream(const AVStream *stream)
+{
+  const AVCodecParameters *par = stream->codecpar;
+  codecType = par->codec_type;
+  codecId = par->codec_id;
+  codecTag = par->codec_tag;
+  profile = par->profile;
+  level = par->level;
+  format = par->format;
+  bitRate = par->bit_rate;
+  bitsPerCodedSample = par->bits_per_coded_sample;
+  bitsPerRawSample = par->bits_per_raw_sample;
+  width = par->width;
+  height = par->height;
+  sarNum = par->sample_aspect_ratio.num;
+  sarDen = par->sample_aspect_ratio.den;
+  fieldOrder = par->field_order;
+  colorRange = par->color_range;
+  colorPrimaries = par->color_primaries;
+  colorTrc = par->color_trc;
+  colorSpace = par->color_space;
+  chromaLocation = par->chroma_location;
+  videoDelay = par->video_delay;
+  channelLayout = par->channel_layout;
+  channels = par->channels;
+  sampleRate = par->sample_rate;
+  blockAlign = par->block_align;
+  frameSize = par->frame_size;
+  initialPadding = par->initial_padding;
+  seekPreroll = par->seek_preroll;
+  timeBaseNum = stream->time_base.num;
+  timeBaseDen = stream->time_base.den;
+  avgFrameRateNum = stream->avg_frame_rate.num;
+  avgFrameRateDen = stream->avg_frame_rate.den;
+  AVRational rFrameRate = av_stream_get_r_frame_rate(stream);
+  rFrameRateNum = rFrameRate.num;
+  rFrameRateDen = rFrameRate.den;
+  duration = stream->duration;
+  if (par->extradata && par->extradata_size > 0)
+    extradata.assign(reinterpret_cast<const char*>(par->extradata), par->extradata_size);
+}
+
+// only parameters the demuxer left unset are filled in, whatever it read from
+// the headers of the file this time wins over the cache
+void SProbeStream::ApplyTo(AVStream *stream) const
+{
+  AVCodecParameters *par = stream->codecpar;
+  if (!par->codec_tag)
+    par->codec_tag = codecTag;
+  if (par->profile == FF_PROFILE_UNKNOWN)
+    par->profile = profile;
+  if (par->level == FF_LEVEL_UNKNOWN)
+    par->level = level;
+  if (par->format < 0)
+    par->format = format;
+  if (!par->bit_rate)
+    par->bit_rate = bitRate;
+  if (!par->bits_per_coded_sample)
+    par->bits_per_coded_sample = bitsPerCodedSample;
+  if (!par->bits_per_raw_sample)
+    par->bits_per_raw_sample = bitsPerRawSample;
+
+  if (par->codec_type == AVMEDIA_TYPE_VIDEO || par->codec_type == AVMEDIA_TYPE_SUBTITLE)
+  {
+    if (!par->width || !par->height)
+    {
+      par->width = width;
+      par->height = height;
+    }
+  }
+
+  if (par->codec_type == AVMEDIA_TYPE_VIDEO)
+  {
+    if (!par->sample_aspect_ratio.num && sarNum)
+      par->sample_aspect_ratio = av_make_q(sarNum, sarDen);
+    if (par->field_order == AV_FIELD_UNKNOWN)
+      par->field_order = static_cast<AVFieldOrder>(fieldOrder);
+    if (par->color_range == AVCOL_RANGE_UNSPECIFIED)
+      par->color_range = static_cast<AVColorRange>(colorRange);
+    if (par->color_primaries == AVCOL_PRI_UNSPECIFIED)
+      par->color_primaries = static_cast<AVColorPrimaries>(colorPrimaries);
+    if (par->color_trc == AVCOL_TRC_UNSPECIFIED)
+      par->color_trc = static_cast<AVColorTransferCharacteristic>(colorTrc);
+    if (par->color_space == AVCOL_SPC_UNSPECIFIED)
+      par->color_space = static_cast<AVColorSpace>(colorSpace);
+    if (par->chroma_location == AVCHROMA_LOC_UNSPECIFIED)
+      par->chroma_location = static_cast<AVChromaLocation>(chromaLocation);
+    if (!par->video_delay)
+      par->video_delay = videoDelay;
+
+    // known frame rates keep avformat_find_stream_info from analysing the timestamps
+    if (!stream->avg_frame_rate.num && avgFrameRateNum)
+      stream->avg_frame_rate = av_make_q(avgFrameRateNum, avgFrameRateDen);
+    if (!av_stream_get_r_frame_rate(stream).num && rFrameRateNum)
+      av_stream_set_r_frame_rate(stream, av_make_q(rFrameRateNum, rFrameRateDen));
+  }
+  else if (par->codec_type == AVMEDIA_TYPE_AUDIO)
+  {
+    if (!par->channels)
+    {
+      par->channels = channels;
+      par->channel_layout = channelLayout;
+    }
+    if (!par->sample_rate)
+      par->sample_rate = sampleRate;
+    if (!par->block_align)
+      par->block_align = blockAlign;
+    if (!par->frame_size)
+      par->frame_size = frameSize;
+    if (!par->initial_padding)
+      par->initial_padding = initialPadding;
+    if (!par->seek_preroll)
+      par->seek_preroll = seekPreroll;
+  }
+
+  if (!par->extradata_size && !extradata.empty())
+  {
+    av_freep(&par->extradata);
+    par->extradata = static_cast<uint8_t*>(av_mallocz(extradata.size() + AV_INPUT_BUFFER_PADDING_SIZE));
+    if (par->extradata)
+    {
+      memcpy(par->extradata, extradata.data(), extradata.size());
+      par->extradata_size = static_cast<int>(extradata.size());
+    }
+  }
+
+  if (stream->duration == AV_NOPTS_VALUE &&
+      stream->time_base.num == timeBaseNum && stream->time_base.den == timeBaseDen)
+    stream->duration = duration;
+}
+
+void SProbeStream::Save(CArchive &ar) const
+{
+  ar << codecType << codecId << codecTag << profile << level << format;
+  ar << bitRate << bitsPerCodedSample << bitsPerRawSample;
+  ar << width << height << sarNum << sarDen << fieldOrder;
+  ar << colorRange << colorPrimaries << colorTrc << colorSpace << chromaLocation << videoDelay;
+  ar << channelLayout << channels << sampleRate << blockAlign << frameSize << initialPadding << seekPreroll;
+  ar << timeBaseNum << timeBaseDen << avgFrameRateNum << avgFrameRateDen << rFrameRateNum << rFrameRateDen;
+  ar << duration << extradata;
+}
+
+void SProbeStream::Load(CArchive &ar)
+{
+  ar >> codecType >> codecId >> codecTag >> profile >> level >> format;
+  ar >> bitRate >> bitsPerCodedSample >> bitsPerRawSample;
+  ar >> width >> height >> sarNum >> sarDen >> fieldOrder;
+  ar >> colorRange >> colorPrimaries >> colorTrc >> colorSpace >> chromaLocation >> videoDelay;
+  ar >> channelLayout >> channels >> sampleRate >> blockAlign >> frameSize >> initialPadding >> seekPreroll;
+  ar >> timeBaseNum >> timeBaseDen >> avgFrameRateNum >> avgFrameRateDen >> rFrameRateNum >> rFrameRateDen;
+  ar >> duration >> extradata;
+}
+
+struct SProbeEntry
+{
+  std::string path;
+  int64_t size = 0;
+  int64_t mtime = 0;
+  std::string format;
+  std::vector<SProbeStream> streams;
+};
+
+std::string GetCacheFile(const std::string &path)
+{
+  return StringUtils::Format(PROBE_CACHE_PATH "%08x.probe", Crc32::Compute(path));
+}
+
+// files that can't be stat'ed or don't report a modification time can't be
+// told apart from a replaced file and are never cached
+bool GetFileVersion(const std::string &path, int64_t &size, int64_t &mtime)
+{
+  struct __stat64 buffer;
+  if (XFILE::CFile::Stat(path, &buffer) != 0)
+    return false;
+
+  size = buffer.st_size;
+  mtime = buffer.st_mtime;
+  return size > 0 && mtime != 0;
+}
+
+bool LoadEntry(const std::string &path, SProbeEntry &entry)
+{
+  int64_t size, mtime;
+  if (!GetFileVersion(path, size, mtime))
+    return false;
+
+  CSingleLock lock(cacheSection);
+
+  XFILE::CFile file;
+  if (!file.Open(GetCacheFile(path)))
+    return false;
+
+  try
+  {
+    CArchive ar(&file, CArchive::load);
+    int version;
+    ar >> version;
+    if (version != PROBE_CACHE_VERSION)
+      throw std::out_of_range("Unknown version");
+
+    ar >> entry.path >> entry.size >> entry.mtime;
+    if (entry.path != path || entry.size != size || entry.mtime != mtime)
+      return false;
+
+    unsigned int count;
+    ar >> entry.format >> count;
+    if (count > PROBE_CACHE_MAX_STREAMS)
+      throw std::out_of_range("Too many streams");
+    entry.streams.resize(count);
+    for (auto &stream : entry.streams)
+      stream.Load(ar);
+
+    int marker;
+    ar >> marker;
+    if (marker != PROBE_CACHE_END_MARKER)
+      throw std::out_of_range("Truncated entry");
+  }
+  catch (std::out_of_range &ex)
+  {
+    CLog::Log(LOGERROR, "CDVDDemuxProbeCache: discarding corrupt entry for %s: %s", CURL::GetRedacted(path).c_str(), ex.what());
+    file.Close();
+    XFILE::CFile::Delete(GetCacheFile(path));
+    return false;
+  }
+
+  return true;
+}
+
+// a video or audio stream without its basic parameters means the probe gave up early
+bool IsComplete(const AVStream *stream)
+{
+  const AVCodecParameters *par = stream->codecpar;
+  if (par->codec_type == AVMEDIA_TYPE_VIDEO && !(stream->disposition & AV_DISPOSITION_ATTACHED_PIC))
+    return par->codec_id != AV_CODEC_ID_NONE && par->width > 0 && par->height > 0 && par->format >= 0;
+  if (par->codec_type == AVMEDIA_TYPE_AUDIO)
+    return par->codec_id != AV_CODEC_ID_NONE && par->sample_rate > 0 && par->channels > 0;
+  return true;
+}
+
+void Prune()
+{
+  CFileItemList items;
+  if (!XFILE::CDirectory::GetDirectory(PROBE_CACHE_PATH, items, ".probe", XFILE::DIR_FLAG_NO_FILE_DIRS) ||
+      items.Size() <= PROBE_CACHE_MAX_ENTRIES)
+    return;
+
+  items.Sort(SortByDate, SortOrderAscending);
+  int remove = items.Size() - PROBE_CACHE_MAX_ENTRIES * 3 / 4;
+  for (int i = 0; i < remove; i++)
+    XFILE::CFile::Delete(items[i]->GetPath());
+
+  CLog::Log(LOGDEBUG, "CDVDDemuxProbeCache: removed %d old entries", remove);
+}
+
+}
+
+bool CDVDDemuxProbeCache::IsCacheable(const CFileItem &item)
+{
+  return !item.IsInternetStream() && !item.IsPVR() && !item.IsLiveTV() && !item.IsPlugin() &&
+         !item.IsStack() && !item.IsDiscImage() && !item.IsOnDVD() &&
+         !item.IsDVDFile() && !item.IsBDFile();
+}
+
+bool CDVDDemuxProbeCache::Apply(const std::string &path, AVFormatContext *context)
+{
+  SProbeEntry entry;
+  if (!LoadEntry(path, entry))
+    return false;
+
+  // the demuxer must have found exactly the streams of the cached probe
+  if (entry.format != context->iformat->name || entry.streams.size() != context->nb_streams)
+    return false;
+
+  for (unsigned int i = 0; i < context->nb_streams; i++)
+  {
+    const AVCodecParameters *par = context->streams[i]->codecpar;
+    if (par->codec_type != entry.streams[i].codecType || par->codec_id != entry.streams[i].codecId)
+      return false;
+  }
+
+  for (unsigned int i = 0; i < context->nb_streams; i++)
+    entry.streams[i].ApplyTo(context->streams[i]);
+
+  return true;
+}
+
+void CDVDDemuxProbeCache::Store(const std::string &path, const AVFormatContext *context)
+{
+  if (!context->nb_streams)
+    return;
+
+  for (unsigned int i = 0; i < context->nb_streams; i++)
+  {
+    if (!IsComplete(context->streams[i]))
+      return;
+  }
+
+  int64_t size, mtime;
+  if (!GetFileVersion(path, size, mtime))
+    return;
+
+  CSingleLock lock(cacheSection);
+
+  if (!cacheCreated)
+  {
+    XFILE::CDirectory::Create(PROBE_CACHE_PATH);
+    // listing and sorting the entries is too slow for the open path of the player
+    CJobManager::GetInstance().Submit([]() { Prune(); }, CJob::PRIORITY_LOW_PAUSABLE);
+    cacheCreated = true;
+  }
+
+  XFILE::CFile file;
+  if (!file.OpenForWrite(GetCacheFile(path), true))
+    return;
+
+  CArchive ar(&file, CArchive::store);
+  ar << PROBE_CACHE_VERSION;
+  ar << path << size << mtime;
+  ar << std::string(context->iformat->name) << context->nb_streams;
+  for (unsigned int i = 0; i < context->nb_streams; i++)
+  {
+    SProbeStream stream;
+    stream.FromStream(context->streams[i]);
+    stream.Save(ar);
+  }
+  ar << PROBE_CACHE_END_MARKER;
+  ar.Close();
+}
+
+bool CDVDDemuxProbeCache::Has(const std::string &path)
+{
+  SProbeEntry entry;
+  return LoadEntry(path, entry);
+}
+
+CDVDDemuxProbeJob::CDVDDemuxProbeJob(const CFileItem &item)
+  : m_item(item)
+{
+  m_item.SetMimeTypeForInternetFile();
+}
+
+bool CDVDDemuxProbeJob::DoWork()
+{
+  if (CDVDDemuxProbeCache::Has(m_item.GetPath()))
+    return true;
+
+  unsigned int start = XbmcThreads::SystemClockMillis();
+
+  auto inputStream = CDVDFactoryInputStream::CreateInputStream(nullptr, m_item);
+  if (!inputStream || !inputStream->Open())
+    return false;
+
+  // opening the demuxer runs the probe, which stores its result in the cache
+  std::unique_ptr<CDVDDemux> demuxer;
+  try
+  {
+    demuxer.reset(CDVDFactoryDemuxer::CreateDemuxer(inputStream));
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "CDVDDemuxProbeJob: exception thrown when opening demuxer for %s", CURL::GetRedacted(m_item.GetPath()).c_str());
+    return false;
+  }
+
+  CLog::Log(LOGDEBUG, "CDVDDemuxProbeJob: probed %s in %u ms", CURL::GetRedacted(m_item.GetPath()).c_str(),
+            XbmcThreads::SystemClockMillis() - start);
+  return demuxer != nullptr;
+}
+
+bool CDVDDemuxProbeJob::operator==(const CJob *job) const
+{
+  if (strcmp(job->GetType(), GetType()) != 0)
+    return false;
+
+  const CDVDDemuxProbeJob *probeJob = dynamic_cast<const CDVDDemuxProbeJob*>(job);
+  return probeJob && probeJob->m_item.GetPath() == m_item.GetPath();
+}
@@ -0,0 +1,82 @@
+#pragma once
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string>
+
+#include "FileItem.h"
+#include "utils/Job.h"
+
+struct AVFormatContext;
+
+/*!
+ \brief Persistent cache of the stream parameters found by avformat_find_stream_info.
+
+ Entries are kept in special://temp/probe_cache and keyed by the path, size and
+ modification time of the file, so a replaced or modified file is probed again.
+ On a hit the demuxer fills in the cached codec parameters and frame rates before
+ calling avformat_find_stream_info, which then only needs to read a few packets.
+ */
+class CDVDDemuxProbeCache
+{
+public:
+  /*!
+   \brief Whether stream info of the given path can be cached.
+   Internet streams, live tv, discs, stacks and plugins are never cached.
+   */
+  static bool IsCacheable(const CFileItem &item);
+
+  /*!
+   \brief Fill in the stream parameters an opened format context is missing from the cache.
+   \param path path of the file the context was opened from
+   \param context format context after avformat_open_input
+   \return true if every stream of the context was matched with a cached stream
+   */
+  static bool Apply(const std::string &path, AVFormatContext *context);
+
+  /*!
+   \brief Store the stream parameters of a probed format context.
+   \param path path of the file the context was opened from
+   \param context format context after avformat_find_stream_info
+   */
+  static void Store(const std::string &path, const AVFormatContext *context);
+
+  /*!
+   \brief Whether a valid entry for the current version of the file exists.
+   */
+  static bool Has(const std::string &path);
+};
+
+/*!
+ \brief Opens a file in the background so its stream info is cached before it is played.
+ \sa CDVDDemuxProbeCache
+ */
+class CDVDDemuxProbeJob : public CJob
+{
+public:
+  explicit CDVDDemuxProbeJob(const CFileItem &item);
+
+  bool DoWork() override;
+  const char *GetType() const override { return "probestream"; }
+  bool operator==(const CJob *job) const override;
+
+private:
+  CFileItem m_item;
+};
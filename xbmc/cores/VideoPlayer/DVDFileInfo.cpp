@@ -52,7 +52,11 @@
 #include "TextureCache.h"
 #include "Util.h"
 #include "utils/LangCodeExpander.h"
+#include "utils/YUVConverter.h"
+#include "threads/Condition.h"
+#include "threads/SingleLock.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <memory>
 
@@ -98,26 +102,179 @@ int DegreeToOrientation(int degrees)
   }
 }
 
+// decoders of files extracted at the same time must fit into this budget
+#define THUMB_EXTRACT_MEMORY_BUDGET (256 * 1024 * 1024)
+// estimated decoder and thumbnail memory per pixel of the video
+#define THUMB_EXTRACT_BYTES_PER_PIXEL 32
+
+namespace
+{
+/*!
+ \brief Reserves memory for a thumbnail extraction from the budget shared by all
+ extractions, waiting until enough of it is free. An extraction that is larger
+ than the whole budget runs once no other extraction is left.
+ */
+class CThumbMemoryReservation
+{
+public:
+  CThumbMemoryReservation(int width, int height)
+  {
+    if (width <= 0 || height <= 0)
+    {
+      width = 1920;
+      height = 1080;
+    }
+    m_size = static_cast<size_t>(width) * height * THUMB_EXTRACT_BYTES_PER_PIXEL;
+
+    CSingleLock lock(m_section);
+    while (m_reserved > 0 && m_reserved + m_size > THUMB_EXTRACT_MEMORY_BUDGET)
+      m_released.wait(lock);
+    m_reserved += m_size;
+  }
+
+  ~CThumbMemoryReservation()
+  {
+    CSingleLock lock(m_section);
+    m_reserved -= m_size;
+    m_released.notifyAll();
+  }
+
+private:
+  size_t m_size;
+
+  static CCriticalSection m_section;
+  static XbmcThreads::ConditionVariable m_released;
+  static size_t m_reserved;
+};
+
+CCriticalSection CThumbMemoryReservation::m_section;
+XbmcThreads::ConditionVariable CThumbMemoryReservation::m_released;
+size_t CThumbMemoryReservation::m_reserved = 0;
+
+bool GetConverterFormat(AVPixelFormat pixelFormat, CYUVConverter::Format &format)
+{
+  switch (pixelFormat)
+  {
+  case AV_PIX_FMT_YUV420P:
+    format = CYUVConverter::Format::YUV420P;
+    return true;
+  case AV_PIX_FMT_NV12:
+    format = CYUVConverter::Format::NV12;
+    return true;
+  case AV_PIX_FMT_P010LE:
+    format = CYUVConverter::Format::P010;
+    return true;
+  default:
+    return false;
+  }
+}
+
+/*!
+ \brief Scale a decoded picture to thumbnail size and write it to the texture cache.
+ */
+bool CacheThumb(VideoPicture &picture, const CDVDStreamInfo &hint, CTextureDetails &details)
+{
+  bool bOk = false;
+  unsigned int nWidth = std::min(picture.iDisplayWidth, g_advancedSettings.m_imageRes);
+  double aspect = (double)picture.iDisplayWidth / (double)picture.iDisplayHeight;
+  if(hint.forced_aspect && hint.aspect != 0)
+    aspect = hint.aspect;
+  unsigned int nHeight = (unsigned int)((double)nWidth / aspect);
+
+  uint8_t *pOutBuf = (uint8_t*)av_malloc(nWidth * nHeight * 4);
+  uint8_t *planes[YuvImage::MAX_PLANES];
+  int stride[YuvImage::MAX_PLANES];
+  picture.videoBuffer->GetPlanes(planes);
+  picture.videoBuffer->GetStrides(stride);
+  int orientation = DegreeToOrientation(hint.orientation);
+
+  // common formats are converted with the sliced simd converter and scaled
+  // afterwards, anything else is converted and scaled by swscale in one go
+  CYUVConverter::Format format;
+  if (GetConverterFormat(picture.videoBuffer->GetFormat(), format))
+  {
+    CYUVConverter::Matrix matrix = picture.color_space == AVCOL_SPC_BT709 ? CYUVConverter::Matrix::BT709 : CYUVConverter::Matrix::BT601;
+    if (picture.iWidth == nWidth && picture.iHeight == nHeight)
+    {
+      CYUVConverter::Convert(format, planes, stride, nWidth, nHeight, pOutBuf, nWidth * 4, CYUVConverter::Output::BGRA, matrix);
+      bOk = true;
+    }
+    else
+    {
+      uint8_t *pConvertedBuf = (uint8_t*)av_malloc(picture.iWidth * picture.iHeight * 4);
+      if (pConvertedBuf)
+      {
+        CYUVConverter::Convert(format, planes, stride, picture.iWidth, picture.iHeight, pConvertedBuf, picture.iWidth * 4, CYUVConverter::Output::BGRA, matrix);
+        bOk = CPicture::ScaleImage(pConvertedBuf, picture.iWidth, picture.iHeight, picture.iWidth * 4,
+                                   pOutBuf, nWidth, nHeight, nWidth * 4, CPictureScalingAlgorithm::FastBilinear);
+        av_free(pConvertedBuf);
+      }
+      else
+        CLog::Log(LOGERROR, "%s - failed to allocate the converted picture", __FUNCTION__);
+    }
+  }
+  else
+  {
+    struct SwsContext *context = sws_getContext(picture.iWidth, picture.iHeight,
+          picture.videoBuffer->GetFormat(), nWidth, nHeight, AV_PIX_FMT_BGRA, SWS_FAST_BILINEAR, NULL, NULL, NULL);
+
+    if (context)
+    {
+      uint8_t *src[4]= { planes[0], planes[1], planes[2], 0 };
+      int srcStride[] = { stride[0], stride[1], stride[2], 0 };
+      uint8_t *dst[] = { pOutBuf, 0, 0, 0 };
+      int dstStride[] = { (int)nWidth*4, 0, 0, 0 };
+      sws_scale(context, src, srcStride, 0, picture.iHeight, dst, dstStride);
+      sws_freeContext(context);
+      bOk = true;
+    }
+  }
+
+  if (bOk)
+  {
+    details.width = nWidth;
+    details.height = nHeight;
+    CPicture::CacheTexture(pOutBuf, nWidth, nHeight, nWidth * 4, orientation, nWidth, nHeight, CTextureCache::GetCachedPath(details.file));
+  }
+  av_free(pOutBuf);
+  return bOk;
+}
+}
+
 bool CDVDFileInfo::ExtractThumb(const std::string &strPath,
                                 CTextureDetails &details,
                                 CStreamDetails *pStreamDetails, int pos)
+{
+  std::vector<CTextureDetails> thumbs(1, details);
+  bool bOk = ExtractThumbs(strPath, std::vector<int>(1, pos), thumbs, pStreamDetails) == 1;
+  details = thumbs[0];
+  return bOk;
+}
+
+unsigned int CDVDFileInfo::ExtractThumbs(const std::string &strPath,
+                                         const std::vector<int> &positions,
+                                         std::vector<CTextureDetails> &details,
+                                         CStreamDetails *pStreamDetails /* = nullptr */)
 {
   std::string redactPath = CURL::GetRedacted(strPath);
   unsigned int nTime = XbmcThreads::SystemClockMillis();
   CFileItem item(strPath, false);
 
+  std::vector<bool> extracted(positions.size(), false);
+  unsigned int extractedCount = 0;
+
   item.SetMimeTypeForInternetFile();
   auto pInputStream = CDVDFactoryInputStream::CreateInputStream(NULL, item);
   if (!pInputStream)
   {
     CLog::Log(LOGERROR, "InputStream: Error creating stream for %s", redactPath.c_str());
-    return false;
+    return 0;
   }
 
   if (!pInputStream->Open())
   {
     CLog::Log(LOGERROR, "InputStream: Error opening, %s", redactPath.c_str());
-    return false;
+    return 0;
   }
 
   CDVDDemux *pDemuxer = NULL;
@@ -128,7 +285,7 @@ bool CDVDFileInfo::ExtractThumb(const std::string &strPath,
     if(!pDemuxer)
     {
       CLog::Log(LOGERROR, "%s - Error creating demuxer", __FUNCTION__);
-      return false;
+      return 0;
     }
   }
   catch(...)
@@ -137,7 +294,7 @@ bool CDVDFileInfo::ExtractThumb(const std::string &strPath,
     if (pDemuxer)
       delete pDemuxer;
 
-    return false;
+    return 0;
   }
 
   if (pStreamDetails)
@@ -191,7 +348,6 @@ bool CDVDFileInfo::ExtractThumb(const std::string &strPath,
     }
   }
 
-  bool bOk = false;
   int packetsTried = 0;
 
   if (nVideoStream != -1)
@@ -203,20 +359,34 @@ bool CDVDFileInfo::ExtractThumb(const std::string &strPath,
     pProcessInfo->SetPixFormats(pixFmts);
 
     CDVDStreamInfo hint(*pDemuxer->GetStream(demuxerId, nVideoStream), true);
-    hint.codecOptions = CODEC_FORCE_SOFTWARE;
+    hint.codecOptions = CODEC_FORCE_SOFTWARE | CODEC_KEYFRAMES_ONLY;
+
+    // wait until the decoder of this file fits next to the ones of other extractions
+    CThumbMemoryReservation reservation(hint.width, hint.height);
 
     pVideoCodec = CDVDFactoryCodec::CreateVideoCodec(hint, *pProcessInfo);
 
     if (pVideoCodec)
     {
       int nTotalLen = pDemuxer->GetStreamLength();
-      int nSeekTo = (pos==-1) ? nTotalLen / 3 : pos;
 
-      CLog::Log(LOGDEBUG,"%s - seeking to pos %dms (total: %dms) in %s", __FUNCTION__, nSeekTo, nTotalLen, redactPath.c_str());
-      if (pDemuxer->SeekTime(nSeekTo, true))
+      // visit the positions in file order, so every seek goes forward
+      std::vector<std::pair<int, size_t>> order;
+      for (size_t i = 0; i < positions.size(); i++)
+        order.push_back(std::make_pair(positions[i] == -1 ? nTotalLen / 3 : positions[i], i));
+      std::sort(order.begin(), order.end());
+
+      VideoPicture picture = {};
+      for (const auto &position : order)
       {
+        int nSeekTo = position.first;
+
+        CLog::Log(LOGDEBUG,"%s - seeking to pos %dms (total: %dms) in %s", __FUNCTION__, nSeekTo, nTotalLen, redactPath.c_str());
+        if (!pDemuxer->SeekTime(nSeekTo, true))
+          continue;
+
+        pVideoCodec->Reset();
         CDVDVideoCodec::VCReturn iDecoderState = CDVDVideoCodec::VC_NONE;
-        VideoPicture picture = {};
 
         // num streams * 160 frames, should get a valid frame, if not abort.
         int abort_index = pDemuxer->GetNrOfStreams() * 160;
@@ -253,37 +423,10 @@ bool CDVDFileInfo::ExtractThumb(const std::string &strPath,
 
         if (iDecoderState == CDVDVideoCodec::VC_PICTURE && !(picture.iFlags & DVP_FLAG_DROPPED))
         {
+          if (CacheThumb(picture, hint, details[position.second]))
           {
-            unsigned int nWidth = std::min(picture.iDisplayWidth, g_advancedSettings.m_imageRes);
-            double aspect = (double)picture.iDisplayWidth / (double)picture.iDisplayHeight;
-            if(hint.forced_aspect && hint.aspect != 0)
-              aspect = hint.aspect;
-            unsigned int nHeight = (unsigned int)((double)nWidth / aspect);
-
-            uint8_t *pOutBuf = (uint8_t*)av_malloc(nWidth * nHeight * 4);
-            struct SwsContext *context = sws_getContext(picture.iWidth, picture.iHeight,
-                  AV_PIX_FMT_YUV420P, nWidth, nHeight, AV_PIX_FMT_BGRA, SWS_FAST_BILINEAR, NULL, NULL, NULL);
-
-            if (context)
-            {
-              uint8_t *planes[YuvImage::MAX_PLANES];
-              int stride[YuvImage::MAX_PLANES];
-              picture.videoBuffer->GetPlanes(planes);
-              picture.videoBuffer->GetStrides(stride);
-              uint8_t *src[4]= { planes[0], planes[1], planes[2], 0 };
-              int srcStride[] = { stride[0], stride[1], stride[2], 0 };
-              uint8_t *dst[] = { pOutBuf, 0, 0, 0 };
-              int dstStride[] = { (int)nWidth*4, 0, 0, 0 };
-              int orientation = DegreeToOrientation(hint.orientation);
-              sws_scale(context, src, srcStride, 0, picture.iHeight, dst, dstStride);
-              sws_freeContext(context);
-
-              details.width = nWidth;
-              details.height = nHeight;
-              CPicture::CacheTexture(pOutBuf, nWidth, nHeight, nWidth * 4, orientation, nWidth, nHeight, CTextureCache::GetCachedPath(details.file));
-              bOk = true;
-            }
-            av_free(pOutBuf);
+            extracted[position.second] = true;
+            extractedCount++;
           }
         }
         else
@@ -298,16 +441,19 @@ bool CDVDFileInfo::ExtractThumb(const std::string &strPath,
   if (pDemuxer)
     delete pDemuxer;
 
-  if(!bOk)
+  for (size_t i = 0; i < extracted.size(); i++)
   {
-    XFILE::CFile file;
-    if(file.OpenForWrite(CTextureCache::GetCachedPath(details.file)))
-      file.Close();
+    if (!extracted[i])
+    {
+      XFILE::CFile file;
+      if(file.OpenForWrite(CTextureCache::GetCachedPath(details[i].file)))
+        file.Close();
+    }
   }
 
   unsigned int nTotalTime = XbmcThreads::SystemClockMillis() - nTime;
-  CLog::Log(LOGDEBUG,"%s - measured %u ms to extract thumb from file <%s> in %d packets. ", __FUNCTION__, nTotalTime, redactPath.c_str(), packetsTried);
-  return bOk;
+  CLog::Log(LOGDEBUG,"%s - measured %u ms to extract %u of %u thumbs from file <%s> in %d packets. ", __FUNCTION__, nTotalTime, extractedCount, (unsigned int)positions.size(), redactPath.c_str(), packetsTried);
+  return extractedCount;
 }
 
 /**
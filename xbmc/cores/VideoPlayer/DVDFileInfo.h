@@ -39,6 +39,19 @@ public:
                            CTextureDetails &details,
                            CStreamDetails *pStreamDetails, int pos=-1);
 
+  /** \brief Extract thumbnail images at several positions of the media at strPath in one pass.
+  *   The demuxer and decoder are opened once, positions are visited in file order and only
+  *   keyframes are decoded. Files are extracted concurrently as long as their decoders fit
+  *   into a shared memory budget.
+  *   \param positions the positions in ms, -1 for a third of the duration.
+  *   \param[in,out] details one per position, file is the cache file to write, width and height are set on success.
+  *   \return the number of extracted thumbnails, positions that failed get an empty cache file.
+  */
+  static unsigned int ExtractThumbs(const std::string &strPath,
+                                    const std::vector<int> &positions,
+                                    std::vector<CTextureDetails> &details,
+                                    CStreamDetails *pStreamDetails = nullptr);
+
   // Probe the files streams and store the info in the VideoInfoTag
   static bool GetFileStreamDetails(CFileItem *pItem);
   static bool DemuxerToStreamDetails(std::shared_ptr<CDVDInputStream> pInputStream, CDVDDemux *pDemux, CStreamDetails &details, const std::string &path = "");
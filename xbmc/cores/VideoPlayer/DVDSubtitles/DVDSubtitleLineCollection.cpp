@@ -19,16 +19,18 @@
  */
 
 #include "DVDSubtitleLineCollection.h"
-#include <stddef.h>
+#include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
 
+#include <algorithm>
+
+// lines are handed out this long before they start
+#define LINE_LOOKAHEAD DVD_SEC_TO_TIME(5)
 
 CDVDSubtitleLineCollection::CDVDSubtitleLineCollection()
 {
-  m_pHead = NULL;
-  m_pCurrent = NULL;
-  m_pTail = NULL;
-
-  m_iSize = 0;
+  m_current = 0;
+  m_bSorted = true;
+  m_bSeek = false;
 }
 
 CDVDSubtitleLineCollection::~CDVDSubtitleLineCollection()
@@ -38,85 +40,95 @@ CDVDSubtitleLineCollection::~CDVDSubtitleLineCollection()
 
 void CDVDSubtitleLineCollection::Add(CDVDOverlay* pOverlay)
 {
-  ListElement* pElement = new ListElement;
-  pElement->pOverlay = pOverlay;
-  pElement->pNext = NULL;
-
-  if (!m_pHead)
-  {
-    m_pHead = m_pTail = pElement;
-    m_pCurrent = m_pHead;
-  }
-  else
-  {
-    m_pTail->pNext = pElement;
-    m_pTail = pElement;
-  }
+  ListElement element;
+  element.iPTSStartTime = pOverlay->iPTSStartTime;
+  element.iPTSStopTime = pOverlay->iPTSStopTime;
+  element.pOverlay = pOverlay;
+  element.iData = 0;
+
+  m_lines.push_back(element);
+  m_bSorted = false;
+}
 
-  m_iSize++;
+void CDVDSubtitleLineCollection::Add(double iPTSStartTime, double iPTSStopTime, size_t iData)
+{
+  ListElement element;
+  element.iPTSStartTime = iPTSStartTime;
+  element.iPTSStopTime = iPTSStopTime;
+  element.pOverlay = NULL;
+  element.iData = iData;
+
+  m_lines.push_back(element);
+  m_bSorted = false;
 }
 
 void CDVDSubtitleLineCollection::Sort()
 {
-  if (!m_pHead || !m_pHead->pNext)
-    return;
-  
-  for (ListElement* p1 = m_pHead; p1->pNext != NULL; p1 = p1->pNext)
+  // parsers may set the stop time of an overlay when they find the next one
+  for (auto& line : m_lines)
   {
-    for (ListElement* p2 = p1->pNext; p2 != NULL; p2 = p2->pNext)
+    if (line.pOverlay)
     {
-      if (p1->pOverlay->iPTSStartTime > p2->pOverlay->iPTSStartTime)
-      {
-        CDVDOverlay* temp = p1->pOverlay;
-        p1->pOverlay = p2->pOverlay;
-        p2->pOverlay = temp;
-      }
+      line.iPTSStartTime = line.pOverlay->iPTSStartTime;
+      line.iPTSStopTime = line.pOverlay->iPTSStopTime;
     }
   }
+
+  std::stable_sort(m_lines.begin(), m_lines.end(), [](const ListElement& left, const ListElement& right)
+  {
+    return left.iPTSStartTime < right.iPTSStartTime;
+  });
+
+  m_maxStopTimes.resize(m_lines.size());
+  for (size_t i = 0; i < m_lines.size(); i++)
+    m_maxStopTimes[i] = i > 0 ? std::max(m_maxStopTimes[i - 1], m_lines[i].iPTSStopTime) : m_lines[i].iPTSStopTime;
+
+  m_bSorted = true;
+  m_bSeek = true;
 }
 
-CDVDOverlay* CDVDSubtitleLineCollection::Get(double iPts)
+ListElement* CDVDSubtitleLineCollection::Get(double iPts)
 {
-  CDVDOverlay* pOverlay = NULL;
+  if (!m_bSorted)
+    Sort();
 
-  if (m_pCurrent)
+  if (m_bSeek)
   {
-    while (m_pCurrent && m_pCurrent->pOverlay->iPTSStopTime < iPts)
-    {
-      m_pCurrent = m_pCurrent->pNext;
-    }
+    // every line before the first one whose running stop time reaches iPts has stopped
+    m_current = std::lower_bound(m_maxStopTimes.begin(), m_maxStopTimes.end(), iPts) - m_maxStopTimes.begin();
+    m_bSeek = false;
+  }
 
-    if (m_pCurrent)
-    {
-      pOverlay = m_pCurrent->pOverlay;
+  while (m_current < m_lines.size() && m_lines[m_current].iPTSStopTime < iPts)
+    m_current++;
 
-      // advance to the next overlay
-      m_pCurrent = m_pCurrent->pNext;
-    }
-  }
-  return pOverlay;
+  if (m_current >= m_lines.size())
+    return NULL;
+
+  if (m_lines[m_current].iPTSStartTime > iPts + LINE_LOOKAHEAD)
+    return NULL;
+
+  // advance to the next line
+  return &m_lines[m_current++];
 }
 
 void CDVDSubtitleLineCollection::Reset()
 {
-  m_pCurrent = m_pHead;
+  m_current = 0;
+  m_bSeek = true;
 }
 
 void CDVDSubtitleLineCollection::Clear()
 {
-  ListElement* pElement = NULL;
-
-  while (m_pHead)
+  for (auto& line : m_lines)
   {
-    pElement = m_pHead;
-    m_pHead = pElement->pNext;
-
-    pElement->pOverlay->Release();
-    delete pElement;
+    if (line.pOverlay)
+      line.pOverlay->Release();
   }
 
-  m_pTail    = NULL;
-  m_pHead    = NULL;
-  m_pCurrent = NULL;
-  m_iSize    = 0;
+  m_lines.clear();
+  m_maxStopTimes.clear();
+  m_current = 0;
+  m_bSorted = true;
+  m_bSeek = false;
 }
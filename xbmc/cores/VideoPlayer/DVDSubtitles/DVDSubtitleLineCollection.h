@@ -22,10 +22,15 @@
 
 #include "../DVDCodecs/Overlay/DVDOverlay.h"
 
+#include <stddef.h>
+#include <vector>
+
 typedef struct stListElement
 {
-  CDVDOverlay* pOverlay;
-  struct stListElement* pNext;
+  double iPTSStartTime;
+  double iPTSStopTime;
+  CDVDOverlay* pOverlay; // NULL until the parser created it
+  size_t iData;          // where the parser finds the line to create its overlay
 
 } ListElement;
 
@@ -35,26 +40,25 @@ public:
   CDVDSubtitleLineCollection();
   virtual ~CDVDSubtitleLineCollection();
 
-  //void Lock()   { EnterCriticalSection(&m_critSection); }
-  //void Unlock() { LeaveCriticalSection(&m_critSection); }
-
   void Add(CDVDOverlay* pSubtitle);
+  void Add(double iPTSStartTime, double iPTSStopTime, size_t iData); // add a line by its times only
   void Sort();
 
-  CDVDOverlay* Get(double iPts = 0LL); // get the first overlay in this fifo
+  ListElement* Get(double iPts = 0LL); // get the next line shown at or shortly after iPts
 
   void Reset();
 
-  void Remove();
   void Clear();
-  int GetSize() { return m_iSize; }
+  int GetSize() { return (int)m_lines.size(); }
 
 private:
-  ListElement* m_pHead;
-  ListElement* m_pCurrent;
-  ListElement* m_pTail;
+  std::vector<ListElement> m_lines;
 
-  int m_iSize;
-  //CRITICAL_SECTION m_critSection;
-};
+  // highest stop time of the lines up to each line, the first line shown at a
+  // given time is found by binary search after a reset
+  std::vector<double> m_maxStopTimes;
 
+  size_t m_current;
+  bool m_bSorted;
+  bool m_bSeek;
+};
@@ -48,15 +48,26 @@ public:
   ~CDVDSubtitleParserCollection() override = default;
   CDVDOverlay* Parse(double iPts) override
   {
-    CDVDOverlay* o = m_collection.Get(iPts);
-    if(o == NULL)
-      return o;
-    return o->Clone();
+    ListElement* line;
+    while ((line = m_collection.Get(iPts)) != NULL)
+    {
+      if(line->pOverlay == NULL)
+        line->pOverlay = CreateOverlay(*line);
+      if(line->pOverlay)
+        return line->pOverlay->Clone();
+    }
+    return NULL;
   }
   void Reset() override { m_collection.Reset(); }
   void Dispose() override { m_collection.Clear(); }
 
 protected:
+  /*!
+   \brief Create the overlay of a line that was added to the collection by its times only.
+   Called when the line is about to be shown, the collection keeps the overlay.
+   */
+  virtual CDVDOverlay* CreateOverlay(const ListElement& line) { return NULL; }
+
   CDVDSubtitleLineCollection m_collection;
   std::string m_filename;
 };
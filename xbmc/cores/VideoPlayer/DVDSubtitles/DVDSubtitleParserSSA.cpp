@@ -44,7 +44,7 @@ bool CDVDSubtitleParserSSA::Open(CDVDStreamInfo &hints)
   if(!m_libass->CreateTrack((char*) buffer.c_str(), buffer.length()))
     return false;
 
-  //Creating the overlays by going through the list of ass_events
+  //Indexing the list of ass_events, overlays are created when they are about to be shown
   ASS_Event* assEvent = m_libass->GetEvents();
   int numEvents = m_libass->GetNrOfEvents();
 
@@ -53,19 +53,26 @@ bool CDVDSubtitleParserSSA::Open(CDVDStreamInfo &hints)
     ASS_Event* curEvent =  (assEvent+i);
     if (curEvent)
     {
-      CDVDOverlaySSA* overlay = new CDVDOverlaySSA(m_libass);
-
-      overlay->iPTSStartTime = (double)curEvent->Start * (DVD_TIME_BASE / 1000);
-      overlay->iPTSStopTime  = (double)(curEvent->Start + curEvent->Duration) * (DVD_TIME_BASE / 1000);
-
-      overlay->replace = true;
-      m_collection.Add(overlay);
+      double iPTSStartTime = (double)curEvent->Start * (DVD_TIME_BASE / 1000);
+      double iPTSStopTime  = (double)(curEvent->Start + curEvent->Duration) * (DVD_TIME_BASE / 1000);
+      m_collection.Add(iPTSStartTime, iPTSStopTime, i);
     }
   }
   m_collection.Sort();
   return true;
 }
 
+CDVDOverlay* CDVDSubtitleParserSSA::CreateOverlay(const ListElement& line)
+{
+  CDVDOverlaySSA* overlay = new CDVDOverlaySSA(m_libass);
+
+  overlay->iPTSStartTime = line.iPTSStartTime;
+  overlay->iPTSStopTime  = line.iPTSStopTime;
+
+  overlay->replace = true;
+  return overlay;
+}
+
 void CDVDSubtitleParserSSA::Dispose()
 {
   if(m_libass)
@@ -34,6 +34,9 @@ public:
   bool Open(CDVDStreamInfo &hints) override;
   void Dispose() override;
 
+protected:
+  CDVDOverlay* CreateOverlay(const ListElement& line) override;
+
 private:
   CDVDSubtitlesLibass* m_libass;
 };
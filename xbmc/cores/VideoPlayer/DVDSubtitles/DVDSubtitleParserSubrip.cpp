@@ -22,7 +22,6 @@
 #include "DVDCodecs/Overlay/DVDOverlayText.h"
 #include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
 #include "utils/StringUtils.h"
-#include "DVDSubtitleTagSami.h"
 
 CDVDSubtitleParserSubrip::CDVDSubtitleParserSubrip(std::unique_ptr<CDVDSubtitleStream> && pStream, const std::string& strFile)
     : CDVDSubtitleParserText(std::move(pStream), strFile)
@@ -39,13 +38,13 @@ bool CDVDSubtitleParserSubrip::Open(CDVDStreamInfo &hints)
   if (!CDVDSubtitleParserText::Open())
     return false;
 
-  CDVDSubtitleTagSami TagConv;
-  if (!TagConv.Init())
+  if (!m_tagConv.Init())
     return false;
 
   char line[1024];
   std::string strLine;
 
+  // only the times are parsed here, the text of a line is converted when it's about to be shown
   while (m_pStream->ReadLine(line, sizeof(line)))
   {
     strLine = line;
@@ -65,11 +64,13 @@ bool CDVDSubtitleParserSubrip::Open(CDVDStreamInfo &hints)
       }
       else if (c == 14) // time info
       {
-        CDVDOverlayText* pOverlay = new CDVDOverlayText();
-        pOverlay->Acquire(); // increase ref count with one so that we can hold a handle to this overlay
+        double iPTSStartTime = ((double)(((hh1 * 60 + mm1) * 60) + ss1) * 1000 + ms1) * (DVD_TIME_BASE / 1000);
+        double iPTSStopTime  = ((double)(((hh2 * 60 + mm2) * 60) + ss2) * 1000 + ms2) * (DVD_TIME_BASE / 1000);
+        long position = m_pStream->Seek(0, SEEK_CUR);
+        if (position < 0)
+          break;
 
-        pOverlay->iPTSStartTime = ((double)(((hh1 * 60 + mm1) * 60) + ss1) * 1000 + ms1) * (DVD_TIME_BASE / 1000);
-        pOverlay->iPTSStopTime  = ((double)(((hh2 * 60 + mm2) * 60) + ss2) * 1000 + ms2) * (DVD_TIME_BASE / 1000);
+        m_collection.Add(iPTSStartTime, iPTSStopTime, (size_t)position);
 
         while (m_pStream->ReadLine(line, sizeof(line)))
         {
@@ -78,11 +79,7 @@ bool CDVDSubtitleParserSubrip::Open(CDVDStreamInfo &hints)
 
           // empty line, next subtitle is about to start
           if (strLine.length() <= 0) break;
-
-          TagConv.ConvertLine(pOverlay, strLine.c_str(), strLine.length());
         }
-        TagConv.CloseTag(pOverlay);
-        m_collection.Add(pOverlay);
       }
     }
   }
@@ -90,3 +87,30 @@ bool CDVDSubtitleParserSubrip::Open(CDVDStreamInfo &hints)
   return true;
 }
 
+CDVDOverlay* CDVDSubtitleParserSubrip::CreateOverlay(const ListElement& element)
+{
+  if (m_pStream->Seek((long)element.iData, SEEK_SET) < 0)
+    return NULL;
+
+  CDVDOverlayText* pOverlay = new CDVDOverlayText();
+  pOverlay->Acquire(); // increase ref count with one so that we can hold a handle to this overlay
+
+  pOverlay->iPTSStartTime = element.iPTSStartTime;
+  pOverlay->iPTSStopTime  = element.iPTSStopTime;
+
+  char line[1024];
+  std::string strLine;
+
+  while (m_pStream->ReadLine(line, sizeof(line)))
+  {
+    strLine = line;
+    StringUtils::Trim(strLine);
+
+    // empty line, next subtitle is about to start
+    if (strLine.length() <= 0) break;
+
+    m_tagConv.ConvertLine(pOverlay, strLine.c_str(), strLine.length());
+  }
+  m_tagConv.CloseTag(pOverlay);
+  return pOverlay;
+}
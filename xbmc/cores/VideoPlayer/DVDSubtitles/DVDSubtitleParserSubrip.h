@@ -21,6 +21,7 @@
  */
 
 #include "DVDSubtitleParser.h"
+#include "DVDSubtitleTagSami.h"
 
 #include <memory>
 
@@ -31,5 +32,10 @@ public:
   ~CDVDSubtitleParserSubrip() override;
 
   bool Open(CDVDStreamInfo &hints) override;
+
+protected:
+  CDVDOverlay* CreateOverlay(const ListElement& line) override;
+
 private:
+  CDVDSubtitleTagSami m_tagConv;
 };
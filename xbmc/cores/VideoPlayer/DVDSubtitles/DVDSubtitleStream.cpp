@@ -136,6 +136,9 @@ int CDVDSubtitleStream::Read(char* buf, int buf_size)
 
 long CDVDSubtitleStream::Seek(long offset, int whence)
 {
+  // reading past the end leaves the stream failed, which makes seeking fail too
+  m_stringstream.clear();
+
   switch (whence)
   {
     case SEEK_CUR:
@@ -71,24 +71,30 @@ CDVDSubtitlesLibass::CDVDSubtitlesLibass()
 
   CLog::Log(LOGINFO, "CDVDSubtitlesLibass: Initializing ASS Renderer");
 
-  m_renderer = m_dll.ass_renderer_init(m_library);
+  m_renderer = CreateRenderer();
+}
 
-  if(!m_renderer)
-    return;
+ASS_Renderer* CDVDSubtitlesLibass::CreateRenderer()
+{
+  ASS_Renderer* renderer = m_dll.ass_renderer_init(m_library);
+
+  if(!renderer)
+    return NULL;
 
   //Setting default font to the Arial in \media\fonts (used if FontConfig fails)
-  strPath = URIUtils::AddFileToFolder("special://home/media/Fonts/", CServiceBroker::GetSettings().GetString(CSettings::SETTING_SUBTITLES_FONT));
+  std::string strPath = URIUtils::AddFileToFolder("special://home/media/Fonts/", CServiceBroker::GetSettings().GetString(CSettings::SETTING_SUBTITLES_FONT));
   if (!XFILE::CFile::Exists(strPath))
     strPath = URIUtils::AddFileToFolder("special://xbmc/media/Fonts/", CServiceBroker::GetSettings().GetString(CSettings::SETTING_SUBTITLES_FONT));
   int fc = !CServiceBroker::GetSettings().GetBool(CSettings::SETTING_SUBTITLES_OVERRIDEASSFONTS);
 
-  m_dll.ass_set_margins(m_renderer, 0, 0, 0, 0);
-  m_dll.ass_set_use_margins(m_renderer, 0);
-  m_dll.ass_set_font_scale(m_renderer, 1);
+  m_dll.ass_set_margins(renderer, 0, 0, 0, 0);
+  m_dll.ass_set_use_margins(renderer, 0);
+  m_dll.ass_set_font_scale(renderer, 1);
 
   // libass uses fontconfig (system lib) which is not wrapped
   //  so translate the path before calling into libass
-  m_dll.ass_set_fonts(m_renderer, CSpecialProtocol::TranslatePath(strPath).c_str(), "Arial", fc, NULL, 1);
+  m_dll.ass_set_fonts(renderer, CSpecialProtocol::TranslatePath(strPath).c_str(), "Arial", fc, NULL, 1);
+  return renderer;
 }
 
 
@@ -98,6 +104,8 @@ CDVDSubtitlesLibass::~CDVDSubtitlesLibass()
   {
     if(m_track)
       m_dll.ass_free_track(m_track);
+    if(m_lookaheadRenderer)
+      m_dll.ass_renderer_done(m_lookaheadRenderer);
     m_dll.ass_renderer_done(m_renderer);
     m_dll.ass_library_done(m_library);
     m_dll.Unload();
@@ -118,12 +126,16 @@ bool CDVDSubtitlesLibass::DecodeHeader(char* data, int size)
   }
 
   m_dll.ass_process_codec_private(m_track, data, size);
+  AddChange(DVD_NOPTS_VALUE);
   return true;
 }
 
 bool CDVDSubtitlesLibass::DecodeDemuxPkt(char* data, int size, double start, double duration)
 {
+  ++m_waiting;
   CSingleLock lock(m_section);
+  --m_waiting;
+
   if(!m_track)
   {
     CLog::Log(LOGERROR, "CDVDSubtitlesLibass: No SSA header found.");
@@ -131,6 +143,7 @@ bool CDVDSubtitlesLibass::DecodeDemuxPkt(char* data, int size, double start, dou
   }
 
   m_dll.ass_process_chunk(m_track, data, size, DVD_TIME_TO_MSEC(start), DVD_TIME_TO_MSEC(duration));
+  AddChange(start);
   return true;
 }
 
@@ -149,27 +162,125 @@ bool CDVDSubtitlesLibass::CreateTrack(char* buf, size_t size)
   if(m_track == NULL)
     return false;
 
+  AddChange(DVD_NOPTS_VALUE);
   return true;
 }
 
 ASS_Image* CDVDSubtitlesLibass::RenderImage(int frameWidth, int frameHeight, int videoWidth, int videoHeight, double pts, int useMargin, double position, int *changes)
 {
+  ++m_waiting;
   CSingleLock lock(m_section);
-  if(!m_renderer || !m_track)
+  --m_waiting;
+
+  return RenderImage(m_renderer, frameWidth, frameHeight, videoWidth, videoHeight, pts, useMargin, position, changes);
+}
+
+// a lookahead frame is never started while the render thread or the demuxer wait for the
+// track, so they wait for at most one lookahead frame that was already being rendered
+bool CDVDSubtitlesLibass::RenderLookaheadImage(ASS_Image** images, int frameWidth, int frameHeight, int videoWidth, int videoHeight, double pts, int useMargin, double position, int *changes)
+{
+  if(m_waiting > 0)
+    return false;
+
+  CSingleLock lock(m_section);
+  if(m_waiting > 0)
+    return false;
+
+  if(!m_lookaheadRenderer && m_renderer)
+    m_lookaheadRenderer = CreateRenderer();
+
+  *images = RenderImage(m_lookaheadRenderer, frameWidth, frameHeight, videoWidth, videoHeight, pts, useMargin, position, changes);
+  return true;
+}
+
+// the track is shared by both renderers and libass keeps per event state in it,
+// so frames are never rendered concurrently
+ASS_Image* CDVDSubtitlesLibass::RenderImage(ASS_Renderer* renderer, int frameWidth, int frameHeight, int videoWidth, int videoHeight, double pts, int useMargin, double position, int *changes)
+{
+  if(!renderer || !m_track)
   {
     CLog::Log(LOGERROR, "CDVDSubtitlesLibass: %s - Missing ASS structs(m_track or m_renderer)", __FUNCTION__);
     return NULL;
   }
 
   double storage_aspect = (double)frameWidth / frameHeight;
-  m_dll.ass_set_frame_size(m_renderer, frameWidth, frameHeight);
+  m_dll.ass_set_frame_size(renderer, frameWidth, frameHeight);
   int topmargin = (frameHeight - videoHeight) / 2;
   int leftmargin = (frameWidth - videoWidth) / 2;
-  m_dll.ass_set_margins(m_renderer, topmargin, topmargin, leftmargin, leftmargin);
-  m_dll.ass_set_use_margins(m_renderer, useMargin);
-  m_dll.ass_set_line_position(m_renderer, position);
-  m_dll.ass_set_aspect_ratio(m_renderer, storage_aspect / g_graphicsContext.GetResInfo().fPixelRatio, storage_aspect);
-  return m_dll.ass_render_frame(m_renderer, m_track, DVD_TIME_TO_MSEC(pts), changes);
+  m_dll.ass_set_margins(renderer, topmargin, topmargin, leftmargin, leftmargin);
+  m_dll.ass_set_use_margins(renderer, useMargin);
+  m_dll.ass_set_line_position(renderer, position);
+  m_dll.ass_set_aspect_ratio(renderer, storage_aspect / g_graphicsContext.GetResInfo().fPixelRatio, storage_aspect);
+  return m_dll.ass_render_frame(renderer, m_track, DVD_TIME_TO_MSEC(pts), changes);
+}
+
+double CDVDSubtitlesLibass::GetNextEventChange(double pts)
+{
+  CSingleLock lock(m_section);
+  if(!m_track)
+    return DVD_NOPTS_VALUE;
+
+  long long now = DVD_TIME_TO_MSEC(pts);
+  long long next = 0;
+  bool found = false;
+  for(int i = 0; i < m_track->n_events; i++)
+  {
+    const ASS_Event& event = m_track->events[i];
+    long long change;
+    if(event.Start > now)
+      change = event.Start;
+    else if(event.Start + event.Duration > now)
+      change = event.Start + event.Duration;
+    else
+      continue;
+
+    if(!found || change < next)
+    {
+      next = change;
+      found = true;
+    }
+  }
+
+  return found ? DVD_MSEC_TO_TIME(next) : DVD_NOPTS_VALUE;
+}
+
+bool CDVDSubtitlesLibass::GetChangesSince(unsigned int &changes, double &start)
+{
+  CSingleLock lock(m_changesSection);
+  if(changes == m_changes)
+    return false;
+
+  unsigned int count = m_changes - changes;
+  changes = m_changes;
+
+  // older changes than remembered may have touched anything
+  if(count > m_changeStarts.size())
+  {
+    start = DVD_NOPTS_VALUE;
+    return true;
+  }
+
+  start = m_changeStarts.back();
+  for(auto it = m_changeStarts.end() - count; it != m_changeStarts.end(); ++it)
+  {
+    if(*it == DVD_NOPTS_VALUE)
+    {
+      start = DVD_NOPTS_VALUE;
+      break;
+    }
+    if(*it < start)
+      start = *it;
+  }
+  return true;
+}
+
+void CDVDSubtitlesLibass::AddChange(double start)
+{
+  CSingleLock lock(m_changesSection);
+  m_changes++;
+  m_changeStarts.push_back(start);
+  if(m_changeStarts.size() > 64)
+    m_changeStarts.pop_front();
 }
 
 ASS_Event* CDVDSubtitlesLibass::GetEvents()
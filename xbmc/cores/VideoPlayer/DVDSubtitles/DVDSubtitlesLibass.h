@@ -20,6 +20,9 @@
  *
  */
 
+#include <atomic>
+#include <deque>
+
 #include "DllLibass.h"
 #include "DVDResource.h"
 #include "threads/CriticalSection.h"
@@ -33,6 +36,29 @@ public:
   ~CDVDSubtitlesLibass() override;
 
   ASS_Image* RenderImage(int frameWidth, int frameHeight, int videoWidth, int videoHeight, double pts, int useMargin = 0, double position = 0.0, int* changes = NULL);
+
+  /*!
+   \brief Render a frame ahead of presentation with a renderer of its own.
+   The images stay valid until the next call, calls to RenderImage don't affect them.
+   Nothing is rendered while RenderImage or DecodeDemuxPkt wait for the track, they come first.
+   \param images set to the rendered images
+   \return false if the frame was not rendered because the track is needed elsewhere
+   */
+  bool RenderLookaheadImage(ASS_Image** images, int frameWidth, int frameHeight, int videoWidth, int videoHeight, double pts, int useMargin = 0, double position = 0.0, int* changes = NULL);
+
+  /*!
+   \brief Get the first start or end of an event after pts, DVD_NOPTS_VALUE if there is none.
+   */
+  double GetNextEventChange(double pts);
+
+  /*!
+   \brief Check whether events were added since the caller last looked.
+   \param changes number of changes the caller has seen, set to the current number
+   \param start earliest start of the added events, DVD_NOPTS_VALUE if the whole track may have changed
+   \return true if the track changed
+   */
+  bool GetChangesSince(unsigned int &changes, double &start);
+
   ASS_Event* GetEvents();
 
   int GetNrOfEvents();
@@ -42,11 +68,22 @@ public:
   bool CreateTrack(char* buf, size_t size);
 
 private:
+  ASS_Renderer* CreateRenderer();
+  ASS_Image* RenderImage(ASS_Renderer* renderer, int frameWidth, int frameHeight, int videoWidth, int videoHeight, double pts, int useMargin, double position, int* changes);
+  void AddChange(double start);
+
   DllLibass m_dll;
   long m_references;
   ASS_Library* m_library;
   ASS_Track* m_track;
   ASS_Renderer* m_renderer;
+  ASS_Renderer* m_lookaheadRenderer = nullptr;
   CCriticalSection m_section;
+  std::atomic<int> m_waiting{0}; // threads waiting for m_section to render in place or add events
+
+  // start times of the latest track changes, the last one is change number m_changes
+  CCriticalSection m_changesSection;
+  unsigned int m_changes = 0;
+  std::deque<double> m_changeStarts;
 };
 
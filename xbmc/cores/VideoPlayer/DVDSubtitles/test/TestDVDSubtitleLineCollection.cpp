@@ -0,0 +1,131 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/VideoPlayer/DVDSubtitles/DVDSubtitleLineCollection.h"
+#include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
+
+#include "gtest/gtest.h"
+
+namespace
+{
+  // the line handed out next, identified by its data, or -1 if there is none
+  int GetNext(CDVDSubtitleLineCollection &lines, double seconds)
+  {
+    ListElement *line = lines.Get(DVD_SEC_TO_TIME(seconds));
+    return line ? static_cast<int>(line->iData) : -1;
+  }
+}
+
+TEST(TestDVDSubtitleLineCollection, LinesInStartOrder)
+{
+  CDVDSubtitleLineCollection lines;
+  lines.Add(DVD_SEC_TO_TIME(3), DVD_SEC_TO_TIME(4), 3);
+  lines.Add(DVD_SEC_TO_TIME(1), DVD_SEC_TO_TIME(2), 1);
+  lines.Add(DVD_SEC_TO_TIME(2), DVD_SEC_TO_TIME(3), 2);
+  // lines starting at the same time keep the order of the file
+  lines.Add(DVD_SEC_TO_TIME(2), DVD_SEC_TO_TIME(3), 4);
+
+  EXPECT_EQ(1, GetNext(lines, 0));
+  EXPECT_EQ(2, GetNext(lines, 0));
+  EXPECT_EQ(4, GetNext(lines, 0));
+  EXPECT_EQ(3, GetNext(lines, 0));
+  EXPECT_EQ(-1, GetNext(lines, 0));
+}
+
+TEST(TestDVDSubtitleLineCollection, LookaheadWindow)
+{
+  CDVDSubtitleLineCollection lines;
+  lines.Add(DVD_SEC_TO_TIME(10), DVD_SEC_TO_TIME(12), 1);
+
+  // lines are handed out at most 5 s before they start
+  EXPECT_EQ(-1, GetNext(lines, 0));
+  EXPECT_EQ(-1, GetNext(lines, 4.5));
+  EXPECT_EQ(1, GetNext(lines, 5));
+  EXPECT_EQ(-1, GetNext(lines, 5));
+}
+
+TEST(TestDVDSubtitleLineCollection, StoppedLinesAreSkipped)
+{
+  CDVDSubtitleLineCollection lines;
+  lines.Add(DVD_SEC_TO_TIME(1), DVD_SEC_TO_TIME(2), 1);
+  lines.Add(DVD_SEC_TO_TIME(10), DVD_SEC_TO_TIME(11), 2);
+  lines.Add(DVD_SEC_TO_TIME(20), DVD_SEC_TO_TIME(21), 3);
+  lines.Add(DVD_SEC_TO_TIME(30), DVD_SEC_TO_TIME(31), 4);
+
+  // the first lookup searches for the first line still shown
+  EXPECT_EQ(3, GetNext(lines, 20.5));
+  EXPECT_EQ(-1, GetNext(lines, 20.5));
+  EXPECT_EQ(4, GetNext(lines, 25));
+  EXPECT_EQ(-1, GetNext(lines, 31.5));
+}
+
+TEST(TestDVDSubtitleLineCollection, LongLineFoundAfterSeek)
+{
+  CDVDSubtitleLineCollection lines;
+  lines.Add(DVD_SEC_TO_TIME(0), DVD_SEC_TO_TIME(100), 1);
+  lines.Add(DVD_SEC_TO_TIME(10), DVD_SEC_TO_TIME(11), 2);
+  lines.Add(DVD_SEC_TO_TIME(20), DVD_SEC_TO_TIME(21), 3);
+  lines.Add(DVD_SEC_TO_TIME(30), DVD_SEC_TO_TIME(31), 4);
+
+  // a line that started long before the seek target but is still shown is handed out,
+  // the lines that stopped in between are not
+  lines.Reset();
+  EXPECT_EQ(1, GetNext(lines, 28));
+  EXPECT_EQ(4, GetNext(lines, 28));
+  EXPECT_EQ(-1, GetNext(lines, 28));
+}
+
+TEST(TestDVDSubtitleLineCollection, ResetSearchesAgain)
+{
+  CDVDSubtitleLineCollection lines;
+  lines.Add(DVD_SEC_TO_TIME(1), DVD_SEC_TO_TIME(2), 1);
+  lines.Add(DVD_SEC_TO_TIME(10), DVD_SEC_TO_TIME(11), 2);
+  lines.Add(DVD_SEC_TO_TIME(20), DVD_SEC_TO_TIME(21), 3);
+
+  EXPECT_EQ(1, GetNext(lines, 0));
+  EXPECT_EQ(2, GetNext(lines, 10));
+  EXPECT_EQ(3, GetNext(lines, 20));
+  EXPECT_EQ(-1, GetNext(lines, 20));
+
+  // seeking back hands out the lines again
+  lines.Reset();
+  EXPECT_EQ(1, GetNext(lines, 0));
+
+  // seeking forward skips the lines in between
+  lines.Reset();
+  EXPECT_EQ(3, GetNext(lines, 19));
+}
+
+TEST(TestDVDSubtitleLineCollection, AddAfterGet)
+{
+  CDVDSubtitleLineCollection lines;
+  lines.Add(DVD_SEC_TO_TIME(10), DVD_SEC_TO_TIME(11), 2);
+  EXPECT_EQ(2, GetNext(lines, 10));
+
+  // adding a line sorts the lines again and searches from the next lookup
+  lines.Add(DVD_SEC_TO_TIME(1), DVD_SEC_TO_TIME(2), 1);
+  EXPECT_EQ(1, GetNext(lines, 0));
+  EXPECT_EQ(2, GetNext(lines, 5));
+  EXPECT_EQ(2, lines.GetSize());
+
+  lines.Clear();
+  EXPECT_EQ(0, lines.GetSize());
+  EXPECT_EQ(-1, GetNext(lines, 0));
+}
@@ -22,6 +22,38 @@
 #include "threads/SingleLock.h"
 #include <string.h>
 
+extern "C" {
+#include "libavutil/buffer.h"
+#include "libavutil/mem.h"
+}
+
+namespace
+{
+// blocks are rounded up to a size class of at most 1/8 above the request
+size_t GetSizeClass(size_t size)
+{
+  size_t granularity = 4096;
+  while (granularity * 16 <= size)
+    granularity *= 2;
+  return (size + granularity - 1) / granularity * granularity;
+}
+
+// a block may serve a request of at least 4/5 of its size
+bool IsReusable(size_t blockSize, size_t size)
+{
+  return blockSize - size <= blockSize / 5;
+}
+
+// idle blocks not reused within this many requests are freed
+const unsigned int MAX_IDLE_REQUESTS = 128;
+
+struct MemPoolBuffer
+{
+  std::weak_ptr<CVideoBufferMemPool> pool;
+  size_t size;
+};
+}
+
 //-----------------------------------------------------------------------------
 // CVideoBuffer
 //-----------------------------------------------------------------------------
@@ -380,6 +412,107 @@ std::shared_ptr<IVideoBufferPool> CVideoBufferPoolSysMem::CreatePool()
   return std::make_shared<CVideoBufferPoolSysMem>();
 }
 
+//-----------------------------------------------------------------------------
+// CVideoBufferMemPool
+//-----------------------------------------------------------------------------
+
+CVideoBufferMemPool::~CVideoBufferMemPool()
+{
+  for (auto &block : m_free)
+    av_free(block.second.data);
+}
+
+AVBufferRef* CVideoBufferMemPool::Get(size_t size)
+{
+  uint8_t *data = nullptr;
+  size_t blockSize = GetSizeClass(size);
+
+  {
+    CSingleLock lock(m_critSection);
+    m_requests++;
+
+    auto it = m_free.lower_bound(size);
+    if (it != m_free.end() && IsReusable(it->first, size))
+    {
+      blockSize = it->first;
+      data = it->second.data;
+      m_free.erase(it);
+      m_stats.reused++;
+      m_stats.bytesIdle -= blockSize;
+    }
+    FreeIdleBlocks();
+  }
+
+  if (!data)
+  {
+    data = static_cast<uint8_t*>(av_malloc(blockSize));
+    if (!data)
+      return nullptr;
+
+    CSingleLock lock(m_critSection);
+    m_stats.allocated++;
+  }
+
+  MemPoolBuffer *opaque = new MemPoolBuffer{shared_from_this(), blockSize};
+  AVBufferRef *buffer = av_buffer_create(data, blockSize, &CVideoBufferMemPool::FreeBuffer, opaque, 0);
+  if (!buffer)
+  {
+    delete opaque;
+    Return(data, blockSize);
+    return nullptr;
+  }
+
+  CSingleLock lock(m_critSection);
+  m_stats.bytesInUse += blockSize;
+  return buffer;
+}
+
+CVideoBufferMemPool::Stats CVideoBufferMemPool::GetStats()
+{
+  CSingleLock lock(m_critSection);
+  return m_stats;
+}
+
+void CVideoBufferMemPool::FreeBuffer(void *opaque, uint8_t *data)
+{
+  MemPoolBuffer *buffer = static_cast<MemPoolBuffer*>(opaque);
+  std::shared_ptr<CVideoBufferMemPool> pool = buffer->pool.lock();
+  if (pool)
+  {
+    CSingleLock lock(pool->m_critSection);
+    pool->m_stats.bytesInUse -= buffer->size;
+    lock.Leave();
+    pool->Return(data, buffer->size);
+  }
+  else
+    av_free(data);
+
+  delete buffer;
+}
+
+void CVideoBufferMemPool::Return(uint8_t *data, size_t size)
+{
+  CSingleLock lock(m_critSection);
+  m_free.insert(std::make_pair(size, Block{data, m_requests}));
+  m_stats.bytesIdle += size;
+}
+
+void CVideoBufferMemPool::FreeIdleBlocks()
+{
+  for (auto it = m_free.begin(); it != m_free.end();)
+  {
+    if (m_requests - it->second.idleSince > MAX_IDLE_REQUESTS)
+    {
+      av_free(it->second.data);
+      m_stats.freed++;
+      m_stats.bytesIdle -= it->first;
+      it = m_free.erase(it);
+    }
+    else
+      ++it;
+  }
+}
+
 //-----------------------------------------------------------------------------
 // CVideoBufferManager
 //-----------------------------------------------------------------------------
@@ -387,6 +520,7 @@ std::shared_ptr<IVideoBufferPool> CVideoBufferPoolSysMem::CreatePool()
 CVideoBufferManager::CVideoBufferManager()
 {
   CSingleLock lock(m_critSection);
+  m_memPool = std::make_shared<CVideoBufferMemPool>();
   RegisterPoolFactory("SysMem", &CVideoBufferPoolSysMem::CreatePool);
 }
 
@@ -32,6 +32,8 @@ extern "C" {
 #include "libavutil/pixfmt.h"
 }
 
+struct AVBufferRef;
+
 struct YuvImage
 {
   static const int MAX_PLANES = 3;
@@ -178,6 +180,49 @@ protected:
 //
 //-----------------------------------------------------------------------------
 
+// recycles the memory of decoded pictures. blocks are kept in size classes,
+// so frames of a new resolution reuse blocks of a close enough size
+class CVideoBufferMemPool : public std::enable_shared_from_this<CVideoBufferMemPool>
+{
+public:
+  struct Stats
+  {
+    uint64_t allocated = 0;
+    uint64_t reused = 0;
+    uint64_t freed = 0;
+    size_t bytesInUse = 0;
+    size_t bytesIdle = 0;
+  };
+
+  ~CVideoBufferMemPool();
+
+  // get a block of at least size bytes, aligned like av_malloc. the block
+  // goes back to the pool when its last reference is released
+  AVBufferRef* Get(size_t size);
+
+  Stats GetStats();
+
+protected:
+  struct Block
+  {
+    uint8_t *data;
+    unsigned int idleSince;
+  };
+
+  static void FreeBuffer(void *opaque, uint8_t *data);
+  void Return(uint8_t *data, size_t size);
+  void FreeIdleBlocks();
+
+  CCriticalSection m_critSection;
+  std::multimap<size_t, Block> m_free;
+  unsigned int m_requests = 0;
+  Stats m_stats;
+};
+
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+
 typedef std::shared_ptr<IVideoBufferPool> (*CreatePoolFunc)();
 
 class CVideoBufferManager
@@ -190,9 +235,11 @@ public:
   void ReleasePool(IVideoBufferPool *pool);
   CVideoBuffer* Get(AVPixelFormat format, int size, IVideoBufferPool **pPool);
   void ReadyForDisposal(IVideoBufferPool *pool);
+  std::shared_ptr<CVideoBufferMemPool> GetMemPool() { return m_memPool; };
 
 protected:
   CCriticalSection m_critSection;
+  std::shared_ptr<CVideoBufferMemPool> m_memPool;
   std::list<std::shared_ptr<IVideoBufferPool>> m_pools;
   std::list<std::shared_ptr<IVideoBufferPool>> m_discardedPools;
   std::map<std::string, CreatePoolFunc> m_poolFactories;
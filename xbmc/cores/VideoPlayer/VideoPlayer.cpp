@@ -719,6 +719,9 @@ bool CVideoPlayer::OpenFile(const CFileItem& file, const CPlayerOptions &options
   m_error = false;
   m_renderManager.PreInit();
 
+  m_openTime = XbmcThreads::SystemClockMillis();
+  CServiceBroker::GetDataCacheCore().SetTimeToFirstFrame(0);
+
   Create();
 
   m_callback.OnPlayBackStarted(m_item);
@@ -2541,6 +2544,9 @@ void CVideoPlayer::HandleMessages()
 
       m_processInfo->SetPlayTimes(0,0,0,0);
 
+      m_openTime = XbmcThreads::SystemClockMillis();
+      CServiceBroker::GetDataCacheCore().SetTimeToFirstFrame(0);
+
       m_outboundEvents->Submit([this]() {
         m_callback.OnPlayBackStarted(m_item);
       });
@@ -3004,6 +3010,14 @@ void CVideoPlayer::SetCaching(ECacheState state)
     return;
 
   CLog::Log(LOGDEBUG, "CVideoPlayer::SetCaching - caching state %d", state);
+
+  if (m_openTime && (state == CACHESTATE_PLAY || state == CACHESTATE_DONE))
+  {
+    unsigned int timeToFirstFrame = XbmcThreads::SystemClockMillis() - m_openTime;
+    CServiceBroker::GetDataCacheCore().SetTimeToFirstFrame(timeToFirstFrame);
+    CLog::Log(LOGNOTICE, "CVideoPlayer::SetCaching - time to first frame %u ms", timeToFirstFrame);
+    m_openTime = 0;
+  }
   if (state == CACHESTATE_FULL ||
       state == CACHESTATE_INIT)
   {
@@ -495,6 +495,7 @@ protected:
 
   ECacheState  m_caching;
   XbmcThreads::EndTime m_cachingTimer;
+  unsigned int m_openTime = 0; // when the current file was opened, until playback has started
 
   std::unique_ptr<CProcessInfo> m_processInfo;
 
@@ -30,6 +30,8 @@
 #include "utils/log.h"
 #include "system.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "URL.h"
 
 CVideoPlayerSubtitle::CVideoPlayerSubtitle(CDVDOverlayContainer* pOverlayContainer, CProcessInfo &processInfo)
 : IDVDStreamPlayer(processInfo)
@@ -142,6 +144,7 @@ bool CVideoPlayerSubtitle::OpenStream(CDVDStreamInfo &hints, std::string &filena
   // okey check if this is a filesubtitle
   if(filename.size() && filename != "dvd" )
   {
+    unsigned int time = XbmcThreads::SystemClockMillis();
     m_pSubtitleFileParser = CDVDFactorySubtitle::CreateParser(filename);
     if (!m_pSubtitleFileParser)
     {
@@ -157,6 +160,7 @@ bool CVideoPlayerSubtitle::OpenStream(CDVDStreamInfo &hints, std::string &filena
       return false;
     }
     m_pSubtitleFileParser->Reset();
+    CLog::Log(LOGDEBUG, "%s - parsed %s in %u ms", __FUNCTION__, CURL::GetRedacted(filename).c_str(), XbmcThreads::SystemClockMillis() - time);
     return true;
   }
 
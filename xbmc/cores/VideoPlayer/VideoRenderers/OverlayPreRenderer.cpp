@@ -0,0 +1,271 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "OverlayPreRenderer.h"
+#include "OverlayRendererUtil.h"
+#include "cores/VideoPlayer/DVDSubtitles/DVDSubtitlesLibass.h"
+#include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
+#include "utils/TimeUtils.h"
+
+#include <iterator>
+
+// memory the atlases rendered ahead may take
+#define PRERENDER_MAX_SIZE (64 * 1024 * 1024)
+// presentation may get this far ahead of rendering before rendering restarts at the presented frame
+#define PRERENDER_MAX_BEHIND DVD_MSEC_TO_TIME(500)
+// time in ms rendering ahead pauses while the track is needed to render in place or add events
+#define PRERENDER_YIELD_TIME 5
+
+using namespace OVERLAY;
+
+namespace
+{
+
+size_t GetSize(const SQuads &quads)
+{
+  return quads.size_x * quads.size_y + quads.count * sizeof(SQuad);
+}
+
+}
+
+bool CPreRenderer::SParams::operator==(const SParams &right) const
+{
+  return frameWidth == right.frameWidth && frameHeight == right.frameHeight &&
+         videoWidth == right.videoWidth && videoHeight == right.videoHeight &&
+         useMargin == right.useMargin && position == right.position;
+}
+
+CPreRenderer::CPreRenderer()
+  : CThread("OverlayPreRenderer")
+  , m_pts(DVD_NOPTS_VALUE)
+  , m_renderPts(DVD_NOPTS_VALUE)
+  , m_frameDuration(DVD_MSEC_TO_TIME(40))
+{
+}
+
+CPreRenderer::~CPreRenderer()
+{
+  m_wakeup.Set();
+  StopThread(true);
+
+  if (m_libass)
+    m_libass->Release();
+}
+
+std::shared_ptr<SQuads> CPreRenderer::Get(CDVDSubtitlesLibass *libass, const SParams &params, double pts)
+{
+  CSingleLock lock(m_section);
+
+  if (!IsRunning())
+    Create();
+
+  double start;
+  if (libass != m_libass || params != m_params)
+  {
+    if (m_libass)
+      m_libass->Release();
+    m_libass = libass->Acquire();
+    m_params = params;
+    m_changes = 0;
+    m_libass->GetChangesSince(m_changes, start);
+    m_pts = DVD_NOPTS_VALUE;
+    Reset(pts);
+  }
+  else if (libass->GetChangesSince(m_changes, start))
+    Invalidate(start);
+
+  if (m_pts != DVD_NOPTS_VALUE && pts > m_pts && pts - m_pts <= DVD_MSEC_TO_TIME(100))
+    m_frameDuration = pts - m_pts;
+
+  // seeks restart rendering at the presented frame
+  if (m_renderPts == DVD_NOPTS_VALUE || (m_pts != DVD_NOPTS_VALUE && pts < m_pts) ||
+      pts > m_renderPts + PRERENDER_MAX_BEHIND)
+    Reset(pts);
+  m_pts = pts;
+
+  // frames shown before this one aren't needed anymore, the last segment is kept
+  // because rendering continues where it ends
+  auto last = m_segments.begin();
+  while (last != m_segments.end() && std::next(last) != m_segments.end() && last->second.end <= pts)
+    ++last;
+  Erase(m_segments.begin(), last);
+
+  m_wakeup.Set();
+
+  auto segment = m_segments.upper_bound(pts);
+  if (segment == m_segments.begin())
+    return nullptr;
+
+  --segment;
+  if (pts < segment->second.end)
+    return segment->second.quads;
+
+  return nullptr;
+}
+
+void CPreRenderer::Flush()
+{
+  CSingleLock lock(m_section);
+
+  Reset(DVD_NOPTS_VALUE);
+  if (m_libass)
+    m_libass->Release();
+  m_libass = nullptr;
+  m_pts = DVD_NOPTS_VALUE;
+}
+
+double CPreRenderer::GetRenderTime()
+{
+  CSingleLock lock(m_section);
+  return m_renderTime;
+}
+
+void CPreRenderer::Reset(double pts)
+{
+  Erase(m_segments.begin(), m_segments.end());
+  m_renderPts = pts;
+  m_generation++;
+}
+
+// events were added to the track, frames from their start on are rendered again
+void CPreRenderer::Invalidate(double start)
+{
+  if (start == DVD_NOPTS_VALUE)
+  {
+    Reset(m_pts);
+    return;
+  }
+
+  auto it = m_segments.begin();
+  while (it != m_segments.end() && it->second.end <= start)
+    ++it;
+
+  if (it == m_segments.end())
+    return;
+
+  if (it->first < start)
+  {
+    it->second.end = start;
+    m_renderPts = start;
+    ++it;
+  }
+  else
+    m_renderPts = it->first;
+
+  Erase(it, m_segments.end());
+  m_generation++;
+}
+
+void CPreRenderer::Erase(std::map<double, SSegment>::iterator first, std::map<double, SSegment>::iterator last)
+{
+  for (auto it = first; it != last; ++it)
+    m_size -= GetSize(*it->second.quads);
+  m_segments.erase(first, last);
+}
+
+void CPreRenderer::Process()
+{
+  bool rendered = false;
+  unsigned int renderedGeneration = 0;
+
+  while (!m_bStop)
+  {
+    CDVDSubtitlesLibass *libass = nullptr;
+    SParams params = {};
+    double pts = DVD_NOPTS_VALUE;
+    double frameDuration = 0.0;
+    unsigned int generation = 0;
+    bool contiguous = false;
+    {
+      CSingleLock lock(m_section);
+      double lookahead = DVD_MSEC_TO_TIME(g_advancedSettings.m_videoAssLookahead);
+      if (m_libass && m_renderPts != DVD_NOPTS_VALUE && m_pts != DVD_NOPTS_VALUE &&
+          m_renderPts < m_pts + lookahead && m_size < PRERENDER_MAX_SIZE)
+      {
+        libass = m_libass->Acquire();
+        params = m_params;
+        pts = m_renderPts;
+        frameDuration = m_frameDuration;
+        generation = m_generation;
+        contiguous = rendered && generation == renderedGeneration &&
+                     !m_segments.empty() && m_segments.rbegin()->second.end == pts;
+      }
+    }
+
+    if (!libass)
+    {
+      AbortableWait(m_wakeup, 100);
+      continue;
+    }
+
+    int64_t start = CurrentHostCounter();
+
+    int changes = 0;
+    ASS_Image* images = nullptr;
+    if (!libass->RenderLookaheadImage(&images, params.frameWidth, params.frameHeight,
+                                      params.videoWidth, params.videoHeight, pts,
+                                      params.useMargin, params.position, &changes))
+    {
+      // the presented frame is rendered in place or events are added, try again shortly
+      libass->Release();
+      AbortableWait(m_wakeup, PRERENDER_YIELD_TIME);
+      continue;
+    }
+
+    // an unchanged frame extends the segment of the frame before it
+    std::shared_ptr<SQuads> quads;
+    if (changes || !contiguous)
+    {
+      quads = std::make_shared<SQuads>();
+      convert_quad(images, *quads, params.frameWidth);
+    }
+
+    // the next frame is rendered one frame later, or when an event starts or ends before that
+    double next = pts + frameDuration;
+    double change = libass->GetNextEventChange(pts);
+    if (change != DVD_NOPTS_VALUE && change < next)
+      next = change;
+
+    libass->Release();
+
+    double time = (CurrentHostCounter() - start) * 1000.0 / CurrentHostFrequency();
+
+    CSingleLock lock(m_section);
+    rendered = true;
+    renderedGeneration = generation;
+
+    // the track or the presented frame changed while rendering
+    if (generation != m_generation)
+      continue;
+
+    if (quads)
+    {
+      m_segments[pts] = { next, quads };
+      m_size += GetSize(*quads);
+    }
+    else
+      m_segments.rbegin()->second.end = next;
+
+    m_renderPts = next;
+    m_renderTime = m_renderTime > 0.0 ? m_renderTime * 0.9 + time * 0.1 : time;
+  }
+}
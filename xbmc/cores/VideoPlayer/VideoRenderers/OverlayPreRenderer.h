@@ -0,0 +1,109 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/Thread.h"
+
+#include <map>
+#include <memory>
+
+class CDVDSubtitlesLibass;
+
+namespace OVERLAY {
+
+  struct SQuads;
+
+  /*!
+   \brief Renders the upcoming frames of an ASS track on a thread of its own.
+
+   Frames up to the configured lookahead past the presented one are rendered
+   with a libass renderer of their own and packed into glyph atlases. Frames
+   libass reports as unchanged share the atlas of the frame before them, so an
+   atlas covers the time range its images are shown. The overlay renderer then
+   only uploads and composites the atlas of the frame it presents.
+   */
+  class CPreRenderer : private CThread
+  {
+  public:
+    struct SParams
+    {
+      int frameWidth;
+      int frameHeight;
+      int videoWidth;
+      int videoHeight;
+      int useMargin;
+      double position;
+
+      bool operator==(const SParams &right) const;
+      bool operator!=(const SParams &right) const { return !(*this == right); }
+    };
+
+    CPreRenderer();
+    ~CPreRenderer() override;
+
+    /*!
+     \brief Get the atlas of the frame presented at pts and keep rendering ahead of it.
+     \param libass track to render
+     \param params frame geometry libass renders for
+     \param pts presentation time of the frame
+     \return the atlas, or nullptr if the frame has not been rendered yet
+     */
+    std::shared_ptr<SQuads> Get(CDVDSubtitlesLibass *libass, const SParams &params, double pts);
+
+    /*!
+     \brief Drop the rendered frames and the track.
+     */
+    void Flush();
+
+    /*!
+     \brief Average time in ms it took to render and pack a frame ahead.
+     */
+    double GetRenderTime();
+
+  protected:
+    struct SSegment
+    {
+      double end;
+      std::shared_ptr<SQuads> quads;
+    };
+
+    void Process() override;
+    void Reset(double pts);
+    void Invalidate(double start);
+    void Erase(std::map<double, SSegment>::iterator first, std::map<double, SSegment>::iterator last);
+
+    CCriticalSection m_section;
+    CEvent m_wakeup;
+    CDVDSubtitlesLibass *m_libass = nullptr;
+    SParams m_params = {};
+    unsigned int m_changes = 0;
+    unsigned int m_generation = 0;
+    std::map<double, SSegment> m_segments;
+    double m_pts;
+    double m_renderPts;
+    double m_frameDuration;
+    size_t m_size = 0;
+    double m_renderTime = 0.0;
+  };
+
+}
@@ -34,6 +34,8 @@
 #include "settings/AdvancedSettings.h"
 #include "threads/SingleLock.h"
 #include "utils/MathUtils.h"
+#include "utils/TimeUtils.h"
+#include "OverlayPreRenderer.h"
 #include "OverlayRendererUtil.h"
 #include "OverlayRendererGUI.h"
 #if defined(HAS_GL) || defined(HAS_GLES)
@@ -101,6 +103,9 @@ void CRenderer::Flush()
 
   ReleaseCache();
 
+  if (m_preRenderer)
+    m_preRenderer->Flush();
+
   g_fontManager.Unload(m_font);
   g_fontManager.Unload(m_fontBorder);
 }
@@ -118,6 +123,7 @@ void CRenderer::ReleaseCache()
     delete overlay.second;
   }
   m_textureCache.clear();
+  m_preRenderedQuads.clear();
   m_textureid++;
 }
 
@@ -142,6 +148,7 @@ void CRenderer::ReleaseUnused()
     if (!found)
     {
       delete it->second;
+      m_preRenderedQuads.erase(it->first);
       it = m_textureCache.erase(it);
     }
     else
@@ -321,6 +328,18 @@ void CRenderer::SetVideoRect(CRect &source, CRect &dest, CRect &view)
   m_rv = view;
 }
 
+bool CRenderer::GetSubtitleRenderTimes(double &render, double &preRender)
+{
+  CSingleLock lock(m_section);
+
+  if (m_ssaRenderTime == 0.0)
+    return false;
+
+  render = m_ssaRenderTime;
+  preRender = m_preRenderer ? m_preRenderer->GetRenderTime() : 0.0;
+  return true;
+}
+
 COverlay* CRenderer::Convert(CDVDOverlaySSA* o, double pts)
 {
   // libass render in a target area which named as frame. the frame size may bigger than video size,
@@ -353,24 +372,66 @@ COverlay* CRenderer::Convert(CDVDOverlaySSA* o, double pts)
   }
   else
     position = 0.0;
-  int changes = 0;
-  ASS_Image* images = o->m_libass->RenderImage(targetWidth, targetHeight, videoWidth, videoHeight, pts, useMargin, position, &changes);
+  // frames rendered ahead only need to be uploaded, the texture of the frame before
+  // is kept as long as its atlas is
+  std::shared_ptr<SQuads> quads;
+  if (g_advancedSettings.m_videoAssLookahead > 0)
+  {
+    if (!m_preRenderer)
+      m_preRenderer.reset(new CPreRenderer());
 
-  if(o->m_textureid)
+    CPreRenderer::SParams params = { targetWidth, targetHeight, videoWidth, videoHeight, useMargin, position };
+    quads = m_preRenderer->Get(o->m_libass, params, pts);
+  }
+
+  COverlay *overlay = NULL;
+  if (quads)
   {
-    if(changes == 0)
+    if(o->m_textureid)
     {
-      std::map<unsigned int, COverlay*>::iterator it = m_textureCache.find(o->m_textureid);
-      if (it != m_textureCache.end())
-        return it->second;
+      std::map<unsigned int, std::shared_ptr<SQuads>>::iterator it = m_preRenderedQuads.find(o->m_textureid);
+      if (it != m_preRenderedQuads.end() && it->second == quads)
+        return m_textureCache[o->m_textureid];
     }
+
+    overlay = Convert(*quads, targetWidth, targetHeight, videoWidth, videoHeight);
+    m_preRenderedQuads[m_textureid] = quads;
   }
+  else
+  {
+    int changes = 0;
+    ASS_Image* images = o->m_libass->RenderImage(targetWidth, targetHeight, videoWidth, videoHeight, pts, useMargin, position, &changes);
 
+    // a texture made from an atlas rendered ahead doesn't necessarily show the
+    // frame this renderer rendered before
+    if(o->m_textureid && !m_preRenderedQuads.count(o->m_textureid))
+    {
+      if(changes == 0)
+      {
+        std::map<unsigned int, COverlay*>::iterator it = m_textureCache.find(o->m_textureid);
+        if (it != m_textureCache.end())
+          return it->second;
+      }
+    }
+
+    SQuads frame;
+    convert_quad(images, frame, targetWidth);
+    overlay = Convert(frame, targetWidth, targetHeight, videoWidth, videoHeight);
+  }
+
+  m_textureCache[m_textureid] = overlay;
+  o->m_textureid = m_textureid;
+  m_textureid++;
+  return overlay;
+}
+
+COverlay* CRenderer::Convert(const SQuads& quads, int targetWidth, int targetHeight, int videoWidth, int videoHeight)
+{
   COverlay *overlay = NULL;
 #if defined(HAS_GL) || defined(HAS_GLES)
-  overlay = new COverlayGlyphGL(images, targetWidth, targetHeight);
+  overlay = new COverlayGlyphGL(quads, targetWidth, targetHeight);
 #elif defined(HAS_DX)
-  overlay = new COverlayQuadsDX(images, targetWidth, targetHeight);
+  overlay = new COverlayQuadsDX(quads, targetWidth, targetHeight);
 #endif
   // scale to video dimensions
   if (overlay)
@@ -380,9 +441,6 @@ COverlay* CRenderer::Convert(CDVDOverlaySSA* o, double pts)
     overlay->m_x = ((float)videoWidth - targetWidth) / 2 / videoWidth;
     overlay->m_y = ((float)videoHeight - targetHeight) / 2 / videoHeight;
   }
-  m_textureCache[m_textureid] = overlay;
-  o->m_textureid = m_textureid;
-  m_textureid++;
   return overlay;
 }
 
@@ -392,7 +450,12 @@ COverlay* CRenderer::Convert(CDVDOverlay* o, double pts)
   COverlay* r = NULL;
 
   if(o->IsOverlayType(DVDOVERLAY_TYPE_SSA))
+  {
+    int64_t start = CurrentHostCounter();
     r = Convert(static_cast<CDVDOverlaySSA*>(o), pts);
+    double time = (CurrentHostCounter() - start) * 1000.0 / CurrentHostFrequency();
+    m_ssaRenderTime = m_ssaRenderTime > 0.0 ? m_ssaRenderTime * 0.9 + time * 0.1 : time;
+  }
   else if(o->m_textureid)
   {
     std::map<unsigned int, COverlay*>::iterator it = m_textureCache.find(o->m_textureid);
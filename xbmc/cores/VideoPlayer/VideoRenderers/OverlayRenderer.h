@@ -26,6 +26,7 @@
 
 #include <vector>
 #include <map>
+#include <memory>
 
 class CDVDOverlay;
 class CDVDOverlayImage;
@@ -34,6 +35,9 @@ class CDVDOverlaySSA;
 
 namespace OVERLAY {
 
+  class CPreRenderer;
+  struct SQuads;
+
   struct SRenderState
   {
     float x;
@@ -88,6 +92,14 @@ namespace OVERLAY {
     bool HasOverlay(int idx);
     void SetVideoRect(CRect &source, CRect &dest, CRect &view);
 
+    /*!
+     \brief Average times in ms spent on an ASS subtitle frame.
+     \param render time spent by the render thread
+     \param preRender time spent rendering a frame ahead, 0 if frames aren't rendered ahead
+     \return false if no ASS subtitles were rendered
+     */
+    bool GetSubtitleRenderTimes(double &render, double &preRender);
+
   protected:
 
     struct SElement
@@ -104,6 +116,7 @@ namespace OVERLAY {
     void Render(COverlay* o, float adjust_height);
     COverlay* Convert(CDVDOverlay* o, double pts);
     COverlay* Convert(CDVDOverlaySSA* o, double pts);
+    COverlay* Convert(const SQuads& quads, int targetWidth, int targetHeight, int videoWidth, int videoHeight);
 
     void Release(std::vector<SElement>& list);
     void ReleaseCache();
@@ -112,6 +125,9 @@ namespace OVERLAY {
     CCriticalSection m_section;
     std::vector<SElement> m_buffers[NUM_BUFFERS];
     std::map<unsigned int, COverlay*> m_textureCache;
+    std::map<unsigned int, std::shared_ptr<SQuads>> m_preRenderedQuads;
+    std::unique_ptr<CPreRenderer> m_preRenderer;
+    double m_ssaRenderTime = 0.0;
     static unsigned int m_textureid;
     CRect m_rv, m_rs, m_rd;
     std::string m_font, m_fontBorder;
@@ -738,6 +738,10 @@ void CRenderManager::Render(bool clear, DWORD flags, DWORD alpha, bool gui)
                                      clockspeed * 100);
       }
 
+      double subRender, subPreRender;
+      if (m_overlays.GetSubtitleRenderTimes(subRender, subPreRender))
+        vsync += StringUtils::Format("  Sub: render:%.2fms prerender:%.2fms", subRender, subPreRender);
+
       m_debugRenderer.SetInfo(audio, video, player, vsync);
       m_debugRenderer.Render(src, dst, view);
 
@@ -36,6 +36,7 @@
 #include "system.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
+#include "utils/YUVConverter.h"
 #include "VideoShaders/WinVideoFilter.h"
 #include "rendering/dx/DeviceResources.h"
 #include "rendering/dx/RenderContext.h"
@@ -733,6 +734,38 @@ void CWinRenderer::Render(DWORD flags, CD3DTexture* target)
   DX::Windowing().ApplyStateBlock();
 }
 
+// limited range pictures with a BT.601 or BT.709 matrix are converted by CYUVConverter, the rest by swscale
+static bool GetConverterParams(AVPixelFormat decoderFormat, const CRenderBuffer &buf, unsigned int width, unsigned int height,
+                               CYUVConverter::Format &format, CYUVConverter::Matrix &matrix)
+{
+  if (buf.full_range)
+    return false;
+
+  switch (GetFlagsColorMatrix(buf.color_space, width, height))
+  {
+  case CONF_FLAGS_YUVCOEF_BT601:
+    matrix = CYUVConverter::Matrix::BT601;
+    break;
+  case CONF_FLAGS_YUVCOEF_BT709:
+    matrix = CYUVConverter::Matrix::BT709;
+    break;
+  default:
+    return false;
+  }
+
+  switch (decoderFormat)
+  {
+  case AV_PIX_FMT_YUV420P:
+    format = CYUVConverter::Format::YUV420P;
+    return true;
+  case AV_PIX_FMT_NV12:
+    format = CYUVConverter::Format::NV12;
+    return true;
+  default:
+    return false;
+  }
+}
+
 void CWinRenderer::RenderSW(CD3DTexture* target)
 {
   // if creation failed
@@ -764,16 +797,21 @@ void CWinRenderer::RenderSW(CD3DTexture* target)
     }
   }
 
-  // 1. convert yuv to rgb
-  m_sw_scale_ctx = sws_getCachedContext(m_sw_scale_ctx,
-                                        m_sourceWidth, m_sourceHeight, decoderFormat,
-                                        m_sourceWidth, m_sourceHeight, AV_PIX_FMT_BGRA,
-                                        SWS_FAST_BILINEAR, nullptr, nullptr, nullptr);
-
   CRenderBuffer& buf = m_renderBuffers[m_iYV12RenderBuffer];
 
-  uint8_t* src[YuvImage::MAX_PLANES];
-  int srcStride[YuvImage::MAX_PLANES];
+  CYUVConverter::Format converterFormat;
+  CYUVConverter::Matrix converterMatrix;
+  bool useConverter = GetConverterParams(decoderFormat, buf, m_sourceWidth, m_sourceHeight, converterFormat, converterMatrix);
+
+  if (!useConverter)
+    m_sw_scale_ctx = sws_getCachedContext(m_sw_scale_ctx,
+                                          m_sourceWidth, m_sourceHeight, decoderFormat,
+                                          m_sourceWidth, m_sourceHeight, AV_PIX_FMT_BGRA,
+                                          SWS_FAST_BILINEAR, nullptr, nullptr, nullptr);
+
+  // 1. convert yuv to rgb
+  uint8_t* src[YuvImage::MAX_PLANES] = { nullptr, nullptr, nullptr };
+  int srcStride[YuvImage::MAX_PLANES] = { 0, 0, 0 };
 
   for (unsigned int idx = 0; idx < buf.GetActivePlanes(); idx++)
     buf.MapPlane(idx, reinterpret_cast<void**>(&src[idx]), &srcStride[idx]);
@@ -785,7 +823,11 @@ void CWinRenderer::RenderSW(CD3DTexture* target)
   uint8_t *dst[] = { static_cast<uint8_t*>(destlr.pData), nullptr, nullptr };
   int dstStride[] = { static_cast<int>(destlr.RowPitch), 0, 0 };
 
-  sws_scale(m_sw_scale_ctx, src, srcStride, 0, m_sourceHeight, dst, dstStride);
+  if (useConverter)
+    CYUVConverter::Convert(converterFormat, src, srcStride, m_sourceWidth, m_sourceHeight,
+                           dst[0], dstStride[0], CYUVConverter::Output::BGRA, converterMatrix);
+  else
+    sws_scale(m_sw_scale_ctx, src, srcStride, 0, m_sourceHeight, dst, dstStride);
 
   for (unsigned int idx = 0; idx < buf.GetActivePlanes(); idx++)
     buf.UnmapPlane(idx);
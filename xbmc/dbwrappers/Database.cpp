@@ -19,10 +19,13 @@
  */
 
 #include "Database.h"
+#include "LangInfo.h"
 #include "settings/AdvancedSettings.h"
 #include "filesystem/SpecialProtocol.h"
 #include "filesystem/File.h"
 #include "profiles/ProfilesManager.h"
+#include "threads/SystemClock.h"
+#include "utils/DatabaseUtils.h"
 #include "utils/log.h"
 #include "utils/SortUtils.h"
 #include "utils/StringUtils.h"
@@ -42,6 +45,10 @@
 using namespace dbiplus;
 
 #define MAX_COMPRESS_COUNT 20
+// listings smaller than this are sorted from their rows instead of ordering the whole library
+#define LIBRARY_SNAPSHOT_MIN_ITEMS 500
+// pages larger than this are picked from the rows of the listing instead of being queried by id
+#define LIBRARY_SNAPSHOT_MAX_PAGE_IDS 2000
 
 void CDatabase::Filter::AppendField(const std::string &strField)
 {
@@ -157,6 +164,17 @@ CDatabase::CDatabase() :
   m_sqlite = true;
   m_bMultiWrite = false;
   m_multipleExecute = false;
+  m_batch = false;
+  m_batchPaused = false;
+  m_batchMaxItems = 0;
+  m_batchMaxTime = 0;
+  m_batchItems = 0;
+  m_batchStart = 0;
+  m_savepointDepth = 0;
+  m_wal = false;
+  m_readConnections = 0;
+  m_idleConnections = 0;
+  m_idleTimeout = 0;
 }
 
 CDatabase::~CDatabase(void)
@@ -214,6 +232,26 @@ std::string CDatabase::GetSingleValue(const std::string &query, std::unique_ptr<
   return ret;
 }
 
+std::string CDatabase::GetSingleValue(const std::string &query, const dbiplus::BoundParams &params)
+{
+  std::string ret;
+  try
+  {
+    if (!m_pDB.get() || !m_pDS.get())
+      return ret;
+
+    if (m_pDS->query_bound(query, params) && m_pDS->num_rows() > 0)
+      ret = m_pDS->fv(0).get_asString();
+
+    m_pDS->close();
+  }
+  catch(...)
+  {
+    CLog::Log(LOGERROR, "%s - failed on query '%s'", __FUNCTION__, query.c_str());
+  }
+  return ret;
+}
+
 std::string CDatabase::GetSingleValue(const std::string &strTable, const std::string &strColumn, const std::string &strWhereClause /* = std::string() */, const std::string &strOrderBy /* = std::string() */)
 {
   std::string query = PrepareSQL("SELECT %s FROM %s", strColumn.c_str(), strTable.c_str());
@@ -227,7 +265,15 @@ std::string CDatabase::GetSingleValue(const std::string &strTable, const std::st
 
 std::string CDatabase::GetSingleValue(const std::string &query)
 {
-  return GetSingleValue(query, m_pDS);
+  std::unique_ptr<dbiplus::Database> readDB = AcquireReadConnection();
+  if (!readDB)
+    return GetSingleValue(query, m_pDS);
+
+  std::unique_ptr<dbiplus::Dataset> readDS(readDB->CreateDataset());
+  std::string value = GetSingleValue(query, readDS);
+  readDS.reset();
+  ReleaseReadConnection(std::move(readDB));
+  return value;
 }
 
 bool CDatabase::DeleteValues(const std::string &strTable, const Filter &filter /* = Filter() */)
@@ -248,9 +294,28 @@ bool CDatabase::CommitMultipleExecute()
 {
   m_multipleExecute = false;
   BeginTransaction();
-  for (std::vector<std::string>::const_iterator i = m_multipleQueries.begin(); i != m_multipleQueries.end(); ++i)
+  if (!m_sqlite)
   {
-    if (!ExecuteQuery(*i))
+    // send the queries in as few round trips as possible, the server stops at the first failing one
+    try
+    {
+      if (NULL == m_pDB.get() || NULL == m_pDS.get())
+        throw dbiplus::DbErrors("No Database Connection");
+      m_pDS->exec_batch(m_multipleQueries);
+    }
+    catch (dbiplus::DbErrors &error)
+    {
+      CLog::Log(LOGERROR, "%s - failed to execute queries: '%s'", __FUNCTION__, error.getMsg());
+      RollbackTransaction();
+      return false;
+    }
+    m_multipleQueries.clear();
+    return CommitTransaction();
+  }
+  for (const auto &query : m_multipleQueries)
+  {
+    bool success = query.second.empty() ? ExecuteQuery(query.first) : ExecuteQuery(query.first, query.second);
+    if (!success)
     {
       RollbackTransaction();
       return false;
@@ -264,7 +329,7 @@ bool CDatabase::ExecuteQuery(const std::string &strQuery)
 {
   if (m_multipleExecute)
   {
-    m_multipleQueries.push_back(strQuery);
+    m_multipleQueries.push_back(std::make_pair(strQuery, dbiplus::BoundParams()));
     return true;
   }
 
@@ -286,6 +351,32 @@ bool CDatabase::ExecuteQuery(const std::string &strQuery)
   return bReturn;
 }
 
+bool CDatabase::ExecuteQuery(const std::string &strQuery, const dbiplus::BoundParams &params)
+{
+  if (m_multipleExecute)
+  {
+    m_multipleQueries.push_back(std::make_pair(strQuery, params));
+    return true;
+  }
+
+  bool bReturn = false;
+
+  try
+  {
+    if (NULL == m_pDB.get()) return bReturn;
+    if (NULL == m_pDS.get()) return bReturn;
+    m_pDS->exec_bound(strQuery, params);
+    bReturn = true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s - failed to execute query '%s'",
+        __FUNCTION__, strQuery.c_str());
+  }
+
+  return bReturn;
+}
+
 bool CDatabase::ResultQuery(const std::string &strQuery)
 {
   bool bReturn = false;
@@ -308,6 +399,83 @@ bool CDatabase::ResultQuery(const std::string &strQuery)
   return bReturn;
 }
 
+int CDatabase::StreamQuery(const std::string &strQuery, const std::function<void(const dbiplus::sql_record&)> &onRow)
+{
+  if (NULL == m_pDB.get()) return -1;
+  if (NULL == m_pDS.get()) return -1;
+
+  // read from the pool if possible, so a writer on m_pDB doesn't hold us up
+  std::unique_ptr<dbiplus::Database> readDB = AcquireReadConnection();
+  std::unique_ptr<dbiplus::Dataset> readDS(readDB ? readDB->CreateDataset() : NULL);
+  dbiplus::Dataset *ds = readDS ? readDS.get() : m_pDS.get();
+
+  unsigned int time = XbmcThreads::SystemClockMillis();
+  int rows = 0;
+  try
+  {
+    if (!ds->query_stream(strQuery))
+      rows = -1;
+    else
+    {
+      dbiplus::sql_record record;
+      while (ds->step())
+      {
+        ds->fill_record(record);
+        onRow(record);
+        rows++;
+      }
+    }
+    ds->close();
+  }
+  catch (...)
+  {
+    ds->close();
+    readDS.reset();
+    ReleaseReadConnection(std::move(readDB));
+    throw;
+  }
+  readDS.reset();
+  ReleaseReadConnection(std::move(readDB));
+  if (rows < 0)
+    return -1;
+
+  CLog::Log(LOGDEBUG, LOGDATABASE, "%s took %d ms for %d items query: %s",
+            __FUNCTION__, XbmcThreads::SystemClockMillis() - time, rows, strQuery.c_str());
+  return rows;
+}
+
+std::unique_ptr<dbiplus::Database> CDatabase::AcquireReadConnection()
+{
+  // without write-ahead logging readers are blocked by the same locks as this connection,
+  // and another connection wouldn't see the uncommitted writes of a running transaction
+  if (!m_sqlite || !m_wal || m_readConnections == 0 || NULL == m_pDB.get())
+    return std::unique_ptr<dbiplus::Database>();
+  if (m_batch || m_pDB->in_transaction())
+    return std::unique_ptr<dbiplus::Database>();
+
+  std::unique_ptr<dbiplus::Database> connection = CServiceBroker::GetDatabaseManager().AcquireReadConnection(m_pDB->getHostName(), m_pDB->getDatabase());
+  if (connection)
+    return connection;
+
+  SqliteDatabase *sqlite = new SqliteDatabase();
+  connection.reset(sqlite);
+  sqlite->setHostName(m_pDB->getHostName());
+  sqlite->setDatabase(m_pDB->getDatabase());
+  sqlite->setReadOnly(true);
+  if (sqlite->connect(false) != DB_CONNECTION_OK)
+  {
+    CLog::Log(LOGERROR, "%s - unable to open a read-only connection to %s", __FUNCTION__, m_pDB->getDatabase());
+    return std::unique_ptr<dbiplus::Database>();
+  }
+  return connection;
+}
+
+void CDatabase::ReleaseReadConnection(std::unique_ptr<dbiplus::Database> connection)
+{
+  if (connection)
+    CServiceBroker::GetDatabaseManager().ReleaseReadConnection(std::move(connection), m_readConnections);
+}
+
 bool CDatabase::QueueInsertQuery(const std::string &strQuery)
 {
   if (strQuery.empty())
@@ -426,6 +594,23 @@ bool CDatabase::Connect(const std::string &dbName, const DatabaseSettings &dbSet
 #if defined(HAS_MYSQL) || defined(HAS_MARIADB)
   else if (dbSettings.type == "mysql")
   {
+    // logging in to the server takes several round trips, reuse an idle connection of an earlier open
+    m_connectionKey = StringUtils::Join(std::vector<std::string>{ dbSettings.user, dbSettings.pass, dbSettings.host, dbSettings.port, dbName,
+                                                                  dbSettings.key, dbSettings.cert, dbSettings.ca, dbSettings.capath, dbSettings.ciphers,
+                                                                  dbSettings.compression ? "1" : "0" }, "\n");
+    m_idleConnections = dbSettings.idleConnections;
+    m_idleTimeout = dbSettings.idleTimeout * 1000;
+    if (!create)
+    {
+      m_pDB = CServiceBroker::GetDatabaseManager().AcquireConnection(m_connectionKey);
+      if (m_pDB)
+      {
+        m_pDS.reset(m_pDB->CreateDataset());
+        m_pDS2.reset(m_pDB->CreateDataset());
+        m_openCount = 1;
+        return true;
+      }
+    }
     m_pDB.reset( new MysqlDatabase() ) ;
   }
 #endif
@@ -491,6 +676,7 @@ bool CDatabase::Connect(const std::string &dbName, const DatabaseSettings &dbSet
       m_pDS->exec("PRAGMA cache_size=4096\n");
       m_pDS->exec("PRAGMA synchronous='NORMAL'\n");
       m_pDS->exec("PRAGMA count_changes='OFF'\n");
+      SetJournalMode(dbSettings);
     }
   }
   catch (DbErrors &error)
@@ -505,6 +691,40 @@ bool CDatabase::Connect(const std::string &dbName, const DatabaseSettings &dbSet
   return true;
 }
 
+void CDatabase::SetJournalMode(const DatabaseSettings &dbSettings)
+{
+  m_wal = false;
+  m_readConnections = 0;
+
+  // the journal mode is stored in the database file, so only change it when needed.
+  // Switching needs the database to ourselves, retry on the next connect if it's busy.
+  try
+  {
+    bool wal = StringUtils::EqualsNoCase(GetSingleValue("PRAGMA journal_mode", m_pDS), "wal");
+    if (dbSettings.wal && !wal)
+    {
+      m_pDS->exec("PRAGMA journal_mode=WAL\n");
+      wal = StringUtils::EqualsNoCase(GetSingleValue("PRAGMA journal_mode", m_pDS), "wal");
+    }
+    else if (!dbSettings.wal && wal)
+    {
+      m_pDS->exec("PRAGMA journal_mode=DELETE\n");
+      wal = false;
+    }
+
+    if (wal)
+    {
+      m_pDS->exec(PrepareSQL("PRAGMA wal_autocheckpoint=%i\n", dbSettings.walAutoCheckpoint));
+      m_wal = true;
+      m_readConnections = dbSettings.readConnections;
+    }
+  }
+  catch (DbErrors &error)
+  {
+    CLog::Log(LOGWARNING, "%s unable to change the journal mode: '%s'", __FUNCTION__, error.getMsg());
+  }
+}
+
 int CDatabase::GetDBVersion()
 {
   m_pDS->query("SELECT idVersion FROM version\n");
@@ -532,12 +752,24 @@ void CDatabase::Close()
   m_openCount = 0;
   m_multipleExecute = false;
 
+  if (m_batch)
+  {
+    CLog::Log(LOGWARNING, "%s - closing the database while a batch is running, committing it", __FUNCTION__);
+    EndBatch();
+  }
+
   if (NULL == m_pDB.get() ) return ;
   if (NULL != m_pDS.get()) m_pDS->close();
-  m_pDB->disconnect();
-  m_pDB.reset();
   m_pDS.reset();
   m_pDS2.reset();
+
+  // keep the server connection for the next open, the pool resets its session
+  if (!m_connectionKey.empty())
+    CServiceBroker::GetDatabaseManager().ReleaseConnection(m_connectionKey, std::move(m_pDB), m_idleConnections, m_idleTimeout);
+  else
+    m_pDB->disconnect();
+  m_pDB.reset();
+  m_connectionKey.clear();
 }
 
 bool CDatabase::Compress(bool bForce /* =true */)
@@ -567,6 +799,10 @@ bool CDatabase::Compress(bool bForce /* =true */)
 
     if (!m_pDS->exec("vacuum\n"))
       return false;
+
+    // the vacuum went through the write-ahead log, shrink it again
+    if (m_wal)
+      m_pDS->exec("PRAGMA wal_checkpoint(TRUNCATE)\n");
   }
   catch (...)
   {
@@ -585,7 +821,12 @@ void CDatabase::BeginTransaction()
 {
   try
   {
-    if (NULL != m_pDB.get())
+    if (NULL == m_pDB.get())
+      return;
+
+    if (m_batch && !m_batchPaused)
+      m_pDB->start_savepoint(StringUtils::Format("batch%u", ++m_savepointDepth).c_str());
+    else
       m_pDB->start_transaction();
   }
   catch (...)
@@ -598,7 +839,16 @@ bool CDatabase::CommitTransaction()
 {
   try
   {
-    if (NULL != m_pDB.get())
+    if (NULL == m_pDB.get())
+      return true;
+
+    if (m_batch && !m_batchPaused)
+    {
+      // the batch transaction itself is committed at the next checkpoint
+      if (m_savepointDepth > 0)
+        m_pDB->release_savepoint(StringUtils::Format("batch%u", m_savepointDepth--).c_str());
+    }
+    else
       m_pDB->commit_transaction();
   }
   catch (...)
@@ -613,7 +863,19 @@ void CDatabase::RollbackTransaction()
 {
   try
   {
-    if (NULL != m_pDB.get())
+    if (NULL == m_pDB.get())
+      return;
+
+    if (m_batch && !m_batchPaused)
+    {
+      if (m_savepointDepth > 0)
+      {
+        std::string savepoint = StringUtils::Format("batch%u", m_savepointDepth--);
+        m_pDB->rollback_savepoint(savepoint.c_str());
+        m_pDB->release_savepoint(savepoint.c_str());
+      }
+    }
+    else
       m_pDB->rollback_transaction();
   }
   catch (...)
@@ -622,6 +884,100 @@ void CDatabase::RollbackTransaction()
   }
 }
 
+void CDatabase::BeginBatch(unsigned int maxItems, unsigned int maxTime)
+{
+  if (m_batch)
+    EndBatch();
+
+  if (NULL == m_pDB.get())
+    return;
+
+  BeginTransaction();
+  m_batch = true;
+  m_batchPaused = false;
+  m_batchMaxItems = maxItems;
+  m_batchMaxTime = maxTime;
+  m_batchItems = 0;
+  m_batchStart = XbmcThreads::SystemClockMillis();
+  m_savepointDepth = 0;
+}
+
+bool CDatabase::BatchCheckpoint(unsigned int items /* = 1 */)
+{
+  if (!m_batch)
+    return false;
+
+  m_batchItems += items;
+
+  // never commit from inside an item that is still being written
+  if (m_savepointDepth > 0 || m_batchPaused)
+    return false;
+
+  if ((m_batchMaxItems > 0 && m_batchItems >= m_batchMaxItems) ||
+      (m_batchMaxTime > 0 && XbmcThreads::SystemClockMillis() - m_batchStart >= m_batchMaxTime))
+  {
+    bool committed = CommitBatch();
+    m_pDB->start_transaction();
+    return committed;
+  }
+  return false;
+}
+
+bool CDatabase::EndBatch()
+{
+  if (!m_batch)
+    return true;
+
+  bool committed = m_batchPaused || CommitBatch();
+  m_batch = false;
+  m_batchPaused = false;
+  m_savepointDepth = 0;
+
+  // move the batch into the database while nobody is waiting for it
+  if (m_wal)
+    ExecuteQuery("PRAGMA wal_checkpoint(PASSIVE)");
+  return committed;
+}
+
+void CDatabase::PauseBatch()
+{
+  if (!m_batch || m_batchPaused || m_savepointDepth > 0)
+    return;
+
+  CommitBatch();
+  m_batchPaused = true;
+}
+
+void CDatabase::ResumeBatch()
+{
+  if (!m_batchPaused)
+    return;
+
+  m_batchPaused = false;
+  m_batchStart = XbmcThreads::SystemClockMillis();
+  m_pDB->start_transaction();
+}
+
+bool CDatabase::CommitBatch()
+{
+  unsigned int items = m_batchItems;
+  unsigned int elapsed = XbmcThreads::SystemClockMillis() - m_batchStart;
+  m_batchItems = 0;
+  m_batchStart = XbmcThreads::SystemClockMillis();
+
+  try
+  {
+    m_pDB->commit_transaction();
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s - failed to commit a batch of %u items", __FUNCTION__, items);
+    return false;
+  }
+  CLog::Log(LOGDEBUG, "%s - committed a batch of %u items after %u ms", __FUNCTION__, items, elapsed);
+  return true;
+}
+
 bool CDatabase::InTransaction()
 {
   if (NULL != m_pDB.get()) return false;
@@ -675,6 +1031,272 @@ bool CDatabase::BuildSQL(const std::string &strQuery, const Filter &filter, std:
   return true;
 }
 
+bool CDatabase::CreateFullTextIndex(const std::string &index, const std::string &table, const std::string &idColumn, const std::vector<std::string> &columns)
+{
+  if (!m_sqlite || columns.empty() || NULL == m_pDB.get() || NULL == m_pDS.get())
+    return false;
+
+  std::string columnList = StringUtils::Join(columns, ", ");
+  std::string newColumns;
+  for (const auto &column : columns)
+    newColumns += ", new." + column;
+
+  try
+  {
+    m_pDS->exec("DROP TABLE IF EXISTS " + index);
+    m_pDS->exec(PrepareSQL("CREATE VIRTUAL TABLE %s USING fts5(%s, tokenize='unicode61')", index.c_str(), columnList.c_str()));
+  }
+  catch (...)
+  {
+    CLog::Log(LOGWARNING, "%s - full-text index %s is not available, searches will scan %s", __FUNCTION__, index.c_str(), table.c_str());
+    return false;
+  }
+
+  try
+  {
+    m_pDS->exec(PrepareSQL("INSERT INTO %s (rowid, %s) SELECT %s, %s FROM %s",
+                           index.c_str(), columnList.c_str(), idColumn.c_str(), columnList.c_str(), table.c_str()));
+    m_pDS->exec(PrepareSQL("CREATE TRIGGER %s_insert AFTER INSERT ON %s FOR EACH ROW BEGIN "
+                           "INSERT INTO %s (rowid, %s) VALUES (new.%s%s); "
+                           "END", index.c_str(), table.c_str(), index.c_str(), columnList.c_str(), idColumn.c_str(), newColumns.c_str()));
+    m_pDS->exec(PrepareSQL("CREATE TRIGGER %s_update AFTER UPDATE OF %s ON %s FOR EACH ROW BEGIN "
+                           "DELETE FROM %s WHERE rowid = old.%s; "
+                           "INSERT INTO %s (rowid, %s) VALUES (new.%s%s); "
+                           "END", index.c_str(), columnList.c_str(), table.c_str(), index.c_str(), idColumn.c_str(), index.c_str(), columnList.c_str(), idColumn.c_str(), newColumns.c_str()));
+    m_pDS->exec(PrepareSQL("CREATE TRIGGER %s_delete AFTER DELETE ON %s FOR EACH ROW BEGIN "
+                           "DELETE FROM %s WHERE rowid = old.%s; "
+                           "END", index.c_str(), table.c_str(), index.c_str(), idColumn.c_str()));
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s - failed to fill full-text index %s", __FUNCTION__, index.c_str());
+  }
+
+  // an index that is not maintained would return stale results, and its triggers would
+  // make every change of the indexed table fail, so don't leave either around
+  try
+  {
+    for (const char *trigger : { "insert", "update", "delete" })
+      m_pDS->exec(PrepareSQL("DROP TRIGGER IF EXISTS %s_%s", index.c_str(), trigger));
+    m_pDS->exec("DROP TABLE IF EXISTS " + index);
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s - failed to remove full-text index %s", __FUNCTION__, index.c_str());
+  }
+  return false;
+}
+
+bool CDatabase::HasFullTextIndex(const std::string &index)
+{
+  if (!m_sqlite)
+    return false;
+
+  return !GetSingleValue(PrepareSQL("SELECT name FROM sqlite_master WHERE type='table' AND name='%s'", index.c_str())).empty();
+}
+
+std::string CDatabase::PrepareFullTextQuery(const std::string &search, bool leadingOnly /* = false */, const std::vector<std::string> &columns /* = std::vector<std::string>() */)
+{
+  std::vector<std::string> words = StringUtils::Split(search, " ");
+  std::string phrase;
+  for (const auto &word : words)
+  {
+    if (word.empty())
+      continue;
+    if (!phrase.empty())
+      phrase += " ";
+    phrase += word;
+  }
+  if (phrase.empty())
+    return phrase;
+
+  // quote the words so that they are never taken for query syntax
+  StringUtils::Replace(phrase, "\"", "\"\"");
+
+  std::string query;
+  if (leadingOnly)
+  {
+    // the text has to start with the search, or with a sort token followed by it
+    query = "^\"" + phrase + "\"*";
+    std::set<std::string> articles;
+    for (const auto &token : g_langInfo.GetSortTokens())
+    {
+      std::string article = token;
+      StringUtils::Trim(article, " ._");
+      if (!article.empty() && article.find('"') == std::string::npos && articles.insert(article).second)
+        query += " OR ^\"" + article + " " + phrase + "\"*";
+    }
+  }
+  else
+  {
+    // every word has to be found, in any order
+    StringUtils::Replace(phrase, " ", "\"* \"");
+    query = "\"" + phrase + "\"*";
+  }
+
+  if (!columns.empty())
+    query = "{" + StringUtils::Join(columns, " ") + "} : (" + query + ")";
+
+  return query;
+}
+
+bool CDatabase::CreateLibraryVersionTriggers(const std::vector<std::string> &tables,
+                                             const std::map<std::string, std::vector<std::string>> &orderColumns /* = std::map<std::string, std::vector<std::string>>() */)
+{
+  if (NULL == m_pDB.get() || NULL == m_pDS.get())
+    return false;
+
+  static const char *events[] = { "insert", "update", "delete" };
+  try
+  {
+    for (const auto &table : tables)
+    {
+      // MySQL has no UPDATE OF triggers, so the update trigger compares the order columns itself
+      std::string changed;
+      auto columns = orderColumns.find(table);
+      if (columns != orderColumns.end())
+      {
+        std::vector<std::string> conditions;
+        for (const auto &column : columns->second)
+          conditions.push_back(PrepareSQL("old.%s <> new.%s OR (old.%s IS NULL) <> (new.%s IS NULL)",
+                                          column.c_str(), column.c_str(), column.c_str(), column.c_str()));
+        changed = " WHERE " + StringUtils::Join(conditions, " OR ");
+      }
+
+      for (const char *event : events)
+      {
+        std::string upper = event;
+        StringUtils::ToUpper(upper);
+        m_pDS->exec(PrepareSQL("CREATE TRIGGER %s_libraryversion_%s AFTER %s ON %s FOR EACH ROW BEGIN "
+                               "UPDATE libraryversion SET iVersion = iVersion + 1%s; "
+                               "END", table.c_str(), event, upper.c_str(), table.c_str(),
+                               upper == "UPDATE" ? changed.c_str() : ""));
+      }
+    }
+
+    if (GetSingleValue("SELECT iVersion FROM libraryversion").empty())
+      m_pDS->exec("INSERT INTO libraryversion (iVersion) VALUES (0)");
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGWARNING, "%s - unable to track library changes, sorted listings will not be cached", __FUNCTION__);
+  }
+
+  // without the version the cached orders could never be invalidated
+  m_pDS->exec("DELETE FROM libraryversion");
+  return false;
+}
+
+bool CDatabase::GetSortedPage(const std::string &mediaType, const std::string &strSQL, const std::string &strSQLExtra,
+                              const SortDescription &sorting, int &total, const std::function<void(const dbiplus::sql_record*)> &onRow)
+{
+  if (NULL == m_pDB.get() || NULL == m_pDS.get())
+    return false;
+
+  if (sorting.sortBy == SortByNone || sorting.sortBy == SortByRandom)
+    return false;
+
+  // uncommitted changes must not end up in an order shared with other connections
+  if (m_batch || m_pDB->in_transaction())
+    return false;
+
+  std::string version = GetSingleValue("SELECT iVersion FROM libraryversion");
+  if (version.empty())
+    return false;
+
+  std::string idField = DatabaseUtils::GetField(FieldId, mediaType, DatabaseQueryPartSelect);
+  int idIndex = DatabaseUtils::GetFieldIndex(FieldId, mediaType);
+  if (idField.empty() || idIndex < 0)
+    return false;
+  std::string viewFields = idField.substr(0, idField.find('.')) + ".*";
+
+  std::vector<int> ids;
+  if (StreamQuery(PrepareSQL(strSQL, idField.c_str()) + strSQLExtra,
+                  [&ids](const dbiplus::sql_record &record) { ids.push_back(record.at(0).get_asInt()); }) < 0)
+    return false;
+
+  CLibrarySnapshot &snapshot = CServiceBroker::GetDatabaseManager().GetLibrarySnapshot();
+  std::string library = StringUtils::Format("%s/%s:%s", m_pDB->getHostName(), m_pDB->getDatabase(), mediaType.c_str());
+  int64_t libraryVersion = strtoll(version.c_str(), NULL, 10);
+  std::shared_ptr<const CLibrarySnapshot::Ranks> ranks = snapshot.Get(library, libraryVersion, sorting);
+  if (!ranks)
+  {
+    // sorting small listings from their rows is cheaper than ordering the whole library
+    if (ids.size() < LIBRARY_SNAPSHOT_MIN_ITEMS)
+      return false;
+
+    if (!m_pDS->query(PrepareSQL(strSQL, viewFields.c_str())))
+      return false;
+
+    SortDescription librarySorting = sorting;
+    librarySorting.limitStart = 0;
+    librarySorting.limitEnd = -1;
+    DatabaseResults results;
+    if (!SortUtils::SortFromDataset(librarySorting, mediaType, m_pDS, results))
+    {
+      m_pDS->close();
+      return false;
+    }
+
+    std::shared_ptr<CLibrarySnapshot::Ranks> libraryRanks(new CLibrarySnapshot::Ranks());
+    const query_data &data = m_pDS->get_result_set().records;
+    unsigned int rank = 0;
+    for (const auto &result : results)
+    {
+      int id = data.at(static_cast<unsigned int>(result.at(FieldRow).asInteger()))->at(idIndex).get_asInt();
+      if (id < 0)
+        continue;
+      if (static_cast<size_t>(id) >= libraryRanks->size())
+        libraryRanks->resize(id + 1, CLibrarySnapshot::NoRank);
+      (*libraryRanks)[id] = rank++;
+    }
+    m_pDS->close();
+
+    ranks = libraryRanks;
+    snapshot.Set(library, libraryVersion, sorting, ranks);
+  }
+
+  int count = static_cast<int>(ids.size());
+  if (!CLibrarySnapshot::Order(*ranks, ids, sorting.limitStart, sorting.limitEnd))
+    return false;
+
+  total = count;
+  if (ids.empty())
+    return true;
+
+  // fetch the rows on the page by their ids, unless there are so many that the listing itself is cheaper
+  std::string strPageSQL = PrepareSQL(strSQL, viewFields.c_str());
+  if (ids.size() <= LIBRARY_SNAPSHOT_MAX_PAGE_IDS)
+  {
+    std::vector<std::string> idList;
+    idList.reserve(ids.size());
+    for (int id : ids)
+      idList.push_back(StringUtils::Format("%i", id));
+    strPageSQL += "WHERE " + idField + " IN (" + StringUtils::Join(idList, ",") + ")";
+  }
+  else
+    strPageSQL += strSQLExtra;
+
+  if (!m_pDS->query(strPageSQL))
+    return false;
+
+  std::map<int, const dbiplus::sql_record*> rows;
+  for (const auto &record : m_pDS->get_result_set().records)
+    rows.insert(std::make_pair(record->at(idIndex).get_asInt(), record));
+
+  for (int id : ids)
+  {
+    auto row = rows.find(id);
+    if (row != rows.end())
+      onRow(row->second);
+  }
+
+  m_pDS->close();
+  return true;
+}
+
 bool CDatabase::BuildSQL(const std::string &strBaseDir, const std::string &strQuery, Filter &filter, std::string &strSQL, CDbUrl &dbUrl)
 {
   SortDescription sorting;
@@ -25,10 +25,15 @@ namespace dbiplus {
   class Dataset;
 }
 
+#include <functional>
+#include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "qry_dat.h"
+
 class DatabaseSettings; // forward
 class CDbUrl;
 class CProfilesManager;
@@ -87,6 +92,51 @@ public:
   virtual bool CommitTransaction();
   void RollbackTransaction();
   bool InTransaction();
+
+  /*! \brief Group many small writes, e.g. those of a library scan, into a few large transactions.
+   Opens a transaction that is held across BeginTransaction()/CommitTransaction() pairs, which
+   become savepoints while the batch is running so that a failing item only rolls back its own writes.
+   The transaction is committed at a BatchCheckpoint() once maxItems items were checkpointed or
+   maxTime milliseconds passed since the last commit.
+   \param maxItems the number of items after which the batch is committed, 0 for no limit.
+   \param maxTime the time in milliseconds after which the batch is committed, 0 for no limit.
+   \sa BatchCheckpoint, EndBatch
+   */
+  void BeginBatch(unsigned int maxItems, unsigned int maxTime);
+
+  /*! \brief Mark a consistent point of the running batch.
+   Anything written up to here is known to be complete, so the batch may be committed.
+   \param items the number of items that were written since the last checkpoint.
+   \return true if the batch was committed, false otherwise.
+   \sa BeginBatch
+   */
+  bool BatchCheckpoint(unsigned int items = 1);
+
+  /*! \brief Commit and finish the running batch.
+   \return true if the batch was committed successfully or no batch was running, false otherwise.
+   \sa BeginBatch
+   */
+  bool EndBatch();
+
+  /*! \brief Commit the running batch and hold no transaction until ResumeBatch().
+   Used around slow work between items, e.g. scraper calls, so that other connections aren't kept
+   waiting for the database while nothing is written. Writes made while paused are committed on their own.
+   Does nothing if no batch is running or an item is still being written.
+   \sa ResumeBatch
+   */
+  void PauseBatch();
+
+  /*! \brief Continue a batch paused by PauseBatch().
+   \sa PauseBatch
+   */
+  void ResumeBatch();
+
+  bool InBatch() const { return m_batch; }
+
+  /*! \brief Whether sqlite uses write-ahead logging on this connection, see DatabaseSettings.
+   */
+  bool IsWAL() const { return m_wal; }
+
   void CopyDB(const std::string& latestDb);
   void DropAnalytics();
 
@@ -111,6 +161,14 @@ public:
    */
   std::string GetSingleValue(const std::string &query, std::unique_ptr<dbiplus::Dataset> &ds);
 
+  /*! \brief Get a single value from a query with ? placeholders bound to the given values.
+   The compiled query is cached by the connection and reused on later calls.
+   \param query the query in question.
+   \param params the values of the placeholders.
+   \return the value from the query, empty on failure.
+   */
+  std::string GetSingleValue(const std::string &query, const dbiplus::BoundParams &params);
+
   /*!
    * @brief Delete values from a table.
    * @param strTable The table to delete the values from.
@@ -129,6 +187,17 @@ public:
    */
   bool ExecuteQuery(const std::string &strQuery);
 
+  /*!
+   * @brief Execute a query with ? placeholders bound to the given values.
+   *        The compiled query is cached by the connection and reused for
+   *        every later call, including those queued by BeginMultipleExecute().
+   * @param strQuery The query to execute, with ? placeholders.
+   * @param params The values of the placeholders.
+   * @return True if the query was executed successfully, false otherwise.
+   * @sa ExecuteQuery
+   */
+  bool ExecuteQuery(const std::string &strQuery, const dbiplus::BoundParams &params);
+
   /*!
    * @brief Execute a query that returns a result.
    * @remarks Call m_pDS->close(); to clean up the dataset when done.
@@ -137,6 +206,16 @@ public:
    */
   bool ResultQuery(const std::string &strQuery);
 
+  /*!
+   * @brief Execute a select query as a forward-only stream on m_pDS.
+   *        Rows are handed to onRow as they are read from the database,
+   *        without materializing the result set, and m_pDS is closed afterwards.
+   * @param strQuery The prepared query to execute.
+   * @param onRow Called for each row. The record is reused for the next row.
+   * @return The number of rows read, or -1 if the query failed.
+   */
+  int StreamQuery(const std::string &strQuery, const std::function<void(const dbiplus::sql_record&)> &onRow);
+
   /*!
    * @brief Start a multiple execution queue. Any ExecuteQuery() function
    *        following this call will be queued rather than executed until
@@ -217,6 +296,58 @@ protected:
 
   bool BuildSQL(const std::string &strQuery, const Filter &filter, std::string &strSQL);
 
+  /*! \brief Create a full-text index over text columns of a table, kept up to date by triggers.
+   The index is a sqlite FTS5 table whose rowid is the id of the indexed row. It is not available
+   with MySQL or when sqlite was built without FTS5, searches have to fall back to LIKE queries then.
+   \param index name of the full-text table, it is recreated and filled from the indexed table.
+   \param table the table to index.
+   \param idColumn the integer primary key of the indexed table.
+   \param columns the columns to index.
+   \return true if the index was created, false otherwise.
+   \sa HasFullTextIndex, PrepareFullTextQuery
+   */
+  bool CreateFullTextIndex(const std::string &index, const std::string &table, const std::string &idColumn, const std::vector<std::string> &columns);
+
+  /*! \brief Check whether a full-text index created by CreateFullTextIndex() can be queried.
+   */
+  bool HasFullTextIndex(const std::string &index);
+
+  /*! \brief Turn the text entered by the user into a full-text query.
+   Every word is matched by prefix, case and diacritics are folded by the index tokenizer.
+   \param search the text to search for.
+   \param leadingOnly true to only match text starting with the search, ignoring a leading sort token (e.g. "The").
+   \param columns the indexed columns to look in, all of them if empty.
+   \return the expression to MATCH against the index, empty if the search holds no words.
+   */
+  static std::string PrepareFullTextQuery(const std::string &search, bool leadingOnly = false, const std::vector<std::string> &columns = std::vector<std::string>());
+
+  /*! \brief Create triggers bumping the version in the libraryversion table on every change of the given tables.
+   The version tells whether the orders cached by CLibrarySnapshot are still valid. If the triggers
+   can't be created the version is removed, so the snapshot is not used for this database.
+   \param tables the tables that hold fields the library can be sorted by.
+   \param orderColumns for tables that also hold fields changed by playback, like play counts, the columns
+   whose updates bump the version. Updates of the other columns of these tables keep the cached orders.
+   \return true if the triggers were created, false otherwise.
+   \sa GetSortedPage
+   */
+  bool CreateLibraryVersionTriggers(const std::vector<std::string> &tables,
+                                    const std::map<std::string, std::vector<std::string>> &orderColumns = std::map<std::string, std::vector<std::string>>());
+
+  /*! \brief Get the rows on a page of a sorted listing using the cached order of the whole library.
+   Only the ids of the items in the listing are queried to order it, the other fields are only
+   fetched for the rows on the requested page.
+   \param mediaType the media type of the items in the library view.
+   \param strSQL the query of the library view with a %s placeholder for the fields, e.g. "select %s from movie_view ".
+   \param strSQLExtra the joins, conditions and grouping of the listing.
+   \param sorting the sort and limits of the listing.
+   \param total set to the number of items in the listing, regardless of the limits.
+   \param onRow called for the rows on the page, in sorted order.
+   \return true if the page was fetched, false if the listing has to be sorted from its rows instead.
+   \sa CLibrarySnapshot
+   */
+  bool GetSortedPage(const std::string &mediaType, const std::string &strSQL, const std::string &strSQLExtra,
+                     const SortDescription &sorting, int &total, const std::function<void(const dbiplus::sql_record*)> &onRow);
+
   bool m_sqlite; ///< \brief whether we use sqlite (defaults to true)
 
   std::unique_ptr<dbiplus::Database> m_pDB;
@@ -229,11 +360,35 @@ protected:
 
 private:
   void InitSettings(DatabaseSettings &dbSettings);
+  void SetJournalMode(const DatabaseSettings &dbSettings);
   void UpdateVersionNumber();
 
   bool m_bMultiWrite; /*!< True if there are any queries in the queue, false otherwise */
   unsigned int m_openCount;
 
   bool m_multipleExecute;
-  std::vector<std::string> m_multipleQueries;
+  std::vector<std::pair<std::string, dbiplus::BoundParams>> m_multipleQueries;
+
+  bool CommitBatch();
+
+  /*! \brief Get a read-only connection to this database for queries while another connection writes.
+   \return the connection, or an empty pointer if queries have to run on this connection.
+   */
+  std::unique_ptr<dbiplus::Database> AcquireReadConnection();
+  void ReleaseReadConnection(std::unique_ptr<dbiplus::Database> connection);
+
+  bool m_wal;                        /*!< True if sqlite uses write-ahead logging */
+  unsigned int m_readConnections;    /*!< idle read-only connections to keep, see DatabaseSettings */
+
+  std::string m_connectionKey;       /*!< identifies the server connection in the pool of the database manager, empty if not pooled */
+  unsigned int m_idleConnections;    /*!< idle server connections to keep, see DatabaseSettings */
+  unsigned int m_idleTimeout;        /*!< milliseconds an idle server connection is kept, see DatabaseSettings */
+
+  bool m_batch; /*!< True while a batch transaction is held open, see BeginBatch() */
+  bool m_batchPaused;            /*!< True while the batch holds no transaction, see PauseBatch() */
+  unsigned int m_batchMaxItems;
+  unsigned int m_batchMaxTime;
+  unsigned int m_batchItems;     /*!< items checkpointed since the last commit */
+  unsigned int m_batchStart;     /*!< time of the last commit */
+  unsigned int m_savepointDepth; /*!< nested BeginTransaction() calls inside the batch */
 };
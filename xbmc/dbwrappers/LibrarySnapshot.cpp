@@ -0,0 +1,102 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "LibrarySnapshot.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "threads/SingleLock.h"
+
+// every order takes an unsigned int per item, so a handful of sorts of a few libraries is plenty
+#define LIBRARY_SNAPSHOT_MAX_ORDERS 8
+
+const unsigned int CLibrarySnapshot::NoRank = std::numeric_limits<unsigned int>::max();
+
+std::shared_ptr<const CLibrarySnapshot::Ranks> CLibrarySnapshot::Get(const std::string &library, int64_t version, const SortDescription &sorting)
+{
+  CSingleLock lock(m_critSection);
+  for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+  {
+    if (it->library != library || it->sortBy != sorting.sortBy ||
+        it->sortOrder != sorting.sortOrder || it->sortAttributes != sorting.sortAttributes)
+      continue;
+
+    if (it->version != version)
+    {
+      m_entries.erase(it);
+      return std::shared_ptr<const Ranks>();
+    }
+
+    m_entries.splice(m_entries.begin(), m_entries, it);
+    return m_entries.front().ranks;
+  }
+
+  return std::shared_ptr<const Ranks>();
+}
+
+void CLibrarySnapshot::Set(const std::string &library, int64_t version, const SortDescription &sorting, const std::shared_ptr<const Ranks> &ranks)
+{
+  CSingleLock lock(m_critSection);
+  m_entries.remove_if([&](const Entry &entry)
+  {
+    return entry.library == library && entry.sortBy == sorting.sortBy &&
+           entry.sortOrder == sorting.sortOrder && entry.sortAttributes == sorting.sortAttributes;
+  });
+
+  Entry entry;
+  entry.library = library;
+  entry.version = version;
+  entry.sortBy = sorting.sortBy;
+  entry.sortOrder = sorting.sortOrder;
+  entry.sortAttributes = sorting.sortAttributes;
+  entry.ranks = ranks;
+  m_entries.push_front(entry);
+
+  while (m_entries.size() > LIBRARY_SNAPSHOT_MAX_ORDERS)
+    m_entries.pop_back();
+}
+
+void CLibrarySnapshot::Clear()
+{
+  CSingleLock lock(m_critSection);
+  m_entries.clear();
+}
+
+bool CLibrarySnapshot::Order(const Ranks &ranks, std::vector<int> &ids, int limitStart, int limitEnd)
+{
+  for (int id : ids)
+  {
+    if (id < 0 || static_cast<size_t>(id) >= ranks.size() || ranks[id] == NoRank)
+      return false;
+  }
+
+  std::stable_sort(ids.begin(), ids.end(), [&ranks](int lhs, int rhs) { return ranks[lhs] < ranks[rhs]; });
+
+  if (limitStart > 0 && static_cast<size_t>(limitStart) < ids.size())
+  {
+    ids.erase(ids.begin(), ids.begin() + limitStart);
+    limitEnd -= limitStart;
+  }
+  if (limitEnd > 0 && static_cast<size_t>(limitEnd) < ids.size())
+    ids.erase(ids.begin() + limitEnd, ids.end());
+
+  return true;
+}
@@ -0,0 +1,91 @@
+#pragma once
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <list>
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "threads/CriticalSection.h"
+#include "utils/SortUtils.h"
+
+/*!
+ \ingroup database
+ \brief Cache of the order of whole libraries for recently used sorts.
+
+ For every item of a library it holds the position the item takes when the library is sorted,
+ so a filtered, sorted and paged listing only needs the ids of the items passing the filter
+ from the database, and the details of the items on the requested page.
+ Orders are tied to the library version of their database, which is bumped by triggers on
+ every change, and are dropped once that version has moved on.
+ */
+class CLibrarySnapshot
+{
+public:
+  typedef std::vector<unsigned int> Ranks; ///< Position of each item in the sorted library, indexed by item id.
+  static const unsigned int NoRank;         ///< Rank of ids that are not part of the library.
+
+  CLibrarySnapshot() = default;
+  CLibrarySnapshot(const CLibrarySnapshot&) = delete;
+  CLibrarySnapshot const& operator=(CLibrarySnapshot const&) = delete;
+
+  /*! \brief Get the order of a library for a sort.
+   \param library identifies the database and media type.
+   \param version the current library version of the database.
+   \param sorting the sort, its limits are ignored.
+   \return the ranks of the items, or an empty pointer if there is no order for this version.
+   */
+  std::shared_ptr<const Ranks> Get(const std::string &library, int64_t version, const SortDescription &sorting);
+
+  /*! \brief Remember the order of a library for a sort.
+   The least recently used order is dropped if there are too many.
+   \sa Get
+   */
+  void Set(const std::string &library, int64_t version, const SortDescription &sorting, const std::shared_ptr<const Ranks> &ranks);
+
+  /*! \brief Drop all orders.
+   */
+  void Clear();
+
+  /*! \brief Sort ids by their rank and apply the limits of a listing.
+   \param ranks the order of the library.
+   \param ids the ids to sort, replaced by the ids within the limits.
+   \param limitStart the number of items to skip.
+   \param limitEnd the index of the item to stop at, -1 for all.
+   \return false if one of the ids has no rank, ids are left untouched then.
+   */
+  static bool Order(const Ranks &ranks, std::vector<int> &ids, int limitStart, int limitEnd);
+
+private:
+  struct Entry
+  {
+    std::string library;
+    int64_t version;
+    SortBy sortBy;
+    SortOrder sortOrder;
+    SortAttribute sortAttributes;
+    std::shared_ptr<const Ranks> ranks;
+  };
+
+  CCriticalSection m_critSection;
+  std::list<Entry> m_entries; ///< Most recently used first.
+};
@@ -94,6 +94,7 @@ Dataset::Dataset():
   fbof = feof = true;
   autocommit = true;
   fieldIndexMapID = ~0;
+  stream_started = false;
 
   fields_object = new Fields();
 
@@ -112,6 +113,7 @@ Dataset::Dataset(Database *newDb):
   fbof = feof = true;
   autocommit = true;
   fieldIndexMapID = ~0;
+  stream_started = false;
 
   fields_object = new Fields();
 
@@ -417,6 +419,122 @@ const sql_record* Dataset::get_sql_record()
   return result.records[frecno];
 }
 
+std::string Dataset::bind_params(const std::string &sql, const BoundParams &params) {
+  std::string result;
+  result.reserve(sql.size());
+
+  size_t param = 0;
+  bool quoted = false;
+  for (size_t i = 0; i < sql.size(); i++)
+  {
+    const char c = sql[i];
+    if (c == '\'')
+      quoted = !quoted;
+
+    if (c != '?' || quoted)
+    {
+      result += c;
+      continue;
+    }
+
+    if (param >= params.size())
+      throw DbErrors("Missing parameter %d: %s", (int)param + 1, sql.c_str());
+
+    const field_value &value = params[param++];
+    if (value.get_isNull())
+      result += "NULL";
+    else if (value.get_fType() == ft_String)
+      result += db->prepare("'%s'", value.get_asString().c_str());
+    else if (value.get_fType() == ft_Boolean)
+      result += value.get_asBool() ? "1" : "0";
+    else
+      result += value.get_asString();
+  }
+
+  if (param != params.size())
+    throw DbErrors("Too many parameters: %s", sql.c_str());
+
+  return result;
+}
+
+int Dataset::exec_bound(const std::string &sql, const BoundParams &params) {
+  return exec(bind_params(sql, params));
+}
+
+bool Dataset::query_bound(const std::string &sql, const BoundParams &params) {
+  return query(bind_params(sql, params));
+}
+
+int Dataset::exec_batch(const std::vector<std::pair<std::string, BoundParams>> &queries) {
+  for (const auto &query : queries)
+  {
+    if (query.second.empty())
+      exec(query.first);
+    else
+      exec_bound(query.first, query.second);
+  }
+  return 0;
+}
+
+bool Dataset::query_stream(const std::string &sql) {
+  stream_started = false;
+  return query(sql);
+}
+
+bool Dataset::step() {
+  if (!active)
+    return false;
+
+  if (stream_started)
+    next();
+  stream_started = true;
+
+  stream_text.clear();
+  return !eof();
+}
+
+const field_value &Dataset::stream_value(int col) {
+  const sql_record *record = get_sql_record();
+  if (record == NULL || col < 0 || col >= (int)record->size())
+    throw DbErrors("Field index not found: %d", col);
+
+  return record->at(col);
+}
+
+int Dataset::column_count() {
+  return result.record_header.size();
+}
+
+bool Dataset::column_is_null(int col) {
+  return stream_value(col).get_isNull();
+}
+
+int64_t Dataset::column_int64(int col) {
+  return stream_value(col).get_asInt64();
+}
+
+double Dataset::column_double(int col) {
+  return stream_value(col).get_asDouble();
+}
+
+const char *Dataset::column_text(int col, size_t *length) {
+  const field_value &value = stream_value(col);
+  if (stream_text.size() <= (size_t)col)
+    stream_text.resize(col + 1);
+  stream_text[col] = value.get_asString();
+  if (length)
+    *length = stream_text[col].size();
+  return stream_text[col].c_str();
+}
+
+void Dataset::fill_record(sql_record &record) {
+  const sql_record *current = get_sql_record();
+  if (current == NULL)
+    throw DbErrors("No current record");
+
+  record = *current;
+}
+
 const field_value Dataset::f_old(const char *f_name) {
   if (ds_state != dsInactive)
     for (int unsigned i=0; i < fields_object->size(); i++) 
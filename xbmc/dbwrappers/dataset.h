@@ -147,6 +147,12 @@ public:
   virtual void commit_transaction() {};
   virtual void rollback_transaction() {};
 
+/* virtual methods for savepoints, nested inside a running transaction */
+
+  virtual void start_savepoint(const char *name) {};
+  virtual void release_savepoint(const char *name) {};
+  virtual void rollback_savepoint(const char *name) {};
+
 /* virtual methods for formatting */
 
   /*! \brief Prepare a SQL statement for execution or querying using C printf nomenclature.
@@ -263,6 +269,10 @@ protected:
 /* Returns old field value (for :OLD) */
   virtual const field_value f_old(const char *f);
 
+/* Substitutes the ? placeholders of sql with escaped literals of params,
+   for backends without native parameter binding */
+  std::string bind_params(const std::string &sql, const BoundParams &params);
+
 public:
 
  virtual int str_compare(const char * s1, const char * s2);
@@ -404,6 +414,35 @@ public:
   const result_set& get_result_set() { return result; }
   const sql_record* get_sql_record();
 
+/* ------------ forward-only streaming ------------ */
+/* Runs a select query without materializing its result set. Rows are
+   fetched one at a time with step() and read with the column accessors,
+   whose values are only valid until the next step() or close().
+   Navigation and fv() aren't available on a streamed query.
+   Backends without a native cursor fall back to query(). */
+  virtual bool query_stream(const std::string &sql);
+/* Fetches the next row of a streamed query, false once all rows are read */
+  virtual bool step();
+/* Column access for the current row of a streamed query */
+  virtual int column_count();
+  virtual bool column_is_null(int col);
+  virtual int64_t column_int64(int col);
+  virtual double column_double(int col);
+/* Text of a column, length receives its size in bytes when given */
+  virtual const char *column_text(int col, size_t *length = NULL);
+/* Copies the current row of a streamed query into record, reusing its storage */
+  virtual void fill_record(sql_record &record);
+
+/* ------------ bound parameters ------------ */
+/* Executes sql with its ? placeholders bound to params. Backends with a
+   statement cache compile sql once and reuse it for every later call. */
+  virtual int exec_bound(const std::string &sql, const BoundParams &params);
+/* As exec_bound(), for a select query read like after query() */
+  virtual bool query_bound(const std::string &sql, const BoundParams &params);
+/* Executes queries in order, each with its params bound if there are any.
+   Backends with a network round trip per statement send them together. */
+  virtual int exec_batch(const std::vector<std::pair<std::string, BoundParams>> &queries);
+
  private:
   Dataset(const Dataset&) = delete;
   Dataset& operator=(const Dataset&) = delete;
@@ -459,6 +498,12 @@ public:
 /* Get the column index from a string field_value request */
   bool get_index_map_entry(const char *f_name);
 
+/* Current record of a query_stream() fallback */
+  const field_value &stream_value(int col);
+
+  bool stream_started;
+  std::vector<std::string> stream_text;
+
   void set_ds_state(dsStates new_state) {ds_state = new_state;};	
  public:
 /* return ds_state value */
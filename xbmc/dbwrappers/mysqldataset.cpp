@@ -22,6 +22,9 @@
 #include <string>
 #include <set>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iterator>
 
 #include "utils/log.h"
 #include "network/WakeOnAccess.h"
@@ -42,6 +45,42 @@
 #define MYSQL_OK          0
 #define ER_BAD_DB_ERROR   1049
 
+// size of the statements sent in one round trip, well below the default max_allowed_packet of older servers
+#define MYSQL_BATCH_MAX_SIZE  (512 * 1024)
+
+namespace
+{
+// upper bounds of the round trip latency buckets in microseconds, the last bucket takes everything slower
+const unsigned int RoundTripBounds[] = { 250, 500, 1000, 2000, 5000, 10000, 20000, 50000, 100000, 250000, 1000000 };
+const size_t RoundTripBuckets = sizeof(RoundTripBounds) / sizeof(RoundTripBounds[0]) + 1;
+// round trips between reports of the histogram to the database log component
+const unsigned int RoundTripReportInterval = 1000;
+
+std::atomic<unsigned int> roundTrips(0);
+std::atomic<unsigned int> roundTripHistogram[RoundTripBuckets];
+
+void RecordRoundTrip(std::chrono::steady_clock::time_point start)
+{
+  unsigned long long elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+  size_t bucket = std::upper_bound(std::begin(RoundTripBounds), std::end(RoundTripBounds), elapsed) - std::begin(RoundTripBounds);
+  roundTripHistogram[bucket]++;
+
+  unsigned int count = ++roundTrips;
+  if (count % RoundTripReportInterval != 0)
+    return;
+
+  std::string histogram;
+  for (size_t i = 0; i < RoundTripBuckets; ++i)
+  {
+    if (i + 1 < RoundTripBuckets)
+      histogram += StringUtils::Format(" <%uus:%u", RoundTripBounds[i], roundTripHistogram[i].load());
+    else
+      histogram += StringUtils::Format(" slower:%u", roundTripHistogram[i].load());
+  }
+  CLog::Log(LOGDEBUG, LOGDATABASE, "MYSQL: %u round trips,%s", count, histogram.c_str());
+}
+}
+
 namespace dbiplus {
 
 //************* MysqlDatabase implementation ***************
@@ -264,6 +303,41 @@ void MysqlDatabase::disconnect(void) {
   active = false;
 }
 
+int MysqlDatabase::reset() {
+  if (!active || conn == NULL)
+    return DB_UNEXPECTED_RESULT;
+
+  // hand the session over as a new login would: rolls back a pending transaction and drops
+  // temporary tables, user variables and everything changed with SET
+#if (defined(HAS_MYSQL) && MYSQL_VERSION_ID >= 50703) || \
+    (defined(MARIADB_PACKAGE_VERSION_ID) && MARIADB_PACKAGE_VERSION_ID >= 30000)
+  bool failed = mysql_reset_connection(conn) != MYSQL_OK;
+#else
+  bool failed = mysql_change_user(conn, login.c_str(), passwd.c_str(), db.c_str()) != 0;
+#endif
+  _in_transaction = false;
+  if (failed)
+  {
+    CLog::Log(LOGWARNING, "Unable to reset the session: %s [%d](%s)",
+              db.c_str(), mysql_errno(conn), mysql_error(conn));
+    return DB_UNEXPECTED_RESULT;
+  }
+
+  // the session settings are back to the server defaults, set ours again
+  try
+  {
+    if (mysql_set_character_set(conn, "utf8"))
+      return DB_UNEXPECTED_RESULT;
+    configure_connection();
+  }
+  catch (DbErrors &error)
+  {
+    CLog::Log(LOGWARNING, "Unable to configure the session: %s", error.getMsg());
+    return DB_UNEXPECTED_RESULT;
+  }
+  return DB_COMMAND_OK;
+}
+
 int MysqlDatabase::create() {
   return connect(true);
 }
@@ -444,6 +518,7 @@ int MysqlDatabase::drop_analytics(void) {
 int MysqlDatabase::query_with_reconnect(const char* query) {
   int attempts = 5;
   int result;
+  auto start = std::chrono::steady_clock::now();
 
   // try to reconnect if server is gone
   while ( ((result = mysql_real_query(conn, query, strlen(query))) != MYSQL_OK) &&
@@ -455,6 +530,54 @@ int MysqlDatabase::query_with_reconnect(const char* query) {
     connect(true);
   }
 
+  RecordRoundTrip(start);
+  return result;
+}
+
+int MysqlDatabase::exec_multiple(const std::vector<std::string> &statements, size_t &failed) {
+  failed = 0;
+  if (statements.empty())
+    return MYSQL_OK;
+
+  // the statements run inside a transaction a reconnect would lose, so there is no retry here
+  if (mysql_set_server_option(conn, MYSQL_OPTION_MULTI_STATEMENTS_ON) != MYSQL_OK)
+    return mysql_errno(conn);
+
+  int result = MYSQL_OK;
+  size_t next = 0;
+  std::string batch;
+  while (result == MYSQL_OK && next < statements.size())
+  {
+    size_t first = next;
+    batch = statements[next++];
+    while (next < statements.size() && batch.size() + statements[next].size() < MYSQL_BATCH_MAX_SIZE)
+    {
+      batch += ";\n";
+      batch += statements[next++];
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    failed = first;
+    if (mysql_real_query(conn, batch.c_str(), batch.size()) == MYSQL_OK)
+    {
+      // every statement leaves a result, the server skips the remaining ones after a failure
+      do
+      {
+        MYSQL_RES *res = mysql_store_result(conn);
+        if (res)
+          mysql_free_result(res);
+        failed++;
+      } while ((result = mysql_next_result(conn)) == MYSQL_OK);
+
+      // -1 marks the end of the results
+      result = result < 0 ? MYSQL_OK : mysql_errno(conn);
+    }
+    else
+      result = mysql_errno(conn);
+    RecordRoundTrip(start);
+  }
+
+  mysql_set_server_option(conn, MYSQL_OPTION_MULTI_STATEMENTS_OFF);
   return result;
 }
 
@@ -530,6 +653,30 @@ void MysqlDatabase::rollback_transaction() {
   }
 }
 
+void MysqlDatabase::start_savepoint(const char *name) {
+  if (active)
+  {
+    std::string sql = std::string("SAVEPOINT ") + name;
+    query_with_reconnect(sql.c_str());
+  }
+}
+
+void MysqlDatabase::release_savepoint(const char *name) {
+  if (active)
+  {
+    std::string sql = std::string("RELEASE SAVEPOINT ") + name;
+    query_with_reconnect(sql.c_str());
+  }
+}
+
+void MysqlDatabase::rollback_savepoint(const char *name) {
+  if (active)
+  {
+    std::string sql = std::string("ROLLBACK TO SAVEPOINT ") + name;
+    query_with_reconnect(sql.c_str());
+  }
+}
+
 bool MysqlDatabase::exists(void) {
   bool ret = false;
 
@@ -1488,11 +1635,8 @@ static size_t ci_find(const std::string& where, const std::string& what)
     return loc - where.begin();
 }
 
-int MysqlDataset::exec(const std::string &sql) {
-  if (!handle()) throw DbErrors("No Database Connection");
+std::string MysqlDataset::prepare_exec(const std::string &sql) {
   std::string qry = sql;
-  int res = 0;
-  exec_res.clear();
 
   // enforce the "auto_increment" keyword to be appended to "integer primary key"
   size_t loc;
@@ -1517,6 +1661,15 @@ int MysqlDataset::exec(const std::string &sql) {
       qry += " CHARACTER SET utf8 COLLATE utf8_general_ci";
   }
 
+  return qry;
+}
+
+int MysqlDataset::exec(const std::string &sql) {
+  if (!handle()) throw DbErrors("No Database Connection");
+  std::string qry = prepare_exec(sql);
+  int res = 0;
+  exec_res.clear();
+
   CLog::Log(LOGDEBUG,"Mysql execute: %s", qry.c_str());
 
   if (db->setErr( static_cast<MysqlDatabase*>(db)->query_with_reconnect(qry.c_str()), qry.c_str()) != MYSQL_OK)
@@ -1534,6 +1687,33 @@ int MysqlDataset::exec() {
    return exec(sql);
 }
 
+int MysqlDataset::exec_batch(const std::vector<std::pair<std::string, BoundParams>> &queries) {
+  if (!handle()) throw DbErrors("No Database Connection");
+  exec_res.clear();
+
+  std::vector<std::string> statements;
+  statements.reserve(queries.size());
+  for (const auto &query : queries)
+  {
+    std::string qry = prepare_exec(query.second.empty() ? query.first : bind_params(query.first, query.second));
+    // the statements are joined by ';', a trailing one would leave an empty statement behind
+    StringUtils::TrimRight(qry, " \t\r\n;");
+    if (qry.empty())
+      continue;
+    CLog::Log(LOGDEBUG,"Mysql execute: %s", qry.c_str());
+    statements.push_back(qry);
+  }
+
+  size_t failed = 0;
+  int result = static_cast<MysqlDatabase*>(db)->exec_multiple(statements, failed);
+  if (result != MYSQL_OK)
+  {
+    db->setErr(result, failed < statements.size() ? statements[failed].c_str() : "");
+    throw DbErrors(db->getErrorMsg());
+  }
+  return 0;
+}
+
 const void* MysqlDataset::getExecRes() {
   return &exec_res;
 }
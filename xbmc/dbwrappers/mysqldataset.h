@@ -21,6 +21,8 @@
  */
 
 #include <stdio.h>
+#include <string>
+#include <vector>
 #include "dataset.h"
 #ifdef HAS_MYSQL
 #include "mysql/mysql.h"
@@ -62,6 +64,8 @@ public:
   int connect(bool create) override;
 /* func. disconnects from database-server */
   void disconnect() override;
+/* func. resets the session for reuse as if newly logged in */
+  int reset() override;
 /* func. creates new database */
   int create() override;
 /* func. deletes database */
@@ -83,11 +87,18 @@ public:
   void commit_transaction() override;
   void rollback_transaction() override;
 
+  void start_savepoint(const char *name) override;
+  void release_savepoint(const char *name) override;
+  void rollback_savepoint(const char *name) override;
+
 /* virtual methods for formatting */
   std::string vprepare(const char *format, va_list args) override;
 
   bool in_transaction() override {return _in_transaction;};
   int query_with_reconnect(const char* query);
+/* func. sends statements in as few round trips as possible, without reconnecting.
+   On error failed receives the index of the statement that failed. */
+  int exec_multiple(const std::vector<std::string> &statements, size_t &failed);
   void configure_connection();
 
 private:
@@ -124,6 +135,8 @@ protected:
   void make_edit() override;
 /* Delete SQL */
   void make_deletion() override;
+/* Adapts sql to be executed by MySQL */
+  std::string prepare_exec(const std::string &sql);
 
 
 /* This function works only with MySQL database
@@ -150,6 +163,8 @@ or insert() operations default = false) */
 /* func. executes a query without results to return */
   int  exec () override;
   int  exec (const std::string &sql) override;
+/* func. executes queries in as few round trips as possible */
+  int  exec_batch(const std::vector<std::pair<std::string, BoundParams>> &queries) override;
   const void* getExecRes() override;
 /* as open, but with our query exec Sql */
   bool query(const std::string &query) override;
@@ -56,6 +56,13 @@ field_value::field_value(const char *s):
   field_type = ft_String;
   is_null = false;
 }
+
+field_value::field_value(const std::string &s):
+  str_value(s)
+{
+  field_type = ft_String;
+  is_null = false;
+}
   
 field_value::field_value(const bool b) {
   bool_value = b; 
@@ -654,6 +661,10 @@ void field_value::set_asString(const char *s) {
 void field_value::set_asString(const std::string & s) {
   str_value = s;
   field_type = ft_String;}
+
+void field_value::set_asString(const char *s, size_t length) {
+  str_value.assign(s, length);
+  field_type = ft_String;}
   
 void field_value::set_asBool(const bool b) {
   bool_value = b; 
@@ -32,6 +32,7 @@
 #include "sqlitedataset.h"
 #include "utils/log.h"
 #include "utils/URIUtils.h"
+#include "utils/StringUtils.h"
 
 #ifdef TARGET_POSIX
 #include "platform/linux/XTimeUtils.h"
@@ -88,6 +89,7 @@ SqliteDatabase::SqliteDatabase() {
 
   active = false;  
   _in_transaction = false;    // for transaction
+  readonly = false;
 
   error = "Unknown database error";//S_NO_CONNECTION;
   host = "localhost";
@@ -214,7 +216,9 @@ int SqliteDatabase::connect(bool create) {
   {
     disconnect();
     int flags = SQLITE_OPEN_READWRITE;
-    if (create)
+    if (readonly)
+      flags = SQLITE_OPEN_READONLY;
+    else if (create)
       flags |= SQLITE_OPEN_CREATE;
     if (sqlite3_open_v2(db_fullpath.c_str(), &conn, flags, NULL)==SQLITE_OK)
     {
@@ -256,10 +260,36 @@ bool SqliteDatabase::exists(void)
 
 void SqliteDatabase::disconnect(void) {
   if (active == false) return;
+  clear_statements();
   sqlite3_close(conn);
   active = false;
 }
 
+// upper limit of cached statements, the cache is emptied when it's reached
+#define MAX_CACHED_STATEMENTS 256
+
+sqlite3_stmt *SqliteDatabase::getStatement(const std::string &sql) {
+  std::map<std::string, sqlite3_stmt*>::iterator it = statements.find(sql);
+  if (it != statements.end())
+    return it->second;
+
+  if (statements.size() >= MAX_CACHED_STATEMENTS)
+    clear_statements();
+
+  sqlite3_stmt *stmt = NULL;
+  if (setErr(sqlite3_prepare_v2(conn, sql.c_str(), -1, &stmt, NULL), sql.c_str()) != SQLITE_OK)
+    throw DbErrors(getErrorMsg());
+
+  statements.insert(std::make_pair(sql, stmt));
+  return stmt;
+}
+
+void SqliteDatabase::clear_statements() {
+  for (std::map<std::string, sqlite3_stmt*>::iterator it = statements.begin(); it != statements.end(); ++it)
+    sqlite3_finalize(it->second);
+  statements.clear();
+}
+
 int SqliteDatabase::create() {
   return connect(true);
 }
@@ -410,6 +440,27 @@ void SqliteDatabase::rollback_transaction() {
   }  
 }
 
+void SqliteDatabase::start_savepoint(const char *name) {
+  if (active) {
+    std::string sql = std::string("SAVEPOINT ") + name;
+    sqlite3_exec(conn,sql.c_str(),NULL,NULL,NULL);
+  }
+}
+
+void SqliteDatabase::release_savepoint(const char *name) {
+  if (active) {
+    std::string sql = std::string("RELEASE SAVEPOINT ") + name;
+    sqlite3_exec(conn,sql.c_str(),NULL,NULL,NULL);
+  }
+}
+
+void SqliteDatabase::rollback_savepoint(const char *name) {
+  if (active) {
+    std::string sql = std::string("ROLLBACK TO SAVEPOINT ") + name;
+    sqlite3_exec(conn,sql.c_str(),NULL,NULL,NULL);
+  }
+}
+
 
 // methods for formatting
 // ---------------------------------------------
@@ -450,6 +501,7 @@ SqliteDataset::SqliteDataset():Dataset() {
   db = NULL;
   errmsg = NULL;
   autorefresh = false;
+  stream = NULL;
 }
 
 
@@ -458,9 +510,11 @@ SqliteDataset::SqliteDataset(SqliteDatabase *newDb):Dataset(newDb) {
   db = newDb;
   errmsg = NULL;
   autorefresh = false;
+  stream = NULL;
 }
 
  SqliteDataset::~SqliteDataset(){
+   if (stream) sqlite3_finalize(stream);
    if (errmsg) sqlite3_free(errmsg);
  }
 
@@ -635,20 +689,7 @@ const void* SqliteDataset::getExecRes() {
 }
 
 
-bool SqliteDataset::query(const std::string &query) {
-    if(!handle()) throw DbErrors("No Database Connection");
-    std::string qry = query;
-    int fs = qry.find("select");
-    int fS = qry.find("SELECT");
-    if (!( fs >= 0 || fS >=0))                                 
-         throw DbErrors("MUST be select SQL!"); 
-
-  close();
-
-  sqlite3_stmt *stmt = NULL;
-  if (db->setErr(sqlite3_prepare_v2(handle(),query.c_str(),-1,&stmt, NULL),query.c_str()) != SQLITE_OK)
-    throw DbErrors(db->getErrorMsg());
-
+void SqliteDataset::fetch_rows(sqlite3_stmt *stmt) {
   // column headers
   const unsigned int numColumns = sqlite3_column_count(stmt);
   result.record_header.resize(numColumns);
@@ -686,6 +727,26 @@ bool SqliteDataset::query(const std::string &query) {
     }
     result.records.push_back(res);
   }
+}
+
+bool SqliteDataset::query(const std::string &query) {
+    if(!handle()) throw DbErrors("No Database Connection");
+    std::string qry = query;
+    int fs = qry.find("select");
+    int fS = qry.find("SELECT");
+    // pragmas that read a setting return it as a row, e.g. "PRAGMA journal_mode"
+    bool pragma = StringUtils::StartsWithNoCase(qry, "pragma");
+    if (!( fs >= 0 || fS >=0 || pragma))
+         throw DbErrors("MUST be select SQL!"); 
+
+  close();
+
+  sqlite3_stmt *stmt = NULL;
+  if (db->setErr(sqlite3_prepare_v2(handle(),query.c_str(),-1,&stmt, NULL),query.c_str()) != SQLITE_OK)
+    throw DbErrors(db->getErrorMsg());
+
+  fetch_rows(stmt);
+
   if (db->setErr(sqlite3_finalize(stmt),query.c_str()) == SQLITE_OK)
   {
     active = true;
@@ -699,6 +760,82 @@ bool SqliteDataset::query(const std::string &query) {
   }  
 }
 
+void SqliteDataset::bind_statement(sqlite3_stmt *stmt, const std::string &sql, const BoundParams &params) {
+  if ((int)params.size() != sqlite3_bind_parameter_count(stmt))
+    throw DbErrors("Parameter count mismatch: %s", sql.c_str());
+
+  for (unsigned int i = 0; i < params.size(); i++)
+  {
+    const field_value &v = params[i];
+    int rc;
+    if (v.get_isNull())
+      rc = sqlite3_bind_null(stmt, i + 1);
+    else
+    {
+      switch (v.get_fType())
+      {
+      case ft_String:
+      {
+        const std::string value = v.get_asString();
+        rc = sqlite3_bind_text(stmt, i + 1, value.c_str(), value.size(), SQLITE_TRANSIENT);
+        break;
+      }
+      case ft_Float:
+      case ft_Double:
+        rc = sqlite3_bind_double(stmt, i + 1, v.get_asDouble());
+        break;
+      default:
+        rc = sqlite3_bind_int64(stmt, i + 1, v.get_asInt64());
+        break;
+      }
+    }
+    if (db->setErr(rc, sql.c_str()) != SQLITE_OK)
+    {
+      sqlite3_clear_bindings(stmt);
+      throw DbErrors(db->getErrorMsg());
+    }
+  }
+}
+
+int SqliteDataset::exec_bound(const std::string &sql, const BoundParams &params) {
+  if(!handle()) throw DbErrors("No Database Connection");
+
+  sqlite3_stmt *stmt = static_cast<SqliteDatabase*>(db)->getStatement(sql);
+  bind_statement(stmt, sql, params);
+
+  int rc;
+  while ((rc = sqlite3_step(stmt)) == SQLITE_ROW)
+    ;
+  sqlite3_reset(stmt);
+  sqlite3_clear_bindings(stmt);
+
+  if (db->setErr(rc == SQLITE_DONE ? SQLITE_OK : rc, sql.c_str()) != SQLITE_OK)
+    throw DbErrors(db->getErrorMsg());
+
+  return SQLITE_OK;
+}
+
+bool SqliteDataset::query_bound(const std::string &sql, const BoundParams &params) {
+  if(!handle()) throw DbErrors("No Database Connection");
+
+  close();
+
+  sqlite3_stmt *stmt = static_cast<SqliteDatabase*>(db)->getStatement(sql);
+  bind_statement(stmt, sql, params);
+
+  fetch_rows(stmt);
+
+  int rc = sqlite3_reset(stmt);
+  sqlite3_clear_bindings(stmt);
+  if (db->setErr(rc, sql.c_str()) != SQLITE_OK)
+    throw DbErrors(db->getErrorMsg());
+
+  active = true;
+  ds_state = dsSelect;
+  this->first();
+  return true;
+}
+
 void SqliteDataset::open(const std::string &sql) {
   set_select_sql(sql);
   open();
@@ -715,6 +852,11 @@ void SqliteDataset::open() {
 
 
 void SqliteDataset::close() {
+  if (stream)
+  {
+    sqlite3_finalize(stream);
+    stream = NULL;
+  }
   Dataset::close();
   result.clear();
   edit_object->clear();
@@ -804,6 +946,112 @@ long SqliteDataset::nextid(const char *seq_name) {
   else return DB_UNEXPECTED_RESULT;
 }
 
+bool SqliteDataset::query_stream(const std::string &query) {
+  if(!handle()) throw DbErrors("No Database Connection");
+  if (query.find("select") == std::string::npos && query.find("SELECT") == std::string::npos)
+    throw DbErrors("MUST be select SQL!");
+
+  close();
+
+  if (db->setErr(sqlite3_prepare_v2(handle(),query.c_str(),-1,&stream, NULL),query.c_str()) != SQLITE_OK)
+  {
+    stream = NULL;
+    throw DbErrors(db->getErrorMsg());
+  }
+
+  // column headers
+  const unsigned int numColumns = sqlite3_column_count(stream);
+  result.record_header.resize(numColumns);
+  for (unsigned int i = 0; i < numColumns; i++)
+    result.record_header[i].name = sqlite3_column_name(stream, i);
+
+  active = true;
+  ds_state = dsSelect;
+  return true;
+}
+
+bool SqliteDataset::step() {
+  if (!stream)
+    return false;
+
+  int rc = sqlite3_step(stream);
+  if (rc == SQLITE_ROW)
+    return true;
+
+  // finalizing reports the error of a failed step
+  std::string query = sqlite3_sql(stream);
+  rc = sqlite3_finalize(stream);
+  stream = NULL;
+  if (db->setErr(rc, query.c_str()) != SQLITE_OK)
+    throw DbErrors(db->getErrorMsg());
+
+  return false;
+}
+
+void SqliteDataset::check_stream_column(int col) {
+  if (!stream || col < 0 || col >= sqlite3_column_count(stream))
+    throw DbErrors("Field index not found: %d", col);
+}
+
+int SqliteDataset::column_count() {
+  return stream ? sqlite3_column_count(stream) : 0;
+}
+
+bool SqliteDataset::column_is_null(int col) {
+  check_stream_column(col);
+  return sqlite3_column_type(stream, col) == SQLITE_NULL;
+}
+
+int64_t SqliteDataset::column_int64(int col) {
+  check_stream_column(col);
+  return sqlite3_column_int64(stream, col);
+}
+
+double SqliteDataset::column_double(int col) {
+  check_stream_column(col);
+  return sqlite3_column_double(stream, col);
+}
+
+const char *SqliteDataset::column_text(int col, size_t *length) {
+  check_stream_column(col);
+  const char *text = (const char *)sqlite3_column_text(stream, col);
+  if (length)
+    *length = text ? sqlite3_column_bytes(stream, col) : 0;
+  return text ? text : "";
+}
+
+void SqliteDataset::fill_record(sql_record &record) {
+  const int numColumns = column_count();
+  record.resize(numColumns);
+  for (int i = 0; i < numColumns; i++)
+  {
+    field_value &v = record[i];
+    v.set_isNull(false);
+    switch (sqlite3_column_type(stream, i))
+    {
+    case SQLITE_INTEGER:
+      v.set_asInt64(sqlite3_column_int64(stream, i));
+      break;
+    case SQLITE_FLOAT:
+      v.set_asDouble(sqlite3_column_double(stream, i));
+      break;
+    case SQLITE_TEXT:
+    case SQLITE_BLOB:
+    {
+      size_t length;
+      const char *text = column_text(i, &length);
+      v.set_asString(text, length);
+      break;
+    }
+    case SQLITE_NULL:
+    default:
+      v.set_asString("", 0);
+      v.set_isNull();
+      break;
+    }
+  }
+}
+
 void SqliteDataset::interrupt() {
   sqlite3_interrupt(handle());
 }
@@ -28,6 +28,7 @@
  *
  **********************************************************************/
 
+#include <map>
 #include <stdio.h>
 #include "dataset.h"
 #include <sqlite3.h>
@@ -43,8 +44,13 @@ protected:
 /* connect descriptor */
   sqlite3 *conn;
   bool _in_transaction;
+  bool readonly;
   int last_err;
 
+/* compiled statements of bound queries, keyed by their sql */
+  std::map<std::string, sqlite3_stmt*> statements;
+  void clear_statements();
+
 public:
 /* default constructor */
   SqliteDatabase();
@@ -55,6 +61,8 @@ public:
 
 /* func. returns connection handle with SQLite-server */
   sqlite3 *getHandle() {  return conn; }
+/* func. returns the cached compiled statement for sql, reset and ready to bind */
+  sqlite3_stmt *getStatement(const std::string &sql);
 /* func. returns current status about SQLite-server connection */
   int status() override;
   int setErr(int err_code,const char * qry) override;
@@ -64,6 +72,8 @@ public:
   void setHostName(const char *newHost) override;
 /* sets a database name */
   void setDatabase(const char *newDb) override;
+/* opens the connection read-only on the next connect */
+  void setReadOnly(bool newReadOnly) { readonly = newReadOnly; }
 
 /* func. connects to database-server */
 
@@ -91,6 +101,10 @@ public:
   void commit_transaction() override;
   void rollback_transaction() override;
 
+  void start_savepoint(const char *name) override;
+  void release_savepoint(const char *name) override;
+  void rollback_savepoint(const char *name) override;
+
 /* virtual methods for formatting */
   std::string vprepare(const char *format, va_list args) override;
 
@@ -127,6 +141,15 @@ protected:
 /* Changing field values during dataset navigation */
   virtual void free_row();  // free the memory allocated for the current row
 
+/* Statement of a query_stream() cursor */
+  sqlite3_stmt *stream;
+  void check_stream_column(int col);
+
+/* Reads all rows of stmt into the result set */
+  void fetch_rows(sqlite3_stmt *stmt);
+/* Binds params to the placeholders of a cached statement */
+  void bind_statement(sqlite3_stmt *stmt, const std::string &sql, const BoundParams &params);
+
 public:
 /* constructor */
   SqliteDataset();
@@ -171,6 +194,20 @@ or insert() operations default = false) */
   bool seek(int pos=0) override;
 
   bool dropIndex(const char *table, const char *index) override;
+
+/* forward-only streaming straight from the sqlite statement */
+  bool query_stream(const std::string &sql) override;
+  bool step() override;
+  int column_count() override;
+  bool column_is_null(int col) override;
+  int64_t column_int64(int col) override;
+  double column_double(int col) override;
+  const char *column_text(int col, size_t *length = NULL) override;
+  void fill_record(sql_record &record) override;
+
+/* bound parameters on cached statements */
+  int exec_bound(const std::string &sql, const BoundParams &params) override;
+  bool query_bound(const std::string &sql, const BoundParams &params) override;
 };
 } //namespace
 
@@ -0,0 +1,151 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "dbwrappers/Database.h"
+#include "dbwrappers/dataset.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "settings/AdvancedSettings.h"
+#include "utils/StringUtils.h"
+
+#include "gtest/gtest.h"
+
+class CTestDatabase : public CDatabase
+{
+public:
+  int GetSchemaVersion() const override { return 1; }
+  const char *GetBaseDBName() const override { return "MyTest"; }
+
+  bool CreateItemSearch()
+  {
+    return CreateFullTextIndex("itemsearch", "item", "idItem", { "strName" });
+  }
+  bool HasItemSearch() { return HasFullTextIndex("itemsearch"); }
+
+  void ExecBatch(const std::vector<std::pair<std::string, dbiplus::BoundParams>> &queries)
+  {
+    m_pDS->exec_batch(queries);
+  }
+
+protected:
+  void CreateTables() override
+  {
+    m_pDS->exec("CREATE TABLE item (idItem INTEGER PRIMARY KEY, strName TEXT)\n");
+  }
+  void CreateAnalytics() override {}
+};
+
+class TestDatabase : public ::testing::Test
+{
+protected:
+  DatabaseSettings settings;
+  CTestDatabase database;
+
+  void SetUp() override
+  {
+    settings.type = "sqlite3";
+    settings.host = CSpecialProtocol::TranslatePath("special://temp/");
+  }
+
+  void TearDown() override
+  {
+    database.Close();
+    for (const char *suffix : { ".db", ".db-wal", ".db-shm" })
+      XFILE::CFile::Delete(settings.host + "testdatabase" + suffix);
+  }
+};
+
+TEST_F(TestDatabase, WALActiveAfterConnect)
+{
+  settings.wal = true;
+  ASSERT_TRUE(database.Connect("testdatabase", settings, true));
+
+  EXPECT_TRUE(database.IsWAL());
+  EXPECT_TRUE(StringUtils::EqualsNoCase(database.GetSingleValue("PRAGMA journal_mode"), "wal"));
+}
+
+TEST_F(TestDatabase, WALSwitchedOff)
+{
+  settings.wal = true;
+  ASSERT_TRUE(database.Connect("testdatabase", settings, true));
+  EXPECT_TRUE(database.IsWAL());
+  database.Close();
+
+  // the journal mode is stored in the file, reconnecting without WAL switches it back
+  settings.wal = false;
+  ASSERT_TRUE(database.Connect("testdatabase", settings, false));
+
+  EXPECT_FALSE(database.IsWAL());
+  EXPECT_TRUE(StringUtils::EqualsNoCase(database.GetSingleValue("PRAGMA journal_mode"), "delete"));
+}
+
+TEST_F(TestDatabase, FullTextIndexRemovedWithItsTriggers)
+{
+  ASSERT_TRUE(database.Connect("testdatabase", settings, true));
+
+  // a trigger in the way makes creating the update trigger fail after the insert trigger exists
+  ASSERT_TRUE(database.ExecuteQuery("CREATE TRIGGER itemsearch_update AFTER UPDATE ON item FOR EACH ROW BEGIN SELECT 1; END"));
+  EXPECT_FALSE(database.CreateItemSearch());
+  EXPECT_FALSE(database.HasItemSearch());
+
+  // the indexed table can still be changed
+  EXPECT_TRUE(database.ExecuteQuery("INSERT INTO item (strName) VALUES ('name')"));
+  EXPECT_TRUE(database.ExecuteQuery("UPDATE item SET strName = 'other'"));
+  EXPECT_TRUE(database.ExecuteQuery("DELETE FROM item"));
+  EXPECT_TRUE(database.GetSingleValue("SELECT name FROM sqlite_master WHERE type = 'trigger'").empty());
+}
+
+TEST_F(TestDatabase, ExecBatch)
+{
+  ASSERT_TRUE(database.Connect("testdatabase", settings, true));
+
+  // statements run in order, with and without bound parameters
+  database.ExecBatch({ { "INSERT INTO item (strName) VALUES ('first')", {} },
+                       { "INSERT INTO item (strName) VALUES (?)", { dbiplus::field_value("second") } },
+                       { "UPDATE item SET strName = ? WHERE strName = ?", { dbiplus::field_value("third"), dbiplus::field_value("first") } } });
+  EXPECT_EQ("2", database.GetSingleValue("SELECT COUNT(*) FROM item"));
+  EXPECT_EQ("third", database.GetSingleValue("SELECT strName FROM item WHERE idItem = 1"));
+  EXPECT_EQ("second", database.GetSingleValue("SELECT strName FROM item WHERE idItem = 2"));
+
+  // a failing statement stops the batch
+  EXPECT_THROW(database.ExecBatch({ { "DELETE FROM item WHERE idItem = 1", {} },
+                                    { "INSERT INTO missing (strName) VALUES ('none')", {} },
+                                    { "DELETE FROM item", {} } }), dbiplus::DbErrors);
+  EXPECT_EQ("1", database.GetSingleValue("SELECT COUNT(*) FROM item"));
+}
+
+TEST_F(TestDatabase, MultipleExecute)
+{
+  ASSERT_TRUE(database.Connect("testdatabase", settings, true));
+
+  EXPECT_TRUE(database.BeginMultipleExecute());
+  EXPECT_TRUE(database.ExecuteQuery("INSERT INTO item (strName) VALUES ('first')"));
+  EXPECT_TRUE(database.ExecuteQuery("INSERT INTO item (strName) VALUES (?)", { dbiplus::field_value("second") }));
+  EXPECT_EQ("0", database.GetSingleValue("SELECT COUNT(*) FROM item"));
+  EXPECT_TRUE(database.CommitMultipleExecute());
+  EXPECT_EQ("2", database.GetSingleValue("SELECT COUNT(*) FROM item"));
+
+  // the queue is applied as a whole or not at all
+  EXPECT_TRUE(database.BeginMultipleExecute());
+  EXPECT_TRUE(database.ExecuteQuery("DELETE FROM item"));
+  EXPECT_TRUE(database.ExecuteQuery("INSERT INTO missing (strName) VALUES ('none')"));
+  EXPECT_FALSE(database.CommitMultipleExecute());
+  EXPECT_EQ("2", database.GetSingleValue("SELECT COUNT(*) FROM item"));
+}
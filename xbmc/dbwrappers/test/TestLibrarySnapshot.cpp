@@ -0,0 +1,95 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "dbwrappers/LibrarySnapshot.h"
+
+#include "gtest/gtest.h"
+
+class TestLibrarySnapshot : public ::testing::Test
+{
+protected:
+  // ids 0-6, id 3 is not part of the library, the sorted library is 5 1 6 2 0 4
+  CLibrarySnapshot::Ranks ranks = { 4, 1, 3, CLibrarySnapshot::NoRank, 5, 0, 2 };
+};
+
+TEST_F(TestLibrarySnapshot, Order)
+{
+  std::vector<int> ids = { 0, 1, 2, 4, 5, 6 };
+  EXPECT_TRUE(CLibrarySnapshot::Order(ranks, ids, 0, -1));
+  EXPECT_EQ(std::vector<int>({ 5, 1, 6, 2, 0, 4 }), ids);
+
+  // a filtered listing keeps the relative order of the library
+  ids = { 4, 2, 5 };
+  EXPECT_TRUE(CLibrarySnapshot::Order(ranks, ids, 0, -1));
+  EXPECT_EQ(std::vector<int>({ 5, 2, 4 }), ids);
+}
+
+TEST_F(TestLibrarySnapshot, OrderLimits)
+{
+  std::vector<int> ids = { 0, 1, 2, 4, 5, 6 };
+  EXPECT_TRUE(CLibrarySnapshot::Order(ranks, ids, 0, 2));
+  EXPECT_EQ(std::vector<int>({ 5, 1 }), ids);
+
+  ids = { 0, 1, 2, 4, 5, 6 };
+  EXPECT_TRUE(CLibrarySnapshot::Order(ranks, ids, 2, 4));
+  EXPECT_EQ(std::vector<int>({ 6, 2 }), ids);
+
+  ids = { 0, 1, 2, 4, 5, 6 };
+  EXPECT_TRUE(CLibrarySnapshot::Order(ranks, ids, 4, -1));
+  EXPECT_EQ(std::vector<int>({ 0, 4 }), ids);
+
+  // limits beyond the listing are ignored, as in SortUtils::Sort()
+  ids = { 0, 1, 2, 4, 5, 6 };
+  EXPECT_TRUE(CLibrarySnapshot::Order(ranks, ids, 0, 10));
+  EXPECT_EQ(6U, ids.size());
+}
+
+TEST_F(TestLibrarySnapshot, OrderUnknownIds)
+{
+  std::vector<int> ids = { 0, 3, 5 };
+  EXPECT_FALSE(CLibrarySnapshot::Order(ranks, ids, 0, -1));
+  EXPECT_EQ(std::vector<int>({ 0, 3, 5 }), ids);
+
+  ids = { 0, 7 };
+  EXPECT_FALSE(CLibrarySnapshot::Order(ranks, ids, 0, -1));
+
+  ids = { -1, 0 };
+  EXPECT_FALSE(CLibrarySnapshot::Order(ranks, ids, 0, -1));
+}
+
+TEST_F(TestLibrarySnapshot, GetSet)
+{
+  CLibrarySnapshot snapshot;
+  SortDescription sorting;
+  sorting.sortBy = SortByTitle;
+  std::shared_ptr<const CLibrarySnapshot::Ranks> order(new CLibrarySnapshot::Ranks(ranks));
+
+  snapshot.Set("db:movie", 1, sorting, order);
+  EXPECT_EQ(order, snapshot.Get("db:movie", 1, sorting));
+  EXPECT_FALSE(snapshot.Get("db:episode", 1, sorting));
+
+  SortDescription descending = sorting;
+  descending.sortOrder = SortOrderDescending;
+  EXPECT_FALSE(snapshot.Get("db:movie", 1, descending));
+
+  // a newer library version drops the order
+  EXPECT_FALSE(snapshot.Get("db:movie", 2, sorting));
+  EXPECT_FALSE(snapshot.Get("db:movie", 1, sorting));
+}
@@ -115,6 +115,43 @@ bool CDDSImage::ReadFile(const std::string &inputFile)
   return true;
 }
 
+bool CDDSImage::Create(const std::string &outputFile, unsigned int width, unsigned int height, unsigned int pitch, const unsigned char *argb)
+{
+  if (!argb || !width || !height)
+    return false;
+
+  Allocate(width, height, XB_FMT_A8R8G8B8);
+  if (pitch == width * 4)
+    memcpy(m_data, argb, m_desc.linearSize);
+  else
+  {
+    for (unsigned int y = 0; y < height; y++)
+      memcpy(m_data + y * width * 4, argb + y * pitch, width * 4);
+  }
+  return WriteFile(outputFile);
+}
+
+bool CDDSImage::WriteFile(const std::string &outputFile) const
+{
+  // open the file
+  CFile file;
+  if (!file.OpenForWrite(outputFile, true))
+    return false;
+
+  // write the header
+  if (file.Write("DDS ", 4) != 4)
+    return false;
+  if (file.Write(&m_desc, sizeof(m_desc)) != sizeof(m_desc))
+    return false;
+
+  // now the data
+  if (file.Write(m_data, m_desc.linearSize) != m_desc.linearSize)
+    return false;
+
+  file.Close();
+  return true;
+}
+
 unsigned int CDDSImage::GetStorageRequirements(unsigned int width, unsigned int height, unsigned int format)
 {
   switch (format)
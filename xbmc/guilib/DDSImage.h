@@ -38,6 +38,18 @@ public:
 
   bool ReadFile(const std::string &file);
 
+  /*! \brief Create an uncompressed DDS file from 32bit ARGB pixels
+   The resulting file can be uploaded to the GPU as is, without any further decoding.
+   \param outputFile the file to write
+   \param width width of the image
+   \param height height of the image
+   \param pitch pitch of the input pixels
+   \param argb 32bit ARGB pixel data (XB_FMT_A8R8G8B8)
+   \return true on success, false otherwise
+   */
+  bool Create(const std::string &outputFile, unsigned int width, unsigned int height, unsigned int pitch, const unsigned char *argb);
+  bool WriteFile(const std::string &file) const;
+
 private:
   void Allocate(unsigned int width, unsigned int height, unsigned int format);
   static const char *GetFourCC(unsigned int format);
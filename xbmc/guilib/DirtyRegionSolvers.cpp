@@ -20,6 +20,8 @@
 
 #include "DirtyRegionSolvers.h"
 #include "GraphicContext.h"
+#include <algorithm>
+#include <cmath>
 #include <stdio.h>
 
 void CUnionDirtyRegionSolver::Solve(const CDirtyRegionList &input, CDirtyRegionList &output)
@@ -81,3 +83,133 @@ void CGreedyDirtyRegionSolver::Solve(const CDirtyRegionList &input, CDirtyRegion
       output.push_back(currentRegion);
   }
 }
+
+CTiledDirtyRegionSolver::CTiledDirtyRegionSolver(unsigned int columns, unsigned int rows, float costPerPass)
+{
+  m_columns = std::max(columns, 1U);
+  m_rows = std::max(rows, 1U);
+  m_costPerPass = costPerPass;
+}
+
+void CTiledDirtyRegionSolver::Solve(const CDirtyRegionList &input, CDirtyRegionList &output)
+{
+  Solve(input, output, g_graphicsContext.GetViewWindow());
+}
+
+void CTiledDirtyRegionSolver::Solve(const CDirtyRegionList &input, CDirtyRegionList &output, const CRect &viewport)
+{
+  if (input.empty() || viewport.IsEmpty())
+    return;
+
+  // mark the tiles touched by the dirty regions
+  float tileWidth = viewport.Width() / m_columns;
+  float tileHeight = viewport.Height() / m_rows;
+  std::vector<bool> tiles(m_columns * m_rows, false);
+  bool dirty = false;
+  for (CDirtyRegionList::const_iterator i = input.begin(); i != input.end(); ++i)
+  {
+    CRect region(*i);
+    region.Intersect(viewport);
+    if (region.IsEmpty())
+      continue;
+
+    int left = std::max((int)((region.x1 - viewport.x1) / tileWidth), 0);
+    int right = std::min((int)ceilf((region.x2 - viewport.x1) / tileWidth), (int)m_columns);
+    int top = std::max((int)((region.y1 - viewport.y1) / tileHeight), 0);
+    int bottom = std::min((int)ceilf((region.y2 - viewport.y1) / tileHeight), (int)m_rows);
+    for (int row = top; row < bottom; row++)
+      for (int col = left; col < right; col++)
+        tiles[row * m_columns + col] = true;
+    dirty = true;
+  }
+  if (!dirty)
+    return;
+
+  // combine the marked tiles into rectangles, growing right first and then down
+  std::vector<CRect> rects;
+  for (unsigned int row = 0; row < m_rows; row++)
+  {
+    for (unsigned int col = 0; col < m_columns; col++)
+    {
+      if (!tiles[row * m_columns + col])
+        continue;
+
+      unsigned int right = col;
+      while (right + 1 < m_columns && tiles[row * m_columns + right + 1])
+        right++;
+
+      unsigned int bottom = row;
+      while (bottom + 1 < m_rows)
+      {
+        bool full = true;
+        for (unsigned int x = col; x <= right && full; x++)
+          full = tiles[(bottom + 1) * m_columns + x];
+        if (!full)
+          break;
+        bottom++;
+      }
+
+      for (unsigned int y = row; y <= bottom; y++)
+        for (unsigned int x = col; x <= right; x++)
+          tiles[y * m_columns + x] = false;
+
+      CRect tileRect(viewport.x1 + col * tileWidth, viewport.y1 + row * tileHeight,
+                     viewport.x1 + (right + 1) * tileWidth, viewport.y1 + (bottom + 1) * tileHeight);
+
+      // only draw the part of the tiles that is actually dirty
+      CRect rect;
+      for (CDirtyRegionList::const_iterator i = input.begin(); i != input.end(); ++i)
+      {
+        CRect clipped(*i);
+        clipped.Intersect(tileRect);
+        rect.Union(clipped);
+      }
+      if (!rect.IsEmpty())
+        rects.push_back(rect);
+    }
+  }
+
+  // merge rectangles while a single pass is cheaper than two
+  float passCost = m_costPerPass * viewport.Area();
+  while (rects.size() > 1)
+  {
+    float bestSaving = 0.0f;
+    size_t bestA = 0, bestB = 0;
+    for (size_t a = 0; a < rects.size(); a++)
+    {
+      for (size_t b = a + 1; b < rects.size(); b++)
+      {
+        CRect merged(rects[a]);
+        merged.Union(rects[b]);
+        float saving = passCost + rects[a].Area() + rects[b].Area() - merged.Area();
+        if (saving > bestSaving)
+        {
+          bestSaving = saving;
+          bestA = a;
+          bestB = b;
+        }
+      }
+    }
+    if (bestSaving <= 0.0f)
+      break;
+
+    rects[bestA].Union(rects[bestB]);
+    rects.erase(rects.begin() + bestB);
+
+    // drop anything the merged rectangle now covers
+    const CRect merged(rects[bestA]);
+    for (size_t i = rects.size(); i-- > 0;)
+    {
+      if (i != bestA && rects[i].x1 >= merged.x1 && rects[i].x2 <= merged.x2 &&
+          rects[i].y1 >= merged.y1 && rects[i].y2 <= merged.y2)
+      {
+        rects.erase(rects.begin() + i);
+        if (i < bestA)
+          bestA--;
+      }
+    }
+  }
+
+  for (std::vector<CRect>::const_iterator i = rects.begin(); i != rects.end(); ++i)
+    output.push_back(CDirtyRegion(*i));
+}
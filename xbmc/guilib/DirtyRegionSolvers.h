@@ -48,3 +48,28 @@ private:
   float m_costNewRegion;
   float m_costPerArea;
 };
+
+/*!
+ \brief Solver that snaps dirty regions to a grid of tiles and merges them based on cost
+
+ Every rendering pass has a fixed cost, as all controls are traversed again, plus a cost per
+ pixel drawn. The tiles touched by dirty regions are combined into rectangles, which are shrunk
+ to the dirty area they contain and then merged for as long as a merged pass is cheaper than
+ the separate ones.
+ */
+class CTiledDirtyRegionSolver : public IDirtyRegionSolver
+{
+public:
+  /*!
+   \param columns number of tile columns the viewport is split into
+   \param rows number of tile rows the viewport is split into
+   \param costPerPass cost of an additional rendering pass, as a fraction of the viewport area
+   */
+  CTiledDirtyRegionSolver(unsigned int columns = 16, unsigned int rows = 9, float costPerPass = 0.1f);
+  void Solve(const CDirtyRegionList &input, CDirtyRegionList &output) override;
+  void Solve(const CDirtyRegionList &input, CDirtyRegionList &output, const CRect &viewport);
+private:
+  unsigned int m_columns;
+  unsigned int m_rows;
+  float m_costPerPass;
+};
@@ -162,7 +162,7 @@ bool CFFmpegImage::LoadImageFromMemory(unsigned char* buffer, unsigned int bufSi
                                       unsigned int width, unsigned int height)
 {
     
-  if (!Initialize(buffer, bufSize))
+  if (!Initialize(buffer, bufSize, width, height))
   {
     //log
     return false;
@@ -174,7 +174,60 @@ bool CFFmpegImage::LoadImageFromMemory(unsigned char* buffer, unsigned int bufSi
   return !(m_pFrame == nullptr);
 }
 
-bool CFFmpegImage::Initialize(unsigned char* buffer, unsigned int bufSize)
+bool CFFmpegImage::GetJpegDimensions(const unsigned char* buffer, unsigned int bufSize, unsigned int &width, unsigned int &height)
+{
+  if (bufSize < 4 || buffer[0] != 0xFF || buffer[1] != 0xD8)
+    return false;
+
+  // walk the marker segments until we hit a start of frame
+  size_t pos = 2;
+  while (pos + 4 <= bufSize)
+  {
+    if (buffer[pos] != 0xFF)
+      return false;
+    unsigned char marker = buffer[pos + 1];
+    if (marker == 0xFF)
+    { // fill byte
+      pos++;
+      continue;
+    }
+    if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD7))
+    { // standalone markers
+      pos += 2;
+      continue;
+    }
+    if (marker == 0xDA || marker == 0xD9)
+      return false; // start of scan or end of image before any frame header
+
+    size_t length = (buffer[pos + 2] << 8) | buffer[pos + 3];
+    // SOF0..SOF15, except DHT (C4), JPG (C8) and DAC (CC)
+    if (marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC)
+    {
+      if (pos + 9 > bufSize || length < 7)
+        return false;
+      height = (buffer[pos + 5] << 8) | buffer[pos + 6];
+      width = (buffer[pos + 7] << 8) | buffer[pos + 8];
+      return width > 0 && height > 0;
+    }
+    pos += 2 + length;
+  }
+  return false;
+}
+
+int CFFmpegImage::GetLowres(unsigned int width, unsigned int height, unsigned int idealWidth, unsigned int idealHeight, int maxLowres)
+{
+  if (!width || !height || !idealWidth || !idealHeight)
+    return 0;
+
+  // the image gets scaled to fit the ideal size, so we only need to keep that many pixels
+  float scale = std::min((float)idealWidth / width, (float)idealHeight / height);
+  int lowres = 0;
+  while (lowres < maxLowres && (1 << (lowres + 1)) * scale <= 1.0f)
+    lowres++;
+  return lowres;
+}
+
+bool CFFmpegImage::Initialize(unsigned char* buffer, unsigned int bufSize, unsigned int idealWidth, unsigned int idealHeight)
 {
   int bufferSize = 4096;
   uint8_t* fbuffer = (uint8_t*)av_malloc(bufferSize + AV_INPUT_BUFFER_PADDING_SIZE);
@@ -269,6 +322,19 @@ bool CFFmpegImage::Initialize(unsigned char* buffer, unsigned int bufSize)
     return false;
   }
 
+  // let the jpeg decoder downscale in the DCT domain if we don't need the full resolution
+  unsigned int jpegWidth = 0, jpegHeight = 0;
+  if (codec && codec->id == AV_CODEC_ID_MJPEG && codec->max_lowres > 0 &&
+      GetJpegDimensions(buffer, bufSize, jpegWidth, jpegHeight))
+  {
+    m_codec_ctx->lowres = GetLowres(jpegWidth, jpegHeight, idealWidth, idealHeight, codec->max_lowres);
+    if (m_codec_ctx->lowres)
+    {
+      m_originalWidth = jpegWidth;
+      m_originalHeight = jpegHeight;
+    }
+  }
+
   if (avcodec_open2(m_codec_ctx, codec, NULL) < 0)
   {
     avformat_close_input(&m_fctx);
@@ -313,8 +379,11 @@ AVFrame* CFFmpegImage::ExtractFrame()
   av_frame_set_pkt_duration(frame, av_rescale_q(frame->pkt_duration, m_fctx->streams[0]->time_base, AVRational{ 1, 1000 }));
   m_height = frame->height;
   m_width = frame->width;
-  m_originalWidth = m_width;
-  m_originalHeight = m_height;
+  if (!m_codec_ctx->lowres)
+  { // with lowres decoding the original dimensions are those of the jpeg header
+    m_originalWidth = m_width;
+    m_originalHeight = m_height;
+  }
 
   const AVPixFmtDescriptor* pixDescriptor = av_pix_fmt_desc_get(static_cast<AVPixelFormat>(frame->format));
   if (pixDescriptor && ((pixDescriptor->flags & (AV_PIX_FMT_FLAG_ALPHA | AV_PIX_FMT_FLAG_PAL)) != 0))
@@ -488,8 +557,8 @@ bool CFFmpegImage::DecodeFrame(AVFrame* frame, unsigned int width, unsigned int
 
   // assumption quadratic maximums e.g. 2048x2048
   float ratio = m_width / (float)m_height;
-  unsigned int nHeight = m_originalHeight;
-  unsigned int nWidth = m_originalWidth;
+  unsigned int nHeight = frame->height;
+  unsigned int nWidth = frame->width;
   if (nHeight > height)
   {
     nHeight = height;
@@ -501,7 +570,7 @@ bool CFFmpegImage::DecodeFrame(AVFrame* frame, unsigned int width, unsigned int
     nHeight = (unsigned int)(nWidth / ratio + 0.5f);
   }
 
-  struct SwsContext* context = sws_getContext(m_originalWidth, m_originalHeight, pixFormat,
+  struct SwsContext* context = sws_getContext(frame->width, frame->height, pixFormat,
     nWidth, nHeight, AV_PIX_FMT_RGB32, SWS_BICUBIC, NULL, NULL, NULL);
 
   if (range == AVCOL_RANGE_JPEG)
@@ -514,7 +583,7 @@ bool CFFmpegImage::DecodeFrame(AVFrame* frame, unsigned int width, unsigned int
     sws_setColorspaceDetails(context, inv_table, srcRange, table, dstRange, brightness, contrast, saturation);
   }
 
-  sws_scale(context, frame->data, frame->linesize, 0, m_originalHeight,
+  sws_scale(context, frame->data, frame->linesize, 0, frame->height,
     pictureRGB->data, pictureRGB->linesize);
   sws_freeContext(context);
 
@@ -81,7 +81,17 @@ public:
                                   unsigned int &bufferoutSize) override;
   void ReleaseThumbnailBuffer() override;
 
-  bool Initialize(unsigned char* buffer, unsigned int bufSize);
+  /*!
+   \brief Prepare decoding of the image in the given buffer
+   \param buffer the encoded image
+   \param bufSize size of the encoded image
+   \param idealWidth the width the image will be displayed at, 0 for full size
+   \param idealHeight the height the image will be displayed at, 0 for full size
+   If the image is a JPEG that is much larger than the ideal size, it is decoded at 1/2, 1/4
+   or 1/8 scale directly in the DCT domain, never going below the ideal size. The decoded
+   frame is not resampled to the ideal size, scaling it is left to the caller.
+   */
+  bool Initialize(unsigned char* buffer, unsigned int bufSize, unsigned int idealWidth = 0, unsigned int idealHeight = 0);
 
   std::shared_ptr<Frame> ReadFrame();
 
@@ -92,6 +102,8 @@ private:
   static int EncodeFFmpegFrame(AVCodecContext *avctx, AVPacket *pkt, int *got_packet, AVFrame *frame);
   static int DecodeFFmpegFrame(AVCodecContext *avctx, AVFrame *frame, int *got_frame, AVPacket *pkt);
   static AVPixelFormat ConvertFormats(AVFrame* frame);
+  static bool GetJpegDimensions(const unsigned char* buffer, unsigned int bufSize, unsigned int &width, unsigned int &height);
+  static int GetLowres(unsigned int width, unsigned int height, unsigned int idealWidth, unsigned int idealHeight, int maxLowres);
   std::string m_strMimeType;
   void CleanupLocalOutputBuffer();
 
@@ -33,11 +33,17 @@
 #include "listproviders/IListProvider.h"
 #include "settings/Settings.h"
 #include "guiinfo/GUIInfoLabels.h"
+#include "GUILargeTextureManager.h"
+
+#include <cmath>
+#include <cstdlib>
 
 #define HOLD_TIME_START 100
 #define HOLD_TIME_END   3000
 #define SCROLLING_GAP   200U
 #define SCROLLING_THRESHOLD 300U
+#define PREFETCH_MAX_PAGES  3
+#define PREFETCH_LOOKAHEAD  1000.0f // ms of scrolling to prefetch artwork for
 
 CGUIBaseContainer::CGUIBaseContainer(int parentID, int controlID, float posX, float posY, float width, float height, ORIENTATION orientation, const CScroller& scroller, int preloadItems)
     : IGUIContainer(parentID, controlID, posX, posY, width, height)
@@ -61,6 +67,10 @@ CGUIBaseContainer::CGUIBaseContainer(int parentID, int controlID, float posX, fl
   m_autoScrollDelayTime = 0;
   m_autoScrollIsReversed = false;
   m_lastRenderTime = 0;
+  m_prefetchValid = false;
+  m_prefetchFirstItem = 0;
+  m_prefetchTime = 0;
+  m_prefetchVelocity = 0.0f;
 }
 
 CGUIBaseContainer::~CGUIBaseContainer(void)
@@ -143,6 +153,8 @@ void CGUIBaseContainer::Process(unsigned int currentTime, CDirtyRegionList &dirt
   // to have same behaviour when scrolling down, we need to set page control to offset+1
   UpdatePageControl(offset + (m_scroller.IsScrollingDown() ? 1 : 0));
 
+  UpdatePrefetch(offset, m_itemsPerPage, currentTime);
+
   m_lastRenderTime = currentTime;
 
   CGUIControl::Process(currentTime, dirtyregions);
@@ -872,6 +884,7 @@ void CGUIBaseContainer::FreeResources(bool immediately)
     }
   }
   m_scroller.Stop();
+  CancelPrefetch();
 }
 
 void CGUIBaseContainer::UpdateLayout(bool updateAllItems)
@@ -1135,6 +1148,7 @@ int CGUIBaseContainer::CorrectOffset(int offset, int cursor) const
 
 void CGUIBaseContainer::Reset()
 {
+  CancelPrefetch();
   m_wasReset = true;
   m_items.clear();
   m_lastItem.reset();
@@ -1197,6 +1211,83 @@ void CGUIBaseContainer::FreeMemory(int keepStart, int keepEnd)
   }
 }
 
+void CGUIBaseContainer::UpdatePrefetch(int firstItem, int itemsPerPage, unsigned int currentTime)
+{
+  if (itemsPerPage <= 0)
+    return;
+
+  if (!m_prefetchValid)
+  { // need a second sample to know which way (and how fast) we're going
+    m_prefetchValid = true;
+    m_prefetchFirstItem = firstItem;
+    m_prefetchTime = currentTime;
+    return;
+  }
+
+  int delta = firstItem - m_prefetchFirstItem;
+  if (delta == 0)
+    return;
+
+  unsigned int elapsed = currentTime - m_prefetchTime;
+  float velocity = elapsed ? delta * 1000.0f / elapsed : 0.0f;
+  if (abs(delta) > itemsPerPage || (velocity > 0) != (m_prefetchVelocity > 0))
+    m_prefetchVelocity = velocity; // jumped or changed direction
+  else
+    m_prefetchVelocity = 0.5f * (m_prefetchVelocity + velocity);
+  m_prefetchFirstItem = firstItem;
+  m_prefetchTime = currentTime;
+
+  int pages = 1 + (int)(fabs(m_prefetchVelocity) * PREFETCH_LOOKAHEAD / 1000.0f / itemsPerPage);
+  pages = std::min(pages, PREFETCH_MAX_PAGES);
+
+  int start, end;
+  if (delta > 0)
+  {
+    start = firstItem + itemsPerPage;
+    end = start + pages * itemsPerPage;
+  }
+  else
+  {
+    end = firstItem;
+    start = end - pages * itemsPerPage;
+  }
+
+  static const char* artTypes[] = { "poster", "thumb" };
+
+  std::set<std::string> prefetch;
+  for (int i = std::max(start, 0); i < end && i < (int)m_items.size(); ++i)
+  {
+    for (const char* type : artTypes)
+    {
+      std::string art = m_items[i]->GetArt(type);
+      if (!art.empty())
+      {
+        if (m_prefetched.find(art) == m_prefetched.end())
+          g_largeTextureManager.PrefetchImage(art);
+        prefetch.insert(art);
+        break;
+      }
+    }
+  }
+
+  // cancel anything we've scrolled past or are no longer heading towards
+  for (std::set<std::string>::const_iterator it = m_prefetched.begin(); it != m_prefetched.end(); ++it)
+  {
+    if (prefetch.find(*it) == prefetch.end())
+      g_largeTextureManager.CancelPrefetch(*it);
+  }
+  m_prefetched.swap(prefetch);
+}
+
+void CGUIBaseContainer::CancelPrefetch()
+{
+  for (std::set<std::string>::const_iterator it = m_prefetched.begin(); it != m_prefetched.end(); ++it)
+    g_largeTextureManager.CancelPrefetch(*it);
+  m_prefetched.clear();
+  m_prefetchValid = false;
+  m_prefetchVelocity = 0.0f;
+}
+
 bool CGUIBaseContainer::InsideLayout(const CGUIListItemLayout *layout, const CPoint &point) const
 {
   if (!layout) return false;
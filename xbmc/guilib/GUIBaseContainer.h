@@ -25,6 +25,8 @@
  *
  */
 
+#include <set>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -136,6 +138,17 @@ protected:
   int ScrollCorrectionRange() const;
   inline float Size() const;
   void FreeMemory(int keepStart, int keepEnd);
+
+  /*! \brief Prefetch artwork of the items we are scrolling towards
+   The number of pages prefetched ahead grows with the scroll speed. Prefetches for items that
+   are no longer ahead of us are cancelled.
+   \param firstItem index of the first visible item
+   \param itemsPerPage number of items visible at once
+   \param currentTime the current frame time
+   \sa CGUILargeTextureManager::PrefetchImage
+   */
+  void UpdatePrefetch(int firstItem, int itemsPerPage, unsigned int currentTime);
+  void CancelPrefetch();
   void GetCurrentLayouts();
   CGUIListItemLayout *GetFocusedLayout() const;
 
@@ -235,6 +248,13 @@ private:
   std::string m_match;
   float m_scrollItemsPerFrame;
 
+  // artwork prefetching
+  bool m_prefetchValid;
+  int m_prefetchFirstItem;
+  unsigned int m_prefetchTime;
+  float m_prefetchVelocity; ///< smoothed scroll speed in items per second
+  std::set<std::string> m_prefetched;
+
   static const int letter_match_timeout = 1000;
 };
 
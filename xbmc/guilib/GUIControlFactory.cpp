@@ -360,6 +360,28 @@ bool CGUIControlFactory::GetTexture(const TiXmlNode* pRootNode, const char* strT
   return true;
 }
 
+void CGUIControlFactory::GetTextureNames(const TiXmlNode* pRootNode, std::vector<std::string> &textures)
+{
+  for (const TiXmlElement* pNode = pRootNode->FirstChildElement(); pNode; pNode = pNode->NextSiblingElement())
+  {
+    std::string tag = pNode->ValueStr();
+    if (StringUtils::StartsWith(tag, "texture") || StringUtils::EndsWith(tag, "texture"))
+    {
+      const char *background = pNode->Attribute("background");
+      std::string filename = pNode->FirstChild() ? pNode->FirstChild()->ValueStr() : "";
+      if (!filename.empty() && filename.find('$') == std::string::npos &&
+          !(background && strnicmp(background, "true", 4) == 0))
+        textures.push_back(filename);
+
+      std::string diffuse = XMLUtils::GetAttribute(pNode, "diffuse");
+      if (!diffuse.empty() && diffuse.find('$') == std::string::npos)
+        textures.push_back(diffuse);
+    }
+    else
+      GetTextureNames(pNode, textures);
+  }
+}
+
 void CGUIControlFactory::GetRectFromString(const std::string &string, CRect &rect)
 {
   // format is rect="left[,top,right,bottom]"
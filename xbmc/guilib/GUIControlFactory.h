@@ -65,6 +65,13 @@ public:
   static bool GetAspectRatio(const TiXmlNode* pRootNode, const char* strTag, CAspectRatio &aspectRatio);
   static bool GetInfoTexture(const TiXmlNode* pRootNode, const char* strTag, CTextureInfo &image, CGUIInfoLabel &info, int parentID);
   static bool GetTexture(const TiXmlNode* pRootNode, const char* strTag, CTextureInfo &image);
+
+  /*! \brief Collect the static texture and diffuse filenames referenced below the given node.
+   Textures given by info labels or loaded in the background are skipped.
+   \param pRootNode node to search, usually a window's resolved root element.
+   \param textures [out] the texture filenames found.
+   */
+  static void GetTextureNames(const TiXmlNode* pRootNode, std::vector<std::string> &textures);
   static bool GetAlignment(const TiXmlNode* pRootNode, const char* strTag, uint32_t& dwAlignment);
   static bool GetAlignmentY(const TiXmlNode* pRootNode, const char* strTag, uint32_t& dwAlignment);
   static bool GetAnimations(TiXmlNode *control, const CRect &rect, int context, std::vector<CAnimation> &animation);
@@ -92,6 +92,8 @@ void CGUIPanelContainer::Process(unsigned int currentTime, CDirtyRegionList &dir
   // to have same behaviour when scrolling down, we need to set page control to offset+1
   UpdatePageControl(offset + (m_scroller.IsScrollingDown() ? 1 : 0));
 
+  UpdatePrefetch(offset * m_itemsPerRow, m_itemsPerPage * m_itemsPerRow, currentTime);
+
   CGUIControl::Process(currentTime, dirtyregions);
 }
 
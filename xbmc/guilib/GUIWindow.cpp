@@ -24,6 +24,7 @@
 #include "GUIControlFactory.h"
 #include "GUIControlGroup.h"
 #include "GUIControlProfiler.h"
+#include "TextureManager.h"
 
 #include "addons/Skin.h"
 #include "GUIInfoManager.h"
@@ -195,6 +196,11 @@ bool CGUIWindow::Load(TiXmlElement *pRootElement)
   CRect parentRect(0, 0, static_cast<float>(m_coordsRes.iWidth), static_cast<float>(m_coordsRes.iHeight));
   CGUIControlFactory::GetHitRect(pRootElement, m_hitRect, parentRect);
 
+  // start decompressing the bundled textures while the controls are created
+  std::vector<std::string> textures;
+  CGUIControlFactory::GetTextureNames(pRootElement, textures);
+  g_TextureManager.PrefetchTextures(textures);
+
   TiXmlElement *pChild = pRootElement->FirstChildElement();
   while (pChild)
   {
@@ -36,6 +36,7 @@
 #include "input/Key.h"
 #include "utils/log.h"
 #include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
 
 #include "windows/GUIWindowHome.h"
 #include "events/windows/GUIWindowEventLog.h"
@@ -1182,7 +1183,12 @@ bool CGUIWindowManager::Render()
   assert(g_application.IsCurrentThread());
   CSingleExit lock(g_graphicsContext);
 
+  int64_t start = CurrentHostCounter();
   CDirtyRegionList dirtyRegions = m_tracker.GetDirtyRegions();
+  int64_t solved = CurrentHostCounter();
+
+  m_renderStats = RenderStatistics();
+  m_renderStats.markedRegions = m_tracker.GetMarkedRegions().size();
 
   bool hasRendered = false;
   // If we visualize the regions we will always render the entire viewport
@@ -1190,6 +1196,8 @@ bool CGUIWindowManager::Render()
   {
     RenderPass();
     hasRendered = true;
+    m_renderStats.renderPasses = 1;
+    m_renderStats.pixelsRendered = g_graphicsContext.GetViewWindow().Area();
   }
   else if (g_advancedSettings.m_guiAlgorithmDirtyRegions == DIRTYREGION_SOLVER_FILL_VIEWPORT_ON_CHANGE)
   {
@@ -1197,6 +1205,8 @@ bool CGUIWindowManager::Render()
     {
       RenderPass();
       hasRendered = true;
+      m_renderStats.renderPasses = 1;
+      m_renderStats.pixelsRendered = g_graphicsContext.GetViewWindow().Area();
     }
   }
   else
@@ -1209,10 +1219,16 @@ bool CGUIWindowManager::Render()
       g_graphicsContext.SetScissors(*i);
       RenderPass();
       hasRendered = true;
+      m_renderStats.renderPasses++;
+      m_renderStats.pixelsRendered += i->Area();
     }
     g_graphicsContext.ResetScissors();
   }
 
+  int64_t frequency = CurrentHostFrequency();
+  m_renderStats.solveTime = 1000.0f * (solved - start) / frequency;
+  m_renderStats.renderTime = 1000.0f * (CurrentHostCounter() - solved) / frequency;
+
   if (g_advancedSettings.m_guiVisualizeDirtyRegions)
   {
     g_graphicsContext.SetRenderingResolution(g_graphicsContext.GetResInfo(), false);
@@ -118,6 +118,19 @@ public:
    */
   bool Render();
 
+  /*! \brief Statistics of the last call to Render()
+   */
+  struct RenderStatistics
+  {
+    unsigned int markedRegions = 0; ///< number of regions marked dirty by controls
+    unsigned int renderPasses = 0;  ///< number of (scissored) rendering passes
+    float pixelsRendered = 0.0f;    ///< pixels covered by the rendering passes
+    float solveTime = 0.0f;         ///< time taken to work out the rendering passes, in ms
+    float renderTime = 0.0f;        ///< time taken by the rendering passes, in ms
+  };
+
+  const RenderStatistics &GetRenderStatistics() const { return m_renderStats; }
+
   void RenderEx() const;
 
   /*! \brief Do any post render activities.
@@ -288,6 +301,7 @@ private:
 
   CDirtyRegionList m_dirtyregions;
   CDirtyRegionTracker m_tracker;
+  RenderStatistics m_renderStats;
 };
 
 /*!
@@ -78,6 +78,21 @@ int CTextureBundle::LoadAnim(const std::string& Filename, CBaseTexture*** ppText
   return 0;
 }
 
+void CTextureBundle::PrefetchTextures(const std::vector<std::string>& names)
+{
+  m_tbXBT.PrefetchTextures(names);
+}
+
+void CTextureBundle::CancelPrefetch()
+{
+  m_tbXBT.CancelPrefetch();
+}
+
+CTextureBundleXBT::Statistics CTextureBundle::GetStatistics() const
+{
+  return m_tbXBT.GetStatistics();
+}
+
 void CTextureBundle::SetThemeBundle(bool themeBundle)
 {
   m_tbXBT.SetThemeBundle(themeBundle);
@@ -40,6 +40,10 @@ public:
 
   int LoadAnim(const std::string& Filename, CBaseTexture*** ppTextures, int &width, int &height, int& nLoops, int** ppDelays);
 
+  void PrefetchTextures(const std::vector<std::string>& names);
+  void CancelPrefetch();
+  CTextureBundleXBT::Statistics GetStatistics() const;
+
 private:
   CTextureBundleXBT m_tbXBT;
 
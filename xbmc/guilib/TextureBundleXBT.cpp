@@ -24,7 +24,11 @@
 #include "Texture.h"
 #include "GraphicContext.h"
 #include "utils/log.h"
+#include "utils/Job.h"
+#include "utils/JobManager.h"
 #include "settings/Settings.h"
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
 #include "filesystem/SpecialProtocol.h"
 #include "filesystem/XbtManager.h"
 #include "utils/URIUtils.h"
@@ -33,6 +37,9 @@
 #include "XBTFReader.h"
 #include <lzo/lzo1x.h>
 
+#include <map>
+#include <set>
+
 #ifdef TARGET_WINDOWS_DESKTOP
 #ifdef NDEBUG
 #pragma comment(lib,"lzo2.lib")
@@ -43,20 +50,92 @@
 #endif
 #endif
 
+// upper limit of decompressed frames waiting to be loaded
+#define MAX_PREFETCH_BYTES (64 * 1024 * 1024)
+
+struct CTextureBundleXBT::PrefetchState
+{
+  ~PrefetchState()
+  {
+    for (auto& frame : ready)
+      delete[] frame.second;
+  }
+
+  CCriticalSection section;
+  std::map<uint64_t, unsigned int> pending; ///< jobs of the frames queued for decompression, by offset
+  std::map<uint64_t, uint8_t*> ready;       ///< decompressed frames by offset
+  uint64_t readyBytes = 0;
+  unsigned int unpacking = 0;               ///< jobs decompressing a frame right now
+  CEvent idle;                              ///< set when the last job decompressing a frame is done
+  Statistics stats;
+};
+
+class CTextureBundleXBT::CPrefetchJob : public CJob
+{
+public:
+  CPrefetchJob(const std::shared_ptr<PrefetchState>& state, const CXBTFReaderPtr& reader, const CXBTFFrame& frame)
+    : m_state(state)
+    , m_reader(reader)
+    , m_frame(frame)
+  {
+  }
+
+  const char* GetType() const override { return "xbtprefetch"; }
+
+  bool DoWork() override
+  {
+    const uint64_t offset = m_frame.GetOffset();
+    {
+      // the frame may have been loaded synchronously in the meantime
+      CSingleLock lock(m_state->section);
+      if (m_state->pending.find(offset) == m_state->pending.end())
+        return true;
+      m_state->unpacking++;
+    }
+
+    uint8_t* buffer = UnpackFrame(*m_reader, m_frame);
+
+    CSingleLock lock(m_state->section);
+    if (--m_state->unpacking == 0)
+      m_state->idle.Set();
+
+    if (m_state->pending.erase(offset) == 0 || buffer == nullptr ||
+        m_state->readyBytes + m_frame.GetUnpackedSize() > MAX_PREFETCH_BYTES)
+    {
+      delete[] buffer;
+      m_state->stats.prefetchDropped++;
+      return buffer != nullptr;
+    }
+
+    m_state->ready[offset] = buffer;
+    m_state->readyBytes += m_frame.GetUnpackedSize();
+    return true;
+  }
+
+private:
+  std::shared_ptr<PrefetchState> m_state;
+  CXBTFReaderPtr m_reader;
+  CXBTFFrame m_frame;
+};
+
 CTextureBundleXBT::CTextureBundleXBT()
   : m_TimeStamp{0}
   , m_themeBundle{false}
+  , m_prefetch{new PrefetchState}
 {
 }
 
 CTextureBundleXBT::CTextureBundleXBT(bool themeBundle)
   : m_TimeStamp{0}
   , m_themeBundle{themeBundle}
+  , m_prefetch{new PrefetchState}
 {
 }
 
 CTextureBundleXBT::~CTextureBundleXBT(void)
 {
+  CancelPrefetch();
+
   if (m_XBTFReader != nullptr && m_XBTFReader->IsOpen())
   {
     XFILE::CXbtManager::GetInstance().Release(CURL(m_path));
@@ -98,6 +177,9 @@ bool CTextureBundleXBT::OpenBundle()
 
   m_path = CSpecialProtocol::TranslatePathConvertCase(m_path);
 
+  // frames prefetched from a previous bundle are keyed by offset and no longer valid
+  CancelPrefetch();
+
   // Load the texture file
   if (!XFILE::CXbtManager::GetInstance().GetReader(CURL(m_path), m_XBTFReader))
   {
@@ -213,43 +295,33 @@ int CTextureBundleXBT::LoadAnim(const std::string& Filename, CBaseTexture*** ppT
 
 bool CTextureBundleXBT::ConvertFrameToTexture(const std::string& name, CXBTFFrame& frame, CBaseTexture** ppTexture)
 {
-  // found texture - allocate the necessary buffers
-  unsigned char *buffer = new unsigned char [(size_t)frame.GetPackedSize()];
-  if (buffer == NULL)
+  uint8_t* buffer = nullptr;
   {
-    CLog::Log(LOGERROR, "Out of memory loading texture: %s (need %" PRIu64" bytes)", name.c_str(), frame.GetPackedSize());
-    return false;
+    CSingleLock lock(m_prefetch->section);
+    auto it = m_prefetch->ready.find(frame.GetOffset());
+    if (it != m_prefetch->ready.end())
+    {
+      buffer = it->second;
+      m_prefetch->readyBytes -= frame.GetUnpackedSize();
+      m_prefetch->ready.erase(it);
+      m_prefetch->stats.prefetchHits++;
+    }
+    else
+    {
+      // don't wait for a queued prefetch, the job drops its result once we've claimed the frame
+      m_prefetch->pending.erase(frame.GetOffset());
+      m_prefetch->stats.synchronousLoads++;
+    }
   }
 
-  // load the compressed texture
-  if (!m_XBTFReader->Load(frame, buffer))
+  if (buffer == nullptr)
   {
-    CLog::Log(LOGERROR, "Error loading texture: %s", name.c_str());
-    delete[] buffer;
-    return false;
-  }
-
-  // check if it's packed with lzo
-  if (frame.IsPacked())
-  { // unpack
-    unsigned char *unpacked = new unsigned char[(size_t)frame.GetUnpackedSize()];
-    if (unpacked == NULL)
+    buffer = UnpackFrame(*m_XBTFReader, frame);
+    if (buffer == nullptr)
     {
-      CLog::Log(LOGERROR, "Out of memory unpacking texture: %s (need %" PRIu64" bytes)", name.c_str(), frame.GetUnpackedSize());
-      delete[] buffer;
+      CLog::Log(LOGERROR, "Error loading texture: %s", name.c_str());
       return false;
     }
-    lzo_uint s = (lzo_uint)frame.GetUnpackedSize();
-    if (lzo1x_decompress_safe(buffer, (lzo_uint)frame.GetPackedSize(), unpacked, &s, NULL) != LZO_E_OK ||
-        s != frame.GetUnpackedSize())
-    {
-      CLog::Log(LOGERROR, "Error loading texture: %s: Decompression error", name.c_str());
-      delete[] buffer;
-      delete[] unpacked;
-      return false;
-    }
-    delete[] buffer;
-    buffer = unpacked;
   }
 
   // create an xbmc texture
@@ -261,6 +333,90 @@ bool CTextureBundleXBT::ConvertFrameToTexture(const std::string& name, CXBTFFram
   return true;
 }
 
+void CTextureBundleXBT::PrefetchTextures(const std::vector<std::string>& names)
+{
+  if ((m_XBTFReader == nullptr || !m_XBTFReader->IsOpen()) && !OpenBundle())
+    return;
+
+  std::vector<CXBTFFrame> frames;
+  std::set<uint64_t> offsets;
+  for (const auto& name : names)
+  {
+    CXBTFFile file;
+    if (!m_XBTFReader->Get(Normalize(name), file))
+      continue;
+
+    for (const auto& frame : file.GetFrames())
+    {
+      if (offsets.insert(frame.GetOffset()).second)
+        frames.push_back(frame);
+    }
+  }
+
+  CSingleLock lock(m_prefetch->section);
+
+  // release frames prefetched for an earlier request that were never loaded
+  for (auto it = m_prefetch->ready.begin(); it != m_prefetch->ready.end();)
+  {
+    if (offsets.find(it->first) == offsets.end())
+    {
+      delete[] it->second;
+      it = m_prefetch->ready.erase(it);
+      m_prefetch->stats.prefetchDropped++;
+    }
+    else
+      ++it;
+  }
+  m_prefetch->readyBytes = 0;
+  for (const auto& frame : frames)
+  {
+    if (m_prefetch->ready.find(frame.GetOffset()) != m_prefetch->ready.end())
+      m_prefetch->readyBytes += frame.GetUnpackedSize();
+  }
+
+  // queue the remaining frames, these are decompressed in parallel by the job manager's workers
+  for (const auto& frame : frames)
+  {
+    if (m_prefetch->ready.find(frame.GetOffset()) != m_prefetch->ready.end() ||
+        m_prefetch->pending.find(frame.GetOffset()) != m_prefetch->pending.end())
+      continue;
+
+    m_prefetch->stats.prefetchQueued++;
+    m_prefetch->pending[frame.GetOffset()] = CJobManager::GetInstance().AddJob(new CPrefetchJob(m_prefetch, m_XBTFReader, frame), nullptr, CJob::PRIORITY_NORMAL);
+  }
+}
+
+void CTextureBundleXBT::CancelPrefetch()
+{
+  CSingleLock lock(m_prefetch->section);
+
+  for (const auto& frame : m_prefetch->pending)
+    CJobManager::GetInstance().CancelJob(frame.second);
+  m_prefetch->pending.clear();
+
+  for (auto& frame : m_prefetch->ready)
+  {
+    delete[] frame.second;
+    m_prefetch->stats.prefetchDropped++;
+  }
+  m_prefetch->ready.clear();
+  m_prefetch->readyBytes = 0;
+
+  // jobs already decompressing a frame still read from the bundle, wait for them
+  // to drop their result before the bundle is released
+  while (m_prefetch->unpacking > 0)
+  {
+    CSingleExit exit(m_prefetch->section);
+    m_prefetch->idle.Wait();
+  }
+}
+
+CTextureBundleXBT::Statistics CTextureBundleXBT::GetStatistics() const
+{
+  CSingleLock lock(m_prefetch->section);
+  return m_prefetch->stats;
+}
+
 void CTextureBundleXBT::SetThemeBundle(bool themeBundle)
 {
   m_themeBundle = themeBundle;
@@ -281,24 +437,32 @@ std::string CTextureBundleXBT::Normalize(const std::string &name)
 
 uint8_t* CTextureBundleXBT::UnpackFrame(const CXBTFReader& reader, const CXBTFFrame& frame)
 {
-  uint8_t* packedBuffer = new uint8_t[static_cast<size_t>(frame.GetPackedSize())];
-  if (packedBuffer == nullptr)
+  // packed frames are decompressed straight out of the mapped bundle when possible
+  const uint8_t* packedData = frame.IsPacked() ? reader.GetFrameData(frame) : nullptr;
+  uint8_t* packedBuffer = nullptr;
+  if (packedData == nullptr)
   {
-    CLog::Log(LOGERROR, "CTextureBundleXBT: out of memory loading frame with %" PRIu64" packed bytes", frame.GetPackedSize());
-    return nullptr;
-  }
+    packedBuffer = new uint8_t[static_cast<size_t>(frame.GetPackedSize())];
+    if (packedBuffer == nullptr)
+    {
+      CLog::Log(LOGERROR, "CTextureBundleXBT: out of memory loading frame with %" PRIu64" packed bytes", frame.GetPackedSize());
+      return nullptr;
+    }
 
-  // load the compressed texture
-  if (!reader.Load(frame, packedBuffer))
-  {
-    CLog::Log(LOGERROR, "CTextureBundleXBT: error loading frame");
-    delete[] packedBuffer;
-    return nullptr;
-  }
+    // load the compressed texture
+    if (!reader.Load(frame, packedBuffer))
+    {
+      CLog::Log(LOGERROR, "CTextureBundleXBT: error loading frame");
+      delete[] packedBuffer;
+      return nullptr;
+    }
 
-  // if the frame isn't packed there's nothing else to be done
-  if (!frame.IsPacked())
-    return packedBuffer;
+    // if the frame isn't packed there's nothing else to be done
+    if (!frame.IsPacked())
+      return packedBuffer;
+
+    packedData = packedBuffer;
+  }
 
   uint8_t* unpackedBuffer = new uint8_t[static_cast<size_t>(frame.GetUnpackedSize())];
   if (unpackedBuffer == nullptr)
@@ -318,7 +482,7 @@ uint8_t* CTextureBundleXBT::UnpackFrame(const CXBTFReader& reader, const CXBTFFr
   }
 
   lzo_uint size = static_cast<lzo_uint>(frame.GetUnpackedSize());
-  if (lzo1x_decompress_safe(packedBuffer, static_cast<lzo_uint>(frame.GetPackedSize()), unpackedBuffer, &size, nullptr) != LZO_E_OK || size != frame.GetUnpackedSize())
+  if (lzo1x_decompress_safe(packedData, static_cast<lzo_uint>(frame.GetPackedSize()), unpackedBuffer, &size, nullptr) != LZO_E_OK || size != frame.GetUnpackedSize())
   {
     CLog::Log(LOGERROR, "CTextureBundleXBT: failed to decompress frame with %" PRIu64" unpacked bytes to %" PRIu64" bytes", frame.GetPackedSize(), frame.GetUnpackedSize());
     delete[] packedBuffer;
@@ -48,9 +48,38 @@ public:
   int LoadAnim(const std::string& Filename, CBaseTexture*** ppTextures,
                 int &width, int &height, int& nLoops, int** ppDelays);
 
+  /*!
+   \brief Decompress the frames of the given textures in the background so that
+   a following LoadTexture() or LoadAnim() only has to upload them.
+   Textures that aren't part of the bundle are ignored.
+   \param names names of the textures to prefetch.
+   */
+  void PrefetchTextures(const std::vector<std::string>& names);
+
+  /*!
+   \brief Cancel the queued prefetches, wait for the running ones and free the prefetched frames.
+   */
+  void CancelPrefetch();
+
+  /*!
+   \brief Frame load statistics of the bundle.
+   */
+  struct Statistics
+  {
+    unsigned int prefetchQueued = 0;   ///< frames queued for background decompression
+    unsigned int prefetchHits = 0;     ///< frames loaded from a prefetched buffer
+    unsigned int prefetchDropped = 0;  ///< prefetched frames discarded before they were used
+    unsigned int synchronousLoads = 0; ///< frames decompressed by the caller, usually the render thread
+  };
+
+  Statistics GetStatistics() const;
+
   static uint8_t* UnpackFrame(const CXBTFReader& reader, const CXBTFFrame& frame);
 
 private:
+  class CPrefetchJob;
+  struct PrefetchState;
+
   bool OpenBundle();
   bool ConvertFrameToTexture(const std::string& name, CXBTFFrame& frame, CBaseTexture** ppTexture);
 
@@ -59,6 +88,7 @@ private:
   bool m_themeBundle;
   std::string m_path;
   std::shared_ptr<CXBTFReader> m_XBTFReader;
+  std::shared_ptr<PrefetchState> m_prefetch;
 };
 
 
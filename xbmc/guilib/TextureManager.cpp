@@ -495,6 +495,63 @@ void CGUITextureManager::ReleaseTexture(const std::string& strTextureName, bool
   CLog::Log(LOGWARNING, "%s: Unable to release texture %s", __FUNCTION__, strTextureName.c_str());
 }
 
+void CGUITextureManager::PrefetchTextures(const std::vector<std::string>& textureNames)
+{
+  CSingleLock lock(m_section);
+
+  // the theme bundle takes precedence, so only prefetch from the bundle Load() will use
+  std::vector<std::string> bundled[2];
+  for (const auto& textureName : textureNames)
+  {
+    if (textureName.empty() || !CanLoad(textureName))
+      continue;
+
+    bool loaded = false;
+    for (const auto& pMap : m_vecTextures)
+    {
+      if (pMap->GetName() == textureName)
+      {
+        loaded = true;
+        break;
+      }
+    }
+    if (loaded)
+      continue;
+
+    std::string bundledName = CTextureBundle::Normalize(textureName);
+    for (int i = 0; i < 2; i++)
+    {
+      if (m_TexBundle[i].HasFile(bundledName))
+      {
+        bundled[i].push_back(bundledName);
+        break;
+      }
+    }
+  }
+
+  for (int i = 0; i < 2; i++)
+  {
+    if (!bundled[i].empty())
+      m_TexBundle[i].PrefetchTextures(bundled[i]);
+  }
+}
+
+CTextureBundleXBT::Statistics CGUITextureManager::GetBundleStatistics() const
+{
+  CSingleLock lock(m_section);
+
+  CTextureBundleXBT::Statistics stats;
+  for (int i = 0; i < 2; i++)
+  {
+    CTextureBundleXBT::Statistics bundleStats = m_TexBundle[i].GetStatistics();
+    stats.prefetchQueued += bundleStats.prefetchQueued;
+    stats.prefetchHits += bundleStats.prefetchHits;
+    stats.prefetchDropped += bundleStats.prefetchDropped;
+    stats.synchronousLoads += bundleStats.synchronousLoads;
+  }
+  return stats;
+}
+
 void CGUITextureManager::FreeUnusedTextures(unsigned int timeDelay)
 {
   unsigned int currFrameTime = XbmcThreads::SystemClockMillis();
@@ -546,6 +603,8 @@ void CGUITextureManager::Cleanup()
     i = m_vecTextures.erase(i);
   }
 
+  m_TexBundle[0].CancelPrefetch();
+  m_TexBundle[1].CancelPrefetch();
   m_TexBundle[0] = CTextureBundle(true);
   m_TexBundle[1] = CTextureBundle();
   FreeUnusedTextures();
@@ -555,6 +614,10 @@ void CGUITextureManager::Dump() const
 {
   CLog::Log(LOGDEBUG, "{0}: total texturemaps size: {1}", __FUNCTION__, m_vecTextures.size());
 
+  CTextureBundleXBT::Statistics stats = GetBundleStatistics();
+  CLog::Log(LOGDEBUG, "{0}: bundled frames: {1} prefetched, {2} prefetch hits, {3} dropped, {4} loaded synchronously",
+            __FUNCTION__, stats.prefetchQueued, stats.prefetchHits, stats.prefetchDropped, stats.synchronousLoads);
+
   for (int i = 0; i < (int)m_vecTextures.size(); ++i)
   {
     const CTextureMap* pMap = m_vecTextures[i];
@@ -122,6 +122,18 @@ public:
   void SetTexturePath(const std::string &texturePath);    ///< Set a single path as the path to check when loading media (clear then add)
   void RemoveTexturePath(const std::string &texturePath); ///< Remove a path from the paths to check when loading media
 
+  /*!
+   \brief Decompress bundled textures in the background ahead of their Load().
+   Textures that are already loaded or not bundled are skipped.
+   \param textureNames names of the textures, as used in the skin.
+   */
+  void PrefetchTextures(const std::vector<std::string>& textureNames);
+
+  /*!
+   \brief Frame load statistics, summed over the skin and theme bundles.
+   */
+  CTextureBundleXBT::Statistics GetBundleStatistics() const;
+
   void FreeUnusedTextures(unsigned int timeDelay = 0); ///< Free textures (called from app thread only)
   void ReleaseHwTexture(unsigned int texture);
 protected:
@@ -134,7 +146,7 @@ protected:
   CTextureBundle m_TexBundle[2];
 
   std::vector<std::string> m_texturePaths;
-  CCriticalSection m_section;
+  mutable CCriticalSection m_section;
 };
 
 /*!
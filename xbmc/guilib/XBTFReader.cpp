@@ -25,8 +25,13 @@
 
 #include "XBTFReader.h"
 #include "guilib/XBTF.h"
+#include "threads/SingleLock.h"
 #include "utils/EndianSwap.h"
 
+#ifdef TARGET_POSIX
+#include <sys/mman.h>
+#endif
+
 #ifdef TARGET_WINDOWS
 #include "filesystem/SpecialProtocol.h"
 #include "utils/CharsetConverter.h"
@@ -68,12 +73,15 @@ static bool ReadUInt64(FILE* file, uint64_t& value)
 CXBTFReader::CXBTFReader()
   : CXBTFBase(),
     m_path(),
-    m_file(nullptr)
+    m_file(nullptr),
+    m_mapped(nullptr),
+    m_mappedSize(0)
 { }
 
 CXBTFReader::~CXBTFReader()
 {
   Close();
+  Unmap();
 }
 
 bool CXBTFReader::Open(const std::string& path)
@@ -177,16 +185,35 @@ bool CXBTFReader::Open(const std::string& path)
   if (pos != GetHeaderSize())
     return false;
 
+#ifdef TARGET_POSIX
+  // map the whole bundle so frames can be read concurrently without seeking
+  Unmap();
+  struct stat fileStat;
+  if (fstat(fileno(m_file), &fileStat) == 0 && fileStat.st_size > 0)
+  {
+    void* mapped = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fileno(m_file), 0);
+    if (mapped != MAP_FAILED)
+    {
+      m_mapped = static_cast<unsigned char*>(mapped);
+      m_mappedSize = static_cast<uint64_t>(fileStat.st_size);
+    }
+  }
+#endif
+
   return true;
 }
 
 bool CXBTFReader::IsOpen() const
 {
+  CSingleLock lock(m_fileSection);
   return m_file != nullptr;
 }
 
 void CXBTFReader::Close()
 {
+  // waits for reads in progress, later reads fail. The mapping is kept until
+  // destruction as a caller may still be decompressing a frame straight out of it
+  CSingleLock lock(m_fileSection);
   if (m_file != nullptr)
   {
     fclose(m_file);
@@ -199,6 +226,7 @@ void CXBTFReader::Close()
 
 time_t CXBTFReader::GetLastModificationTimestamp() const
 {
+  CSingleLock lock(m_fileSection);
   if (m_file == nullptr)
     return 0;
 
@@ -209,8 +237,39 @@ time_t CXBTFReader::GetLastModificationTimestamp() const
   return fileStat.st_mtime;
 }
 
+void CXBTFReader::Unmap()
+{
+#ifdef TARGET_POSIX
+  if (m_mapped != nullptr)
+    munmap(m_mapped, static_cast<size_t>(m_mappedSize));
+#endif
+
+  m_mapped = nullptr;
+  m_mappedSize = 0;
+}
+
+const unsigned char* CXBTFReader::GetFrameData(const CXBTFFrame& frame) const
+{
+  CSingleLock lock(m_fileSection);
+  if (m_file == nullptr || m_mapped == nullptr)
+    return nullptr;
+
+  if (frame.GetOffset() > m_mappedSize || frame.GetPackedSize() > m_mappedSize - frame.GetOffset())
+    return nullptr;
+
+  return m_mapped + frame.GetOffset();
+}
+
 bool CXBTFReader::Load(const CXBTFFrame& frame, unsigned char* buffer) const
 {
+  const unsigned char* data = GetFrameData(frame);
+  if (data != nullptr)
+  {
+    memcpy(buffer, data, static_cast<size_t>(frame.GetPackedSize()));
+    return true;
+  }
+
+  CSingleLock lock(m_fileSection);
   if (m_file == nullptr)
     return false;
 
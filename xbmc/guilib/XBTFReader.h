@@ -26,6 +26,7 @@
 #include <stdint.h>
 
 #include "XBTF.h"
+#include "threads/CriticalSection.h"
 
 class CXBTFReader : public CXBTFBase
 {
@@ -39,11 +40,29 @@ public:
 
   time_t GetLastModificationTimestamp() const;
 
+  /*!
+   \brief Copy the packed data of the given frame into the given buffer.
+   Safe to call from several threads at once.
+   \param frame the frame to load.
+   \param buffer buffer of at least frame.GetPackedSize() bytes.
+   */
   bool Load(const CXBTFFrame& frame, unsigned char* buffer) const;
 
+  /*!
+   \brief Get the packed data of the given frame directly from the memory mapped bundle.
+   \param frame the frame to look up.
+   \return pointer to frame.GetPackedSize() bytes, or nullptr if the bundle isn't memory mapped.
+   */
+  const unsigned char* GetFrameData(const CXBTFFrame& frame) const;
+
 private:
+  void Unmap();
+
   std::string m_path;
   FILE* m_file;
+  unsigned char* m_mapped;
+  uint64_t m_mappedSize;
+  mutable CCriticalSection m_fileSection; ///< guards m_file, serializes seek/read when the bundle isn't mapped
 };
 
 typedef std::shared_ptr<CXBTFReader> CXBTFReaderPtr;
@@ -0,0 +1,133 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "guilib/DirtyRegionSolvers.h"
+
+#include "gtest/gtest.h"
+
+namespace
+{
+const CRect viewport(0, 0, 1920, 1080);
+
+// true if every pixel of region (clipped to the viewport) is drawn by one of the passes
+bool IsCovered(const CDirtyRegion &region, const CDirtyRegionList &passes)
+{
+  CRect clipped(region);
+  clipped.Intersect(viewport);
+  std::vector<CRect> rects(passes.begin(), passes.end());
+  return clipped.IsEmpty() || clipped.SubtractRects(rects).empty();
+}
+
+float Area(const CDirtyRegionList &passes)
+{
+  float area = 0;
+  for (CDirtyRegionList::const_iterator i = passes.begin(); i != passes.end(); ++i)
+    area += i->Area();
+  return area;
+}
+}
+
+TEST(TestDirtyRegionSolvers, TiledEmpty)
+{
+  CTiledDirtyRegionSolver solver;
+  CDirtyRegionList input, output;
+  solver.Solve(input, output, viewport);
+  EXPECT_TRUE(output.empty());
+
+  // entirely off screen
+  input.push_back(CDirtyRegion(2000, 0, 2100, 100));
+  solver.Solve(input, output, viewport);
+  EXPECT_TRUE(output.empty());
+}
+
+TEST(TestDirtyRegionSolvers, TiledSingleLabel)
+{
+  CTiledDirtyRegionSolver solver;
+  CDirtyRegionList input, output;
+  input.push_back(CDirtyRegion(1700, 30, 1850, 70));
+  solver.Solve(input, output, viewport);
+  ASSERT_EQ(1U, output.size());
+  EXPECT_EQ(CRect(1700, 30, 1850, 70), CRect(output[0]));
+}
+
+TEST(TestDirtyRegionSolvers, TiledDistantRegionsStaySeparate)
+{
+  CTiledDirtyRegionSolver solver;
+  CDirtyRegionList input, output;
+  input.push_back(CDirtyRegion(50, 50, 250, 100));
+  input.push_back(CDirtyRegion(1600, 900, 1800, 1000));
+  solver.Solve(input, output, viewport);
+  EXPECT_EQ(2U, output.size());
+  for (CDirtyRegionList::const_iterator i = input.begin(); i != input.end(); ++i)
+    EXPECT_TRUE(IsCovered(*i, output));
+  EXPECT_FLOAT_EQ(200 * 50 + 200 * 100, Area(output));
+}
+
+TEST(TestDirtyRegionSolvers, TiledNeighboursAreMerged)
+{
+  CTiledDirtyRegionSolver solver;
+  CDirtyRegionList input, output;
+  input.push_back(CDirtyRegion(100, 500, 400, 560));
+  input.push_back(CDirtyRegion(410, 500, 700, 560));
+  solver.Solve(input, output, viewport);
+  ASSERT_EQ(1U, output.size());
+  EXPECT_EQ(CRect(100, 500, 700, 560), CRect(output[0]));
+}
+
+TEST(TestDirtyRegionSolvers, TiledRecordedListScroll)
+{
+  // recorded from a poster wall scrolling while the clock and a progress bar update
+  CTiledDirtyRegionSolver solver;
+  CDirtyRegionList input, output;
+  for (int col = 0; col < 6; col++)
+    for (int row = 0; row < 2; row++)
+      input.push_back(CDirtyRegion(90 + col * 290, 200 + row * 420, 360 + col * 290, 600 + row * 420));
+  input.push_back(CDirtyRegion(1760, 20, 1890, 60));
+  input.push_back(CDirtyRegion(60, 1040, 1860, 1050));
+  solver.Solve(input, output, viewport);
+
+  for (CDirtyRegionList::const_iterator i = input.begin(); i != input.end(); ++i)
+    EXPECT_TRUE(IsCovered(*i, output));
+  EXPECT_LE(output.size(), 3U);
+  EXPECT_LE(Area(output), viewport.Area());
+}
+
+TEST(TestDirtyRegionSolvers, TiledFullScreen)
+{
+  CTiledDirtyRegionSolver solver;
+  CDirtyRegionList input, output;
+  input.push_back(CDirtyRegion(-10, -10, 1930, 1090));
+  input.push_back(CDirtyRegion(100, 100, 200, 200));
+  solver.Solve(input, output, viewport);
+  ASSERT_EQ(1U, output.size());
+  EXPECT_EQ(viewport, CRect(output[0]));
+}
+
+TEST(TestDirtyRegionSolvers, TiledCostOfPasses)
+{
+  // with expensive passes everything ends up in a single pass
+  CTiledDirtyRegionSolver solver(16, 9, 1.0f);
+  CDirtyRegionList input, output;
+  input.push_back(CDirtyRegion(50, 50, 250, 100));
+  input.push_back(CDirtyRegion(1600, 900, 1800, 1000));
+  solver.Solve(input, output, viewport);
+  ASSERT_EQ(1U, output.size());
+  EXPECT_EQ(CRect(50, 50, 1800, 1000), CRect(output[0]));
+}
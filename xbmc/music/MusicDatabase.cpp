@@ -63,6 +63,7 @@
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "utils/XMLUtils.h"
+#include <cmath>
 #include <inttypes.h>
 
 using namespace XFILE;
@@ -81,6 +82,32 @@ using namespace CDDB;
 using namespace MEDIA_DETECT;
 #endif
 
+// bind empty strings as NULL, as the queries they replace did
+static dbiplus::field_value NullIfEmpty(const std::string &value)
+{
+  dbiplus::field_value result(value);
+  if (value.empty())
+    result.set_isNull();
+  return result;
+}
+
+// whether a sort uses song fields changed by playing or rating a song. Their changes don't bump the library
+// version as every play would drop every cached order, so these sorts are never served from it.
+static bool IsSortOnPlayFields(SortBy sortBy)
+{
+  switch (sortBy)
+  {
+  case SortByPlaycount:
+  case SortByLastPlayed:
+  case SortByRating:
+  case SortByUserRating:
+  case SortByVotes:
+    return true;
+  default:
+    return false;
+  }
+}
+
 static void AnnounceRemove(const std::string& content, int id)
 {
   CVariant data;
@@ -202,6 +229,12 @@ void CMusicDatabase::CreateTables()
   CLog::Log(LOGINFO, "create versiontagscan table");
   m_pDS->exec("CREATE TABLE versiontagscan (idVersion integer, iNeedsScan integer)");
   m_pDS->exec(PrepareSQL("INSERT INTO versiontagscan (idVersion, iNeedsScan) values(%i, 0)", GetSchemaVersion()));
+
+  CLog::Log(LOGINFO, "create artistsummary table");
+  m_pDS->exec("CREATE TABLE artistsummary (idArtist integer primary key, iSongs integer, iContributions integer, iAlbums integer)");
+
+  CLog::Log(LOGINFO, "create libraryversion table");
+  m_pDS->exec("CREATE TABLE libraryversion (iVersion integer)");
 }
 
 void CMusicDatabase::CreateAnalytics()
@@ -256,17 +289,85 @@ void CMusicDatabase::CreateAnalytics()
               "  DELETE FROM song_artist WHERE song_artist.idArtist = old.idArtist;"
               "  DELETE FROM discography WHERE discography.idArtist = old.idArtist;"
               "  DELETE FROM art WHERE media_id=old.idArtist AND media_type='artist';"
+              "  DELETE FROM artistsummary WHERE artistsummary.idArtist = old.idArtist;"
               " END");
   m_pDS->exec("CREATE TRIGGER tgrDeleteSong AFTER delete ON song FOR EACH ROW BEGIN"
               "  DELETE FROM song_artist WHERE song_artist.idSong = old.idSong;"
               "  DELETE FROM song_genre WHERE song_genre.idSong = old.idSong;"
               "  DELETE FROM art WHERE media_id=old.idSong AND media_type='song';"
               " END");
-  
+
+  // artistsummary counts the songs and albums of each artist for the artists node,
+  // song counts are for the default role only, contributions are for any role
+  m_pDS->exec("CREATE TRIGGER tgrInsertArtist AFTER insert ON artist FOR EACH ROW BEGIN"
+              "  DELETE FROM artistsummary WHERE artistsummary.idArtist = new.idArtist;"
+              "  INSERT INTO artistsummary (idArtist, iSongs, iContributions, iAlbums) VALUES (new.idArtist, 0, 0, 0);"
+              " END");
+  m_pDS->exec("CREATE TRIGGER tgrInsertSongArtist AFTER insert ON song_artist FOR EACH ROW BEGIN"
+              "  UPDATE artistsummary SET iSongs = iSongs + CASE WHEN new.idRole = 1 THEN 1 ELSE 0 END, iContributions = iContributions + 1"
+              "  WHERE artistsummary.idArtist = new.idArtist;"
+              " END");
+  m_pDS->exec("CREATE TRIGGER tgrDeleteSongArtist AFTER delete ON song_artist FOR EACH ROW BEGIN"
+              "  UPDATE artistsummary SET iSongs = iSongs - CASE WHEN old.idRole = 1 THEN 1 ELSE 0 END, iContributions = iContributions - 1"
+              "  WHERE artistsummary.idArtist = old.idArtist;"
+              " END");
+  m_pDS->exec("CREATE TRIGGER tgrUpdateSongArtist AFTER update ON song_artist FOR EACH ROW BEGIN"
+              "  UPDATE artistsummary SET iSongs = iSongs - CASE WHEN old.idRole = 1 THEN 1 ELSE 0 END, iContributions = iContributions - 1"
+              "  WHERE artistsummary.idArtist = old.idArtist;"
+              "  UPDATE artistsummary SET iSongs = iSongs + CASE WHEN new.idRole = 1 THEN 1 ELSE 0 END, iContributions = iContributions + 1"
+              "  WHERE artistsummary.idArtist = new.idArtist;"
+              " END");
+  m_pDS->exec("CREATE TRIGGER tgrInsertAlbumArtist AFTER insert ON album_artist FOR EACH ROW BEGIN"
+              "  UPDATE artistsummary SET iAlbums = iAlbums + 1 WHERE artistsummary.idArtist = new.idArtist;"
+              " END");
+  m_pDS->exec("CREATE TRIGGER tgrDeleteAlbumArtist AFTER delete ON album_artist FOR EACH ROW BEGIN"
+              "  UPDATE artistsummary SET iAlbums = iAlbums - 1 WHERE artistsummary.idArtist = old.idArtist;"
+              " END");
+  m_pDS->exec("CREATE TRIGGER tgrUpdateAlbumArtist AFTER update ON album_artist FOR EACH ROW BEGIN"
+              "  UPDATE artistsummary SET iAlbums = iAlbums - 1 WHERE artistsummary.idArtist = old.idArtist;"
+              "  UPDATE artistsummary SET iAlbums = iAlbums + 1 WHERE artistsummary.idArtist = new.idArtist;"
+              " END");
+  RebuildArtistSummary();
+
+  // invalidates the cached orders of the library, see GetSortedPage()
+  // playing and rating a song don't change the orders that are cached, see IsSortOnPlayFields()
+  CreateLibraryVersionTriggers({ "song", "album", "path" },
+                               { { "song", { "idAlbum", "idPath", "strArtistDisp", "strArtistSort", "strGenres", "strTitle", "iTrack",
+                                             "iDuration", "iYear", "strFileName", "iStartOffset", "iEndOffset", "comment", "mood", "dateAdded" } } });
+
+  // full-text indexes for the search dialog
+  CreateFullTextIndex("artistsearch", "artist", "idArtist", { "strArtist" });
+  CreateFullTextIndex("albumsearch", "album", "idAlbum", { "strAlbum" });
+  CreateFullTextIndex("songsearch", "song", "idSong", { "strTitle" });
+
   // we create views last to ensure all indexes are rolled in
   CreateViews();
 }
 
+bool CMusicDatabase::RebuildArtistSummary()
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    CLog::Log(LOGDEBUG, LOGDATABASE, "%s: Rebuilding artist summary", __FUNCTION__);
+    m_pDS->exec("DELETE FROM artistsummary");
+    m_pDS->exec("INSERT INTO artistsummary (idArtist, iSongs, iContributions, iAlbums) "
+                "SELECT idArtist, "
+                "(SELECT COUNT(1) FROM song_artist WHERE song_artist.idArtist = artist.idArtist AND song_artist.idRole = 1), "
+                "(SELECT COUNT(1) FROM song_artist WHERE song_artist.idArtist = artist.idArtist), "
+                "(SELECT COUNT(1) FROM album_artist WHERE album_artist.idArtist = artist.idArtist) "
+                "FROM artist");
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
+  }
+  return false;
+}
+
 void CMusicDatabase::CreateViews()
 {
   CLog::Log(LOGINFO, "create song view");
@@ -530,54 +631,45 @@ int CMusicDatabase::AddSong(const int idAlbum,
     int idPath = AddPath(strPath);
 
     if (!strMusicBrainzTrackID.empty())
-      strSQL = PrepareSQL("SELECT idSong FROM song WHERE idAlbum = %i AND iTrack=%i AND strMusicBrainzTrackID = '%s'",
-                          idAlbum, 
-                          iTrack,
-                          strMusicBrainzTrackID.c_str());
+    {
+      strSQL = "SELECT idSong FROM song WHERE idAlbum = ? AND iTrack=? AND strMusicBrainzTrackID = ?";
+      if (!m_pDS->query_bound(strSQL, { dbiplus::field_value(idAlbum), dbiplus::field_value(iTrack),
+                                        dbiplus::field_value(strMusicBrainzTrackID) }))
+        return -1;
+    }
     else
-      strSQL = PrepareSQL("SELECT idSong FROM song WHERE idAlbum=%i AND strFileName='%s' AND strTitle='%s' AND iTrack=%i AND strMusicBrainzTrackID IS NULL",
-                          idAlbum,
-                          strFileName.c_str(),
-                          strTitle.c_str(),
-                          iTrack);
-
-    if (!m_pDS->query(strSQL))
-      return -1;
+    {
+      strSQL = "SELECT idSong FROM song WHERE idAlbum=? AND strFileName=? AND strTitle=? AND iTrack=? AND strMusicBrainzTrackID IS NULL";
+      if (!m_pDS->query_bound(strSQL, { dbiplus::field_value(idAlbum), dbiplus::field_value(strFileName),
+                                        dbiplus::field_value(strTitle), dbiplus::field_value(iTrack) }))
+        return -1;
+    }
 
     if (m_pDS->num_rows() == 0)
     {
       m_pDS->close();
-      strSQL=PrepareSQL("INSERT INTO song ("
-                                          "idSong,idAlbum,idPath,strArtistDisp,"
-                                          "strTitle,iTrack,iDuration,iYear,strFileName,"
-                                          "strMusicBrainzTrackID, strArtistSort, "
-                                          "iTimesPlayed,iStartOffset, "
-                                          "iEndOffset,lastplayed,rating,userrating,votes,comment,mood,strReplayGain"
-                        ") values (NULL, %i, %i, '%s', '%s', %i, %i, %i, '%s'",
-                    idAlbum,
-                    idPath,
-                    artistDisp.c_str(),
-                    strTitle.c_str(),
-                    iTrack, iDuration, iYear,
-                    strFileName.c_str());
-
-      if (strMusicBrainzTrackID.empty())
-        strSQL += PrepareSQL(",NULL");
-      else
-        strSQL += PrepareSQL(",'%s'", strMusicBrainzTrackID.c_str());
-      if (artistSort.empty())
-        strSQL += PrepareSQL(",NULL");
-      else
-        strSQL += PrepareSQL(",'%s'", artistSort.c_str());
-
-      if (dtLastPlayed.IsValid())
-        strSQL += PrepareSQL(",%i,%i,%i,'%s', %.1f, %i, %i, '%s','%s', '%s')",
-                      iTimesPlayed, iStartOffset, iEndOffset, dtLastPlayed.GetAsDBDateTime().c_str(), rating, userrating, votes, 
-                      strComment.c_str(), strMood.c_str(), replayGain.Get().c_str());
-      else
-        strSQL += PrepareSQL(",%i,%i,%i,NULL, %.1f, %i, %i,'%s', '%s', '%s')",
-                      iTimesPlayed, iStartOffset, iEndOffset, rating, userrating, votes, strComment.c_str(), strMood.c_str(), replayGain.Get().c_str());
-      m_pDS->exec(strSQL);
+      strSQL = "INSERT INTO song ("
+                 "idSong,idAlbum,idPath,strArtistDisp,"
+                 "strTitle,iTrack,iDuration,iYear,strFileName,"
+                 "strMusicBrainzTrackID, strArtistSort, "
+                 "iTimesPlayed,iStartOffset, "
+                 "iEndOffset,lastplayed,rating,userrating,votes,comment,mood,strReplayGain"
+               ") values (NULL, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)";
+      m_pDS->exec_bound(strSQL, {
+        dbiplus::field_value(idAlbum),
+        dbiplus::field_value(idPath),
+        dbiplus::field_value(artistDisp),
+        dbiplus::field_value(strTitle),
+        dbiplus::field_value(iTrack), dbiplus::field_value(iDuration), dbiplus::field_value(iYear),
+        dbiplus::field_value(strFileName),
+        NullIfEmpty(strMusicBrainzTrackID),
+        NullIfEmpty(artistSort),
+        dbiplus::field_value(iTimesPlayed), dbiplus::field_value(iStartOffset), dbiplus::field_value(iEndOffset),
+        NullIfEmpty(dtLastPlayed.IsValid() ? dtLastPlayed.GetAsDBDateTime() : ""),
+        dbiplus::field_value(std::round(rating * 10) / 10.0), // stored with one decimal
+        dbiplus::field_value(userrating), dbiplus::field_value(votes),
+        dbiplus::field_value(strComment), dbiplus::field_value(strMood), dbiplus::field_value(replayGain.Get())
+      });
       idSong = (int)m_pDS->lastinsertid();
     }
     else
@@ -1041,14 +1133,14 @@ int CMusicDatabase::AddGenre(std::string& strGenre)
       return it->second;
 
 
-    strSQL=PrepareSQL("SELECT idGenre, strGenre FROM genre WHERE strGenre LIKE '%s'", strGenre.c_str());
-    m_pDS->query(strSQL);
+    strSQL = "SELECT idGenre, strGenre FROM genre WHERE strGenre LIKE ?";
+    m_pDS->query_bound(strSQL, { dbiplus::field_value(strGenre) });
     if (m_pDS->num_rows() == 0)
     {
       m_pDS->close();
       // doesnt exists, add it
-      strSQL=PrepareSQL("INSERT INTO genre (idGenre, strGenre) values( NULL, '%s' )", strGenre.c_str());
-      m_pDS->exec(strSQL);
+      strSQL = "INSERT INTO genre (idGenre, strGenre) values( NULL, ? )";
+      m_pDS->exec_bound(strSQL, { dbiplus::field_value(strGenre) });
 
       int idGenre = (int)m_pDS->lastinsertid();
       m_genreCache.insert(std::pair<std::string, int>(strGenre, idGenre));
@@ -1432,16 +1524,16 @@ int CMusicDatabase::AddRole(const std::string &strRole)
   {
     if (NULL == m_pDB.get()) return -1;
     if (NULL == m_pDS.get()) return -1;
-    strSQL = PrepareSQL("SELECT idRole FROM role WHERE strRole LIKE '%s'", strRole.c_str());
-    m_pDS->query(strSQL);
+    strSQL = "SELECT idRole FROM role WHERE strRole LIKE ?";
+    m_pDS->query_bound(strSQL, { dbiplus::field_value(strRole) });
     if (m_pDS->num_rows() > 0)
       idRole = m_pDS->fv("idRole").get_asInt();
     m_pDS->close();
 
     if (idRole < 0)
     {
-      strSQL = PrepareSQL("INSERT INTO role (strRole) VALUES ('%s')", strRole.c_str());
-      m_pDS->exec(strSQL);
+      strSQL = "INSERT INTO role (strRole) VALUES (?)";
+      m_pDS->exec_bound(strSQL, { dbiplus::field_value(strRole) });
       idRole = static_cast<int>(m_pDS->lastinsertid());
       m_pDS->close();
     }
@@ -1461,10 +1553,12 @@ bool CMusicDatabase::AddSongArtist(int idArtist, int idSong, const std::string&
 
 bool CMusicDatabase::AddSongArtist(int idArtist, int idSong, int idRole, const std::string& strArtist, int iOrder)
 {
-  std::string strSQL;
-  strSQL = PrepareSQL("replace into song_artist (idArtist, idSong, idRole, strArtist, iOrder) values(%i,%i,%i,'%s',%i)",
-    idArtist, idSong, idRole, strArtist.c_str(), iOrder);
-  return ExecuteQuery(strSQL);
+  // not a replace, that fires the insert trigger keeping artistsummary current but not the delete trigger
+  return ExecuteQuery("DELETE FROM song_artist WHERE idSong = ? AND idArtist = ? AND idRole = ?",
+                      { dbiplus::field_value(idSong), dbiplus::field_value(idArtist), dbiplus::field_value(idRole) }) &&
+         ExecuteQuery("INSERT INTO song_artist (idArtist, idSong, idRole, strArtist, iOrder) values(?,?,?,?,?)",
+                      { dbiplus::field_value(idArtist), dbiplus::field_value(idSong), dbiplus::field_value(idRole),
+                        dbiplus::field_value(strArtist), dbiplus::field_value(iOrder) });
 }
 
 int CMusicDatabase::AddSongContributor(int idSong, const std::string& strRole, const std::string& strArtist, const std::string &strSort)
@@ -1598,10 +1692,12 @@ bool CMusicDatabase::DeleteSongArtistsBySong(int idSong)
 
 bool CMusicDatabase::AddAlbumArtist(int idArtist, int idAlbum, std::string strArtist, int iOrder)
 {
-  std::string strSQL;
-  strSQL = PrepareSQL("replace into album_artist (idArtist, idAlbum, strArtist, iOrder) values(%i,%i,'%s',%i)",
-    idArtist, idAlbum, strArtist.c_str(), iOrder);
-  return ExecuteQuery(strSQL);
+  // not a replace, see AddSongArtist()
+  return ExecuteQuery("DELETE FROM album_artist WHERE idAlbum = ? AND idArtist = ?",
+                      { dbiplus::field_value(idAlbum), dbiplus::field_value(idArtist) }) &&
+         ExecuteQuery("INSERT INTO album_artist (idArtist, idAlbum, strArtist, iOrder) values(?,?,?,?)",
+                      { dbiplus::field_value(idArtist), dbiplus::field_value(idAlbum),
+                        dbiplus::field_value(strArtist), dbiplus::field_value(iOrder) });
 }
 
 bool CMusicDatabase::DeleteAlbumArtistsByAlbum(int idAlbum)
@@ -1626,9 +1722,8 @@ bool CMusicDatabase::AddSongGenres(int idSong, const std::vector<std::string>& g
     for (auto &strGenre : modgenres)
     {
       int idGenre = AddGenre(strGenre); // Genre string trimed and matched case insensitively
-      strSQL = PrepareSQL("INSERT INTO song_genre (idGenre, idSong, iOrder) VALUES(%i,%i,%i)",
-        idGenre, idSong, index++);
-      if (!ExecuteQuery(strSQL))
+      strSQL = "INSERT INTO song_genre (idGenre, idSong, iOrder) VALUES(?,?,?)";
+      if (!ExecuteQuery(strSQL, { dbiplus::field_value(idGenre), dbiplus::field_value(idSong), dbiplus::field_value((int)index++) }))
         return false;
     }
     // Update concatenated genre string from the standardised genre values
@@ -1944,14 +2039,14 @@ int CMusicDatabase::AddPath(const std::string& strPath1)
     if (it != m_pathCache.end())
       return it->second;
 
-    strSQL=PrepareSQL( "select * from path where strPath='%s'", strPath.c_str());
-    m_pDS->query(strSQL);
+    strSQL = "select * from path where strPath=?";
+    m_pDS->query_bound(strSQL, { dbiplus::field_value(strPath) });
     if (m_pDS->num_rows() == 0)
     {
       m_pDS->close();
       // doesnt exists, add it
-      strSQL=PrepareSQL("insert into path (idPath, strPath) values( NULL, '%s' )", strPath.c_str());
-      m_pDS->exec(strSQL);
+      strSQL = "insert into path (idPath, strPath) values( NULL, ? )";
+      m_pDS->exec_bound(strSQL, { dbiplus::field_value(strPath) });
 
       int idPath = (int)m_pDS->lastinsertid();
       m_pathCache.insert(std::pair<std::string, int>(strPath, idPath));
@@ -2307,7 +2402,11 @@ bool CMusicDatabase::SearchArtists(const std::string& search, CFileItemList &art
 
     std::string strVariousArtists = g_localizeStrings.Get(340).c_str();
     std::string strSQL;
-    if (search.size() >= MIN_FULL_SEARCH_LENGTH)
+    if (HasFullTextIndex("artistsearch"))
+      strSQL=PrepareSQL("select artist.* from artistsearch join artist on artist.idArtist = artistsearch.rowid "
+                                "where artistsearch match '%s' and strArtist <> '%s' order by artistsearch.rank"
+                                , PrepareFullTextQuery(search, search.size() < MIN_FULL_SEARCH_LENGTH).c_str(), strVariousArtists.c_str() );
+    else if (search.size() >= MIN_FULL_SEARCH_LENGTH)
       strSQL=PrepareSQL("select * from artist "
                                 "where (strArtist like '%s%%' or strArtist like '%% %s%%') and strArtist <> '%s' "
                                 , search.c_str(), search.c_str(), strVariousArtists.c_str() );
@@ -2852,7 +2951,10 @@ bool CMusicDatabase::SearchSongs(const std::string& search, CFileItemList &items
       return false;
 
     std::string strSQL;
-    if (search.size() >= MIN_FULL_SEARCH_LENGTH)
+    if (HasFullTextIndex("songsearch"))
+      strSQL=PrepareSQL("select songview.* from songsearch join songview on songview.idSong = songsearch.rowid "
+                        "where songsearch match '%s' order by songsearch.rank limit 1000", PrepareFullTextQuery(search, search.size() < MIN_FULL_SEARCH_LENGTH).c_str());
+    else if (search.size() >= MIN_FULL_SEARCH_LENGTH)
       strSQL=PrepareSQL("select * from songview where strTitle like '%s%%' or strTitle like '%% %s%%' limit 1000", search.c_str(), search.c_str());
     else
       strSQL=PrepareSQL("select * from songview where strTitle like '%s%%' limit 1000", search.c_str());
@@ -2888,7 +2990,10 @@ bool CMusicDatabase::SearchAlbums(const std::string& search, CFileItemList &albu
     if (NULL == m_pDS.get()) return false;
 
     std::string strSQL;
-    if (search.size() >= MIN_FULL_SEARCH_LENGTH)
+    if (HasFullTextIndex("albumsearch"))
+      strSQL=PrepareSQL("select albumview.* from albumsearch join albumview on albumview.idAlbum = albumsearch.rowid "
+                        "where albumsearch match '%s' order by albumsearch.rank", PrepareFullTextQuery(search, search.size() < MIN_FULL_SEARCH_LENGTH).c_str());
+    else if (search.size() >= MIN_FULL_SEARCH_LENGTH)
       strSQL=PrepareSQL("select * from albumview where strAlbum like '%s%%' or strAlbum like '%% %s%%'", search.c_str(), search.c_str());
     else
       strSQL=PrepareSQL("select * from albumview where strAlbum like '%s%%'", search.c_str());
@@ -3322,6 +3427,11 @@ int CMusicDatabase::Cleanup(CGUIDialogProgress* progressDialog /*= nullptr*/)
     ret = ERROR_REORG_OTHER;
     goto error;
   }
+  if (!RebuildArtistSummary())
+  {
+    ret = ERROR_REORG_OTHER;
+    goto error;
+  }
   // commit transaction
   if (progressDialog)
   {
@@ -4537,6 +4647,26 @@ bool CMusicDatabase::GetSongsByWhere(const std::string &baseDir, const Filter &f
     if (!BuildSQL(strSQLExtra, extFilter, strSQLExtra))
       return false;
 
+    // with the cached order of the library only the ids of the listing and the rows on the page are read
+    if (extFilter.limit.empty() && (filter.fields.empty() || filter.fields.compare("*") == 0) &&
+        !IsSortOnPlayFields(sortDescription.sortBy))
+    {
+      int count = 0;
+      if (GetSortedPage(MediaTypeSong, strSQL, strSQLExtra, sortDescription, total, [&](const dbiplus::sql_record* const record)
+          {
+            CFileItemPtr item(new CFileItem);
+            GetFileItemFromDataset(record, item.get(), musicUrl);
+            // HACK for sorting by database returned order
+            item->m_iprogramCount = ++count;
+            items.Add(item);
+          }))
+      {
+        if (total > 0)
+          items.SetProperty("total", total);
+        return true;
+      }
+    }
+
     // Apply the limiting directly here if there's no special sorting but limiting
     if (extFilter.limit.empty() &&
         sortDescription.sortBy == SortByNone &&
@@ -4549,6 +4679,30 @@ bool CMusicDatabase::GetSongsByWhere(const std::string &baseDir, const Filter &f
     strSQL = PrepareSQL(strSQL, !filter.fields.empty() && filter.fields.compare("*") != 0 ? filter.fields.c_str() : "songview.*") + strSQLExtra;
 
     CLog::Log(LOGDEBUG, "%s query = %s", __FUNCTION__, strSQL.c_str());
+
+    // without sorting the rows are used in database order, so stream them
+    // instead of materializing the whole result set first
+    if (sortDescription.sortBy == SortByNone)
+    {
+      int count = 0;
+      int iRowsFound = StreamQuery(strSQL, [&](const dbiplus::sql_record& record)
+      {
+        CFileItemPtr item(new CFileItem);
+        GetFileItemFromDataset(&record, item.get(), musicUrl);
+        // HACK for sorting by database returned order
+        item->m_iprogramCount = ++count;
+        items.Add(item);
+      });
+      if (iRowsFound < 0)
+        return false;
+
+      if (total < iRowsFound)
+        total = iRowsFound;
+      if (iRowsFound > 0)
+        items.SetProperty("total", total);
+      return true;
+    }
+
     // run query
     if (!m_pDS->query(strSQL))
       return false;
@@ -5260,6 +5414,13 @@ void CMusicDatabase::UpdateTables(int version)
     // Update all songs iStartOffset and iEndOffset to milliseconds instead of frames (* 1000 / 75)
     m_pDS->exec("UPDATE song SET iStartOffset = iStartOffset * 40 / 3, iEndOffset = iEndOffset * 40 / 3 \n");
   }
+  if (version < 71)
+  {
+    // Filled by RebuildArtistSummary() once CreateAnalytics() has set up the triggers
+    m_pDS->exec("CREATE TABLE artistsummary (idArtist integer primary key, iSongs integer, iContributions integer, iAlbums integer)");
+  }
+  if (version < 73)
+    m_pDS->exec("CREATE TABLE libraryversion (iVersion integer)");
 
   // Set the verion of tag scanning required. 
   // Not every schema change requires the tags to be rescanned, set to the highest schema version 
@@ -5280,7 +5441,7 @@ void CMusicDatabase::UpdateTables(int version)
 
 int CMusicDatabase::GetSchemaVersion() const
 {
-  return 70;
+  return 74;
 }
 
 int CMusicDatabase::GetMusicNeedsTagScan()
@@ -7441,6 +7602,20 @@ bool CMusicDatabase::GetFilter(CDbUrl &musicUrl, Filter &filter, SortDescription
         filter.AppendWhere(PrepareSQL("artistview.idArtist IN (SELECT song_artist.idArtist FROM song_artist "
           "WHERE song_artist.idSong = %i %s)", idSong, strRoleSQL.c_str()));
       }
+      else if (idGenre <= 0 && (idRole < 0 || idRole == 1))
+      { // All artists of any role or of the default role, the song and album counts
+        // maintained in artistsummary answer this without visiting the link tables
+        ExistsSubQuery summarySub("artistsummary", "artistsummary.idArtist = artistview.idArtist");
+        if (albumArtistsOnly && idRole == 1)
+          summarySub.AppendWhere("artistsummary.iAlbums > 0");
+        else if (idRole < 0)
+          summarySub.AppendWhere("(artistsummary.iContributions > 0 OR artistsummary.iAlbums > 0)");
+        else
+          summarySub.AppendWhere("(artistsummary.iSongs > 0 OR artistsummary.iAlbums > 0)");
+        std::string summarySQL;
+        summarySub.BuildSQL(summarySQL);
+        filter.AppendWhere(summarySQL);
+      }
       else
       { // Artists can be only album artists, so for all artists (with linked albums or songs) 
         // we need to check both album_artist and song_artist tables.
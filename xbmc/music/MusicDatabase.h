@@ -116,6 +116,11 @@ public:
   void EmptyCache();
   void Clean();
   int  Cleanup(CGUIDialogProgress* progressDialog = nullptr);
+  /*! \brief Recompute the artistsummary table from the song and album artist links.
+   The table is kept up to date by triggers, this is the consistency check run on cleanup.
+   \return true if the summary was rebuilt, false otherwise.
+   */
+  bool RebuildArtistSummary();
   bool LookupCDDBInfo(bool bRequery=false);
   void DeleteCDDBInfo();
 
@@ -120,6 +120,7 @@ void CMusicInfoScanner::Process()
       // Reset progress vars
       m_currentItem=0;
       m_itemCount=-1;
+      StartScanRate();
 
       // Create the thread to count all files to be scanned
       if (m_handle)
@@ -147,7 +148,12 @@ void CMusicInfoScanner::Process()
           continue;
         }
 
+        // group the writes of the scan into a few transactions, committed at
+        // directory boundaries so an interrupted scan resumes where it stopped
+        m_musicDatabase.BeginBatch(g_advancedSettings.m_iMusicLibraryScanBatchItems,
+                                   g_advancedSettings.m_iMusicLibraryScanBatchTime);
         bool scancomplete = DoScan(*it);
+        m_musicDatabase.EndBatch();
         if (scancomplete)
         { 
           if (m_albumsAdded.size() > 0)
@@ -193,6 +199,7 @@ void CMusicInfoScanner::Process()
       
       tick = XbmcThreads::SystemClockMillis() - tick;
       CLog::Log(LOGNOTICE, "My Music: Scanning for music info using worker thread, operation took %s", StringUtils::SecondsToTimeString(tick / 1000).c_str());
+      CLog::Log(LOGNOTICE, "My Music: Scanned %u songs (%.1f songs/s)", m_scannedItems, GetScanRate());
     }
     if (m_scanType == 1) // load album info
     {
@@ -456,7 +463,7 @@ static std::string Prettify(const std::string& strDirectory)
 bool CMusicInfoScanner::DoScan(const std::string& strDirectory)
 {
   if (m_handle)
-    m_handle->SetText(Prettify(strDirectory));
+    m_handle->SetText(FormatScanRate(Prettify(strDirectory)));
 
   std::set<std::string>::const_iterator it = m_seenPaths.find(strDirectory);
   if (it != m_seenPaths.end())
@@ -495,7 +502,8 @@ bool CMusicInfoScanner::DoScan(const std::string& strDirectory)
     items.Sort(SortByLabel, SortOrderAscending);
 
     // and then scan in the new information from tags
-    if (RetrieveMusicInfo(strDirectory, items) > 0)
+    int numAdded = RetrieveMusicInfo(strDirectory, items);
+    if (numAdded > 0)
     {
       if (m_handle)
         OnDirectoryScanned(strDirectory);
@@ -503,6 +511,10 @@ bool CMusicInfoScanner::DoScan(const std::string& strDirectory)
 
     // save information about this folder
     m_musicDatabase.SetPathHash(strDirectory, hash);
+
+    // the folder and its hash are complete, so the batch may be committed here
+    AddScannedItems(numAdded);
+    m_musicDatabase.BatchCheckpoint(numAdded);
   }
   else
   { // path is the same - no need to rescan
@@ -0,0 +1,115 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "music/MusicDatabase.h"
+#include "settings/AdvancedSettings.h"
+#include "utils/StringUtils.h"
+
+#include "gtest/gtest.h"
+
+class TestMusicDatabase : public ::testing::Test
+{
+protected:
+  DatabaseSettings settings;
+  CMusicDatabase database;
+
+  void SetUp() override
+  {
+    settings.type = "sqlite3";
+    settings.host = CSpecialProtocol::TranslatePath("special://temp/");
+
+    database.Connect("testmusic", settings, true);
+  }
+
+  void TearDown() override
+  {
+    database.Close();
+    XFILE::CFile::Delete(settings.host + "testmusic.db");
+  }
+
+  std::string Summary(int idArtist)
+  {
+    return database.GetSingleValue(StringUtils::Format("SELECT iSongs || ',' || iContributions || ',' || iAlbums "
+                                                       "FROM artistsummary WHERE idArtist = %i", idArtist));
+  }
+};
+
+TEST_F(TestMusicDatabase, ArtistSummaryRelinkSongArtist)
+{
+  int idArtist = database.AddArtist("Artist", "");
+  ASSERT_GT(idArtist, 0);
+  EXPECT_EQ("0,0,0", Summary(idArtist));
+
+  EXPECT_TRUE(database.AddSongArtist(idArtist, 1, ROLE_ARTIST, "Artist", 0));
+  EXPECT_EQ("1,1,0", Summary(idArtist));
+
+  // linking the same song and role again keeps the counts
+  EXPECT_TRUE(database.AddSongArtist(idArtist, 1, ROLE_ARTIST, "Artist", 1));
+  EXPECT_EQ("1,1,0", Summary(idArtist));
+
+  // another role on the same song is a contribution only
+  EXPECT_TRUE(database.AddSongArtist(idArtist, 1, "Composer", "Artist", 0));
+  EXPECT_TRUE(database.AddSongArtist(idArtist, 1, "Composer", "Artist", 0));
+  EXPECT_EQ("1,2,0", Summary(idArtist));
+
+  EXPECT_TRUE(database.DeleteSongArtistsBySong(1));
+  EXPECT_EQ("0,0,0", Summary(idArtist));
+}
+
+TEST_F(TestMusicDatabase, ArtistSummaryRelinkAlbumArtist)
+{
+  int idArtist = database.AddArtist("Artist", "");
+  ASSERT_GT(idArtist, 0);
+
+  EXPECT_TRUE(database.AddAlbumArtist(idArtist, 1, "Artist", 0));
+  EXPECT_TRUE(database.AddAlbumArtist(idArtist, 1, "Artist", 1));
+  EXPECT_TRUE(database.AddAlbumArtist(idArtist, 2, "Artist", 0));
+  EXPECT_EQ("0,0,2", Summary(idArtist));
+
+  // the counts match a rebuild from the link tables
+  EXPECT_TRUE(database.RebuildArtistSummary());
+  EXPECT_EQ("0,0,2", Summary(idArtist));
+
+  EXPECT_TRUE(database.DeleteAlbumArtistsByAlbum(1));
+  EXPECT_EQ("0,0,1", Summary(idArtist));
+}
+
+TEST_F(TestMusicDatabase, LibraryVersionIgnoresPlayback)
+{
+  ASSERT_TRUE(database.ExecuteQuery("INSERT INTO song (idSong, idAlbum, idPath, strTitle, iTimesPlayed) VALUES (1, 1, 1, 'Title', 0)"));
+  std::string version = database.GetSingleValue("SELECT iVersion FROM libraryversion");
+  ASSERT_FALSE(version.empty());
+
+  // playing and rating a song keep the cached orders
+  EXPECT_TRUE(database.ExecuteQuery("UPDATE song SET iTimesPlayed=iTimesPlayed+1, lastplayed=CURRENT_TIMESTAMP WHERE idSong=1"));
+  EXPECT_TRUE(database.SetSongUserrating(1, 8));
+  EXPECT_EQ(version, database.GetSingleValue("SELECT iVersion FROM libraryversion"));
+
+  // changing a field the songs are sorted by drops them
+  EXPECT_TRUE(database.ExecuteQuery("UPDATE song SET strTitle='Other' WHERE idSong=1"));
+  EXPECT_NE(version, database.GetSingleValue("SELECT iVersion FROM libraryversion"));
+  version = database.GetSingleValue("SELECT iVersion FROM libraryversion");
+
+  // as does setting a nullable field for the first time
+  EXPECT_TRUE(database.ExecuteQuery("UPDATE song SET comment='Comment' WHERE idSong=1"));
+  EXPECT_NE(version, database.GetSingleValue("SELECT iVersion FROM libraryversion"));
+}
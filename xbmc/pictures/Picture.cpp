@@ -28,6 +28,7 @@
 #include "filesystem/File.h"
 #include "utils/log.h"
 #include "utils/URIUtils.h"
+#include "guilib/DDSImage.h"
 #include "guilib/Texture.h"
 #include "guilib/imagefactory.h"
 #include "cores/FFmpeg.h"
@@ -69,6 +70,11 @@ bool CPicture::GetThumbnailFromSurface(const unsigned char* buffer, int width, i
 bool CPicture::CreateThumbnailFromSurface(const unsigned char *buffer, int width, int height, int stride, const std::string &thumbFile)
 {
   CLog::Log(LOGDEBUG, "cached image '%s' size %dx%d", CURL::GetRedacted(thumbFile).c_str(), width, height);
+  if (URIUtils::HasExtension(thumbFile, ".dds"))
+  { // uncompressed, ready to upload to the GPU without decoding
+    CDDSImage dds;
+    return dds.Create(thumbFile, width, height, stride, buffer);
+  }
   if (URIUtils::HasExtension(thumbFile, ".jpg"))
   {
 #if defined(TARGET_RASPBERRY_PI)
@@ -140,6 +140,7 @@ CPVRManager::CPVRManager(void) :
     m_database(new CPVRDatabase),
     m_bFirstStart(true),
     m_bEpgsCreated(false),
+    m_iStartTime(0),
     m_managerState(ManagerStateStopped),
     m_parentalTimer(new CStopWatch),
     m_settings({
@@ -392,8 +393,14 @@ void CPVRManager::PublishEvent(PVREvent event)
   m_events.Publish(event);
 }
 
+unsigned int CPVRManager::GetTimeSinceStart(void) const
+{
+  return XbmcThreads::SystemClockMillis() - m_iStartTime;
+}
+
 void CPVRManager::Process(void)
 {
+  m_iStartTime = XbmcThreads::SystemClockMillis();
   m_addons->Continue();
   m_database->Open();
 
@@ -429,7 +436,7 @@ void CPVRManager::Process(void)
   m_pendingUpdates.Start();
 
   SetState(ManagerStateStarted);
-  CLog::Log(LOGNOTICE, "PVR Manager: Started");
+  CLog::Log(LOGNOTICE, "PVR Manager: Started after %u ms", GetTimeSinceStart());
 
   /* main loop */
   CLog::Log(LOGDEBUG, "PVRManager - %s - entering main loop", __FUNCTION__);
@@ -537,6 +544,8 @@ bool CPVRManager::LoadComponents(CPVRGUIProgressHandler* progressHandler)
   if (!m_channelGroups->Load() || !IsInitialising())
     return false;
 
+  CLog::Log(LOGDEBUG, "PVRManager - %s - channels loaded after %u ms", __FUNCTION__, GetTimeSinceStart());
+
   SetChanged();
   NotifyObservers(ObservableMessageChannelGroupsLoaded);
 
@@ -545,12 +554,14 @@ bool CPVRManager::LoadComponents(CPVRGUIProgressHandler* progressHandler)
     progressHandler->UpdateProgress(g_localizeStrings.Get(19237), 50); // Loading timers from clients
 
   m_timers->Load();
+  CLog::Log(LOGDEBUG, "PVRManager - %s - timers loaded after %u ms", __FUNCTION__, GetTimeSinceStart());
 
   /* get recordings from the backend */
   if (progressHandler)
     progressHandler->UpdateProgress(g_localizeStrings.Get(19238), 75); // Loading recordings from clients
 
   m_recordings->Load();
+  CLog::Log(LOGDEBUG, "PVRManager - %s - recordings loaded after %u ms", __FUNCTION__, GetTimeSinceStart());
 
   if (!IsInitialising())
     return false;
@@ -256,6 +256,12 @@ namespace PVR
       return GetState() == ManagerStateStarted;
     }
 
+    /*!
+     * @brief Get the time since the PVRManager started loading its data.
+     * @return The time in milliseconds.
+     */
+    unsigned int GetTimeSinceStart(void) const;
+
     /*!
      * @brief Check whether the PVRManager is stopping
      * @return True while the PVRManager is stopping.
@@ -586,6 +592,7 @@ namespace PVR
     CCriticalSection                m_critSection;                 /*!< critical section for all changes to this class, except for changes to triggers */
     bool                            m_bFirstStart;                 /*!< true when the PVR manager was started first, false otherwise */
     bool                            m_bEpgsCreated;                /*!< true if epg data for channels has been created */
+    unsigned int                    m_iStartTime;                  /*!< system clock time at which the PVR manager thread started loading its data */
 
     CCriticalSection                m_managerStateMutex;
     ManagerState                    m_managerState;
@@ -28,6 +28,8 @@
 #include "addons/BinaryAddonCache.h"
 #include "guilib/LocalizeStrings.h"
 #include "messaging/ApplicationMessenger.h"
+#include "threads/SystemClock.h"
+#include "utils/JobManager.h"
 #include "utils/log.h"
 
 #include "pvr/PVRJobs.h"
@@ -53,6 +55,64 @@ namespace
     return iClientId;
   }
 
+  /*!
+   * @brief Interval at which clients that did not finish a parallel call yet are reported.
+   */
+  const unsigned int PVR_CLIENT_CALL_LOG_INTERVAL = 10000; // ms
+
+  /*!
+   * @brief A call of a function for a set of clients, made in parallel with one job per client.
+   */
+  class CPVRClientsCall
+  {
+  public:
+    CPVRClientsCall(const char* strFunctionName, const CPVRClientMap &clients, const CPVRClients::PVRClientFunction &function)
+    : m_strFunctionName(strFunctionName),
+      m_function(function),
+      m_errors(clients.size(), PVR_ERROR_NO_ERROR)
+    {
+      for (const auto &clientEntry : clients)
+        m_clients.push_back(clientEntry);
+    }
+
+    void Run()
+    {
+      unsigned int iStartTime = XbmcThreads::SystemClockMillis();
+      std::shared_ptr<CParallelJobs> jobs = CParallelJobs::Run(m_clients.size(), [this, iStartTime](unsigned int i) { Call(i, iStartTime); });
+
+      // the clients write into containers owned by the caller, so a slow client can only be reported, not abandoned
+      while (!jobs->Wait(PVR_CLIENT_CALL_LOG_INTERVAL))
+      {
+        for (size_t i = 0; i < m_clients.size(); ++i)
+        {
+          if (!jobs->IsFinished(i))
+            CLog::Log(LOGWARNING, "CPVRClients - %s - client '%s' is still running after %u ms",
+                      m_strFunctionName, m_clients[i].second->GetFriendlyName().c_str(), XbmcThreads::SystemClockMillis() - iStartTime);
+        }
+      }
+    }
+
+    size_t Size() const { return m_clients.size(); }
+    const std::pair<int, CPVRClientPtr> &Client(size_t i) const { return m_clients[i]; }
+    PVR_ERROR Error(size_t i) const { return m_errors[i]; }
+
+  private:
+    void Call(size_t i, unsigned int iStartTime)
+    {
+      m_errors[i] = m_function(m_clients[i].second);
+
+      // the data of this client is there now, no matter how long the other clients take
+      CLog::Log(LOGDEBUG, "CPVRClients - %s - client '%s' finished after %u ms, %u ms after the PVR manager started",
+                m_strFunctionName, m_clients[i].second->GetFriendlyName().c_str(), XbmcThreads::SystemClockMillis() - iStartTime,
+                CServiceBroker::GetPVRManager().GetTimeSinceStart());
+    }
+
+    const char* m_strFunctionName;
+    CPVRClients::PVRClientFunction m_function;
+    std::vector<std::pair<int, CPVRClientPtr>> m_clients;
+    std::vector<PVR_ERROR> m_errors;
+  };
+
 } // unnamed namespace
 
 CPVRClients::CPVRClients(void)
@@ -755,7 +815,7 @@ bool CPVRClients::SupportsTimers() const
 
 bool CPVRClients::GetTimers(CPVRTimersContainer *timers, std::vector<int> &failedClients)
 {
-  return ForCreatedClients(__FUNCTION__, [timers](const CPVRClientPtr &client) {
+  return ForCreatedClientsInParallel(__FUNCTION__, [timers](const CPVRClientPtr &client) {
     return client->GetTimers(timers);
   }, failedClients) == PVR_ERROR_NO_ERROR;
 }
@@ -905,7 +965,10 @@ PVR_ERROR CPVRClients::IsPlayable(const CConstPVREpgInfoTagPtr& tag, bool &bIsPl
 
 PVR_ERROR CPVRClients::GetChannels(CPVRChannelGroupInternal *group, std::vector<int> &failedClients)
 {
-  return ForCreatedClients(__FUNCTION__, [group](const CPVRClientPtr &client) {
+  /* every client adds its channels to the group while it transfers them, the group serialises the
+   * updates. callers merge the group by client id and unique channel id, so the order in which the
+   * clients finish does not change how new channels are numbered */
+  return ForCreatedClientsInParallel(__FUNCTION__, [group](const CPVRClientPtr &client) {
     return client->GetChannels(*group, group->IsRadio());
   }, failedClients);
 }
@@ -1124,6 +1187,35 @@ PVR_ERROR CPVRClients::ForCreatedClients(const char* strFunctionName, PVRClientF
   return lastError;
 }
 
+PVR_ERROR CPVRClients::ForCreatedClientsInParallel(const char* strFunctionName, PVRClientFunction function, std::vector<int> &failedClients) const
+{
+  PVR_ERROR lastError = PVR_ERROR_NO_ERROR;
+
+  CPVRClientMap clients;
+  GetCreatedClients(clients, failedClients);
+  if (clients.empty())
+    return lastError;
+
+  CPVRClientsCall call(strFunctionName, clients, function);
+  call.Run();
+
+  for (size_t i = 0; i < call.Size(); ++i)
+  {
+    const CPVRClientPtr &client = call.Client(i).second;
+    PVR_ERROR currentError = call.Error(i);
+
+    if (currentError != PVR_ERROR_NO_ERROR && currentError != PVR_ERROR_NOT_IMPLEMENTED)
+    {
+      CLog::Log(LOGERROR,
+                "CPVRClients - %s - client '%s' returned an error: %s",
+                strFunctionName, client->GetFriendlyName().c_str(), CPVRClient::ToString(currentError));
+      lastError = currentError;
+      failedClients.emplace_back(call.Client(i).first);
+    }
+  }
+  return lastError;
+}
+
 PVR_ERROR CPVRClients::ForCreatedClient(const char* strFunctionName, int iClientId, PVRClientFunction function) const
 {
   PVR_ERROR error = PVR_ERROR_UNKNOWN;
@@ -62,6 +62,8 @@ namespace PVR
   class CPVRClients : public ADDON::IAddonMgrCallback
   {
   public:
+    typedef std::function<PVR_ERROR(const CPVRClientPtr&)> PVRClientFunction;
+
     CPVRClients(void);
     ~CPVRClients(void) override;
 
@@ -638,6 +640,16 @@ namespace PVR
      */
     void ConnectionStateChange(CPVRClient *client, std::string &strConnectionString, PVR_CONNECTION_STATE newState, std::string &strMessage);
 
+    /*!
+     * @brief Call a function for all created clients in parallel, so that a slow client does not delay the others.
+     *        The function and the add-on callbacks it triggers must not need a lock held by the calling thread.
+     * @param strFunctionName The function name, for logging purposes.
+     * @param function The function to call. It has to have return type PVR_ERROR and must take a const reference to a CPVRClientPtr as parameter.
+     * @param failedClients Contains a list of the ids of clients for that the call failed, if any.
+     * @return PVR_ERROR_NO_ERROR on success, any other PVR_ERROR_* value otherwise.
+     */
+    PVR_ERROR ForCreatedClientsInParallel(const char* strFunctionName, PVRClientFunction function, std::vector<int> &failedClients) const;
+
   private:
     /*!
      * @brief Get the client instance for a given client id.
@@ -669,8 +681,6 @@ namespace PVR
      */
     PVR_ERROR GetCreatedClients(CPVRClientMap &clientsReady, std::vector<int> &clientsNotReady) const;
 
-    typedef std::function<PVR_ERROR(const CPVRClientPtr&)> PVRClientFunction;
-
     /*!
      * @brief Wraps calls to all created clients in order to do common pre and post function invocation actions.
      * @param strFunctionName The function name, for logging purposes.
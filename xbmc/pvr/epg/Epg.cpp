@@ -20,7 +20,10 @@
 
 #include "Epg.h"
 
+#include <algorithm>
+#include <functional>
 #include <utility>
+#include <vector>
 
 #include "addons/kodi-addon-dev-kit/include/kodi/xbmc_epg_types.h"
 #include "EpgContainer.h"
@@ -30,6 +33,7 @@
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #include "utils/log.h"
 
 #include "pvr/PVRManager.h"
@@ -39,6 +43,29 @@
 
 using namespace PVR;
 
+namespace
+{
+  time_t GetAsTime(const CDateTime &dateTime)
+  {
+    time_t time = 0;
+    dateTime.GetAsTime(time);
+    return time;
+  }
+
+  /*!
+   * @brief Get the UTC day a time falls into.
+   */
+  time_t GetDay(time_t time)
+  {
+    return time / (24 * 60 * 60);
+  }
+
+  void HashCombine(std::size_t &hash, std::size_t value)
+  {
+    hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  }
+}
+
 CPVREpg::CPVREpg(int iEpgID, const std::string &strName /* = "" */, const std::string &strScraperName /* = "" */, bool bLoadedFromDb /* = false */) :
     m_bChanged(!bLoadedFromDb),
     m_bTagsChanged(false),
@@ -47,6 +74,7 @@ CPVREpg::CPVREpg(int iEpgID, const std::string &strName /* = "" */, const std::s
     m_iEpgID(iEpgID),
     m_strName(strName),
     m_strScraperName(strScraperName),
+    m_nowActiveStart(0),
     m_bUpdateLastScanTime(false)
 {
 }
@@ -59,6 +87,7 @@ CPVREpg::CPVREpg(const CPVRChannelPtr &channel, bool bLoadedFromDb /* = false */
     m_iEpgID(channel->EpgID()),
     m_strName(channel->ChannelName()),
     m_strScraperName(channel->EPGScraper()),
+    m_nowActiveStart(0),
     m_pvrChannel(channel),
     m_bUpdateLastScanTime(false)
 {
@@ -70,6 +99,7 @@ CPVREpg::CPVREpg(void) :
     m_bLoaded(false),
     m_bUpdatePending(false),
     m_iEpgID(0),
+    m_nowActiveStart(0),
     m_bUpdateLastScanTime(false)
 {
 }
@@ -91,9 +121,14 @@ CPVREpg &CPVREpg::operator =(const CPVREpg &right)
   m_nowActiveStart    = right.m_nowActiveStart;
   m_lastScanTime      = right.m_lastScanTime;
   m_pvrChannel        = right.m_pvrChannel;
+  m_dayHashes.clear();
 
-  for (std::map<CDateTime, CPVREpgInfoTagPtr>::const_iterator it = right.m_tags.begin(); it != right.m_tags.end(); ++it)
-    m_tags.insert(make_pair(it->first, it->second));
+  for (const auto &entry : right.m_tags)
+  {
+    EpgTags::iterator it = LowerBound(entry.start);
+    if (it == m_tags.end() || it->start != entry.start)
+      m_tags.insert(it, entry);
+  }
 
   return *this;
 }
@@ -134,13 +169,14 @@ bool CPVREpg::HasValidEntries(void) const
 
   return (m_iEpgID > 0 && /* valid EPG ID */
       !m_tags.empty()  && /* contains at least 1 tag */
-      m_tags.rbegin()->second->EndAsUTC() >= CDateTime::GetCurrentDateTime().GetAsUTCDateTime()); /* the last end time hasn't passed yet */
+      m_tags.back().tag->EndAsUTC() >= CDateTime::GetCurrentDateTime().GetAsUTCDateTime()); /* the last end time hasn't passed yet */
 }
 
 void CPVREpg::Clear(void)
 {
   CSingleLock lock(m_critSection);
   m_tags.clear();
+  m_dayHashes.clear();
 }
 
 void CPVREpg::Cleanup(void)
@@ -153,54 +189,60 @@ void CPVREpg::Cleanup(void)
 void CPVREpg::Cleanup(const CDateTime &Time)
 {
   CSingleLock lock(m_critSection);
-  for (std::map<CDateTime, CPVREpgInfoTagPtr>::iterator it = m_tags.begin(); it != m_tags.end();)
+  EpgTags::iterator last = m_tags.begin();
+  for (EpgTags::iterator it = m_tags.begin(); it != m_tags.end(); ++it)
   {
-    if (it->second->EndAsUTC() < Time)
+    if (it->tag->EndAsUTC() < Time)
     {
-      if (m_nowActiveStart == it->first)
-        m_nowActiveStart.SetValid(false);
+      if (m_nowActiveStart == it->start)
+        m_nowActiveStart = 0;
 
-      it->second->ClearTimer();
-      it->second->ClearRecording();
-      it = m_tags.erase(it);
+      it->tag->ClearTimer();
+      it->tag->ClearRecording();
     }
     else
     {
-      ++it;
+      if (last != it)
+        *last = std::move(*it);
+      ++last;
     }
   }
+  m_tags.erase(last, m_tags.end());
+
+  /* forget the days that were cleaned up, the client may send them again */
+  m_dayHashes.erase(m_dayHashes.begin(), m_dayHashes.lower_bound(GetDay(GetAsTime(Time)) + 1));
 }
 
 CPVREpgInfoTagPtr CPVREpg::GetTagNow(bool bUpdateIfNeeded /* = true */) const
 {
   CSingleLock lock(m_critSection);
-  if (m_nowActiveStart.IsValid())
+  if (m_nowActiveStart != 0)
   {
-    std::map<CDateTime, CPVREpgInfoTagPtr>::const_iterator it = m_tags.find(m_nowActiveStart);
-    if (it != m_tags.end() && it->second->IsActive())
-      return it->second;
+    EpgTags::const_iterator it = FindEntry(m_nowActiveStart);
+    if (it != m_tags.end() && it->tag->IsActive())
+      return it->tag;
   }
 
-  if (bUpdateIfNeeded)
+  if (bUpdateIfNeeded && !m_tags.empty())
   {
-    CPVREpgInfoTagPtr lastActiveTag;
-
-    /* one of the first items will always match if the list is sorted */
-    for (std::map<CDateTime, CPVREpgInfoTagPtr>::const_iterator it = m_tags.begin(); it != m_tags.end(); ++it)
+    /* overlapping events are fixed on update, so the last event that started is the active one */
+    time_t now = GetAsTime(m_tags.front().tag->GetCurrentPlayingTime());
+    EpgTags::const_iterator it = std::upper_bound(m_tags.begin(), m_tags.end(), now,
+                                                  [](time_t time, const EpgTagEntry &entry) { return time < entry.start; });
+    if (it != m_tags.begin())
     {
-      if (it->second->IsActive())
+      const CPVREpgInfoTagPtr &lastTag = (--it)->tag;
+      if (lastTag->IsActive())
       {
-        m_nowActiveStart = it->first;
-        return it->second;
+        m_nowActiveStart = it->start;
+        return lastTag;
       }
-      else if (it->second->WasActive())
-        lastActiveTag = it->second;
-    }
 
-    /* there might be a gap between the last and next event. return the last if found and it ended not more than 5 minutes ago */
-    if (lastActiveTag &&
-        lastActiveTag->EndAsUTC() + CDateTimeSpan(0, 0, 5, 0) >= CDateTime::GetUTCDateTime())
-      return lastActiveTag;
+      /* there might be a gap between the last and next event. return the last if found and it ended not more than 5 minutes ago */
+      if (lastTag->WasActive() &&
+          lastTag->EndAsUTC() + CDateTimeSpan(0, 0, 5, 0) >= CDateTime::GetUTCDateTime())
+        return lastTag;
+    }
   }
 
   return CPVREpgInfoTagPtr();
@@ -212,17 +254,21 @@ CPVREpgInfoTagPtr CPVREpg::GetTagNext() const
   if (nowTag)
   {
     CSingleLock lock(m_critSection);
-    std::map<CDateTime, CPVREpgInfoTagPtr>::const_iterator it = m_tags.find(nowTag->StartAsUTC());
+    EpgTags::const_iterator it = FindEntry(GetAsTime(nowTag->StartAsUTC()));
     if (it != m_tags.end() && ++it != m_tags.end())
-      return it->second;
+      return it->tag;
   }
-  else if (Size() > 0)
+  else
   {
-    /* return the first event that is in the future */
-    for (std::map<CDateTime, CPVREpgInfoTagPtr>::const_iterator it = m_tags.begin(); it != m_tags.end(); ++it)
+    CSingleLock lock(m_critSection);
+    if (!m_tags.empty())
     {
-      if (it->second->IsUpcoming())
-        return it->second;
+      /* return the first event that is in the future */
+      time_t now = GetAsTime(m_tags.front().tag->GetCurrentPlayingTime());
+      EpgTags::const_iterator it = std::upper_bound(m_tags.begin(), m_tags.end(), now,
+                                                    [](time_t time, const EpgTagEntry &entry) { return time < entry.start; });
+      if (it != m_tags.end())
+        return it->tag;
     }
   }
 
@@ -249,10 +295,10 @@ CPVREpgInfoTagPtr CPVREpg::GetTagByBroadcastId(unsigned int iUniqueBroadcastId)
   if (iUniqueBroadcastId != EPG_TAG_INVALID_UID)
   {
     CSingleLock lock(m_critSection);
-    for (const auto &infoTag : m_tags)
+    for (const auto &entry : m_tags)
     {
-      if (infoTag.second->UniqueBroadcastID() == iUniqueBroadcastId)
-        return infoTag.second;
+      if (entry.tag->UniqueBroadcastID() == iUniqueBroadcastId)
+        return entry.tag;
     }
   }
   return CPVREpgInfoTagPtr();
@@ -261,10 +307,10 @@ CPVREpgInfoTagPtr CPVREpg::GetTagByBroadcastId(unsigned int iUniqueBroadcastId)
 CPVREpgInfoTagPtr CPVREpg::GetTagBetween(const CDateTime &beginTime, const CDateTime &endTime) const
 {
   CSingleLock lock(m_critSection);
-  for (std::map<CDateTime, CPVREpgInfoTagPtr>::const_iterator it = m_tags.begin(); it != m_tags.end(); ++it)
+  for (EpgTags::const_iterator it = LowerBound(GetAsTime(beginTime)); it != m_tags.end(); ++it)
   {
-    if (it->second->StartAsUTC() >= beginTime && it->second->EndAsUTC() <= endTime)
-      return it->second;
+    if (it->tag->EndAsUTC() <= endTime)
+      return it->tag;
   }
 
   return CPVREpgInfoTagPtr();
@@ -275,15 +321,12 @@ std::vector<CPVREpgInfoTagPtr> CPVREpg::GetTagsBetween(const CDateTime &beginTim
   std::vector<CPVREpgInfoTagPtr> epgTags;
 
   CSingleLock lock(m_critSection);
-  for (const auto &infoTag : m_tags)
+  for (EpgTags::const_iterator it = LowerBound(GetAsTime(beginTime)); it != m_tags.end(); ++it)
   {
-    if (infoTag.second->StartAsUTC() >= beginTime)
-    {
-      if (infoTag.second->EndAsUTC() <= endTime)
-        epgTags.emplace_back(infoTag.second);
-      else
-        break; // done.
-    }
+    if (it->tag->EndAsUTC() <= endTime)
+      epgTags.emplace_back(it->tag);
+    else
+      break; // done.
   }
 
   return epgTags;
@@ -295,13 +338,14 @@ void CPVREpg::AddEntry(const CPVREpgInfoTag &tag)
   CPVRChannelPtr channel;
   {
     CSingleLock lock(m_critSection);
-    std::map<CDateTime, CPVREpgInfoTagPtr>::iterator itr = m_tags.find(tag.StartAsUTC());
-    if (itr != m_tags.end())
-      newTag = itr->second;
+    time_t start = GetAsTime(tag.StartAsUTC());
+    EpgTags::iterator itr = LowerBound(start);
+    if (itr != m_tags.end() && itr->start == start)
+      newTag = itr->tag;
     else
     {
       newTag.reset(new CPVREpgInfoTag(this, m_pvrChannel, m_strName, m_pvrChannel ? m_pvrChannel->IconPath() : ""));
-      m_tags.insert(make_pair(tag.StartAsUTC(), newTag));
+      m_tags.insert(itr, EpgTagEntry{start, newTag});
     }
 
     channel = m_pvrChannel;
@@ -355,9 +399,30 @@ bool CPVREpg::UpdateEntries(const CPVREpg &epg, bool bStoreInDb /* = true */)
 #if EPG_DEBUGGING
   CLog::Log(LOGDEBUG, "EPG - {0} - {1} entries in memory before merging", __FUNCTION__, m_tags.size());
 #endif
-  /* copy over tags */
-  for (std::map<CDateTime, CPVREpgInfoTagPtr>::const_iterator it = epg.m_tags.begin(); it != epg.m_tags.end(); ++it)
-    UpdateEntry(it->second, bStoreInDb);
+  /* merge the tags day by day. days that the client sends unchanged since the last update are skipped */
+  for (EpgTags::const_iterator dayBegin = epg.m_tags.begin(); dayBegin != epg.m_tags.end();)
+  {
+    const time_t day = GetDay(dayBegin->start);
+    std::size_t hash(0);
+    EpgTags::const_iterator dayEnd = dayBegin;
+    for (; dayEnd != epg.m_tags.end() && GetDay(dayEnd->start) == day; ++dayEnd)
+    {
+      HashCombine(hash, dayEnd->tag->GetDatabaseHash());
+      HashCombine(hash, std::hash<std::string>()(dayEnd->tag->SeriesLink()));
+    }
+
+    std::map<time_t, std::size_t>::const_iterator dayHash = m_dayHashes.find(day);
+    if (dayHash == m_dayHashes.end() || dayHash->second != hash)
+    {
+      RemoveStaleEntries(dayBegin, dayEnd, bStoreInDb);
+
+      for (EpgTags::const_iterator it = dayBegin; it != dayEnd; ++it)
+        UpdateEntry(it->tag, bStoreInDb);
+
+      m_dayHashes[day] = hash;
+    }
+    dayBegin = dayEnd;
+  }
 
 #if EPG_DEBUGGING
   CLog::Log(LOGDEBUG, "EPG - {0} - {1} entries in memory after merging and before fixing", __FUNCTION__, m_tags.size());
@@ -417,17 +482,20 @@ bool CPVREpg::UpdateEntry(const CPVREpgInfoTagPtr &tag, bool bUpdateDatabase)
 
   {
     CSingleLock lock(m_critSection);
-    std::map<CDateTime, CPVREpgInfoTagPtr>::iterator it = m_tags.find(tag->StartAsUTC());
+    time_t start = GetAsTime(tag->StartAsUTC());
+    EpgTags::iterator it = LowerBound(start);
     bool bNewTag(false);
-    if (it != m_tags.end())
+    std::size_t previousHash(0);
+    if (it != m_tags.end() && it->start == start)
     {
-      infoTag = it->second;
+      infoTag = it->tag;
+      previousHash = infoTag->GetDatabaseHash();
     }
     else
     {
       infoTag.reset(new CPVREpgInfoTag(this, m_pvrChannel, m_strName, m_pvrChannel ? m_pvrChannel->IconPath() : ""));
       infoTag->SetUniqueBroadcastID(tag->UniqueBroadcastID());
-      m_tags.insert(std::make_pair(tag->StartAsUTC(), infoTag));
+      m_tags.insert(it, EpgTagEntry{start, infoTag});
       bNewTag = true;
     }
 
@@ -435,7 +503,8 @@ bool CPVREpg::UpdateEntry(const CPVREpgInfoTagPtr &tag, bool bUpdateDatabase)
     infoTag->SetEpg(this);
     infoTag->SetChannel(m_pvrChannel);
 
-    if (bUpdateDatabase)
+    /* only write the tag when its row in the database changes */
+    if (bUpdateDatabase && (bNewTag || infoTag->GetDatabaseHash() != previousHash))
       m_changedTags.insert(std::make_pair(infoTag->UniqueBroadcastID(), infoTag));
   }
 
@@ -450,6 +519,12 @@ bool CPVREpg::UpdateEntry(const CPVREpgInfoTagPtr &tag, EPG_EVENT_STATE newState
   bool bRet(true);
   bool bNotify(true);
 
+  {
+    /* the day no longer matches what the client sent with the last update */
+    CSingleLock lock(m_critSection);
+    m_dayHashes.erase(GetDay(GetAsTime(tag->StartAsUTC())));
+  }
+
   if (newState == EPG_EVENT_CREATED || newState == EPG_EVENT_UPDATED)
   {
     bRet = UpdateEntry(tag, bUpdateDatabase);
@@ -461,7 +536,7 @@ bool CPVREpg::UpdateEntry(const CPVREpgInfoTagPtr &tag, EPG_EVENT_STATE newState
     auto it = m_tags.begin();
     for (; it != m_tags.end(); ++it)
     {
-      if (it->second->UniqueBroadcastID() == tag->UniqueBroadcastID())
+      if (it->tag->UniqueBroadcastID() == tag->UniqueBroadcastID())
         break;
     }
 
@@ -474,13 +549,16 @@ bool CPVREpg::UpdateEntry(const CPVREpgInfoTagPtr &tag, EPG_EVENT_STATE newState
       // Respect epg linger time.
       int iPastDays = CServiceBroker::GetPVRManager().EpgContainer().GetPastDaysToDisplay();
       const CDateTime cleanupTime(CDateTime::GetUTCDateTime() - CDateTimeSpan(iPastDays, 0, 0, 0));
-      if (it->second->EndAsUTC() < cleanupTime)
+      if (it->tag->EndAsUTC() < cleanupTime)
       {
         if (bUpdateDatabase)
-          m_deletedTags.insert(std::make_pair(it->second->UniqueBroadcastID(), it->second));
+          m_deletedTags.insert(std::make_pair(it->tag->UniqueBroadcastID(), it->tag));
+
+        if (m_nowActiveStart == it->start)
+          m_nowActiveStart = 0;
 
-        it->second->ClearTimer();
-        it->second->ClearRecording();
+        it->tag->ClearTimer();
+        it->tag->ClearRecording();
         m_tags.erase(it);
       }
       else
@@ -562,8 +640,8 @@ int CPVREpg::Get(CFileItemList &results) const
 
   CSingleLock lock(m_critSection);
 
-  for (std::map<CDateTime, CPVREpgInfoTagPtr>::const_iterator it = m_tags.begin(); it != m_tags.end(); ++it)
-    results.Add(CFileItemPtr(new CFileItem(it->second)));
+  for (const auto &entry : m_tags)
+    results.Add(CFileItemPtr(new CFileItem(entry.tag)));
 
   return results.Size() - iInitialSize;
 }
@@ -577,10 +655,15 @@ int CPVREpg::Get(CFileItemList &results, const CPVREpgSearchFilter &filter) cons
 
   CSingleLock lock(m_critSection);
 
-  for (std::map<CDateTime, CPVREpgInfoTagPtr>::const_iterator it = m_tags.begin(); it != m_tags.end(); ++it)
+  /* skip the entries starting before the filter's start time, with a day to spare for the local time conversion */
+  EpgTags::const_iterator it = m_tags.begin();
+  if (filter.GetStartDateTime().IsValid())
+    it = LowerBound(GetAsTime(filter.GetStartDateTime()) - 24 * 60 * 60);
+
+  for (; it != m_tags.end(); ++it)
   {
-    if (filter.FilterEntry(it->second))
-      results.Add(CFileItemPtr(new CFileItem(it->second)));
+    if (filter.FilterEntry(it->tag))
+      results.Add(CFileItemPtr(new CFileItem(it->tag)));
   }
 
   return results.Size() - iInitialSize;
@@ -602,6 +685,10 @@ bool CPVREpg::Persist(void)
     return false;
   }
 
+  unsigned int iStartTime = XbmcThreads::SystemClockMillis();
+  size_t iChanges(0);
+  size_t iBytes(0);
+
   database->Lock();
 
   {
@@ -613,11 +700,19 @@ bool CPVREpg::Persist(void)
         m_iEpgID = iId;
     }
 
-    for (std::map<int, CPVREpgInfoTagPtr>::iterator it = m_deletedTags.begin(); it != m_deletedTags.end(); ++it)
-      database->Delete(*it->second);
+    std::vector<CPVREpgInfoTagPtr> tags;
+    tags.reserve(std::max(m_deletedTags.size(), m_changedTags.size()));
 
-    for (std::map<int, CPVREpgInfoTagPtr>::iterator it = m_changedTags.begin(); it != m_changedTags.end(); ++it)
-      it->second->Persist(false);
+    for (const auto &tag : m_deletedTags)
+      tags.push_back(tag.second);
+    iBytes += database->Delete(tags);
+
+    tags.clear();
+    for (const auto &tag : m_changedTags)
+      tags.push_back(tag.second);
+    iBytes += database->Persist(tags);
+
+    iChanges = m_deletedTags.size() + m_changedTags.size();
 
     if (m_bUpdateLastScanTime)
       database->PersistLastEpgScanTime(m_iEpgID, true);
@@ -632,6 +727,15 @@ bool CPVREpg::Persist(void)
   bool bRet = database->CommitInsertQueries();
 
   database->Unlock();
+
+  if (iChanges > 0)
+  {
+    unsigned int iDuration = XbmcThreads::SystemClockMillis() - iStartTime;
+    CLog::Log(LOGDEBUG, "EPG - %s - table '%s': persisted %u changed tags (%u bytes) in %u ms, %.0f changes/s",
+              __FUNCTION__, Name().c_str(), static_cast<unsigned int>(iChanges), static_cast<unsigned int>(iBytes), iDuration,
+              iDuration > 0 ? iChanges * 1000.0 / iDuration : static_cast<double>(iChanges) * 1000.0);
+  }
+
   return bRet;
 }
 
@@ -641,7 +745,7 @@ CDateTime CPVREpg::GetFirstDate(void) const
 
   CSingleLock lock(m_critSection);
   if (!m_tags.empty())
-    first = m_tags.begin()->second->StartAsUTC();
+    first = m_tags.front().tag->StartAsUTC();
 
   return first;
 }
@@ -652,7 +756,7 @@ CDateTime CPVREpg::GetLastDate(void) const
 
   CSingleLock lock(m_critSection);
   if (!m_tags.empty())
-    last = m_tags.rbegin()->second->StartAsUTC();
+    last = m_tags.back().tag->StartAsUTC();
 
   return last;
 }
@@ -667,43 +771,74 @@ bool CPVREpg::FixOverlappingEvents(bool bUpdateDb /* = false */)
   bool bReturn(true);
   CPVREpgInfoTagPtr previousTag, currentTag;
 
-  for (std::map<CDateTime, CPVREpgInfoTagPtr>::iterator it = m_tags.begin(); it != m_tags.end(); it != m_tags.end() ? it++ : it)
+  EpgTags::iterator last = m_tags.begin();
+  for (EpgTags::iterator it = m_tags.begin(); it != m_tags.end(); ++it)
   {
-    if (!previousTag)
-    {
-      previousTag = it->second;
-      continue;
-    }
-    currentTag = it->second;
+    currentTag = it->tag;
 
-    if (previousTag->EndAsUTC() >= currentTag->EndAsUTC())
+    if (previousTag && previousTag->EndAsUTC() >= currentTag->EndAsUTC())
     {
       // delete the current tag. it's completely overlapped
       if (bUpdateDb)
         m_deletedTags.insert(make_pair(currentTag->UniqueBroadcastID(), currentTag));
 
-      if (m_nowActiveStart == it->first)
-        m_nowActiveStart.SetValid(false);
+      if (m_nowActiveStart == it->start)
+        m_nowActiveStart = 0;
 
-      it->second->ClearTimer();
-      it->second->ClearRecording();
-      m_tags.erase(it++);
+      currentTag->ClearTimer();
+      currentTag->ClearRecording();
+      continue;
     }
-    else if (previousTag->EndAsUTC() > currentTag->StartAsUTC())
+
+    if (previousTag && previousTag->EndAsUTC() > currentTag->StartAsUTC())
     {
       previousTag->SetEndFromUTC(currentTag->StartAsUTC());
       if (bUpdateDb)
         m_changedTags.insert(make_pair(previousTag->UniqueBroadcastID(), previousTag));
+    }
+
+    previousTag = currentTag;
+    if (last != it)
+      *last = std::move(*it);
+    ++last;
+  }
+  m_tags.erase(last, m_tags.end());
+
+  return bReturn;
+}
+
+void CPVREpg::RemoveStaleEntries(EpgTags::const_iterator begin, EpgTags::const_iterator end, bool bUpdateDb)
+{
+  const time_t last = (end - 1)->start;
+  EpgTags::iterator it = LowerBound(begin->start);
+  while (it != m_tags.end() && it->start <= last)
+  {
+    while (begin != end && begin->start < it->start)
+      ++begin;
 
-      previousTag = it->second;
+    if (begin != end && begin->start == it->start)
+    {
+      ++it;
+      continue;
     }
-    else
+
+    /* the client no longer sends this tag */
+    if (bUpdateDb)
     {
-      previousTag = it->second;
+      std::map<int, CPVREpgInfoTagPtr>::iterator changed = m_changedTags.find(it->tag->UniqueBroadcastID());
+      if (changed != m_changedTags.end() && changed->second == it->tag)
+        m_changedTags.erase(changed);
+
+      m_deletedTags.insert(std::make_pair(it->tag->UniqueBroadcastID(), it->tag));
     }
-  }
 
-  return bReturn;
+    if (m_nowActiveStart == it->start)
+      m_nowActiveStart = 0;
+
+    it->tag->ClearTimer();
+    it->tag->ClearRecording();
+    it = m_tags.erase(it);
+  }
 }
 
 bool CPVREpg::UpdateFromScraper(time_t start, time_t end)
@@ -825,14 +960,34 @@ bool CPVREpg::LoadFromClients(time_t start, time_t end)
 CPVREpgInfoTagPtr CPVREpg::GetNextEvent(const CPVREpgInfoTag& tag) const
 {
   CSingleLock lock(m_critSection);
-  std::map<CDateTime, CPVREpgInfoTagPtr>::const_iterator it = m_tags.find(tag.StartAsUTC());
+  EpgTags::const_iterator it = FindEntry(GetAsTime(tag.StartAsUTC()));
   if (it != m_tags.end() && ++it != m_tags.end())
-    return it->second;
+    return it->tag;
 
   CPVREpgInfoTagPtr retVal;
   return retVal;
 }
 
+CPVREpg::EpgTags::iterator CPVREpg::LowerBound(time_t start)
+{
+  return std::lower_bound(m_tags.begin(), m_tags.end(), start,
+                          [](const EpgTagEntry &entry, time_t time) { return entry.start < time; });
+}
+
+CPVREpg::EpgTags::const_iterator CPVREpg::LowerBound(time_t start) const
+{
+  return std::lower_bound(m_tags.begin(), m_tags.end(), start,
+                          [](const EpgTagEntry &entry, time_t time) { return entry.start < time; });
+}
+
+CPVREpg::EpgTags::const_iterator CPVREpg::FindEntry(time_t start) const
+{
+  EpgTags::const_iterator it = LowerBound(start);
+  if (it != m_tags.end() && it->start != start)
+    return m_tags.end();
+  return it;
+}
+
 CPVRChannelPtr CPVREpg::Channel(void) const
 {
   CSingleLock lock(m_critSection);
@@ -856,8 +1011,8 @@ void CPVREpg::SetChannel(const PVR::CPVRChannelPtr &channel)
       channel->SetEpgID(m_iEpgID);
     }
     m_pvrChannel = channel;
-    for (std::map<CDateTime, CPVREpgInfoTagPtr>::iterator it = m_tags.begin(); it != m_tags.end(); ++it)
-      it->second->SetChannel(m_pvrChannel);
+    for (const auto &entry : m_tags)
+      entry.tag->SetChannel(m_pvrChannel);
   }
 }
 
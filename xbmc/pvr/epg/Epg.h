@@ -324,7 +324,41 @@ namespace PVR
      */
     bool UpdateEntries(const CPVREpg &epg, bool bStoreInDb = true);
 
-    std::map<CDateTime, CPVREpgInfoTagPtr> m_tags;
+    /*!
+     * @brief An entry of this table. The start time in UTC is kept next to the tag so that time lookups
+     *        are a binary search over contiguous memory instead of a walk over the tags.
+     */
+    struct EpgTagEntry
+    {
+      time_t start;
+      CPVREpgInfoTagPtr tag;
+    };
+    typedef std::vector<EpgTagEntry> EpgTags;
+
+    /*!
+     * @brief Get the first entry starting at or after the given time.
+     * @param start The start time in UTC.
+     * @return The entry or m_tags.end() if all entries start before the given time.
+     */
+    EpgTags::iterator LowerBound(time_t start);
+    EpgTags::const_iterator LowerBound(time_t start) const;
+
+    /*!
+     * @brief Get the entry starting at the given time.
+     * @param start The start time in UTC.
+     * @return The entry or m_tags.end() if it wasn't found.
+     */
+    EpgTags::const_iterator FindEntry(time_t start) const;
+
+    /*!
+     * @brief Remove the entries starting within the time range of the given tags that are not among them.
+     * @param begin The first of the tags, sorted by start time.
+     * @param end The end of the tags.
+     * @param bUpdateDb If set to yes, the removed entries will be deleted from the database.
+     */
+    void RemoveStaleEntries(EpgTags::const_iterator begin, EpgTags::const_iterator end, bool bUpdateDb);
+
+    EpgTags                                m_tags;            /*!< the entries of this table, sorted by their unique start times */
     std::map<int, CPVREpgInfoTagPtr>       m_changedTags;
     std::map<int, CPVREpgInfoTagPtr>       m_deletedTags;
     bool                                m_bChanged;        /*!< true if anything changed that needs to be persisted, false otherwise */
@@ -334,7 +368,8 @@ namespace PVR
     int                                 m_iEpgID;          /*!< the database ID of this table */
     std::string                         m_strName;         /*!< the name of this table */
     std::string                         m_strScraperName;  /*!< the name of the scraper to use */
-    mutable CDateTime                   m_nowActiveStart;  /*!< the start time of the tag that is currently active */
+    mutable time_t                      m_nowActiveStart;  /*!< the start time in UTC of the tag that is currently active, 0 if unknown */
+    std::map<time_t, std::size_t>       m_dayHashes;       /*!< hash of the tags per UTC day as last received from the client */
 
     CDateTime                           m_lastScanTime;    /*!< the last time the EPG has been updated */
 
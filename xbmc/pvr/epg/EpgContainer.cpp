@@ -20,7 +20,9 @@
 
 #include "EpgContainer.h"
 
+#include <map>
 #include <utility>
+#include <vector>
 
 #include "Application.h"
 #include "ServiceBroker.h"
@@ -34,6 +36,7 @@
 
 #include "pvr/PVRManager.h"
 #include "pvr/PVRGUIProgressHandler.h"
+#include "pvr/addons/PVRClients.h"
 #include "pvr/channels/PVRChannelGroupsContainer.h"
 #include "pvr/epg/Epg.h"
 #include "pvr/epg/EpgSearchFilter.h"
@@ -682,40 +685,91 @@ bool CPVREpgContainer::UpdateEPG(bool bOnlyPending /* = false */)
   if (bShowProgress && !bOnlyPending)
     progressHandler = new CPVRGUIProgressHandler(g_localizeStrings.Get(19004)); // Importing guide from clients
 
-  /* load or update all EPG tables */
+  CCriticalSection updateSection;
   unsigned int iCounter(0);
-  for (const auto &epgEntry : m_epgs)
+  const int iUpdateTime = m_settings.GetIntValue(CSettings::SETTING_EPG_EPGUPDATE) * 60;
+
+  /* load or update an EPG table. returns false if the update was interrupted */
+  auto updateEpg = [&](const CPVREpgPtr &epg) -> bool
   {
     if (InterruptUpdate())
     {
+      CSingleLock lock(updateSection);
       bInterrupted = true;
-      break;
+      return false;
     }
 
-    CPVREpgPtr epg = epgEntry.second;
-    if (!epg)
-      continue;
-
     if (bShowProgress && !bOnlyPending)
-      progressHandler->UpdateProgress(epg->Name(), ++iCounter, m_epgs.size());
-
-    // we currently only support update via pvr add-ons. skip update when the pvr manager isn't started
-    if (!CServiceBroker::GetPVRManager().IsStarted())
-      continue;
-
-    // check the pvr manager when the channel pointer isn't set
-    if (!epg->Channel())
     {
-      CPVRChannelPtr channel = CServiceBroker::GetPVRManager().ChannelGroups()->GetChannelByEpgId(epg->EpgID());
-      if (channel)
-        epg->SetChannel(channel);
+      CSingleLock lock(updateSection);
+      progressHandler->UpdateProgress(epg->Name(), ++iCounter, m_epgs.size());
     }
 
-    if ((!bOnlyPending || epg->UpdatePending()) &&
-        epg->Update(start, end, m_settings.GetIntValue(CSettings::SETTING_EPG_EPGUPDATE) * 60, bOnlyPending))
+    bool bUpdated = (!bOnlyPending || epg->UpdatePending()) &&
+                    epg->Update(start, end, iUpdateTime, bOnlyPending);
+
+    CSingleLock lock(updateSection);
+    if (bUpdated)
       iUpdatedTables++;
     else if (!epg->IsValid())
       invalidTables.push_back(epg);
+    return true;
+  };
+
+  // we currently only support update via pvr add-ons. skip update when the pvr manager isn't started
+  if (CServiceBroker::GetPVRManager().IsStarted())
+  {
+    /* group the tables by client, tables of different clients are updated in parallel */
+    std::map<int, std::vector<CPVREpgPtr>> clientEpgs;
+    for (const auto &epgEntry : m_epgs)
+    {
+      CPVREpgPtr epg = epgEntry.second;
+      if (!epg)
+        continue;
+
+      // check the pvr manager when the channel pointer isn't set
+      if (!epg->Channel())
+      {
+        CPVRChannelPtr channel = CServiceBroker::GetPVRManager().ChannelGroups()->GetChannelByEpgId(epg->EpgID());
+        if (channel)
+          epg->SetChannel(channel);
+      }
+
+      const CPVRChannelPtr channel = epg->Channel();
+      clientEpgs[channel ? channel->ClientID() : PVR_INVALID_CLIENT_ID].push_back(epg);
+    }
+
+    std::vector<int> failedClients;
+    CServiceBroker::GetPVRManager().Clients()->ForCreatedClientsInParallel(__FUNCTION__,
+      [&clientEpgs, &updateEpg, &updateSection](const CPVRClientPtr &client)
+      {
+        std::vector<CPVREpgPtr> epgs;
+        {
+          CSingleLock lock(updateSection);
+          std::map<int, std::vector<CPVREpgPtr>>::iterator it = clientEpgs.find(client->GetID());
+          if (it == clientEpgs.end())
+            return PVR_ERROR_NO_ERROR;
+          epgs.swap(it->second);
+          clientEpgs.erase(it);
+        }
+
+        for (const auto &epg : epgs)
+        {
+          if (!updateEpg(epg))
+            break;
+        }
+        return PVR_ERROR_NO_ERROR;
+      }, failedClients);
+
+    /* tables without a channel or of clients that are not created */
+    for (const auto &epgs : clientEpgs)
+    {
+      for (const auto &epg : epgs.second)
+      {
+        if (!updateEpg(epg))
+          break;
+      }
+    }
   }
 
   if (bShowProgress && !bOnlyPending)
@@ -20,7 +20,9 @@
 
 #include "EpgDatabase.h"
 
+#include <algorithm>
 #include <cstdlib>
+#include <map>
 
 #include "addons/kodi-addon-dev-kit/include/kodi/xbmc_pvr_types.h"
 #include "dbwrappers/dataset.h"
@@ -33,6 +35,10 @@
 using namespace dbiplus;
 using namespace PVR;
 
+/* SQLite limits multi-row VALUES clauses to 500 rows, keep well below that and the MySQL packet size */
+#define EPG_BULK_WRITE_ROWS 250
+#define EPG_BULK_WRITE_SIZE (256 * 1024)
+
 bool CPVREpgDatabase::Open()
 {
   CSingleLock lock(m_critSection);
@@ -238,7 +244,7 @@ int CPVREpgDatabase::Get(CPVREpg &epg)
   int iReturn(-1);
 
   CSingleLock lock(m_critSection);
-  std::string strQuery = PrepareSQL("SELECT * FROM epgtags WHERE idEpg = %u;", epg.EpgID());
+  std::string strQuery = PrepareSQL("SELECT * FROM epgtags WHERE idEpg = %u ORDER BY iStartTime;", epg.EpgID());
   if (ResultQuery(strQuery))
   {
     iReturn = 0;
@@ -277,7 +283,7 @@ int CPVREpgDatabase::Get(CPVREpg &epg)
         newTag->m_strIMDBNumber      = m_pDS->fv("sIMDBNumber").get_asString().c_str();
         newTag->m_iGenreType         = m_pDS->fv("iGenreType").get_asInt();
         newTag->m_iGenreSubType      = m_pDS->fv("iGenreSubType").get_asInt();
-        newTag->m_genre              = newTag->Tokenize(m_pDS->fv("sGenre").get_asString());
+        newTag->m_genre              = std::make_shared<const std::vector<std::string>>(newTag->Tokenize(m_pDS->fv("sGenre").get_asString()));
         newTag->m_iParentalRating    = m_pDS->fv("iParentalRating").get_asInt();
         newTag->m_iStarRating        = m_pDS->fv("iStarRating").get_asInt();
         newTag->m_bNotify            = m_pDS->fv("bNotify").get_asBool();
@@ -370,51 +376,10 @@ int CPVREpgDatabase::Persist(const CPVREpgInfoTag &tag, bool bSingleUpdate /* =
     return iReturn;
   }
 
-  time_t iStartTime, iEndTime, iFirstAired;
-  tag.StartAsUTC().GetAsTime(iStartTime);
-  tag.EndAsUTC().GetAsTime(iEndTime);
-  tag.FirstAiredAsUTC().GetAsTime(iFirstAired);
-
-  int iBroadcastId = tag.BroadcastId();
-  std::string strQuery;
-
-  /* Only store the genre string when needed */
-  std::string strGenre = (tag.GenreType() == EPG_GENRE_USE_STRING) ? tag.DeTokenize(tag.Genre()) : "";
-
   CSingleLock lock(m_critSection);
 
-  if (iBroadcastId < 0)
-  {
-    strQuery = PrepareSQL("REPLACE INTO epgtags (idEpg, iStartTime, "
-        "iEndTime, sTitle, sPlotOutline, sPlot, sOriginalTitle, sCast, sDirector, sWriter, iYear, sIMDBNumber, "
-        "sIconPath, iGenreType, iGenreSubType, sGenre, iFirstAired, iParentalRating, iStarRating, bNotify, iSeriesId, "
-        "iEpisodeId, iEpisodePart, sEpisodeName, iFlags, iBroadcastUid) "
-        "VALUES (%u, %u, %u, '%s', '%s', '%s', '%s', '%s', '%s', '%s', %i, '%s', '%s', %i, %i, '%s', %u, %i, %i, %i, %i, %i, %i, '%s', %i, %i);",
-        tag.EpgID(), static_cast<unsigned int>(iStartTime), static_cast<unsigned int>(iEndTime),
-        tag.Title(true).c_str(), tag.PlotOutline(true).c_str(), tag.Plot(true).c_str(),
-        tag.OriginalTitle(true).c_str(), tag.DeTokenize(tag.Cast()).c_str(), tag.DeTokenize(tag.Directors()).c_str(),
-        tag.DeTokenize(tag.Writers()).c_str(), tag.Year(), tag.IMDBNumber().c_str(),
-        tag.Icon().c_str(), tag.GenreType(), tag.GenreSubType(), strGenre.c_str(),
-        static_cast<unsigned int>(iFirstAired), tag.ParentalRating(), tag.StarRating(), tag.Notify(),
-        tag.SeriesNumber(), tag.EpisodeNumber(), tag.EpisodePart(), tag.EpisodeName(true).c_str(), tag.Flags(),
-        tag.UniqueBroadcastID());
-  }
-  else
-  {
-    strQuery = PrepareSQL("REPLACE INTO epgtags (idEpg, iStartTime, "
-        "iEndTime, sTitle, sPlotOutline, sPlot, sOriginalTitle, sCast, sDirector, sWriter, iYear, sIMDBNumber, "
-        "sIconPath, iGenreType, iGenreSubType, sGenre, iFirstAired, iParentalRating, iStarRating, bNotify, iSeriesId, "
-        "iEpisodeId, iEpisodePart, sEpisodeName, iFlags, iBroadcastUid, idBroadcast) "
-        "VALUES (%u, %u, %u, '%s', '%s', '%s', '%s', '%s', '%s', '%s', %i, '%s', '%s', %i, %i, '%s', %u, %i, %i, %i, %i, %i, %i, '%s', %i, %i, %i);",
-        tag.EpgID(), static_cast<unsigned int>(iStartTime), static_cast<unsigned int>(iEndTime),
-        tag.Title(true).c_str(), tag.PlotOutline(true).c_str(), tag.Plot(true).c_str(),
-        tag.OriginalTitle(true).c_str(), tag.DeTokenize(tag.Cast()).c_str(), tag.DeTokenize(tag.Directors()).c_str(),
-        tag.DeTokenize(tag.Writers()).c_str(), tag.Year(), tag.IMDBNumber().c_str(),
-        tag.Icon().c_str(), tag.GenreType(), tag.GenreSubType(), strGenre.c_str(),
-        static_cast<unsigned int>(iFirstAired), tag.ParentalRating(), tag.StarRating(), tag.Notify(),
-        tag.SeriesNumber(), tag.EpisodeNumber(), tag.EpisodePart(), tag.EpisodeName(true).c_str(), tag.Flags(),
-        tag.UniqueBroadcastID(), iBroadcastId);
-  }
+  const std::string strQuery = StringUtils::Format("REPLACE INTO epgtags (%s) VALUES %s;",
+      GetTagColumns(tag.BroadcastId() >= 0).c_str(), GetTagValues(tag).c_str());
 
   if (bSingleUpdate)
   {
@@ -430,6 +395,127 @@ int CPVREpgDatabase::Persist(const CPVREpgInfoTag &tag, bool bSingleUpdate /* =
   return iReturn;
 }
 
+size_t CPVREpgDatabase::Persist(const std::vector<CPVREpgInfoTagPtr> &tags)
+{
+  size_t iBytes(0);
+
+  CSingleLock lock(m_critSection);
+
+  /* tags that were stored before replace their row by database ID, new tags get one assigned */
+  for (int iWithBroadcastId = 0; iWithBroadcastId <= 1; ++iWithBroadcastId)
+  {
+    const std::string strInsert = StringUtils::Format("REPLACE INTO epgtags (%s) VALUES ", GetTagColumns(iWithBroadcastId == 1).c_str());
+    std::string strQuery;
+    unsigned int iRows(0);
+
+    for (const auto &tag : tags)
+    {
+      if ((tag->BroadcastId() >= 0) != (iWithBroadcastId == 1))
+        continue;
+
+      if (tag->EpgID() <= 0)
+      {
+        CLog::Log(LOGERROR, "%s - tag '%s' does not have a valid table", __FUNCTION__, tag->Title(true).c_str());
+        continue;
+      }
+
+      strQuery += strQuery.empty() ? strInsert : ", ";
+      strQuery += GetTagValues(*tag);
+
+      if (++iRows >= EPG_BULK_WRITE_ROWS || strQuery.size() >= EPG_BULK_WRITE_SIZE)
+      {
+        strQuery += ";";
+        iBytes += strQuery.size();
+        QueueInsertQuery(strQuery);
+        strQuery.clear();
+        iRows = 0;
+      }
+    }
+
+    if (!strQuery.empty())
+    {
+      strQuery += ";";
+      iBytes += strQuery.size();
+      QueueInsertQuery(strQuery);
+    }
+  }
+
+  return iBytes;
+}
+
+size_t CPVREpgDatabase::Delete(const std::vector<CPVREpgInfoTagPtr> &tags)
+{
+  size_t iBytes(0);
+
+  /* tags written by a bulk persist don't know their database ID, so remove
+     them by table and start time, which is unique per table */
+  std::map<int, std::vector<std::string>> startTimesByEpg;
+  for (const auto &tag : tags)
+  {
+    if (tag->EpgID() <= 0)
+      continue;
+
+    time_t iStartTime;
+    tag->StartAsUTC().GetAsTime(iStartTime);
+    startTimesByEpg[tag->EpgID()].push_back(StringUtils::Format("%u", static_cast<unsigned int>(iStartTime)));
+  }
+
+  CSingleLock lock(m_critSection);
+
+  for (const auto &epg : startTimesByEpg)
+  {
+    for (size_t iOffset = 0; iOffset < epg.second.size(); iOffset += EPG_BULK_WRITE_ROWS)
+    {
+      const std::vector<std::string> startTimes(epg.second.begin() + iOffset,
+          epg.second.begin() + std::min(iOffset + static_cast<size_t>(EPG_BULK_WRITE_ROWS), epg.second.size()));
+      const std::string strQuery = StringUtils::Format("DELETE FROM epgtags WHERE idEpg = %u AND iStartTime IN (%s);",
+          epg.first, StringUtils::Join(startTimes, ",").c_str());
+      iBytes += strQuery.size();
+      QueueInsertQuery(strQuery);
+    }
+  }
+
+  return iBytes;
+}
+
+std::string CPVREpgDatabase::GetTagColumns(bool bWithBroadcastId) const
+{
+  std::string strColumns = "idEpg, iStartTime, iEndTime, sTitle, sPlotOutline, sPlot, sOriginalTitle, sCast, sDirector, sWriter, "
+      "iYear, sIMDBNumber, sIconPath, iGenreType, iGenreSubType, sGenre, iFirstAired, iParentalRating, iStarRating, bNotify, "
+      "iSeriesId, iEpisodeId, iEpisodePart, sEpisodeName, iFlags, iBroadcastUid";
+
+  if (bWithBroadcastId)
+    strColumns += ", idBroadcast";
+
+  return strColumns;
+}
+
+std::string CPVREpgDatabase::GetTagValues(const CPVREpgInfoTag &tag) const
+{
+  time_t iStartTime, iEndTime, iFirstAired;
+  tag.StartAsUTC().GetAsTime(iStartTime);
+  tag.EndAsUTC().GetAsTime(iEndTime);
+  tag.FirstAiredAsUTC().GetAsTime(iFirstAired);
+
+  /* Only store the genre string when needed */
+  std::string strGenre = (tag.GenreType() == EPG_GENRE_USE_STRING) ? tag.DeTokenize(tag.Genre()) : "";
+
+  std::string strValues = PrepareSQL("(%u, %u, %u, '%s', '%s', '%s', '%s', '%s', '%s', '%s', %i, '%s', '%s', %i, %i, '%s', %u, %i, %i, %i, %i, %i, %i, '%s', %i, %i",
+      tag.EpgID(), static_cast<unsigned int>(iStartTime), static_cast<unsigned int>(iEndTime),
+      tag.Title(true).c_str(), tag.PlotOutline(true).c_str(), tag.Plot(true).c_str(),
+      tag.OriginalTitle(true).c_str(), tag.DeTokenize(tag.Cast()).c_str(), tag.DeTokenize(tag.Directors()).c_str(),
+      tag.DeTokenize(tag.Writers()).c_str(), tag.Year(), tag.IMDBNumber().c_str(),
+      tag.Icon().c_str(), tag.GenreType(), tag.GenreSubType(), strGenre.c_str(),
+      static_cast<unsigned int>(iFirstAired), tag.ParentalRating(), tag.StarRating(), tag.Notify(),
+      tag.SeriesNumber(), tag.EpisodeNumber(), tag.EpisodePart(), tag.EpisodeName(true).c_str(), tag.Flags(),
+      tag.UniqueBroadcastID());
+
+  if (tag.BroadcastId() >= 0)
+    strValues += StringUtils::Format(", %i", tag.BroadcastId());
+
+  return strValues + ")";
+}
+
 int CPVREpgDatabase::GetLastEPGId(void)
 {
   CSingleLock lock(m_critSection);
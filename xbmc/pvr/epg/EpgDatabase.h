@@ -19,6 +19,9 @@
  *
  */
 
+#include <string>
+#include <vector>
+
 #include "XBDateTime.h"
 #include "dbwrappers/Database.h"
 #include "threads/CriticalSection.h"
@@ -154,6 +157,21 @@ namespace PVR
      */
     int Persist(const CPVREpgInfoTag &tag, bool bSingleUpdate = true);
 
+    /*!
+     * @brief Queue the writes of a set of infotags, using multi-row statements.
+     * @param tags The tags to persist.
+     * @return The size in bytes of the queued statements.
+     */
+    size_t Persist(const std::vector<CPVREpgInfoTagPtr> &tags);
+
+    /*!
+     * @brief Queue the removal of a set of EPG entries, using multi-row statements.
+     * Entries are matched by table and start time, so tags that were persisted in bulk and never got a database ID are removed too.
+     * @param tags The entries to remove.
+     * @return The size in bytes of the queued statements.
+     */
+    size_t Delete(const std::vector<CPVREpgInfoTagPtr> &tags);
+
     /*!
      * @return Last EPG id in the database
      */
@@ -180,6 +198,18 @@ namespace PVR
 
     int GetMinSchemaVersion() const override { return 4; }
 
+    /*!
+     * @brief Get the columns written by Persist for an infotag.
+     * @param bWithBroadcastId True to include the database ID of the tag.
+     */
+    std::string GetTagColumns(bool bWithBroadcastId) const;
+
+    /*!
+     * @brief Get the values written by Persist for an infotag, as a parenthesized row.
+     * @param tag The tag.
+     */
+    std::string GetTagValues(const CPVREpgInfoTag &tag) const;
+
     CCriticalSection m_critSection;
   };
 }
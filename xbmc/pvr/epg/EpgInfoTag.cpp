@@ -20,12 +20,16 @@
 
 #include "EpgInfoTag.h"
 
+#include <functional>
+#include <map>
+
 #include "ServiceBroker.h"
 #include "addons/kodi-addon-dev-kit/include/kodi/xbmc_pvr_types.h"
 #include "cores/DataCacheCore.h"
 #include "guilib/LocalizeStrings.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
+#include "threads/SingleLock.h"
 #include "utils/StringUtils.h"
 #include "utils/Variant.h"
 #include "utils/log.h"
@@ -39,6 +43,33 @@
 
 using namespace PVR;
 
+namespace
+{
+  /*!
+   * @brief Get the description of a genre type and subtype. Tags of a guide use a few dozen genres
+   *        at most, so the description is shared between them instead of copied into every tag.
+   */
+  std::shared_ptr<const std::vector<std::string>> GetGenreDescription(int iGenreType, int iGenreSubType)
+  {
+    static CCriticalSection genresSection;
+    static std::map<std::string, std::shared_ptr<const std::vector<std::string>>> genres;
+
+    const std::string &strGenre = CPVREpg::ConvertGenreIdToString(iGenreType, iGenreSubType);
+
+    CSingleLock lock(genresSection);
+    std::shared_ptr<const std::vector<std::string>> &genre = genres[strGenre];
+    if (!genre)
+      genre = std::make_shared<const std::vector<std::string>>(StringUtils::Split(strGenre, g_advancedSettings.m_videoItemSeparator));
+    return genre;
+  }
+
+  template<typename T>
+  void HashCombine(std::size_t &hash, const T &value)
+  {
+    hash ^= std::hash<T>()(value) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  }
+}
+
 CPVREpgInfoTagPtr CPVREpgInfoTag::CreateDefaultTag()
 {
   return CPVREpgInfoTagPtr(new CPVREpgInfoTag());
@@ -166,7 +197,7 @@ bool CPVREpgInfoTag::operator ==(const CPVREpgInfoTag& right) const
           m_writers            == right.m_writers &&
           m_iYear              == right.m_iYear &&
           m_strIMDBNumber      == right.m_strIMDBNumber &&
-          m_genre              == right.m_genre &&
+          Genre()              == right.Genre() &&
           m_strEpisodeName     == right.m_strEpisodeName &&
           m_strIconPath        == right.m_strIconPath &&
           m_strFileNameAndPath == right.m_strFileNameAndPath &&
@@ -199,7 +230,7 @@ void CPVREpgInfoTag::Serialize(CVariant &value) const
   value["writer"] = DeTokenize(m_writers);
   value["year"] = m_iYear;
   value["imdbnumber"] = m_strIMDBNumber;
-  value["genre"] = m_genre;
+  value["genre"] = Genre();
   value["filenameandpath"] = m_strFileNameAndPath;
   value["starttime"] = m_startTime.IsValid() ? m_startTime.GetAsDBDateTime() : StringUtils::Empty;
   value["endtime"] = m_endTime.IsValid() ? m_endTime.GetAsDBDateTime() : StringUtils::Empty;
@@ -442,7 +473,7 @@ const std::string CPVREpgInfoTag::GetWritersLabel() const
 
 const std::string CPVREpgInfoTag::GetGenresLabel() const
 {
-  return StringUtils::Join(m_genre, g_advancedSettings.m_videoItemSeparator);
+  return StringUtils::Join(Genre(), g_advancedSettings.m_videoItemSeparator);
 }
 
 int CPVREpgInfoTag::Year(void) const
@@ -465,12 +496,12 @@ void CPVREpgInfoTag::SetGenre(int iGenreType, int iGenreSubType, const char* str
     {
       /* Type and sub type are not given. No EPG color coding possible
        * Use the provided genre description as backup. */
-      m_genre = Tokenize(strGenre);
+      m_genre = std::make_shared<const std::vector<std::string>>(Tokenize(strGenre));
     }
     else
     {
       /* Determine the genre description from the type and subtype IDs */
-      m_genre = StringUtils::Split(CPVREpg::ConvertGenreIdToString(iGenreType, iGenreSubType), g_advancedSettings.m_videoItemSeparator);
+      m_genre = GetGenreDescription(iGenreType, iGenreSubType);
     }
   }
 }
@@ -487,7 +518,9 @@ int CPVREpgInfoTag::GenreSubType(void) const
 
 const std::vector<std::string> CPVREpgInfoTag::Genre(void) const
 {
-  return m_genre;
+  if (m_genre)
+    return *m_genre;
+  return std::vector<std::string>();
 }
 
 CDateTime CPVREpgInfoTag::FirstAiredAsUTC(void) const
@@ -628,7 +661,7 @@ bool CPVREpgInfoTag::Update(const CPVREpgInfoTag &tag, bool bUpdateBroadcastId /
         m_iUniqueBroadcastID != tag.m_iUniqueBroadcastID ||
         m_iUniqueChannelID   != tag.m_iUniqueChannelID ||
         EpgID()              != tag.EpgID() ||
-        m_genre              != tag.m_genre ||
+        Genre()              != tag.Genre() ||
         m_strIconPath        != tag.m_strIconPath ||
         m_iFlags             != tag.m_iFlags ||
         m_strSeriesLink      != tag.m_strSeriesLink
@@ -672,7 +705,7 @@ bool CPVREpgInfoTag::Update(const CPVREpgInfoTag &tag, bool bUpdateBroadcastId /
       else
       {
         /* Determine genre description by type/subtype */
-        m_genre = StringUtils::Split(CPVREpg::ConvertGenreIdToString(tag.m_iGenreType, tag.m_iGenreSubType), g_advancedSettings.m_videoItemSeparator);
+        m_genre = GetGenreDescription(tag.m_iGenreType, tag.m_iGenreSubType);
       }
       m_firstAired         = tag.m_firstAired;
       m_iParentalRating    = tag.m_iParentalRating;
@@ -693,6 +726,43 @@ bool CPVREpgInfoTag::Update(const CPVREpgInfoTag &tag, bool bUpdateBroadcastId /
   return bChanged;
 }
 
+std::size_t CPVREpgInfoTag::GetDatabaseHash(void) const
+{
+  time_t iStartTime, iEndTime, iFirstAired;
+  m_startTime.GetAsTime(iStartTime);
+  m_endTime.GetAsTime(iEndTime);
+  m_firstAired.GetAsTime(iFirstAired);
+
+  std::size_t hash(0);
+  HashCombine(hash, iStartTime);
+  HashCombine(hash, iEndTime);
+  HashCombine(hash, m_strTitle);
+  HashCombine(hash, m_strPlotOutline);
+  HashCombine(hash, m_strPlot);
+  HashCombine(hash, m_strOriginalTitle);
+  HashCombine(hash, DeTokenize(m_cast));
+  HashCombine(hash, DeTokenize(m_directors));
+  HashCombine(hash, DeTokenize(m_writers));
+  HashCombine(hash, m_iYear);
+  HashCombine(hash, m_strIMDBNumber);
+  HashCombine(hash, m_strIconPath);
+  HashCombine(hash, m_iGenreType);
+  HashCombine(hash, m_iGenreSubType);
+  if (m_iGenreType == EPG_GENRE_USE_STRING)
+    HashCombine(hash, DeTokenize(Genre()));
+  HashCombine(hash, iFirstAired);
+  HashCombine(hash, m_iParentalRating);
+  HashCombine(hash, m_iStarRating);
+  HashCombine(hash, m_bNotify);
+  HashCombine(hash, m_iSeriesNumber);
+  HashCombine(hash, m_iEpisodeNumber);
+  HashCombine(hash, m_iEpisodePart);
+  HashCombine(hash, m_strEpisodeName);
+  HashCombine(hash, m_iFlags);
+  HashCombine(hash, m_iUniqueBroadcastID);
+  return hash;
+}
+
 bool CPVREpgInfoTag::Persist(bool bSingleUpdate /* = true */)
 {
   bool bReturn = false;
@@ -451,6 +451,12 @@ namespace PVR
      */
     bool Update(const CPVREpgInfoTag &tag, bool bUpdateBroadcastId = true);
 
+    /*!
+     * @brief Get a hash of the information of this tag that is stored in the database.
+     * @return The hash. Tags with equal hashes produce the same database row.
+     */
+    std::size_t GetDatabaseHash(void) const;
+
     /*!
      * @return True if this tag has any series attributes, false otherwise
      */
@@ -476,6 +482,11 @@ namespace PVR
      */
     const std::string DeTokenize(const std::vector<std::string> &tokens) const;
 
+    /*!
+     * @brief Get current time, taking timeshifting into account.
+     */
+    CDateTime GetCurrentPlayingTime(void) const;
+
   private:
     /*!
      * @brief Change the genre of this event.
@@ -489,11 +500,6 @@ namespace PVR
      */
     void UpdatePath(void);
 
-    /*!
-     * @brief Get current time, taking timeshifting into account.
-     */
-    CDateTime GetCurrentPlayingTime(void) const;
-
     bool                     m_bNotify;            /*!< notify on start */
     int                      m_iClientId;          /*!< client id */
     int                      m_iBroadcastId;       /*!< database ID */
@@ -515,7 +521,7 @@ namespace PVR
     std::vector<std::string> m_writers;            /*!< writer(s) */
     int                      m_iYear;              /*!< year */
     std::string              m_strIMDBNumber;      /*!< imdb number */
-    std::vector<std::string> m_genre;              /*!< genre */
+    std::shared_ptr<const std::vector<std::string>> m_genre; /*!< genre, shared by all tags of a genre type unless the description is custom */
     std::string              m_strEpisodeName;     /*!< episode name */
     std::string              m_strIconPath;        /*!< the path to the icon */
     std::string              m_strFileNameAndPath; /*!< the filename and path */
@@ -0,0 +1,150 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string>
+#include <vector>
+
+#include "addons/kodi-addon-dev-kit/include/kodi/xbmc_epg_types.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "pvr/epg/Epg.h"
+#include "pvr/epg/EpgDatabase.h"
+#include "pvr/epg/EpgInfoTag.h"
+#include "settings/AdvancedSettings.h"
+#include "utils/StringUtils.h"
+
+#include "gtest/gtest.h"
+
+using namespace PVR;
+
+namespace
+{
+  /* 2017-07-14 10:00 UTC */
+  const time_t START = 17361 * 24 * 60 * 60 + 10 * 60 * 60;
+  const time_t HOUR = 60 * 60;
+}
+
+class TestEpgDatabase : public ::testing::Test
+{
+protected:
+  DatabaseSettings settings;
+  CPVREpgDatabase database;
+  CPVREpg epg1{1, "first"};
+  CPVREpg epg2{2, "second"};
+
+  void SetUp() override
+  {
+    settings.type = "sqlite3";
+    settings.host = CSpecialProtocol::TranslatePath("special://temp/");
+    ASSERT_TRUE(database.Connect("testepg", settings, true));
+  }
+
+  void TearDown() override
+  {
+    database.Close();
+    XFILE::CFile::Delete(settings.host + "testepg.db");
+  }
+
+  /*!
+   * @brief Create an event of a table, the way the add-on transfer callback does. It has no database ID.
+   */
+  CPVREpgInfoTagPtr CreateTag(CPVREpg &epg, time_t start, const std::string &strTitle)
+  {
+    EPG_TAG data = {};
+    data.iUniqueBroadcastId = static_cast<unsigned int>(start);
+    data.strTitle = strTitle.c_str();
+    data.startTime = start;
+    data.endTime = start + HOUR;
+
+    CPVREpgInfoTagPtr tag(new CPVREpgInfoTag(data, 1));
+    tag->SetEpg(&epg);
+    return tag;
+  }
+
+  void Persist(const std::vector<CPVREpgInfoTagPtr> &tags)
+  {
+    EXPECT_GT(database.Persist(tags), 0U);
+    EXPECT_TRUE(database.CommitInsertQueries());
+  }
+
+  void Delete(const std::vector<CPVREpgInfoTagPtr> &tags)
+  {
+    EXPECT_GT(database.Delete(tags), 0U);
+    EXPECT_TRUE(database.CommitInsertQueries());
+  }
+
+  std::string GetStoredTags(const CPVREpg &epg)
+  {
+    return database.GetSingleValue(StringUtils::Format("SELECT COUNT(*) FROM epgtags WHERE idEpg = %i", epg.EpgID()));
+  }
+
+  std::string GetStoredTitle(const CPVREpg &epg, time_t start)
+  {
+    return database.GetSingleValue(StringUtils::Format("SELECT sTitle FROM epgtags WHERE idEpg = %i AND iStartTime = %u",
+                                                       epg.EpgID(), static_cast<unsigned int>(start)));
+  }
+};
+
+TEST_F(TestEpgDatabase, PersistInBulk)
+{
+  Persist({ CreateTag(epg1, START, "First"), CreateTag(epg1, START + HOUR, "Second"), CreateTag(epg2, START, "Other") });
+  EXPECT_EQ("2", GetStoredTags(epg1));
+  EXPECT_EQ("1", GetStoredTags(epg2));
+  EXPECT_EQ("Second", GetStoredTitle(epg1, START + HOUR));
+
+  /* a changed event replaces the row of its table and start time */
+  Persist({ CreateTag(epg1, START + HOUR, "Second, renamed") });
+  EXPECT_EQ("2", GetStoredTags(epg1));
+  EXPECT_EQ("Second, renamed", GetStoredTitle(epg1, START + HOUR));
+  EXPECT_EQ("Other", GetStoredTitle(epg2, START));
+}
+
+TEST_F(TestEpgDatabase, DeleteTagsWithoutDatabaseId)
+{
+  const CPVREpgInfoTagPtr removed = CreateTag(epg1, START + HOUR, "Second");
+  Persist({ CreateTag(epg1, START, "First"), removed, CreateTag(epg1, START + 2 * HOUR, "Third"), CreateTag(epg2, START + HOUR, "Other") });
+  ASSERT_EQ(-1, removed->BroadcastId());
+
+  /* the tag is matched by table and start time, the other table keeps its tag at that time */
+  Delete({ removed });
+  EXPECT_EQ("2", GetStoredTags(epg1));
+  EXPECT_EQ("First", GetStoredTitle(epg1, START));
+  EXPECT_TRUE(GetStoredTitle(epg1, START + HOUR).empty());
+  EXPECT_EQ("Third", GetStoredTitle(epg1, START + 2 * HOUR));
+  EXPECT_EQ("Other", GetStoredTitle(epg2, START + HOUR));
+}
+
+TEST_F(TestEpgDatabase, PersistAndDeleteInChunks)
+{
+  /* more tags than fit into one statement */
+  std::vector<CPVREpgInfoTagPtr> tags;
+  for (int i = 0; i < 1000; ++i)
+    tags.push_back(CreateTag(i % 2 ? epg2 : epg1, START + i * HOUR, StringUtils::Format("Event %i", i)));
+
+  Persist(tags);
+  EXPECT_EQ("500", GetStoredTags(epg1));
+  EXPECT_EQ("500", GetStoredTags(epg2));
+
+  tags.resize(700);
+  Delete(tags);
+  EXPECT_EQ("150", GetStoredTags(epg1));
+  EXPECT_EQ("150", GetStoredTags(epg2));
+  EXPECT_EQ("Event 700", GetStoredTitle(epg1, START + 700 * HOUR));
+}
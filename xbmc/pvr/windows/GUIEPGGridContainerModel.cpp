@@ -20,11 +20,13 @@
 
 #include "GUIEPGGridContainerModel.h"
 
+#include <algorithm>
 #include <cmath>
 
 #include "FileItem.h"
 #include "ServiceBroker.h"
 #include "settings/Settings.h"
+#include "threads/SingleLock.h"
 #include "utils/Variant.h"
 
 #include "pvr/PVRManager.h"
@@ -38,6 +40,20 @@ using namespace PVR;
 
 static const unsigned int GRID_START_PADDING = 30; // minutes
 
+CGUIEPGGridContainerModel::CGUIEPGGridContainerModel(const CGUIEPGGridContainerModel &other) :
+  m_gridStart(other.m_gridStart),
+  m_gridEnd(other.m_gridEnd),
+  m_programmeItems(other.m_programmeItems),
+  m_channelItems(other.m_channelItems),
+  m_rulerItems(other.m_rulerItems),
+  m_epgItemsPtr(other.m_epgItemsPtr),
+  m_blocks(other.m_blocks),
+  m_blockSize(other.m_blockSize)
+{
+  CSingleLock lock(other.m_gridSection);
+  m_gridIndex = other.m_gridIndex;
+}
+
 void CGUIEPGGridContainerModel::SetInvalid()
 {
   for (const auto &programme : m_programmeItems)
@@ -50,14 +66,11 @@ void CGUIEPGGridContainerModel::SetInvalid()
 
 void CGUIEPGGridContainerModel::Reset()
 {
-  for (auto &channel : m_gridIndex)
+  CSingleLock lock(m_gridSection);
+  for (const auto &channel : m_gridIndex)
   {
-    for (const auto &block : channel)
-    {
-      if (block.item)
-        block.item->ClearProperties();
-    }
-    channel.clear();
+    for (const auto &gridItem : channel.items)
+      gridItem.item->ClearProperties();
   }
   m_gridIndex.clear();
 
@@ -165,118 +178,127 @@ void CGUIEPGGridContainerModel::Refresh(const std::unique_ptr<CFileItemList> &it
   else if (m_blocks < iBlocksPerPage)
     m_blocks = iBlocksPerPage;
 
-  m_gridIndex.reserve(m_channelItems.size());
-  const std::vector<GridItem> blocks(m_blocks);
+  // the channels are built when they are first shown
+  m_blockSize = fBlockSize;
+  CSingleLock lock(m_gridSection);
+  m_gridIndex.resize(m_channelItems.size());
+}
+
+int CGUIEPGGridContainerModel::GetFirstBlockFrom(const CDateTime &gridStart, const CDateTime &datetime)
+{
+  // the first block starting at or after datetime, i.e. the block of datetime rounded up
+  static const int blockSeconds = MINSPERBLOCK * 60;
 
-  for (size_t channel = 0; channel < m_channelItems.size(); ++channel)
+  if (gridStart > datetime)
+    return -((gridStart - datetime).GetSecondsTotal() / blockSeconds);
+
+  return ((datetime - gridStart).GetSecondsTotal() + blockSeconds - 1) / blockSeconds;
+}
+
+std::vector<CGUIEPGGridContainerModel::GridRun> CGUIEPGGridContainerModel::GetGridRuns(const std::vector<std::pair<CDateTime, CDateTime>> &events,
+                                                                                       const CDateTime &gridStart, const CDateTime &gridEnd, int iBlocks)
+{
+  std::vector<GridRun> runs;
+  int nextBlock = 0; // first block not taken by an earlier run
+
+  for (size_t i = 0; i < events.size() && nextBlock < iBlocks; ++i)
   {
-    m_gridIndex.emplace_back(blocks);
-
-    CDateTime gridCursor(m_gridStart); //reset cursor for new channel
-    unsigned long progIdx = m_epgItemsPtr[channel].start;
-    unsigned long lastIdx = m_epgItemsPtr[channel].stop;
-    int iEpgId            = m_programmeItems[progIdx]->GetEPGInfoTag()->EpgID();
-    int itemSize          = 1; // size of the programme in blocks
-    int savedBlock        = 0;
-    CFileItemPtr item;
-    CPVREpgInfoTagPtr tag;
-
-    for (int block = 0; block < m_blocks; ++block)
-    {
-      while (progIdx <= lastIdx)
-      {
-        item = m_programmeItems[progIdx];
-        tag = item->GetEPGInfoTag();
+    if (gridEnd <= events[i].first)
+      break;
 
-        // Note: Start block of an event is start-time-based calculated block + 1,
-        //       unless start times matches exactly the begin of a block.
+    // Note: An event takes the blocks whose start time lies within the event, so its start block
+    //       is the start-time-based calculated block + 1, unless start time matches exactly the
+    //       begin of a block. Events overlapping an earlier one only take the blocks left over.
+    int startBlock = std::max(nextBlock, GetFirstBlockFrom(gridStart, events[i].first));
+    int endBlock = std::min(iBlocks, GetFirstBlockFrom(gridStart, events[i].second));
+    if (startBlock >= endBlock)
+      continue;
 
-        if (tag->EpgID() != iEpgId || gridCursor < tag->StartAsUTC() || m_gridEnd <= tag->StartAsUTC())
-          break;
+    if (startBlock > nextBlock)
+      runs.push_back({ INVALID_INDEX, nextBlock, startBlock });
 
-        if (gridCursor < tag->EndAsUTC())
-        {
-          m_gridIndex[channel][block].item = item;
-          m_gridIndex[channel][block].progIndex = progIdx;
-          break;
-        }
+    runs.push_back({ static_cast<int>(i), startBlock, endBlock });
+    nextBlock = endBlock;
+  }
 
-        progIdx++;
-      }
+  if (nextBlock < iBlocks)
+    runs.push_back({ INVALID_INDEX, nextBlock, iBlocks });
 
-      gridCursor += blockDuration;
+  return runs;
+}
 
-      if (block == 0)
-        continue;
+std::vector<GridItem> &CGUIEPGGridContainerModel::GetGridChannel(int iChannel) const
+{
+  CSingleLock lock(m_gridSection);
+  GridChannel &channel = m_gridIndex[iChannel];
+  if (!channel.built)
+  {
+    BuildGridChannel(iChannel, channel.items);
+    channel.built = true;
+  }
+  return channel.items;
+}
 
-      const CFileItemPtr prevItem(m_gridIndex[channel][block - 1].item);
-      const CFileItemPtr currItem(m_gridIndex[channel][block].item);
+GridItem &CGUIEPGGridContainerModel::FindGridItem(int iChannel, int iBlock) const
+{
+  // the items cover every block of the grid, a block belongs to the last item starting at or before it
+  std::vector<GridItem> &items = GetGridChannel(iChannel);
+  auto it = std::upper_bound(items.begin(), items.end(), iBlock,
+                             [](int block, const GridItem &gridItem) { return block < gridItem.startBlock; });
+  return *(it - 1);
+}
 
-      if (block == m_blocks - 1 || prevItem != currItem)
-      {
-        // special handling for last block.
-        int blockDelta = -1;
-        int sizeDelta = 0;
-        if (block == m_blocks - 1 && prevItem == currItem)
-        {
-          itemSize++;
-          blockDelta = 0;
-          sizeDelta = 1;
-        }
-
-        if (prevItem)
-        {
-          m_gridIndex[channel][savedBlock].item->SetProperty("GenreType", prevItem->GetEPGInfoTag()->GenreType());
-        }
-        else
-        {
-          CPVREpgInfoTagPtr gapTag(CPVREpgInfoTag::CreateDefaultTag());
-          gapTag->SetChannel(m_channelItems[channel]->GetPVRChannelInfoTag());
-          CFileItemPtr gapItem(new CFileItem(gapTag));
-          for (int i = block + blockDelta; i >= block - itemSize + sizeDelta; --i)
-          {
-            m_gridIndex[channel][i].item = gapItem;
-          }
-        }
-
-        float fItemWidth = itemSize * fBlockSize;
-        m_gridIndex[channel][savedBlock].originWidth = fItemWidth;
-        m_gridIndex[channel][savedBlock].width = fItemWidth;
-
-        itemSize = 1;
-        savedBlock = block;
-
-        // special handling for last block.
-        if (block == m_blocks - 1 && prevItem != currItem)
-        {
-          if (currItem)
-          {
-            m_gridIndex[channel][savedBlock].item->SetProperty("GenreType", currItem->GetEPGInfoTag()->GenreType());
-          }
-          else
-          {
-            CPVREpgInfoTagPtr gapTag(CPVREpgInfoTag::CreateDefaultTag());
-            gapTag->SetChannel(m_channelItems[channel]->GetPVRChannelInfoTag());
-            CFileItemPtr gapItem(new CFileItem(gapTag));
-            m_gridIndex[channel][block].item = gapItem;
-          }
-
-          m_gridIndex[channel][savedBlock].originWidth = fBlockSize; // size always 1 block here
-          m_gridIndex[channel][savedBlock].width = fBlockSize;
-        }
-      }
-      else
-      {
-        itemSize++;
-      }
+void CGUIEPGGridContainerModel::BuildGridChannel(int iChannel, std::vector<GridItem> &items) const
+{
+  const unsigned long firstIdx = m_epgItemsPtr[iChannel].start;
+  const unsigned long lastIdx  = m_epgItemsPtr[iChannel].stop;
+  const int iEpgId             = m_programmeItems[firstIdx]->GetEPGInfoTag()->EpgID();
+
+  std::vector<std::pair<CDateTime, CDateTime>> events;
+  for (unsigned long progIdx = firstIdx; progIdx <= lastIdx; ++progIdx)
+  {
+    const CPVREpgInfoTagPtr tag = m_programmeItems[progIdx]->GetEPGInfoTag();
+    if (tag->EpgID() != iEpgId || m_gridEnd <= tag->StartAsUTC())
+      break;
+
+    events.emplace_back(tag->StartAsUTC(), tag->EndAsUTC());
+  }
+
+  for (const auto &run : GetGridRuns(events, m_gridStart, m_gridEnd, m_blocks))
+  {
+    if (run.eventIndex == INVALID_INDEX)
+    {
+      AddGapItem(items, iChannel, run.startBlock, run.endBlock);
+      continue;
     }
+
+    const int progIdx = firstIdx + run.eventIndex;
+    const CFileItemPtr &item = m_programmeItems[progIdx];
+    item->SetProperty("GenreType", item->GetEPGInfoTag()->GenreType());
+    AddGridItem(items, item, progIdx, run.startBlock, run.endBlock);
   }
 }
 
-void CGUIEPGGridContainerModel::FindChannelAndBlockIndex(int channelUid, unsigned int broadcastUid, int eventOffset, int &newChannelIndex, int &newBlockIndex) const
+void CGUIEPGGridContainerModel::AddGridItem(std::vector<GridItem> &items, const CFileItemPtr &item, int progIndex, int startBlock, int endBlock) const
 {
-  const CDateTimeSpan blockDuration(0, 0, MINSPERBLOCK, 0);
+  GridItem gridItem;
+  gridItem.item = item;
+  gridItem.progIndex = progIndex;
+  gridItem.startBlock = startBlock;
+  gridItem.originWidth = (endBlock - startBlock) * m_blockSize;
+  gridItem.width = gridItem.originWidth;
+  items.emplace_back(gridItem);
+}
+
+void CGUIEPGGridContainerModel::AddGapItem(std::vector<GridItem> &items, int iChannel, int startBlock, int endBlock) const
+{
+  CPVREpgInfoTagPtr gapTag(CPVREpgInfoTag::CreateDefaultTag());
+  gapTag->SetChannel(m_channelItems[iChannel]->GetPVRChannelInfoTag());
+  AddGridItem(items, CFileItemPtr(new CFileItem(gapTag)), INVALID_INDEX, startBlock, endBlock);
+}
 
+void CGUIEPGGridContainerModel::FindChannelAndBlockIndex(int channelUid, unsigned int broadcastUid, int eventOffset, int &newChannelIndex, int &newBlockIndex) const
+{
   newChannelIndex = INVALID_INDEX;
   newBlockIndex = INVALID_INDEX;
 
@@ -292,35 +314,16 @@ void CGUIEPGGridContainerModel::FindChannelAndBlockIndex(int channelUid, unsigne
     iCurrentChannel++;
   }
 
-  if (newChannelIndex != INVALID_INDEX)
+  if (newChannelIndex != INVALID_INDEX && broadcastUid > 0)
   {
     // find the block
-    CDateTime gridCursor(m_gridStart); //reset cursor for new channel
-    unsigned long progIdx = m_epgItemsPtr[newChannelIndex].start;
-    unsigned long lastIdx = m_epgItemsPtr[newChannelIndex].stop;
-    int iEpgId = m_programmeItems[progIdx]->GetEPGInfoTag()->EpgID();
-    CPVREpgInfoTagPtr tag;
-    for (int block = 0; block < m_blocks; ++block)
+    for (const auto &gridItem : GetGridChannel(newChannelIndex))
     {
-      while (progIdx <= lastIdx)
+      if (gridItem.progIndex != INVALID_INDEX && gridItem.item->GetEPGInfoTag()->UniqueBroadcastID() == broadcastUid)
       {
-        tag = m_programmeItems[progIdx]->GetEPGInfoTag();
-
-        if (tag->EpgID() != iEpgId || gridCursor < tag->StartAsUTC() || m_gridEnd <= tag->StartAsUTC())
-          break; // next block
-
-        if (gridCursor < tag->EndAsUTC())
-        {
-          if (broadcastUid > 0 && tag->UniqueBroadcastID() == broadcastUid)
-          {
-            newBlockIndex = block + eventOffset;
-            return; // done.
-          }
-          break; // next block
-        }
-        progIdx++;
+        newBlockIndex = gridItem.startBlock + eventOffset;
+        return; // done.
       }
-      gridCursor += blockDuration;
     }
   }
 }
@@ -357,39 +360,20 @@ void CGUIEPGGridContainerModel::FreeProgrammeMemory(int channel, int keepStart,
 {
   if (keepStart < keepEnd)
   {
-    // remove before keepStart and after keepEnd
-    if (keepStart > 0 && keepStart < m_blocks)
+    CSingleLock lock(m_gridSection);
+    const GridChannel &gridChannel = m_gridIndex[channel];
+    if (!gridChannel.built)
+      return; // nothing shown yet
+
+    // remove the items entirely before keepStart and after keepEnd, partially visible ones stay
+    const bool freeBefore = keepStart > 0 && keepStart < m_blocks;
+    const bool freeAfter = keepEnd > 0 && keepEnd < m_blocks;
+    const std::vector<GridItem> &items = gridChannel.items;
+    for (size_t i = 0; i < items.size(); ++i)
     {
-      // if item exist and block is not part of visible item
-      CGUIListItemPtr last(m_gridIndex[channel][keepStart].item);
-      for (int i = keepStart - 1; i > 0; --i)
-      {
-        if (m_gridIndex[channel][i].item && m_gridIndex[channel][i].item != last)
-        {
-          m_gridIndex[channel][i].item->FreeMemory();
-          // FreeMemory() is smart enough to not cause any problems when called multiple times on same item
-          // but we can make use of condition needed to not call FreeMemory() on item that is partially visible
-          // to avoid calling FreeMemory() multiple times on item that occupy few blocks in a row
-          last = m_gridIndex[channel][i].item;
-        }
-      }
-    }
-
-    if (keepEnd > 0 && keepEnd < m_blocks)
-    {
-      CGUIListItemPtr last(m_gridIndex[channel][keepEnd].item);
-      for (int i = keepEnd + 1; i < m_blocks; ++i)
-      {
-        // if item exist and block is not part of visible item
-        if (m_gridIndex[channel][i].item && m_gridIndex[channel][i].item != last)
-        {
-          m_gridIndex[channel][i].item->FreeMemory();
-          // FreeMemory() is smart enough to not cause any problems when called multiple times on same item
-          // but we can make use of condition needed to not call FreeMemory() on item that is partially visible
-          // to avoid calling FreeMemory() multiple times on item that occupy few blocks in a row
-          last = m_gridIndex[channel][i].item;
-        }
-      }
+      int endBlock = i + 1 < items.size() ? items[i + 1].startBlock : m_blocks;
+      if ((freeBefore && endBlock <= keepStart) || (freeAfter && items[i].startBlock > keepEnd))
+        items[i].item->FreeMemory();
     }
   }
 }
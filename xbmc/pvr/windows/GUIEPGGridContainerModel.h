@@ -20,9 +20,11 @@
  */
 
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "XBDateTime.h"
+#include "threads/CriticalSection.h"
 
 #include "pvr/PVRTypes.h"
 
@@ -39,8 +41,9 @@ namespace PVR
     float originWidth;
     float width;
     int progIndex;
+    int startBlock;
 
-    GridItem() : originWidth(0.0f), width(0.0f), progIndex(-1) {}
+    GridItem() : originWidth(0.0f), width(0.0f), progIndex(-1), startBlock(0) {}
   };
 
   class CGUIEPGGridContainerModel
@@ -49,7 +52,8 @@ namespace PVR
     static const int MINSPERBLOCK = 5; // minutes
     static const int MAXBLOCKS = 33 * 24 * 60 / MINSPERBLOCK; //! 33 days of 5 minute blocks (31 days for upcoming data + 1 day for past data + 1 day for fillers)
 
-    CGUIEPGGridContainerModel() : m_blocks(0) {}
+    CGUIEPGGridContainerModel() : m_blocks(0), m_blockSize(0.0f) {}
+    CGUIEPGGridContainerModel(const CGUIEPGGridContainerModel &other);
     virtual ~CGUIEPGGridContainerModel() { Reset(); }
 
     void Refresh(const std::unique_ptr<CFileItemList> &items, const CDateTime &gridStart, const CDateTime &gridEnd, int iRulerUnit, int iBlocksPerPage, float fBlockSize);
@@ -75,12 +79,12 @@ namespace PVR
 
     int GetBlockCount() const { return m_blocks; }
     bool HasGridItems() const { return !m_gridIndex.empty(); }
-    GridItem *GetGridItemPtr(int iChannel, int iBlock) { return &m_gridIndex[iChannel][iBlock]; }
-    CFileItemPtr GetGridItem(int iChannel, int iBlock) const { return m_gridIndex[iChannel][iBlock].item; }
-    float GetGridItemWidth(int iChannel, int iBlock) const { return m_gridIndex[iChannel][iBlock].width; }
-    float GetGridItemOriginWidth(int iChannel, int iBlock) const { return m_gridIndex[iChannel][iBlock].originWidth; }
-    int GetGridItemIndex(int iChannel, int iBlock) const { return m_gridIndex[iChannel][iBlock].progIndex; }
-    void SetGridItemWidth(int iChannel, int iBlock, float fWidth) { m_gridIndex[iChannel][iBlock].width = fWidth; }
+    GridItem *GetGridItemPtr(int iChannel, int iBlock) { return &FindGridItem(iChannel, iBlock); }
+    CFileItemPtr GetGridItem(int iChannel, int iBlock) const { return FindGridItem(iChannel, iBlock).item; }
+    float GetGridItemWidth(int iChannel, int iBlock) const { return FindGridItem(iChannel, iBlock).width; }
+    float GetGridItemOriginWidth(int iChannel, int iBlock) const { return FindGridItem(iChannel, iBlock).originWidth; }
+    int GetGridItemIndex(int iChannel, int iBlock) const { return FindGridItem(iChannel, iBlock).progIndex; }
+    void SetGridItemWidth(int iChannel, int iBlock, float fWidth) { FindGridItem(iChannel, iBlock).width = fWidth; }
 
     bool IsZeroGridDuration() const { return (m_gridEnd - m_gridStart) == CDateTimeSpan(0, 0, 0, 0); }
     const CDateTime &GetGridStart() const { return m_gridStart; }
@@ -95,10 +99,50 @@ namespace PVR
     int GetFirstEventBlock(const CPVREpgInfoTagPtr &event) const;
     int GetLastEventBlock(const CPVREpgInfoTagPtr &event) const;
 
+    /*!
+     * @brief A run of blocks of a channel showing the same event or gap.
+     */
+    struct GridRun
+    {
+      int eventIndex; ///< index of the event shown, INVALID_INDEX for a gap
+      int startBlock;
+      int endBlock;   ///< the first block after the run
+    };
+
+    /*!
+     * @brief Lay out the events of a channel in the blocks of a grid.
+     * An event takes the blocks starting within it, an event overlapping an earlier one only the blocks left over.
+     * @param events start and end time of the events, ordered by start time.
+     * @param gridStart the start time of the first block.
+     * @param gridEnd events starting at or after this time are not shown.
+     * @param iBlocks the number of blocks of the grid.
+     * @return the runs, covering every block of the grid.
+     */
+    static std::vector<GridRun> GetGridRuns(const std::vector<std::pair<CDateTime, CDateTime>> &events, const CDateTime &gridStart, const CDateTime &gridEnd, int iBlocks);
+
   private:
     void FreeItemsMemory();
     void Reset();
 
+    /*!
+     * @brief The items of a channel, one per run of blocks showing the same programme or gap, ordered by start block.
+     * Only built when the channel is first accessed, so channels that are never scrolled into view cost nothing.
+     */
+    struct GridChannel
+    {
+      bool built;
+      std::vector<GridItem> items;
+
+      GridChannel() : built(false) {}
+    };
+
+    std::vector<GridItem> &GetGridChannel(int iChannel) const;
+    GridItem &FindGridItem(int iChannel, int iBlock) const;
+    void BuildGridChannel(int iChannel, std::vector<GridItem> &items) const;
+    void AddGridItem(std::vector<GridItem> &items, const CFileItemPtr &item, int progIndex, int startBlock, int endBlock) const;
+    void AddGapItem(std::vector<GridItem> &items, int iChannel, int startBlock, int endBlock) const;
+    static int GetFirstBlockFrom(const CDateTime &gridStart, const CDateTime &datetime);
+
     struct ItemsPtr
     {
       long start;
@@ -112,8 +156,10 @@ namespace PVR
     std::vector<CFileItemPtr> m_channelItems;
     std::vector<CFileItemPtr> m_rulerItems;
     std::vector<ItemsPtr> m_epgItemsPtr;
-    std::vector<std::vector<GridItem> > m_gridIndex;
+    mutable std::vector<GridChannel> m_gridIndex;
+    mutable CCriticalSection m_gridSection; ///< protects building the channels of m_gridIndex
 
     int m_blocks;
+    float m_blockSize;
   };
 }
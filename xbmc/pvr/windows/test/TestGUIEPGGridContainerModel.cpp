@@ -0,0 +1,128 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "pvr/windows/GUIEPGGridContainerModel.h"
+#include "XBDateTime.h"
+
+#include "gtest/gtest.h"
+
+using namespace PVR;
+
+namespace
+{
+  typedef CGUIEPGGridContainerModel::GridRun GridRun;
+
+  const int NONE = CGUIEPGGridContainerModel::INVALID_INDEX;
+  const int BLOCKS = 12; // one hour
+
+  const CDateTime GRID_START(2017, 7, 14, 20, 0, 0);
+  const CDateTime GRID_END(2017, 7, 14, 21, 0, 0);
+
+  /* an event from minutes after the grid start */
+  std::pair<CDateTime, CDateTime> Event(int startMinutes, int endMinutes)
+  {
+    return std::make_pair(GRID_START + CDateTimeSpan(0, 0, startMinutes, 0), GRID_START + CDateTimeSpan(0, 0, endMinutes, 0));
+  }
+
+  /* an event from seconds after the grid start */
+  std::pair<CDateTime, CDateTime> EventSeconds(int startSeconds, int endSeconds)
+  {
+    return std::make_pair(GRID_START + CDateTimeSpan(0, 0, 0, startSeconds), GRID_START + CDateTimeSpan(0, 0, 0, endSeconds));
+  }
+
+  void ExpectRuns(const std::vector<GridRun> &expected, const std::vector<GridRun> &runs)
+  {
+    ASSERT_EQ(expected.size(), runs.size());
+    for (size_t i = 0; i < runs.size(); ++i)
+    {
+      EXPECT_EQ(expected[i].eventIndex, runs[i].eventIndex) << "run " << i;
+      EXPECT_EQ(expected[i].startBlock, runs[i].startBlock) << "run " << i;
+      EXPECT_EQ(expected[i].endBlock, runs[i].endBlock) << "run " << i;
+    }
+  }
+}
+
+TEST(TestGUIEPGGridContainerModel, NoEvents)
+{
+  ExpectRuns({ { NONE, 0, BLOCKS } },
+             CGUIEPGGridContainerModel::GetGridRuns({}, GRID_START, GRID_END, BLOCKS));
+}
+
+TEST(TestGUIEPGGridContainerModel, EventsOnBlockBoundaries)
+{
+  // every block of an event is part of one run, adjacent events split at their common boundary
+  ExpectRuns({ { 0, 0, 6 }, { 1, 6, 7 }, { 2, 7, 12 } },
+             CGUIEPGGridContainerModel::GetGridRuns({ Event(0, 30), Event(30, 35), Event(35, 60) }, GRID_START, GRID_END, BLOCKS));
+}
+
+TEST(TestGUIEPGGridContainerModel, EventsWithinBlocks)
+{
+  // an event takes the blocks starting within it, so the split is at the first block after the change
+  ExpectRuns({ { NONE, 0, 1 }, { 0, 1, 3 }, { 1, 3, 12 } },
+             CGUIEPGGridContainerModel::GetGridRuns({ Event(2, 13), Event(13, 60) }, GRID_START, GRID_END, BLOCKS));
+
+  // one second past a boundary already misses the block
+  ExpectRuns({ { NONE, 0, 2 }, { 0, 2, 12 } },
+             CGUIEPGGridContainerModel::GetGridRuns({ EventSeconds(5 * 60 + 1, 60 * 60) }, GRID_START, GRID_END, BLOCKS));
+
+  // an event no block starts in is not shown, its time goes to the gap
+  ExpectRuns({ { 0, 0, 1 }, { NONE, 1, 2 }, { 2, 2, 12 } },
+             CGUIEPGGridContainerModel::GetGridRuns({ Event(0, 5), Event(6, 9), Event(9, 60) }, GRID_START, GRID_END, BLOCKS));
+}
+
+TEST(TestGUIEPGGridContainerModel, Gaps)
+{
+  // gaps before, between and after the events are runs of their own
+  ExpectRuns({ { NONE, 0, 2 }, { 0, 2, 4 }, { NONE, 4, 8 }, { 1, 8, 10 }, { NONE, 10, 12 } },
+             CGUIEPGGridContainerModel::GetGridRuns({ Event(10, 20), Event(40, 50) }, GRID_START, GRID_END, BLOCKS));
+}
+
+TEST(TestGUIEPGGridContainerModel, OverlappingEvents)
+{
+  // the earlier event keeps the blocks both cover
+  ExpectRuns({ { 0, 0, 6 }, { 1, 6, 8 }, { NONE, 8, 12 } },
+             CGUIEPGGridContainerModel::GetGridRuns({ Event(0, 30), Event(20, 40) }, GRID_START, GRID_END, BLOCKS));
+
+  // an event entirely within an earlier one is not shown
+  ExpectRuns({ { 0, 0, 6 }, { 2, 6, 12 } },
+             CGUIEPGGridContainerModel::GetGridRuns({ Event(0, 30), Event(10, 20), Event(30, 60) }, GRID_START, GRID_END, BLOCKS));
+}
+
+TEST(TestGUIEPGGridContainerModel, EventsOverlappingTheGridStart)
+{
+  // events before the grid start are cut at the first block
+  ExpectRuns({ { 1, 0, 2 }, { 2, 2, 12 } },
+             CGUIEPGGridContainerModel::GetGridRuns({ Event(-60, -30), Event(-30, 10), Event(10, 60) }, GRID_START, GRID_END, BLOCKS));
+
+  // the first block starts within an event running into it
+  ExpectRuns({ { 0, 0, 1 }, { 1, 1, 12 } },
+             CGUIEPGGridContainerModel::GetGridRuns({ Event(-10, 2), Event(2, 60) }, GRID_START, GRID_END, BLOCKS));
+}
+
+TEST(TestGUIEPGGridContainerModel, EventsOverlappingTheGridEnd)
+{
+  // events are cut at the last block and events starting at the grid end are left out
+  ExpectRuns({ { 0, 0, 10 }, { 1, 10, 12 } },
+             CGUIEPGGridContainerModel::GetGridRuns({ Event(0, 50), Event(50, 90), Event(60, 120) }, GRID_START, GRID_END, BLOCKS));
+
+  // a grid padded beyond its end to fill a page shows events starting before the end in full
+  ExpectRuns({ { 0, 0, 18 }, { NONE, 18, 24 } },
+             CGUIEPGGridContainerModel::GetGridRuns({ Event(-30, 90), Event(60, 120) }, GRID_START, GRID_END, 24));
+}
@@ -157,6 +157,8 @@ void CAdvancedSettings::Initialize()
   m_DXVAForceProcessorRenderer = true;
   m_DXVAAllowHqScaling = true;
   m_videoFpsDetect = 1;
+  m_videoProbeCache = true;
+  m_videoProbeNextItem = false;
   m_maxTempo = 1.55f;
 
   m_mediacodecForceSoftwareRendering = false;
@@ -262,6 +264,7 @@ void CAdvancedSettings::Initialize()
   m_fanartRes = 1080;
   m_imageRes = 720;
   m_imageScalingAlgorithm = CPictureScalingAlgorithm::Default;
+  m_imageCacheDDS = false;
 
   m_sambaclienttimeout = 30;
   m_sambadoscodepage = "";
@@ -285,6 +288,8 @@ void CAdvancedSettings::Initialize()
   m_musicArtistSeparators = { ";", " feat. ", " ft. " };
   m_videoItemSeparator = " / ";
   m_iMusicLibraryDateAdded = 1; // prefer mtime over ctime and current time
+  m_iMusicLibraryScanBatchItems = 250;
+  m_iMusicLibraryScanBatchTime = 5000;
 
   m_bVideoLibraryAllItemsOnBottom = false;
   m_iVideoLibraryRecentlyAddedItems = 25;
@@ -295,6 +300,8 @@ void CAdvancedSettings::Initialize()
   m_bVideoLibraryImportResumePoint = false;
   m_bVideoScannerIgnoreErrors = false;
   m_iVideoLibraryDateAdded = 1; // prefer mtime over ctime and current time
+  m_iVideoLibraryScanBatchItems = 25;
+  m_iVideoLibraryScanBatchTime = 5000;
 
   m_iEpgUpdateCheckInterval = 300; /* check if tables need to be updated every 5 minutes */
   m_iEpgCleanupInterval = 900;     /* remove old entries from the EPG every 15 minutes */
@@ -397,6 +404,7 @@ void CAdvancedSettings::Initialize()
   m_useDisplayControlHWStereo = false;
 
   m_videoAssFixedWorks = false;
+  m_videoAssLookahead = 1000;
 
   m_logLevelHint = m_logLevel = LOG_LEVEL_NORMAL;
   m_extraLogEnabled = false;
@@ -538,6 +546,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
   if (pElement)
   {
     XMLUtils::GetBoolean(pElement, "assfixedworks", m_videoAssFixedWorks);
+    XMLUtils::GetInt(pElement, "asslookahead", m_videoAssLookahead, 0, 10000);
     XMLUtils::GetString(pElement, "stereoscopicregex3d", m_stereoscopicregex_3d);
     XMLUtils::GetString(pElement, "stereoscopicregexsbs", m_stereoscopicregex_sbs);
     XMLUtils::GetString(pElement, "stereoscopicregextab", m_stereoscopicregex_tab);
@@ -682,6 +691,9 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetBoolean(pElement, "usedisplaycontrolhwstereo", m_useDisplayControlHWStereo);
     //0 = disable fps detect, 1 = only detect on timestamps with uniform spacing, 2 detect on all timestamps
     XMLUtils::GetInt(pElement, "fpsdetect", m_videoFpsDetect, 0, 2);
+    // cache the stream info of played files and probe the next playlist item ahead
+    XMLUtils::GetBoolean(pElement, "probecache", m_videoProbeCache);
+    XMLUtils::GetBoolean(pElement, "probenextitem", m_videoProbeNextItem);
     XMLUtils::GetFloat(pElement, "maxtempo", m_maxTempo, 1.5, 2.1);
 
     // Store global display latency settings
@@ -734,6 +746,8 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetString(pElement, "albumformat", m_strMusicLibraryAlbumFormat);
     XMLUtils::GetString(pElement, "itemseparator", m_musicItemSeparator);
     XMLUtils::GetInt(pElement, "dateadded", m_iMusicLibraryDateAdded);
+    XMLUtils::GetInt(pElement, "scanbatchitems", m_iMusicLibraryScanBatchItems, 0, INT_MAX);
+    XMLUtils::GetInt(pElement, "scanbatchtime", m_iMusicLibraryScanBatchTime, 0, INT_MAX);
     //Music artist name separators
     TiXmlElement* separators = pElement->FirstChildElement("artistseparators");
     if (separators)
@@ -761,6 +775,8 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetBoolean(pElement, "importwatchedstate", m_bVideoLibraryImportWatchedState);
     XMLUtils::GetBoolean(pElement, "importresumepoint", m_bVideoLibraryImportResumePoint);
     XMLUtils::GetInt(pElement, "dateadded", m_iVideoLibraryDateAdded);
+    XMLUtils::GetInt(pElement, "scanbatchitems", m_iVideoLibraryScanBatchItems, 0, INT_MAX);
+    XMLUtils::GetInt(pElement, "scanbatchtime", m_iVideoLibraryScanBatchTime, 0, INT_MAX);
   }
 
   pElement = pRootElement->FirstChildElement("videoscanner");
@@ -1015,6 +1031,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
   XMLUtils::GetUInt(pRootElement, "imageres", m_imageRes, 0, 9999);
   if (XMLUtils::GetString(pRootElement, "imagescalingalgorithm", tmp))
     m_imageScalingAlgorithm = CPictureScalingAlgorithm::FromString(tmp);
+  XMLUtils::GetBoolean(pRootElement, "imagecachedds", m_imageCacheDDS);
   XMLUtils::GetBoolean(pRootElement, "playlistasfolders", m_playlistAsFolders);
   XMLUtils::GetBoolean(pRootElement, "detectasudf", m_detectAsUdf);
 
@@ -1089,6 +1106,11 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetString(pDatabase, "capath", m_databaseVideo.capath);
     XMLUtils::GetString(pDatabase, "ciphers", m_databaseVideo.ciphers);
     XMLUtils::GetBoolean(pDatabase, "compression", m_databaseVideo.compression);
+    XMLUtils::GetBoolean(pDatabase, "wal", m_databaseVideo.wal);
+    XMLUtils::GetInt(pDatabase, "walautocheckpoint", m_databaseVideo.walAutoCheckpoint, 0, INT_MAX);
+    XMLUtils::GetInt(pDatabase, "readconnections", m_databaseVideo.readConnections, 0, 16);
+    XMLUtils::GetInt(pDatabase, "idleconnections", m_databaseVideo.idleConnections, 0, 16);
+    XMLUtils::GetInt(pDatabase, "idletimeout", m_databaseVideo.idleTimeout, 0, 3600);
   }
 
   pDatabase = pRootElement->FirstChildElement("musicdatabase");
@@ -1106,6 +1128,11 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetString(pDatabase, "capath", m_databaseMusic.capath);
     XMLUtils::GetString(pDatabase, "ciphers", m_databaseMusic.ciphers);
     XMLUtils::GetBoolean(pDatabase, "compression", m_databaseMusic.compression);
+    XMLUtils::GetBoolean(pDatabase, "wal", m_databaseMusic.wal);
+    XMLUtils::GetInt(pDatabase, "walautocheckpoint", m_databaseMusic.walAutoCheckpoint, 0, INT_MAX);
+    XMLUtils::GetInt(pDatabase, "readconnections", m_databaseMusic.readConnections, 0, 16);
+    XMLUtils::GetInt(pDatabase, "idleconnections", m_databaseMusic.idleConnections, 0, 16);
+    XMLUtils::GetInt(pDatabase, "idletimeout", m_databaseMusic.idleTimeout, 0, 3600);
   }
 
   pDatabase = pRootElement->FirstChildElement("tvdatabase");
@@ -1123,6 +1150,8 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetString(pDatabase, "capath", m_databaseTV.capath);
     XMLUtils::GetString(pDatabase, "ciphers", m_databaseTV.ciphers);
     XMLUtils::GetBoolean(pDatabase, "compression", m_databaseTV.compression);
+    XMLUtils::GetInt(pDatabase, "idleconnections", m_databaseTV.idleConnections, 0, 16);
+    XMLUtils::GetInt(pDatabase, "idletimeout", m_databaseTV.idleTimeout, 0, 3600);
   }
 
   pDatabase = pRootElement->FirstChildElement("adspdatabase");
@@ -1156,6 +1185,8 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetString(pDatabase, "capath", m_databaseEpg.capath);
     XMLUtils::GetString(pDatabase, "ciphers", m_databaseEpg.ciphers);
     XMLUtils::GetBoolean(pDatabase, "compression", m_databaseEpg.compression);
+    XMLUtils::GetInt(pDatabase, "idleconnections", m_databaseEpg.idleConnections, 0, 16);
+    XMLUtils::GetInt(pDatabase, "idletimeout", m_databaseEpg.idleTimeout, 0, 3600);
   }
 
   pDatabase = pRootElement->FirstChildElement("savestatedatabase");
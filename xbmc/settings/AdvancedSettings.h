@@ -62,6 +62,11 @@ public:
     capath.clear();
     ciphers.clear();
     compression = false;
+    wal = false;
+    walAutoCheckpoint = 1000;
+    readConnections = 2;
+    idleConnections = 1;
+    idleTimeout = 60;
   };
   std::string type;
   std::string host;
@@ -75,6 +80,11 @@ public:
   std::string capath;
   std::string ciphers;
   bool compression;
+  bool wal;               ///< sqlite: use write-ahead logging so readers don't block on writers
+  int walAutoCheckpoint;  ///< sqlite: pages in the write-ahead log before it's checkpointed
+  int readConnections;    ///< sqlite: idle read-only connections kept for queries while writing, needs wal
+  int idleConnections;    ///< mysql: idle connections kept for the next open of the database, saves logging in again
+  int idleTimeout;        ///< mysql: seconds an idle connection is kept, below the wait_timeout of the server
 };
 
 struct TVShowRegexp
@@ -189,6 +199,8 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_DXVAForceProcessorRenderer;
     bool m_DXVAAllowHqScaling;
     int  m_videoFpsDetect;
+    bool m_videoProbeCache;
+    bool m_videoProbeNextItem;
     bool m_mediacodecForceSoftwareRendering;
     float m_maxTempo;
 
@@ -240,6 +252,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     unsigned int m_fanartRes; ///< \brief the maximal resolution to cache fanart at (assumes 16x9)
     unsigned int m_imageRes;  ///< \brief the maximal resolution to cache images at (assumes 16x9)
     CPictureScalingAlgorithm::Algorithm m_imageScalingAlgorithm;
+    bool m_imageCacheDDS;     ///< \brief cache images as uncompressed DDS at display size, so they load without decoding
 
     int m_sambaclienttimeout;
     std::string m_sambadoscodepage;
@@ -254,6 +267,8 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
 
     int m_iMusicLibraryRecentlyAddedItems;
     int m_iMusicLibraryDateAdded;
+    int m_iMusicLibraryScanBatchItems; ///< songs written per scanner transaction
+    int m_iMusicLibraryScanBatchTime;  ///< ms after which a scanner transaction is committed
     bool m_bMusicLibraryAllItemsOnBottom;
     bool m_bMusicLibraryCleanOnUpdate;
     bool m_bMusicLibraryArtistSortOnUpdate;
@@ -275,6 +290,8 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
 
     bool m_bVideoScannerIgnoreErrors;
     int m_iVideoLibraryDateAdded;
+    int m_iVideoLibraryScanBatchItems; ///< items written per scanner transaction
+    int m_iVideoLibraryScanBatchTime;  ///< ms after which a scanner transaction is committed
 
     std::set<std::string> m_vecTokens;
 
@@ -381,6 +398,9 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     False to show at the bottom of video (default) */
     bool m_videoAssFixedWorks;
 
+    /*!< @brief how far in ms ass subtitle frames are rendered ahead of the presented frame, 0 to render them when presented */
+    int m_videoAssLookahead;
+
     std::string m_userAgent;
 
   private:
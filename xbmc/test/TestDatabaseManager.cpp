@@ -0,0 +1,173 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DatabaseManager.h"
+#include "dbwrappers/sqlitedataset.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+
+#include <chrono>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+class CResetCountingDatabase : public dbiplus::SqliteDatabase
+{
+public:
+  int reset() override
+  {
+    resets++;
+    return resetResult;
+  }
+
+  int resets = 0;
+  int resetResult = DB_COMMAND_OK;
+};
+}
+
+class TestDatabaseManager : public ::testing::Test
+{
+protected:
+  CDatabaseManager manager;
+  std::string host = CSpecialProtocol::TranslatePath("special://temp/");
+
+  std::unique_ptr<dbiplus::Database> Connect(const std::string &name)
+  {
+    std::unique_ptr<dbiplus::Database> connection(new dbiplus::SqliteDatabase());
+    connection->setHostName(host.c_str());
+    connection->setDatabase(name.c_str());
+    EXPECT_EQ(DB_CONNECTION_OK, connection->connect(true));
+    return connection;
+  }
+
+  void TearDown() override
+  {
+    XFILE::CFile::Delete(host + "testpool1.db");
+    XFILE::CFile::Delete(host + "testpool2.db");
+  }
+};
+
+TEST_F(TestDatabaseManager, ConnectionReuse)
+{
+  EXPECT_TRUE(manager.AcquireConnection("key1") == nullptr);
+
+  std::unique_ptr<dbiplus::Database> connection = Connect("testpool1");
+  dbiplus::Database *released = connection.get();
+  manager.ReleaseConnection("key1", std::move(connection), 2, 60000);
+
+  // only the same key gets the connection back, and only once
+  EXPECT_TRUE(manager.AcquireConnection("key2") == nullptr);
+  connection = manager.AcquireConnection("key1");
+  EXPECT_EQ(released, connection.get());
+  EXPECT_TRUE(connection->isActive());
+  EXPECT_TRUE(manager.AcquireConnection("key1") == nullptr);
+}
+
+TEST_F(TestDatabaseManager, ConnectionRelease)
+{
+  // connections beyond the idle limit are closed
+  manager.ReleaseConnection("key1", Connect("testpool1"), 1, 60000);
+  manager.ReleaseConnection("key1", Connect("testpool1"), 1, 60000);
+  EXPECT_TRUE(manager.AcquireConnection("key1") != nullptr);
+  EXPECT_TRUE(manager.AcquireConnection("key1") == nullptr);
+
+  // so are connections that were lost
+  std::unique_ptr<dbiplus::Database> connection = Connect("testpool1");
+  connection->disconnect();
+  manager.ReleaseConnection("key1", std::move(connection), 1, 60000);
+  EXPECT_TRUE(manager.AcquireConnection("key1") == nullptr);
+
+  manager.ReleaseConnection(std::string(), std::unique_ptr<dbiplus::Database>(), 1, 60000);
+  manager.ReleaseConnection("key1", Connect("testpool1"), 0, 60000);
+  EXPECT_TRUE(manager.AcquireConnection("key1") == nullptr);
+  manager.ReleaseConnection("key1", Connect("testpool1"), 1, 0);
+  EXPECT_TRUE(manager.AcquireConnection("key1") == nullptr);
+}
+
+TEST_F(TestDatabaseManager, ConnectionResetOnRelease)
+{
+  std::unique_ptr<CResetCountingDatabase> connection(new CResetCountingDatabase());
+  connection->setHostName(host.c_str());
+  connection->setDatabase("testpool1");
+  ASSERT_EQ(DB_CONNECTION_OK, connection->connect(true));
+  std::unique_ptr<dbiplus::Dataset> ds(connection->CreateDataset());
+  ds->exec("CREATE TABLE item (idItem INTEGER PRIMARY KEY)");
+  ds.reset();
+
+  // the session is reset once on the way into the pool and the connection can be used again
+  CResetCountingDatabase *released = connection.get();
+  manager.ReleaseConnection("key1", std::move(connection), 1, 60000);
+  EXPECT_EQ(1, released->resets);
+  std::unique_ptr<dbiplus::Database> reused = manager.AcquireConnection("key1");
+  ASSERT_EQ(released, reused.get());
+  ds.reset(reused->CreateDataset());
+  ds->exec("INSERT INTO item (idItem) VALUES (1)");
+  EXPECT_TRUE(ds->query("SELECT idItem FROM item"));
+  EXPECT_EQ(1, ds->num_rows());
+  ds.reset();
+
+  // a connection that can't be reset is closed
+  released->resetResult = DB_UNEXPECTED_RESULT;
+  manager.ReleaseConnection("key1", std::move(reused), 1, 60000);
+  EXPECT_EQ(2, released->resets);
+  EXPECT_TRUE(manager.AcquireConnection("key1") == nullptr);
+}
+
+TEST_F(TestDatabaseManager, ConnectionExpiry)
+{
+  manager.ReleaseConnection("key1", Connect("testpool1"), 2, 1);
+  manager.ReleaseConnection("key1", Connect("testpool1"), 2, 60000);
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+  // only the connection within its timeout is left
+  EXPECT_TRUE(manager.AcquireConnection("key1") != nullptr);
+  EXPECT_TRUE(manager.AcquireConnection("key1") == nullptr);
+}
+
+TEST_F(TestDatabaseManager, ReadConnectionReuse)
+{
+  EXPECT_TRUE(manager.AcquireReadConnection(host, "testpool1.db") == nullptr);
+
+  std::unique_ptr<dbiplus::Database> connection = Connect("testpool1");
+  dbiplus::Database *released = connection.get();
+  manager.ReleaseReadConnection(std::move(connection), 2);
+  manager.ReleaseReadConnection(Connect("testpool2"), 2);
+
+  // connections are pooled per database file, sqlite names them with their extension
+  connection = manager.AcquireReadConnection(host, "testpool1.db");
+  EXPECT_EQ(released, connection.get());
+  EXPECT_TRUE(manager.AcquireReadConnection(host, "testpool1.db") == nullptr);
+  EXPECT_TRUE(manager.AcquireReadConnection(host, "testpool2.db") != nullptr);
+}
+
+TEST_F(TestDatabaseManager, ReadConnectionRelease)
+{
+  manager.ReleaseReadConnection(Connect("testpool1"), 1);
+  manager.ReleaseReadConnection(Connect("testpool1"), 1);
+  EXPECT_TRUE(manager.AcquireReadConnection(host, "testpool1.db") != nullptr);
+  EXPECT_TRUE(manager.AcquireReadConnection(host, "testpool1.db") == nullptr);
+
+  std::unique_ptr<dbiplus::Database> connection = Connect("testpool1");
+  connection->disconnect();
+  manager.ReleaseReadConnection(std::move(connection), 1);
+  EXPECT_TRUE(manager.AcquireReadConnection(host, "testpool1.db") == nullptr);
+}
@@ -261,6 +261,30 @@ void CJobManager::CancelJob(unsigned int jobID)
     it->m_callback = NULL; // job is in progress, so only thing to do is to remove callback
 }
 
+bool CJobManager::ChangeJobPriority(unsigned int jobID, CJob::PRIORITY priority)
+{
+  CSingleLock lock(m_section);
+
+  for (unsigned int queue = CJob::PRIORITY_LOW_PAUSABLE; queue <= CJob::PRIORITY_DEDICATED; ++queue)
+  {
+    JobQueue::iterator i = find(m_jobQueue[queue].begin(), m_jobQueue[queue].end(), jobID);
+    if (i != m_jobQueue[queue].end())
+    {
+      if (queue == priority)
+        return true;
+
+      CWorkItem work(*i);
+      m_jobQueue[queue].erase(i);
+      work.m_priority = priority;
+      m_jobQueue[priority].push_back(work);
+
+      StartWorkers(priority);
+      return true;
+    }
+  }
+  return false;
+}
+
 void CJobManager::StartWorkers(CJob::PRIORITY priority)
 {
   CSingleLock lock(m_section);
@@ -435,3 +459,64 @@ unsigned int CJobManager::GetMaxWorkers(CJob::PRIORITY priority)
     return 10000; // A large number..
   return max_workers - (CJob::PRIORITY_HIGH - priority);
 }
+
+CParallelJobs::CParallelJobs(unsigned int count, const Task &task)
+  : m_task(task),
+    m_claimed(new std::atomic<bool>[count]),
+    m_finished(new std::atomic<bool>[count]),
+    m_pending(count),
+    m_done(true, count == 0)
+{
+  for (unsigned int task = 0; task < count; task++)
+  {
+    m_claimed[task] = false;
+    m_finished[task] = false;
+  }
+}
+
+std::shared_ptr<CParallelJobs> CParallelJobs::Run(unsigned int count, const Task &task, CJob::PRIORITY priority /* = CJob::PRIORITY_HIGH */)
+{
+  std::shared_ptr<CParallelJobs> jobs(new CParallelJobs(count, task));
+  for (unsigned int i = 1; i < count; i++)
+    CJobManager::GetInstance().Submit([jobs, i]() { jobs->RunTask(i); }, priority);
+
+  for (unsigned int i = 0; i < count; i++)
+    jobs->RunTask(i);
+
+  return jobs;
+}
+
+void CParallelJobs::Wait()
+{
+  m_done.Wait();
+}
+
+bool CParallelJobs::Wait(unsigned int milliseconds)
+{
+  return m_done.WaitMSec(milliseconds);
+}
+
+bool CParallelJobs::IsFinished(unsigned int task) const
+{
+  return m_finished[task];
+}
+
+void CParallelJobs::RunTask(unsigned int task)
+{
+  if (m_claimed[task].exchange(true))
+    return;
+
+  // a task that throws is finished as well, or the waiting thread would never wake up
+  try
+  {
+    m_task(task);
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s error processing task %u", __FUNCTION__, task);
+  }
+
+  m_finished[task] = true;
+  if (--m_pending == 0)
+    m_done.Set();
+}
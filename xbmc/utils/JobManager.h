@@ -19,10 +19,14 @@
  *
  */
 
+#include <atomic>
+#include <functional>
+#include <memory>
 #include <queue>
 #include <vector>
 #include <string>
 #include "threads/CriticalSection.h"
+#include "threads/Event.h"
 #include "threads/Thread.h"
 #include "Job.h"
 
@@ -276,6 +280,16 @@ public:
    */
   void CancelJob(unsigned int jobID);
 
+  /*!
+   \brief Move a queued job to a different priority.
+   Jobs that are already being processed are not affected.
+   \param jobID the id of the job to change, retrieved previously from AddJob()
+   \param priority the new priority of the job.
+   \return true if the job was still queued and has been moved, false otherwise.
+   \sa AddJob()
+   */
+  bool ChangeJobPriority(unsigned int jobID, CJob::PRIORITY priority);
+
   /*!
    \brief Cancel all remaining jobs, preparing for shutdown
    Should be called prior to destroying any objects that may be being used as callbacks
@@ -382,3 +396,57 @@ private:
   CEvent           m_jobEvent;
   bool             m_running;
 };
+
+/*!
+ \ingroup jobs
+ \brief Runs a fixed number of tasks in parallel on the job manager's workers.
+
+ Every task but the first is submitted as a job, then the calling thread runs every task
+ no worker has started yet itself. The tasks therefore finish even when all workers are
+ busy, and the calling thread never idles while tasks are still queued.
+
+ \sa CJobManager::Submit
+ */
+class CParallelJobs
+{
+public:
+  typedef std::function<void(unsigned int task)> Task;
+
+  /*!
+   \brief Run tasks 0 to count - 1. Returns once the calling thread has no task left to start.
+   \param count the number of tasks.
+   \param task the function running a task, called exactly once per task. A task that throws counts as finished.
+   \param priority the priority of the jobs.
+   \return the tasks, to wait until the ones started by workers are finished.
+   */
+  static std::shared_ptr<CParallelJobs> Run(unsigned int count, const Task &task, CJob::PRIORITY priority = CJob::PRIORITY_HIGH);
+
+  /*!
+   \brief Wait until all tasks are finished.
+   */
+  void Wait();
+
+  /*!
+   \brief Wait until all tasks are finished, or until the time runs out.
+   \param milliseconds the time to wait for.
+   \return true if all tasks are finished, false otherwise.
+   */
+  bool Wait(unsigned int milliseconds);
+
+  /*!
+   \brief Whether a task is finished.
+   \param task the task.
+   \return true if the task is finished, false otherwise.
+   */
+  bool IsFinished(unsigned int task) const;
+
+private:
+  CParallelJobs(unsigned int count, const Task &task);
+  void RunTask(unsigned int task);
+
+  Task m_task;
+  std::unique_ptr<std::atomic<bool>[]> m_claimed;
+  std::unique_ptr<std::atomic<bool>[]> m_finished;
+  std::atomic<unsigned int> m_pending;
+  CEvent m_done;
+};
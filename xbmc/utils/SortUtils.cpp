@@ -24,12 +24,18 @@
 #include "Util.h"
 #include "XBDateTime.h"
 #include "utils/CharsetConverter.h"
+#include "utils/CPUInfo.h"
+#include "utils/JobManager.h"
 #include "utils/StringUtils.h"
 #include "utils/Variant.h"
 #include "utils/log.h"
 
 #include <algorithm>
 
+// inputs this large are sorted in chunks by the job manager's workers and merged afterwards
+#define SORT_PARALLEL_MIN_ITEMS 20000
+#define SORT_PARALLEL_MAX_CHUNKS 8
+
 std::string ArrayToString(SortAttribute attributes, const CVariant &variant, const std::string &separator = " / ")
 {
   std::vector<std::string> strArray;
@@ -433,132 +439,6 @@ std::string ByLastUsed(SortAttribute attributes, const SortItem &values)
   return values.at(FieldLastUsed).asString();
 }
 
-bool preliminarySort(const SortItem &left, const SortItem &right, bool handleFolder, bool &result, std::wstring &labelLeft, std::wstring &labelRight)
-{
-  // make sure both items have the necessary data to do the sorting
-  SortItem::const_iterator itLeftSort, itRightSort;
-  if ((itLeftSort = left.find(FieldSort)) == left.end())
-  {
-    result = false;
-    return true;
-  }
-  if ((itRightSort = right.find(FieldSort)) == right.end())
-  {
-    result = true;
-    return true;
-  }
-
-  // look at special sorting behaviour
-  SortItem::const_iterator itLeft, itRight;
-  SortSpecial leftSortSpecial = SortSpecialNone;
-  SortSpecial rightSortSpecial = SortSpecialNone;
-  if ((itLeft = left.find(FieldSortSpecial)) != left.end() && itLeft->second.asInteger() <= (int64_t)SortSpecialOnBottom)
-    leftSortSpecial = (SortSpecial)itLeft->second.asInteger();
-  if ((itRight = right.find(FieldSortSpecial)) != right.end() && itRight->second.asInteger() <= (int64_t)SortSpecialOnBottom)
-    rightSortSpecial = (SortSpecial)itRight->second.asInteger();
-  
-  // one has a special sort
-  if (leftSortSpecial != rightSortSpecial)
-  {
-    // left should be sorted on top
-    // or right should be sorted on bottom
-    // => left is sorted above right
-    if (leftSortSpecial == SortSpecialOnTop ||
-        rightSortSpecial == SortSpecialOnBottom)
-    {
-      result = true;
-      return true;
-    }
-    
-    // otherwise right is sorted above left
-    result = false;
-    return true;
-  }
-  // both have either sort on top or sort on bottom -> leave as-is
-  else if (leftSortSpecial != SortSpecialNone && leftSortSpecial == rightSortSpecial)
-  {
-    result = false;
-    return true;
-  }
-
-  if (handleFolder)
-  {
-    itLeft = left.find(FieldFolder);
-    itRight = right.find(FieldFolder);
-    if (itLeft != left.end() && itRight != right.end() &&
-        itLeft->second.asBoolean() != itRight->second.asBoolean())
-    {
-      result = itLeft->second.asBoolean();
-      return true;
-    }
-  }
-
-  labelLeft = itLeftSort->second.asWideString();
-  labelRight = itRightSort->second.asWideString();
-
-  return false;
-}
-
-bool SorterAscending(const SortItem &left, const SortItem &right)
-{
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, true, result, labelLeft, labelRight))
-    return result;
-
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) < 0;
-}
-
-bool SorterDescending(const SortItem &left, const SortItem &right)
-{
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, true, result, labelLeft, labelRight))
-    return result;
-
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) > 0;
-}
-
-bool SorterIgnoreFoldersAscending(const SortItem &left, const SortItem &right)
-{
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, false, result, labelLeft, labelRight))
-    return result;
-
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) < 0;
-}
-
-bool SorterIgnoreFoldersDescending(const SortItem &left, const SortItem &right)
-{
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, false, result, labelLeft, labelRight))
-    return result;
-
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) > 0;
-}
-
-bool SorterIndirectAscending(const SortItemPtr &left, const SortItemPtr &right)
-{
-  return SorterAscending(*left, *right);
-}
-
-bool SorterIndirectDescending(const SortItemPtr &left, const SortItemPtr &right)
-{
-  return SorterDescending(*left, *right);
-}
-
-bool SorterIndirectIgnoreFoldersAscending(const SortItemPtr &left, const SortItemPtr &right)
-{
-  return SorterIgnoreFoldersAscending(*left, *right);
-}
-
-bool SorterIndirectIgnoreFoldersDescending(const SortItemPtr &left, const SortItemPtr &right)
-{
-  return SorterIgnoreFoldersDescending(*left, *right);
-}
-
 std::map<SortBy, SortUtils::SortPreparator> fillPreparators()
 {
   std::map<SortBy, SortUtils::SortPreparator> preparators;
@@ -709,104 +589,215 @@ std::map<SortBy, Fields> fillSortingFields()
 std::map<SortBy, SortUtils::SortPreparator> SortUtils::m_preparators = fillPreparators();
 std::map<SortBy, Fields> SortUtils::m_sortingFields = fillSortingFields();
 
-void SortUtils::Sort(SortBy sortBy, SortOrder sortOrder, SortAttribute attributes, DatabaseResults& items, int limitEnd /* = -1 */, int limitStart /* = 0 */)
+namespace
+{
+/*!
+ \brief Everything the sorters look at for one item, taken from its SortItem before sorting.
+ */
+struct SortKey
+{
+  std::wstring label;   ///< the prepared sort label
+  std::string key;      ///< the collation key of the label
+  size_t index;         ///< position of the item before sorting
+  SortSpecial special;
+  int folder;           ///< 1 for folders, 0 for other items, -1 if the item doesn't tell
+};
+
+class SortKeyCompare
 {
-  if (sortBy != SortByNone)
+public:
+  SortKeyCompare(SortOrder sortOrder, SortAttribute attributes)
+    : m_descending(sortOrder == SortOrderDescending),
+      m_handleFolder((attributes & SortAttributeIgnoreFolders) == 0)
+  { }
+
+  /*! \brief Three-way comparison of two items, 0 if their order is to be kept.
+   Items sorted on top or bottom come first/last, then folders come first (unless ignored)
+   and the remaining items are compared by their labels.
+   */
+  int64_t Compare(const SortKey &left, const SortKey &right) const
+  {
+    if (left.special != right.special)
+      return left.special == SortSpecialOnTop || right.special == SortSpecialOnBottom ? -1 : 1;
+    if (left.special != SortSpecialNone)
+      return 0;
+
+    if (m_handleFolder && left.folder >= 0 && right.folder >= 0 && left.folder != right.folder)
+      return left.folder > 0 ? -1 : 1;
+
+    int64_t result = left.key.compare(right.key);
+    return m_descending ? -result : result;
+  }
+
+  bool operator()(const SortKey &left, const SortKey &right) const
+  {
+    return Compare(left, right) < 0;
+  }
+
+private:
+  bool m_descending;
+  bool m_handleFolder;
+};
+
+SortItem& GetSortItem(DatabaseResult &item) { return item; }
+SortItem& GetSortItem(SortItemPtr &item) { return *item; }
+
+void PrepareSortKey(SortUtils::SortPreparator preparator, const Fields &sortingFields, SortAttribute attributes, SortItem &item, SortKey &key)
+{
+  // add all fields to the item that are required for sorting if they are currently missing
+  for (Fields::const_iterator field = sortingFields.begin(); field != sortingFields.end(); ++field)
+  {
+    if (item.find(*field) == item.end())
+      item.insert(std::pair<Field, CVariant>(*field, CVariant::ConstNullVariant));
+  }
+
+  SortItem::const_iterator it;
+  if ((it = item.find(FieldSort)) != item.end())
+    key.label = it->second.asWideString();
+  else
   {
-    // get the matching SortPreparator
-    SortPreparator preparator = getPreparator(sortBy);
-    if (preparator != NULL)
-    {
-      Fields sortingFields = GetFieldsForSorting(sortBy);
-
-      // Prepare the string used for sorting and store it under FieldSort
-      for (DatabaseResults::iterator item = items.begin(); item != items.end(); ++item)
-      {
-        // add all fields to the item that are required for sorting if they are currently missing
-        for (Fields::const_iterator field = sortingFields.begin(); field != sortingFields.end(); ++field)
-        {
-          if (item->find(*field) == item->end())
-            item->insert(std::pair<Field, CVariant>(*field, CVariant::ConstNullVariant));
-        }
-
-        std::wstring sortLabel;
 #ifdef TARGET_ANDROID
-        // Android does not support locale; Translate to ASCII
-        std::string dest;
-        g_charsetConverter.utf8ToASCII(preparator(attributes, *item), dest);
-        for (char c : dest)
-        {
-          if (::isalnum(c) || c == ' ')
-            sortLabel.push_back(c);
-        }
+    // Android does not support locale; Translate to ASCII
+    std::string dest;
+    g_charsetConverter.utf8ToASCII(preparator(attributes, item), dest);
+    for (char c : dest)
+    {
+      if (::isalnum(c) || c == ' ')
+        key.label.push_back(c);
+    }
 #else
-        g_charsetConverter.utf8ToW(preparator(attributes, *item), sortLabel, false);
+    g_charsetConverter.utf8ToW(preparator(attributes, item), key.label, false);
 #endif
-        item->insert(std::pair<Field, CVariant>(FieldSort, CVariant(sortLabel)));
-      }
+  }
+
+  key.key = StringUtils::AlphaNumericCollationKey(key.label.c_str());
+
+  key.special = SortSpecialNone;
+  if ((it = item.find(FieldSortSpecial)) != item.end() && it->second.asInteger() <= (int64_t)SortSpecialOnBottom)
+    key.special = (SortSpecial)it->second.asInteger();
 
-      // Do the sorting
-      std::stable_sort(items.begin(), items.end(), getSorter(sortOrder, attributes));
+  key.folder = -1;
+  if ((it = item.find(FieldFolder)) != item.end())
+    key.folder = it->second.asBoolean() ? 1 : 0;
+}
+
+/*!
+ \brief Stable sort of large inputs, split into chunks that are sorted in parallel
+ and merged afterwards.
+ */
+void ParallelSort(std::vector<SortKey> &keys, const SortKeyCompare &compare, unsigned int chunks)
+{
+  std::vector<size_t> bounds;
+  for (unsigned int chunk = 0; chunk <= chunks; chunk++)
+    bounds.push_back(keys.size() * chunk / chunks);
+
+  CParallelJobs::Run(chunks, [&keys, &compare, &bounds](unsigned int chunk)
+  {
+    std::stable_sort(keys.begin() + bounds[chunk], keys.begin() + bounds[chunk + 1], compare);
+  })->Wait();
+
+  // merge neighbouring chunks until a single one is left
+  while (bounds.size() > 2)
+  {
+    std::vector<size_t> merged;
+    for (size_t i = 0; i + 2 < bounds.size(); i += 2)
+    {
+      std::inplace_merge(keys.begin() + bounds[i], keys.begin() + bounds[i + 1], keys.begin() + bounds[i + 2], compare);
+      merged.push_back(bounds[i]);
     }
+    if (bounds.size() % 2 == 0)
+      merged.push_back(bounds[bounds.size() - 2]);
+    merged.push_back(bounds.back());
+    bounds.swap(merged);
   }
+}
 
-  if (limitStart > 0 && (size_t)limitStart < items.size())
+/*!
+ \brief Get the range of sorted items to keep for the given limits.
+ */
+void GetLimits(size_t size, int limitEnd, int limitStart, size_t &first, size_t &last)
+{
+  first = 0;
+  last = size;
+  if (limitStart > 0 && (size_t)limitStart < size)
   {
-    items.erase(items.begin(), items.begin() + limitStart);
+    first = limitStart;
     limitEnd -= limitStart;
   }
-  if (limitEnd > 0 && (size_t)limitEnd < items.size())
-    items.erase(items.begin() + limitEnd, items.end());
+  if (limitEnd > 0 && (size_t)limitEnd < last - first)
+    last = first + limitEnd;
 }
 
-void SortUtils::Sort(SortBy sortBy, SortOrder sortOrder, SortAttribute attributes, SortItems& items, int limitEnd /* = -1 */, int limitStart /* = 0 */)
+void SortKeys(std::vector<SortKey> &keys, SortOrder sortOrder, SortAttribute attributes, int limitEnd, int limitStart)
 {
-  if (sortBy != SortByNone)
+  SortKeyCompare compare(sortOrder, attributes);
+
+  // when only a page at the start of a long list is kept, the rest doesn't have to be ordered.
+  // Ties are broken by the original position, so the page is the same as with a stable sort
+  size_t first, last;
+  GetLimits(keys.size(), limitEnd, limitStart, first, last);
+  if (last < keys.size() / 2)
   {
-    // get the matching SortPreparator
-    SortPreparator preparator = getPreparator(sortBy);
-    if (preparator != NULL)
+    std::partial_sort(keys.begin(), keys.begin() + last, keys.end(), [&compare](const SortKey &left, const SortKey &right)
     {
-      Fields sortingFields = GetFieldsForSorting(sortBy);
-
-      // Prepare the string used for sorting and store it under FieldSort
-      for (SortItems::iterator item = items.begin(); item != items.end(); ++item)
-      {
-        // add all fields to the item that are required for sorting if they are currently missing
-        for (Fields::const_iterator field = sortingFields.begin(); field != sortingFields.end(); ++field)
-        {
-          if ((*item)->find(*field) == (*item)->end())
-            (*item)->insert(std::pair<Field, CVariant>(*field, CVariant::ConstNullVariant));
-        }
-
-        std::wstring sortLabel;
-#ifdef TARGET_ANDROID
-        // Android does not support locale; Translate to ASCII
-        std::string dest;
-        g_charsetConverter.utf8ToASCII(preparator(attributes, **item), dest);
-        for (char c : dest)
-        {
-          if (::isalnum(c) || c == ' ')
-            sortLabel.push_back(c);
-        }
-#else
-        g_charsetConverter.utf8ToW(preparator(attributes, **item), sortLabel, false);
-#endif
-        (*item)->insert(std::pair<Field, CVariant>(FieldSort, CVariant(sortLabel)));
-      }
+      int64_t result = compare.Compare(left, right);
+      return result != 0 ? result < 0 : left.index < right.index;
+    });
+    return;
+  }
 
-      // Do the sorting
-      std::stable_sort(items.begin(), items.end(), getSorterIndirect(sortOrder, attributes));
-    }
+  unsigned int chunks = std::min(std::max(g_cpuInfo.getCPUCount(), 1), SORT_PARALLEL_MAX_CHUNKS);
+  if (keys.size() >= SORT_PARALLEL_MIN_ITEMS && chunks > 1)
+    ParallelSort(keys, compare, chunks);
+  else
+    std::stable_sort(keys.begin(), keys.end(), compare);
+}
+
+template<typename T>
+void SortAndLimit(SortUtils::SortPreparator preparator, const Fields &sortingFields, SortOrder sortOrder, SortAttribute attributes, std::vector<T> &items, int limitEnd, int limitStart)
+{
+  size_t first, last;
+  if (preparator == NULL)
+  {
+    GetLimits(items.size(), limitEnd, limitStart, first, last);
+    items.erase(items.begin() + last, items.end());
+    items.erase(items.begin(), items.begin() + first);
+    return;
   }
 
-  if (limitStart > 0 && (size_t)limitStart < items.size())
+  std::vector<SortKey> keys(items.size());
+  for (size_t index = 0; index < items.size(); index++)
   {
-    items.erase(items.begin(), items.begin() + limitStart);
-    limitEnd -= limitStart;
+    keys[index].index = index;
+    PrepareSortKey(preparator, sortingFields, attributes, GetSortItem(items[index]), keys[index]);
+  }
+
+  SortKeys(keys, sortOrder, attributes, limitEnd, limitStart);
+
+  // only the items that are kept are moved into place and get their sort label stored under FieldSort
+  GetLimits(keys.size(), limitEnd, limitStart, first, last);
+  std::vector<T> sorted;
+  sorted.reserve(last - first);
+  for (size_t index = first; index < last; index++)
+  {
+    T &item = items[keys[index].index];
+    GetSortItem(item).insert(std::pair<Field, CVariant>(FieldSort, CVariant(std::move(keys[index].label))));
+    sorted.push_back(std::move(item));
   }
-  if (limitEnd > 0 && (size_t)limitEnd < items.size())
-    items.erase(items.begin() + limitEnd, items.end());
+  items.swap(sorted);
+}
+}
+
+void SortUtils::Sort(SortBy sortBy, SortOrder sortOrder, SortAttribute attributes, DatabaseResults& items, int limitEnd /* = -1 */, int limitStart /* = 0 */)
+{
+  SortPreparator preparator = sortBy != SortByNone ? getPreparator(sortBy) : NULL;
+  SortAndLimit(preparator, GetFieldsForSorting(sortBy), sortOrder, attributes, items, limitEnd, limitStart);
+}
+
+void SortUtils::Sort(SortBy sortBy, SortOrder sortOrder, SortAttribute attributes, SortItems& items, int limitEnd /* = -1 */, int limitStart /* = 0 */)
+{
+  SortPreparator preparator = sortBy != SortByNone ? getPreparator(sortBy) : NULL;
+  SortAndLimit(preparator, GetFieldsForSorting(sortBy), sortOrder, attributes, items, limitEnd, limitStart);
 }
 
 void SortUtils::Sort(const SortDescription &sortDescription, DatabaseResults& items)
@@ -849,22 +840,6 @@ const SortUtils::SortPreparator& SortUtils::getPreparator(SortBy sortBy)
   return m_preparators[SortByNone];
 }
 
-SortUtils::Sorter SortUtils::getSorter(SortOrder sortOrder, SortAttribute attributes)
-{
-  if (attributes & SortAttributeIgnoreFolders)
-    return sortOrder == SortOrderDescending ? SorterIgnoreFoldersDescending : SorterIgnoreFoldersAscending;
-
-  return sortOrder == SortOrderDescending ? SorterDescending : SorterAscending;
-}
-
-SortUtils::SorterIndirect SortUtils::getSorterIndirect(SortOrder sortOrder, SortAttribute attributes)
-{
-  if (attributes & SortAttributeIgnoreFolders)
-    return sortOrder == SortOrderDescending ? SorterIndirectIgnoreFoldersDescending : SorterIndirectIgnoreFoldersAscending;
-
-  return sortOrder == SortOrderDescending ? SorterIndirectDescending : SorterIndirectAscending;
-}
-
 const Fields& SortUtils::GetFieldsForSorting(SortBy sortBy)
 {
   std::map<SortBy, Fields>::const_iterator it = m_sortingFields.find(sortBy);
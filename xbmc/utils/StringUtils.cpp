@@ -766,13 +766,18 @@ int StringUtils::FindNumber(const std::string& strInput, const std::string &strF
 // returns negative if left < right, positive if left > right
 // and 0 if they are identical (essentially calculates left - right)
 int64_t StringUtils::AlphaNumericCompare(const wchar_t *left, const wchar_t *right)
+{
+  return AlphaNumericCompare(left, right, g_langInfo.GetSystemLocale());
+}
+
+int64_t StringUtils::AlphaNumericCompare(const wchar_t *left, const wchar_t *right, const std::locale &locale)
 {
   wchar_t *l = (wchar_t *)left;
   wchar_t *r = (wchar_t *)right;
   wchar_t *ld, *rd;
   wchar_t lc, rc;
   int64_t lnum, rnum;
-  const std::collate<wchar_t>& coll = std::use_facet<std::collate<wchar_t> >(g_langInfo.GetSystemLocale());
+  const std::collate<wchar_t>& coll = std::use_facet<std::collate<wchar_t> >(locale);
   int cmp_res = 0;
   while (*l != 0 && *r != 0)
   {
@@ -810,6 +815,17 @@ int64_t StringUtils::AlphaNumericCompare(const wchar_t *left, const wchar_t *rig
     if (rc >= L'A' && rc <= L'Z')
       rc += L'a'- L'A';
 
+    // a number sorts after the characters that collate before '0' and before all others,
+    // whatever its digits, so that numbers are ordered the same against any character
+    bool ldigit = lc >= L'0' && lc <= L'9';
+    if (ldigit != (rc >= L'0' && rc <= L'9'))
+    {
+      const wchar_t zero = L'0';
+      wchar_t c = ldigit ? rc : lc;
+      bool beforeNumbers = coll.compare(&c, &c + 1, &zero, &zero + 1) < 0;
+      return beforeNumbers == ldigit ? 1 : -1;
+    }
+
     // ok, do a normal comparison, taking current locale into account. Add special case stuff (eg '(' characters)) in here later
     if ((cmp_res = coll.compare(&lc, &lc + 1, &rc, &rc + 1)) != 0)
     {
@@ -828,6 +844,106 @@ int64_t StringUtils::AlphaNumericCompare(const wchar_t *left, const wchar_t *rig
   return 0; // files are the same
 }
 
+namespace
+{
+// append an unsigned value in as few bytes as possible, so that the encoded values
+// still compare like the values when compared bytewise. The first byte tells the
+// length: 0x01-0x7f for one byte, 0x80-0xbf for two, 0xc0-0xdf for three, 0xe0 for five
+void AppendCompactUnit(uint32_t unit, std::string &key)
+{
+  if (unit < 0x80)
+    key.push_back(static_cast<char>(unit));
+  else if (unit < 0x4000)
+  {
+    key.push_back(static_cast<char>(0x80 | (unit >> 8)));
+    key.push_back(static_cast<char>(unit));
+  }
+  else if (unit < 0x200000)
+  {
+    key.push_back(static_cast<char>(0xc0 | (unit >> 16)));
+    key.push_back(static_cast<char>(unit >> 8));
+    key.push_back(static_cast<char>(unit));
+  }
+  else
+  {
+    key.push_back(static_cast<char>(0xe0));
+    key.push_back(static_cast<char>(unit >> 24));
+    key.push_back(static_cast<char>(unit >> 16));
+    key.push_back(static_cast<char>(unit >> 8));
+    key.push_back(static_cast<char>(unit));
+  }
+}
+
+// the first byte of every character or number in a key
+enum CollationKeyClass : char
+{
+  COLLATION_KEY_BEFORE_NUMBERS = 1, // characters that collate before '0'
+  COLLATION_KEY_NUMBER = 2,
+  COLLATION_KEY_AFTER_NUMBERS = 3   // all other characters
+};
+
+void AppendCollationWeights(const std::collate<wchar_t> &coll, wchar_t c, std::string &key)
+{
+  // shift the weights by one so the terminator sorts before them, which keeps
+  // a character whose weights are a prefix of another one's in front of it
+  std::wstring weights = coll.transform(&c, &c + 1);
+  for (wchar_t weight : weights)
+    AppendCompactUnit(static_cast<uint32_t>(weight) + 1, key);
+  key.push_back('\0');
+}
+}
+
+std::string StringUtils::AlphaNumericCollationKey(const wchar_t *str)
+{
+  return AlphaNumericCollationKey(str, g_langInfo.GetSystemLocale());
+}
+
+std::string StringUtils::AlphaNumericCollationKey(const wchar_t *str, const std::locale &locale)
+{
+  const std::collate<wchar_t>& coll = std::use_facet<std::collate<wchar_t> >(locale);
+
+  // the weights compare like the characters, so comparing them to the weights of '0' tells
+  // on which side of the numbers a character sorts
+  std::string zero;
+  AppendCollationWeights(coll, L'0', zero);
+
+  std::string key;
+  std::string weights;
+  const wchar_t *s = str;
+  while (*s != 0)
+  {
+    if (*s >= L'0' && *s <= L'9')
+    {
+      // numbers sort by value among each other, 15 digits at a time. The value is
+      // stored without leading zero bytes behind its length, so shorter is smaller
+      key.push_back(COLLATION_KEY_NUMBER);
+      const wchar_t *digits = s;
+      uint64_t number = 0;
+      while (*s >= L'0' && *s <= L'9' && s < digits + 15)
+      {
+        number *= 10;
+        number += *s++ - L'0';
+      }
+      int bytes = 0;
+      while (bytes < 8 && (number >> (8 * bytes)) != 0)
+        bytes++;
+      key.push_back(static_cast<char>(bytes));
+      for (int shift = 8 * (bytes - 1); shift >= 0; shift -= 8)
+        key.push_back(static_cast<char>(number >> shift));
+      continue;
+    }
+
+    wchar_t c = *s++;
+    if (c >= L'A' && c <= L'Z')
+      c += L'a' - L'A';
+    weights.clear();
+    AppendCollationWeights(coll, c, weights);
+    key.push_back(weights.compare(zero) < 0 ? COLLATION_KEY_BEFORE_NUMBERS : COLLATION_KEY_AFTER_NUMBERS);
+    key += weights;
+  }
+  return key;
+}
+
 int StringUtils::DateStringToYYYYMMDD(const std::string &dateString)
 {
   std::vector<std::string> days = StringUtils::Split(dateString, '-');
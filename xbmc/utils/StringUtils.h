@@ -240,6 +240,16 @@ public:
   static std::vector<std::string> SplitMulti(const std::vector<std::string> &input, const std::vector<std::string> &delimiters, unsigned int iMaxStrings = 0);
   static int FindNumber(const std::string& strInput, const std::string &strFind);
   static int64_t AlphaNumericCompare(const wchar_t *left, const wchar_t *right);
+  static int64_t AlphaNumericCompare(const wchar_t *left, const wchar_t *right, const std::locale &locale);
+  /*! \brief Get a key that orders strings like AlphaNumericCompare() when compared bytewise.
+   Numbers are compared by value and letters by the collation of the current locale, so keys
+   are only valid until the locale changes and are best built for a single sort. Numbers sort
+   after the characters that collate before '0' and before all other characters.
+   \param str the string to get the key for
+   \return the key, to be compared with memcmp() or std::string::compare()
+   */
+  static std::string AlphaNumericCollationKey(const wchar_t *str);
+  static std::string AlphaNumericCollationKey(const wchar_t *str, const std::locale &locale);
   static long TimeStringToSeconds(const std::string &timeString);
   static void RemoveCRLF(std::string& strLine);
 
@@ -0,0 +1,398 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "YUVConverter.h"
+#include "utils/CPUInfo.h"
+#include "utils/JobManager.h"
+
+#include <algorithm>
+#include <vector>
+
+#if defined(HAVE_SSE2) && defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(HAS_NEON)
+#include <arm_neon.h>
+#endif
+
+// pictures below this size are converted on the calling thread only
+#define YUV_PARALLEL_MIN_PIXELS (320 * 240)
+#define YUV_PARALLEL_MAX_SLICES 16
+#define YUV_SLICE_MIN_ROWS      64
+
+namespace
+{
+/*!
+ \brief Fixed point conversion coefficients.
+
+ Luma is scaled as Y << 8 and chroma as (C - 128) << 8, both are multiplied by
+ the coefficient * 8192 and the upper 16 bits of the product are kept. That
+ leaves results with 5 fractional bits, which fit 16-bit simd lanes.
+ */
+struct Coefficients
+{
+  int16_t y;
+  int16_t yOffset; // luma of black, (16 << 8) * y >> 16
+  int16_t rv;
+  int16_t gu;
+  int16_t gv;
+  int16_t bu;
+};
+
+const Coefficients BT601 = { 9539, 596, 13075, 3209, 6660, 16525 };
+const Coefficients BT709 = { 9539, 596, 14686, 1747, 4366, 17305 };
+
+struct Picture
+{
+  CYUVConverter::Format format;
+  CYUVConverter::Output output;
+  const uint8_t *planes[3];
+  int strides[3];
+  unsigned int width;
+  uint8_t *dst;
+  int dstStride;
+  const Coefficients *coefficients;
+};
+
+inline uint8_t Clamp(int value)
+{
+  return static_cast<uint8_t>(std::min(std::max(value, 0), 255));
+}
+
+/*!
+ \brief Convert pixels from first up to the end of a row, one at a time.
+ \note The simd kernels produce exactly the same values.
+ */
+template<CYUVConverter::Format format, CYUVConverter::Output output>
+void ConvertPixels(const Picture &picture, const uint8_t *y, const uint8_t *u, const uint8_t *v, uint8_t *dst, unsigned int first)
+{
+  const Coefficients &c = *picture.coefficients;
+  for (unsigned int x = first; x < picture.width; x++)
+  {
+    int luma, cu, cv;
+    switch (format)
+    {
+    case CYUVConverter::Format::YUV420P:
+      luma = y[x];
+      cu = u[x / 2];
+      cv = v[x / 2];
+      break;
+    case CYUVConverter::Format::NV12:
+      luma = y[x];
+      cu = u[x / 2 * 2];
+      cv = u[x / 2 * 2 + 1];
+      break;
+    case CYUVConverter::Format::P010:
+      // the upper byte of each little endian sample
+      luma = y[x * 2 + 1];
+      cu = u[x / 2 * 4 + 1];
+      cv = u[x / 2 * 4 + 3];
+      break;
+    }
+
+    int yv = ((luma << 8) * c.y >> 16) - c.yOffset + 16;
+    cu = (cu - 128) * 256;
+    cv = (cv - 128) * 256;
+
+    uint8_t r = Clamp((yv + (cv * c.rv >> 16)) >> 5);
+    uint8_t g = Clamp((yv - ((cu * c.gu >> 16) + (cv * c.gv >> 16))) >> 5);
+    uint8_t b = Clamp((yv + (cu * c.bu >> 16)) >> 5);
+
+    uint8_t *pixel = dst + x * 4;
+    pixel[0] = output == CYUVConverter::Output::BGRA ? b : r;
+    pixel[1] = g;
+    pixel[2] = output == CYUVConverter::Output::BGRA ? r : b;
+    pixel[3] = 0xFF;
+  }
+}
+
+#if defined(HAVE_SSE2) && defined(__SSE2__)
+/*!
+ \brief Convert 16 pixels at a time.
+ \return the number of pixels converted
+ */
+template<CYUVConverter::Format format, CYUVConverter::Output output>
+unsigned int ConvertPixelsSIMD(const Picture &picture, const uint8_t *y, const uint8_t *u, const uint8_t *v, uint8_t *dst)
+{
+  const Coefficients &c = *picture.coefficients;
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i alpha = _mm_set1_epi8(static_cast<char>(0xFF));
+  const __m128i chromaBias = _mm_set1_epi16(static_cast<short>(0x8000));
+  const __m128i upperBytes = _mm_set1_epi16(static_cast<short>(0xFF00));
+  const __m128i coeffY = _mm_set1_epi16(c.y);
+  const __m128i offsetY = _mm_set1_epi16(c.yOffset - 16);
+  const __m128i coeffRV = _mm_set1_epi16(c.rv);
+  const __m128i coeffGU = _mm_set1_epi16(c.gu);
+  const __m128i coeffGV = _mm_set1_epi16(c.gv);
+  const __m128i coeffBU = _mm_set1_epi16(c.bu);
+
+  unsigned int x = 0;
+  for (; x + 16 <= picture.width; x += 16)
+  {
+    // 16 luma bytes and 8 chroma samples as C << 8
+    __m128i luma, cu, cv;
+    switch (format)
+    {
+    case CYUVConverter::Format::YUV420P:
+      luma = _mm_loadu_si128(reinterpret_cast<const __m128i*>(y + x));
+      cu = _mm_unpacklo_epi8(zero, _mm_loadl_epi64(reinterpret_cast<const __m128i*>(u + x / 2)));
+      cv = _mm_unpacklo_epi8(zero, _mm_loadl_epi64(reinterpret_cast<const __m128i*>(v + x / 2)));
+      break;
+    case CYUVConverter::Format::NV12:
+    {
+      luma = _mm_loadu_si128(reinterpret_cast<const __m128i*>(y + x));
+      __m128i uv = _mm_loadu_si128(reinterpret_cast<const __m128i*>(u + x));
+      cu = _mm_slli_epi16(uv, 8);
+      cv = _mm_and_si128(uv, upperBytes);
+      break;
+    }
+    case CYUVConverter::Format::P010:
+    {
+      // narrowing the upper bytes of the samples gives the NV12 layout
+      const __m128i *src = reinterpret_cast<const __m128i*>(y + x * 2);
+      luma = _mm_packus_epi16(_mm_srli_epi16(_mm_loadu_si128(src), 8),
+                              _mm_srli_epi16(_mm_loadu_si128(src + 1), 8));
+      src = reinterpret_cast<const __m128i*>(u + x * 2);
+      __m128i uv = _mm_packus_epi16(_mm_srli_epi16(_mm_loadu_si128(src), 8),
+                                    _mm_srli_epi16(_mm_loadu_si128(src + 1), 8));
+      cu = _mm_slli_epi16(uv, 8);
+      cv = _mm_and_si128(uv, upperBytes);
+      break;
+    }
+    }
+
+    cu = _mm_xor_si128(cu, chromaBias);
+    cv = _mm_xor_si128(cv, chromaBias);
+
+    __m128i yLow = _mm_sub_epi16(_mm_mulhi_epu16(_mm_unpacklo_epi8(zero, luma), coeffY), offsetY);
+    __m128i yHigh = _mm_sub_epi16(_mm_mulhi_epu16(_mm_unpackhi_epi8(zero, luma), coeffY), offsetY);
+
+    __m128i rv = _mm_mulhi_epi16(cv, coeffRV);
+    __m128i guv = _mm_add_epi16(_mm_mulhi_epi16(cu, coeffGU), _mm_mulhi_epi16(cv, coeffGV));
+    __m128i bu = _mm_mulhi_epi16(cu, coeffBU);
+
+    // every chroma term is used for two neighbouring pixels
+    __m128i r = _mm_packus_epi16(_mm_srai_epi16(_mm_add_epi16(yLow, _mm_unpacklo_epi16(rv, rv)), 5),
+                                 _mm_srai_epi16(_mm_add_epi16(yHigh, _mm_unpackhi_epi16(rv, rv)), 5));
+    __m128i g = _mm_packus_epi16(_mm_srai_epi16(_mm_sub_epi16(yLow, _mm_unpacklo_epi16(guv, guv)), 5),
+                                 _mm_srai_epi16(_mm_sub_epi16(yHigh, _mm_unpackhi_epi16(guv, guv)), 5));
+    __m128i b = _mm_packus_epi16(_mm_srai_epi16(_mm_add_epi16(yLow, _mm_unpacklo_epi16(bu, bu)), 5),
+                                 _mm_srai_epi16(_mm_add_epi16(yHigh, _mm_unpackhi_epi16(bu, bu)), 5));
+
+    __m128i first = output == CYUVConverter::Output::BGRA ? b : r;
+    __m128i third = output == CYUVConverter::Output::BGRA ? r : b;
+
+    __m128i *pixels = reinterpret_cast<__m128i*>(dst + x * 4);
+    __m128i firstG = _mm_unpacklo_epi8(first, g);
+    __m128i thirdA = _mm_unpacklo_epi8(third, alpha);
+    _mm_storeu_si128(pixels, _mm_unpacklo_epi16(firstG, thirdA));
+    _mm_storeu_si128(pixels + 1, _mm_unpackhi_epi16(firstG, thirdA));
+    firstG = _mm_unpackhi_epi8(first, g);
+    thirdA = _mm_unpackhi_epi8(third, alpha);
+    _mm_storeu_si128(pixels + 2, _mm_unpacklo_epi16(firstG, thirdA));
+    _mm_storeu_si128(pixels + 3, _mm_unpackhi_epi16(firstG, thirdA));
+  }
+  return x;
+}
+#elif defined(HAS_NEON)
+inline int16x8_t MulHigh(int16x8_t value, int16_t coefficient)
+{
+  return vcombine_s16(vshrn_n_s32(vmull_n_s16(vget_low_s16(value), coefficient), 16),
+                      vshrn_n_s32(vmull_n_s16(vget_high_s16(value), coefficient), 16));
+}
+
+inline int16x8_t MulHigh(uint16x8_t value, uint16_t coefficient)
+{
+  return vreinterpretq_s16_u16(vcombine_u16(vshrn_n_u32(vmull_n_u16(vget_low_u16(value), coefficient), 16),
+                                            vshrn_n_u32(vmull_n_u16(vget_high_u16(value), coefficient), 16)));
+}
+
+inline uint8x16_t Narrow(int16x8_t low, int16x8_t high)
+{
+  return vcombine_u8(vqshrun_n_s16(low, 5), vqshrun_n_s16(high, 5));
+}
+
+/*!
+ \brief Convert 16 pixels at a time.
+ \return the number of pixels converted
+ */
+template<CYUVConverter::Format format, CYUVConverter::Output output>
+unsigned int ConvertPixelsSIMD(const Picture &picture, const uint8_t *y, const uint8_t *u, const uint8_t *v, uint8_t *dst)
+{
+  const Coefficients &c = *picture.coefficients;
+  const int16x8_t chromaBias = vdupq_n_s16(static_cast<int16_t>(0x8000));
+  const int16x8_t offsetY = vdupq_n_s16(c.yOffset - 16);
+
+  unsigned int x = 0;
+  for (; x + 16 <= picture.width; x += 16)
+  {
+    // 16 luma bytes and 8 chroma bytes
+    uint8x16_t luma;
+    uint8x8_t u8, v8;
+    switch (format)
+    {
+    case CYUVConverter::Format::YUV420P:
+      luma = vld1q_u8(y + x);
+      u8 = vld1_u8(u + x / 2);
+      v8 = vld1_u8(v + x / 2);
+      break;
+    case CYUVConverter::Format::NV12:
+    {
+      luma = vld1q_u8(y + x);
+      uint8x8x2_t uv = vld2_u8(u + x);
+      u8 = uv.val[0];
+      v8 = uv.val[1];
+      break;
+    }
+    case CYUVConverter::Format::P010:
+    {
+      // the upper bytes of the little endian samples
+      luma = vld2q_u8(y + x * 2).val[1];
+      uint8x8x4_t uv = vld4_u8(u + x * 2);
+      u8 = uv.val[1];
+      v8 = uv.val[3];
+      break;
+    }
+    }
+
+    int16x8_t cu = veorq_s16(vreinterpretq_s16_u16(vshll_n_u8(u8, 8)), chromaBias);
+    int16x8_t cv = veorq_s16(vreinterpretq_s16_u16(vshll_n_u8(v8, 8)), chromaBias);
+
+    int16x8_t yLow = vsubq_s16(MulHigh(vshll_n_u8(vget_low_u8(luma), 8), static_cast<uint16_t>(c.y)), offsetY);
+    int16x8_t yHigh = vsubq_s16(MulHigh(vshll_n_u8(vget_high_u8(luma), 8), static_cast<uint16_t>(c.y)), offsetY);
+
+    // every chroma term is used for two neighbouring pixels
+    int16x8x2_t rv = vzipq_s16(MulHigh(cv, c.rv), MulHigh(cv, c.rv));
+    int16x8_t guvTerm = vaddq_s16(MulHigh(cu, c.gu), MulHigh(cv, c.gv));
+    int16x8x2_t guv = vzipq_s16(guvTerm, guvTerm);
+    int16x8x2_t bu = vzipq_s16(MulHigh(cu, c.bu), MulHigh(cu, c.bu));
+
+    uint8x16_t r = Narrow(vaddq_s16(yLow, rv.val[0]), vaddq_s16(yHigh, rv.val[1]));
+    uint8x16_t g = Narrow(vsubq_s16(yLow, guv.val[0]), vsubq_s16(yHigh, guv.val[1]));
+    uint8x16_t b = Narrow(vaddq_s16(yLow, bu.val[0]), vaddq_s16(yHigh, bu.val[1]));
+
+    uint8x16x4_t pixels;
+    pixels.val[0] = output == CYUVConverter::Output::BGRA ? b : r;
+    pixels.val[1] = g;
+    pixels.val[2] = output == CYUVConverter::Output::BGRA ? r : b;
+    pixels.val[3] = vdupq_n_u8(0xFF);
+    vst4q_u8(dst + x * 4, pixels);
+  }
+  return x;
+}
+#else
+template<CYUVConverter::Format format, CYUVConverter::Output output>
+unsigned int ConvertPixelsSIMD(const Picture&, const uint8_t*, const uint8_t*, const uint8_t*, uint8_t*)
+{
+  return 0;
+}
+#endif
+
+template<CYUVConverter::Format format, CYUVConverter::Output output>
+void ConvertRows(const Picture &picture, unsigned int first, unsigned int last)
+{
+  for (unsigned int row = first; row < last; row++)
+  {
+    const uint8_t *y = picture.planes[0] + row * picture.strides[0];
+    const uint8_t *u = picture.planes[1] + row / 2 * picture.strides[1];
+    const uint8_t *v = format == CYUVConverter::Format::YUV420P ? picture.planes[2] + row / 2 * picture.strides[2] : nullptr;
+    uint8_t *dst = picture.dst + row * picture.dstStride;
+
+    unsigned int x = ConvertPixelsSIMD<format, output>(picture, y, u, v, dst);
+    ConvertPixels<format, output>(picture, y, u, v, dst, x);
+  }
+}
+
+template<CYUVConverter::Format format>
+void ConvertRows(const Picture &picture, unsigned int first, unsigned int last)
+{
+  if (picture.output == CYUVConverter::Output::BGRA)
+    ConvertRows<format, CYUVConverter::Output::BGRA>(picture, first, last);
+  else
+    ConvertRows<format, CYUVConverter::Output::RGBA>(picture, first, last);
+}
+
+void ConvertRows(const Picture &picture, unsigned int first, unsigned int last)
+{
+  switch (picture.format)
+  {
+  case CYUVConverter::Format::YUV420P:
+    ConvertRows<CYUVConverter::Format::YUV420P>(picture, first, last);
+    break;
+  case CYUVConverter::Format::NV12:
+    ConvertRows<CYUVConverter::Format::NV12>(picture, first, last);
+    break;
+  case CYUVConverter::Format::P010:
+    ConvertRows<CYUVConverter::Format::P010>(picture, first, last);
+    break;
+  }
+}
+
+/*!
+ \brief Converts slices of a picture on the job manager's threads.
+ */
+void ConvertSliced(const Picture &picture, unsigned int height, unsigned int slices)
+{
+  // slices start on even rows, so no chroma row is shared
+  std::vector<unsigned int> bounds;
+  for (unsigned int slice = 0; slice <= slices; slice++)
+    bounds.push_back(std::min(height, (height * slice / slices + 1) & ~1u));
+  bounds.back() = height;
+
+  CParallelJobs::Run(slices, [&picture, &bounds](unsigned int slice)
+  {
+    ConvertRows(picture, bounds[slice], bounds[slice + 1]);
+  })->Wait();
+}
+}
+
+void CYUVConverter::Convert(Format format, const uint8_t* const planes[3], const int strides[3],
+                            unsigned int width, unsigned int height, uint8_t *dst, int dstStride,
+                            Output output /* = Output::BGRA */, Matrix matrix /* = Matrix::BT601 */, unsigned int slices /* = 0 */)
+{
+  if (width == 0 || height == 0)
+    return;
+
+  Picture picture;
+  picture.format = format;
+  picture.output = output;
+  for (int plane = 0; plane < 3; plane++)
+  {
+    picture.planes[plane] = planes[plane];
+    picture.strides[plane] = strides[plane];
+  }
+  picture.width = width;
+  picture.dst = dst;
+  picture.dstStride = dstStride;
+  picture.coefficients = matrix == Matrix::BT709 ? &BT709 : &BT601;
+
+  if (slices == 0)
+  {
+    slices = 1;
+    if (width * height >= YUV_PARALLEL_MIN_PIXELS)
+      slices = std::min(std::max(g_cpuInfo.getCPUCount(), 1), YUV_PARALLEL_MAX_SLICES);
+    slices = std::max(std::min(slices, height / YUV_SLICE_MIN_ROWS), 1u);
+  }
+  slices = std::min(slices, height);
+
+  if (slices > 1)
+    ConvertSliced(picture, height, slices);
+  else
+    ConvertRows(picture, 0, height);
+}
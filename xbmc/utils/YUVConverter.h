@@ -0,0 +1,69 @@
+#pragma once
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+
+/*!
+ \brief Converts limited range 4:2:0 pictures to 32-bit RGB on the CPU.
+
+ Rows are converted with SSE2 or NEON where available and the picture is
+ split into horizontal slices that are converted on the job manager's threads.
+ Chroma is not interpolated, every chroma sample is used for its 2x2 pixels.
+ */
+class CYUVConverter
+{
+public:
+  enum class Format
+  {
+    YUV420P, //!< 8-bit Y, U and V planes
+    NV12,    //!< 8-bit Y plane, interleaved UV plane
+    P010     //!< 16-bit little endian samples in the upper bits, Y plane, interleaved UV plane
+  };
+
+  enum class Output
+  {
+    BGRA,
+    RGBA
+  };
+
+  enum class Matrix
+  {
+    BT601,
+    BT709
+  };
+
+  /*!
+   \brief Convert a picture to 32-bit RGB with opaque alpha.
+   \param format layout of the source planes
+   \param planes source planes, the third one is only used for YUV420P
+   \param strides line sizes of the source planes in bytes
+   \param width width of the picture in pixels
+   \param height height of the picture in pixels
+   \param dst destination with room for height lines of dstStride bytes
+   \param dstStride line size of the destination in bytes
+   \param output byte order of the destination pixels
+   \param matrix colour matrix of the source
+   \param slices number of slices converted concurrently, 0 picks one per cpu for large pictures
+   */
+  static void Convert(Format format, const uint8_t* const planes[3], const int strides[3],
+                      unsigned int width, unsigned int height, uint8_t *dst, int dstStride,
+                      Output output = Output::BGRA, Matrix matrix = Matrix::BT601, unsigned int slices = 0);
+};
@@ -23,6 +23,7 @@
 
 #include "gtest/gtest.h"
 #include <atomic>
+#include <stdexcept>
 
 #ifdef TARGET_POSIX
 #include "platform/linux/XTimeUtils.h"
@@ -183,3 +184,64 @@ TEST_F(TestJobManager, IsProcessing)
 
   job->FinishAndStopBlocking();
 }
+
+TEST_F(TestJobManager, ChangeJobPriority)
+{
+  JobControlPackage package;
+  CJobManager::GetInstance().PauseJobs();
+
+  // pausable jobs stay queued while paused, so promoting it is the only way it can run
+  BroadcastingJob *job = new BroadcastingJob(package);
+  unsigned int id = CJobManager::GetInstance().AddJob(job, NULL, CJob::PRIORITY_LOW_PAUSABLE);
+  EXPECT_TRUE(CJobManager::GetInstance().ChangeJobPriority(id, CJob::PRIORITY_NORMAL));
+
+  while (!package.ready)
+    package.jobCreatedCond.wait(package.jobCreatedMutex);
+
+  CJobManager::GetInstance().UnPauseJobs();
+  EXPECT_TRUE(CJobManager::GetInstance().IsProcessing(CJob::PRIORITY_NORMAL));
+  EXPECT_FALSE(CJobManager::GetInstance().ChangeJobPriority(id, CJob::PRIORITY_LOW));
+
+  job->FinishAndStopBlocking();
+}
+
+TEST_F(TestJobManager, ParallelJobsRunEveryTaskOnce)
+{
+  std::atomic<int> runs[16];
+  for (auto &run : runs)
+    run = 0;
+
+  std::shared_ptr<CParallelJobs> jobs = CParallelJobs::Run(16, [&runs](unsigned int task) { runs[task]++; });
+  jobs->Wait();
+
+  for (unsigned int task = 0; task < 16; task++)
+  {
+    EXPECT_EQ(1, runs[task]);
+    EXPECT_TRUE(jobs->IsFinished(task));
+  }
+}
+
+TEST_F(TestJobManager, ParallelJobsFinishThrowingTasks)
+{
+  std::shared_ptr<CParallelJobs> jobs = CParallelJobs::Run(4, [](unsigned int task) {
+    if (task % 2 == 0)
+      throw std::runtime_error("task failed");
+  });
+  EXPECT_TRUE(jobs->Wait(5000));
+
+  for (unsigned int task = 0; task < 4; task++)
+    EXPECT_TRUE(jobs->IsFinished(task));
+}
+
+TEST_F(TestJobManager, ParallelJobsDontWaitForWorkers)
+{
+  CJobManager::GetInstance().PauseJobs();
+
+  // the jobs stay queued, so the calling thread runs every task
+  std::atomic<int> runs(0);
+  std::shared_ptr<CParallelJobs> jobs = CParallelJobs::Run(4, [&runs](unsigned int task) { runs++; }, CJob::PRIORITY_LOW_PAUSABLE);
+  EXPECT_TRUE(jobs->Wait(0));
+  EXPECT_EQ(4, runs);
+
+  CJobManager::GetInstance().UnPauseJobs();
+}
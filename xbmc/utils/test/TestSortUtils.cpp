@@ -19,10 +19,51 @@
  */
 
 #include "utils/SortUtils.h"
+#include "utils/StringUtils.h"
 #include "utils/Variant.h"
 
 #include "gtest/gtest.h"
 
+#include <algorithm>
+
+namespace
+{
+// items with many equal artists, FieldId holds the original position
+void FillItems(SortItems &items, int count)
+{
+  for (int i = 0; i < count; i++)
+  {
+    SortItemPtr item(new SortItem());
+    (*item)[FieldArtist] = CVariant(StringUtils::Format("%02d Artist", (i * 7919) % 97));
+    (*item)[FieldId] = CVariant(i);
+    items.push_back(item);
+  }
+}
+
+// the positions of the items after a std::stable_sort on their artists
+std::vector<int> StableSorted(const SortItems &items, SortOrder order)
+{
+  std::vector<int> ids;
+  for (const auto &item : items)
+    ids.push_back(static_cast<int>((*item)[FieldId].asInteger()));
+  std::stable_sort(ids.begin(), ids.end(), [&items, order](int left, int right)
+  {
+    const std::string &leftArtist = (*items[left])[FieldArtist].asString();
+    const std::string &rightArtist = (*items[right])[FieldArtist].asString();
+    return order == SortOrderDescending ? rightArtist < leftArtist : leftArtist < rightArtist;
+  });
+  return ids;
+}
+
+std::vector<int> Ids(const SortItems &items)
+{
+  std::vector<int> ids;
+  for (const auto &item : items)
+    ids.push_back(static_cast<int>((*item)[FieldId].asInteger()));
+  return ids;
+}
+}
+
 TEST(TestSortUtils, Sort_SortBy)
 {
   SortItems items;
@@ -115,6 +156,84 @@ TEST(TestSortUtils, Sort_SortDescription)
   EXPECT_STREQ("R Artist", (*items.at(6))[FieldArtist].asString().c_str());
 }
 
+TEST(TestSortUtils, Sort_Limits)
+{
+  SortItems items;
+
+  const char *artists[] = { "M Artist", "B Artist", "R Artist", "R Artist", "I Artist", "A Artist", "G Artist" };
+  for (const char *artist : artists)
+  {
+    SortItemPtr item(new SortItem());
+    (*item)[FieldArtist] = CVariant(artist);
+    items.push_back(item);
+  }
+
+  SortDescription desc;
+  desc.sortBy = SortByArtist;
+  desc.limitStart = 2;
+  desc.limitEnd = 5;
+  SortUtils::Sort(desc, items);
+
+  EXPECT_EQ((size_t)3, items.size());
+  EXPECT_STREQ("G Artist", (*items.at(0))[FieldArtist].asString().c_str());
+  EXPECT_STREQ("I Artist", (*items.at(1))[FieldArtist].asString().c_str());
+  EXPECT_STREQ("M Artist", (*items.at(2))[FieldArtist].asString().c_str());
+  EXPECT_TRUE(items.at(0)->find(FieldSort) != items.at(0)->end());
+}
+
+TEST(TestSortUtils, Sort_LimitsFirstPage)
+{
+  // a page at the start of a long list takes the partial sort
+  SortItems items;
+  FillItems(items, 1000);
+  std::vector<int> expected = StableSorted(items, SortOrderAscending);
+  expected.resize(50);
+
+  SortDescription desc;
+  desc.sortBy = SortByArtist;
+  desc.limitEnd = 50;
+  SortUtils::Sort(desc, items);
+
+  EXPECT_EQ(expected, Ids(items));
+
+  items.clear();
+  FillItems(items, 1000);
+  expected = StableSorted(items, SortOrderDescending);
+  expected = std::vector<int>(expected.begin() + 20, expected.begin() + 70);
+
+  desc.sortOrder = SortOrderDescending;
+  desc.limitStart = 20;
+  desc.limitEnd = 70;
+  SortUtils::Sort(desc, items);
+
+  EXPECT_EQ(expected, Ids(items));
+}
+
+TEST(TestSortUtils, Sort_Parallel)
+{
+  // large enough to be sorted in chunks on several threads
+  SortItems items;
+  FillItems(items, 50000);
+  std::vector<int> expected = StableSorted(items, SortOrderAscending);
+
+  SortDescription desc;
+  desc.sortBy = SortByArtist;
+  SortUtils::Sort(desc, items);
+
+  EXPECT_EQ(expected, Ids(items));
+
+  items.clear();
+  FillItems(items, 50000);
+  expected = StableSorted(items, SortOrderDescending);
+  expected = std::vector<int>(expected.begin() + 30000, expected.end());
+
+  desc.sortOrder = SortOrderDescending;
+  desc.limitStart = 30000;
+  SortUtils::Sort(desc, items);
+
+  EXPECT_EQ(expected, Ids(items));
+}
+
 TEST(TestSortUtils, GetFieldsForSorting)
 {
   Fields fields;
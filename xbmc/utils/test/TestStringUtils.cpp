@@ -20,6 +20,8 @@
 
 #include "utils/StringUtils.h"
 #include <algorithm>
+#include <locale>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -313,6 +315,232 @@ TEST(TestStringUtils, AlphaNumericCompare)
   EXPECT_LT(var, ref);
 }
 
+namespace
+{
+/*!
+ \brief Collates unlike the code points, the way real locales do.
+ Accented and upper case letters have the weights of their base letter followed by a second level,
+ '¹' and '½' sort among the digits, space and ':' before them and brackets and dashes after the letters.
+ */
+class CTestCollate : public std::collate<wchar_t>
+{
+protected:
+  int do_compare(const wchar_t *low1, const wchar_t *high1, const wchar_t *low2, const wchar_t *high2) const override
+  {
+    return do_transform(low1, high1).compare(do_transform(low2, high2));
+  }
+
+  std::wstring do_transform(const wchar_t *low, const wchar_t *high) const override
+  {
+    std::wstring primary, secondary;
+    for (const wchar_t *c = low; c < high; c++)
+    {
+      wchar_t weight, accent;
+      Weights(*c, weight, accent);
+      primary.push_back(weight);
+      secondary.push_back(accent);
+    }
+    return primary + L'\1' + secondary;
+  }
+
+private:
+  static void Weights(wchar_t c, wchar_t &weight, wchar_t &accent)
+  {
+    accent = 2;
+    switch (c)
+    {
+    case L' ': weight = 0x10; return;
+    case L':': weight = 0x11; return;
+    case L'\u00bd': weight = 0x102; return;              // between '0' and '1'
+    case L'\u00b9': weight = 0x104; accent = 3; return;  // a variant of '1'
+    case L'\u00e9': case L'\u00e8': weight = 0x200 + 4 * (L'e' - L'a'); accent = 3; return;
+    case L'\u00c9': weight = 0x200 + 4 * (L'e' - L'a'); accent = 4; return;
+    case L'\u00df': weight = 0x200 + 4 * (L's' - L'a'); accent = 3; return;
+    case L'\u00e5': case L'\u00c5': weight = 0x200 + 4 * 26; return;  // after 'z', as in Swedish
+    case L'\u00f6': case L'\u00d6': weight = 0x200 + 4 * 27; return;
+    case L'\u0451': weight = 0x300 + 4 * (0x435 - 0x430); accent = 3; return;  // a variant of '\u0435'
+    case L'(': case L')': case L'-': weight = 0x800 + c; return;
+    }
+
+    if (c >= L'0' && c <= L'9')
+      weight = 0x100 + 4 * (c - L'0');
+    else if (c >= L'a' && c <= L'z')
+      weight = 0x200 + 4 * (c - L'a');
+    else if (c >= L'A' && c <= L'Z')
+    {
+      weight = 0x200 + 4 * (c - L'A');
+      accent = 4;
+    }
+    else if (c >= 0x430 && c <= 0x44f)
+      weight = 0x300 + 4 * (c - 0x430);
+    else if (c >= 0x410 && c <= 0x42f)
+    {
+      weight = 0x300 + 4 * (c - 0x410);
+      accent = 4;
+    }
+    else
+      weight = 0x1000 + c;
+  }
+};
+
+/*!
+ \brief Labels made of accented, Cyrillic, CJK, digit and punctuation pieces.
+ */
+std::vector<std::wstring> MultilingualLabels(unsigned int count)
+{
+  static const wchar_t *pieces[] = { L"a", L"B", L"e", L"\u00e9", L"\u00c9", L"\u00e8", L"z", L"\u00e5", L"\u00c5", L"\u00f6",
+                                     L"s", L"\u00df", L"ss", L"\u041c\u043e\u0441\u043a\u0432\u0430", L"\u0451", L"\u0435", L"\u0416",
+                                     L"\u6771\u4eac", L"\u4e00", L"\u30a2", L" ", L"(", L")", L"-", L":", L"0", L"1", L"7", L"9",
+                                     L"10", L"007", L"123456789012345678", L"\u00bd", L"\u00b9", L"Season 2", L"Season 10" };
+  const unsigned int numPieces = sizeof(pieces) / sizeof(pieces[0]);
+
+  std::vector<std::wstring> labels = { L"" };
+  unsigned int random = 12345;
+  while (labels.size() < count)
+  {
+    std::wstring label;
+    random = random * 1103515245 + 12345;
+    for (unsigned int length = 1 + (random >> 16) % 5; length > 0; length--)
+    {
+      random = random * 1103515245 + 12345;
+      label += pieces[(random >> 16) % numPieces];
+    }
+    labels.push_back(label);
+  }
+  return labels;
+}
+
+/*!
+ \brief Check that the keys of all pairs of labels compare like AlphaNumericCompare().
+ */
+void ExpectKeysMatchCompare(const std::vector<std::wstring> &labels, const std::locale &locale)
+{
+  std::vector<std::string> keys;
+  for (const auto &label : labels)
+    keys.push_back(StringUtils::AlphaNumericCollationKey(label.c_str(), locale));
+
+  unsigned int mismatches = 0;
+  for (size_t left = 0; left < labels.size(); left++)
+  {
+    for (size_t right = 0; right < labels.size(); right++)
+    {
+      int64_t expected = StringUtils::AlphaNumericCompare(labels[left].c_str(), labels[right].c_str(), locale);
+      int actual = keys[left].compare(keys[right]);
+      if ((expected < 0) != (actual < 0) || (expected > 0) != (actual > 0))
+      {
+        if (mismatches++ == 0)
+          ADD_FAILURE() << "label " << left << " against label " << right << ": compare " << expected << ", key " << actual;
+      }
+    }
+  }
+  EXPECT_EQ(0U, mismatches);
+}
+}
+
+TEST(TestStringUtils, AlphaNumericCompareNumbersAgainstCharacters)
+{
+  std::locale locale(std::locale::classic(), new CTestCollate);
+
+  // characters collating before '0' sort before every number, all others after it
+  EXPECT_LT(StringUtils::AlphaNumericCompare(L" a", L"9", locale), 0);
+  EXPECT_LT(StringUtils::AlphaNumericCompare(L":", L"0", locale), 0);
+  EXPECT_GT(StringUtils::AlphaNumericCompare(L"\u00bd", L"9", locale), 0);
+  EXPECT_GT(StringUtils::AlphaNumericCompare(L"\u00b9", L"5", locale), 0);
+  EXPECT_GT(StringUtils::AlphaNumericCompare(L"(500) Days of Summer", L"10 Things", locale), 0);
+  EXPECT_LT(StringUtils::AlphaNumericCompare(L"9", L"10", locale), 0);
+
+  // which keeps the order transitive, '\u00b9' would otherwise sort between "10" and "9"
+  std::vector<std::wstring> labels = { L"10", L"\u00b9", L"9" };
+  std::sort(labels.begin(), labels.end(), [&locale](const std::wstring &left, const std::wstring &right)
+  {
+    return StringUtils::AlphaNumericCompare(left.c_str(), right.c_str(), locale) < 0;
+  });
+  EXPECT_EQ(std::vector<std::wstring>({ L"9", L"10", L"\u00b9" }), labels);
+}
+
+TEST(TestStringUtils, AlphaNumericCollationKey)
+{
+  const wchar_t *labels[] = { L"abc123", L"123abc", L"abc", L"ABC", L"abc12", L"abc9", L"abc009", L"abc 10",
+                              L"2001: A Space Odyssey", L"20000 Leagues Under the Sea", L"12345678901234567890",
+                              L"12345678901234567891", L"\u00c9cole", L"ecole", L"\u00e9t\u00e9", L"Stra\u00dfe", L"strasse",
+                              L"\u041c\u043e\u0441\u043a\u0432\u0430", L"\u6771\u4eac", L"(500) Days of Summer", L"", L"a", L"A1b2" };
+
+  for (const wchar_t *left : labels)
+  {
+    std::string leftKey = StringUtils::AlphaNumericCollationKey(left);
+    for (const wchar_t *right : labels)
+    {
+      int64_t expected = StringUtils::AlphaNumericCompare(left, right);
+      int actual = leftKey.compare(StringUtils::AlphaNumericCollationKey(right));
+      EXPECT_EQ(expected < 0, actual < 0);
+      EXPECT_EQ(expected > 0, actual > 0);
+    }
+  }
+}
+
+TEST(TestStringUtils, AlphaNumericCollationKeyMultilingual)
+{
+  std::vector<std::wstring> labels = MultilingualLabels(500);
+
+  {
+    SCOPED_TRACE("test collation");
+    ExpectKeysMatchCompare(labels, std::locale(std::locale::classic(), new CTestCollate));
+  }
+
+  // installed locales are checked as well, they are skipped if not available
+  const char *locales[] = { "C", "C.UTF-8", "en_US.UTF-8", "de_DE.UTF-8", "sv_SE.UTF-8", "fr_FR.UTF-8", "ru_RU.UTF-8", "ja_JP.UTF-8" };
+  for (const char *name : locales)
+  {
+    std::locale locale;
+    try
+    {
+      locale = std::locale(name);
+    }
+    catch (std::runtime_error&)
+    {
+      continue;
+    }
+
+    SCOPED_TRACE(name);
+    ExpectKeysMatchCompare(labels, locale);
+  }
+}
+
+TEST(TestStringUtils, AlphaNumericCollationKeyLocales)
+{
+  const wchar_t *labels[] = { L"abc", L"ABC", L"Abc 2", L"abc 10", L"\u00c9cole", L"ecole", L"Eclair", L"\u00e9t\u00e9",
+                              L"Stra\u00dfe", L"strasse", L"Strasse 2", L"\u00c5ngstr\u00f6m", L"zebra", L"\u00d6l", L"Ol",
+                              L"co-op", L"coop", L"\u041c\u043e\u0441\u043a\u0432\u0430", L"\u0451\u043b\u043a\u0430" };
+
+  // the collation of these locales differs from the order of the code points, they are skipped if not installed
+  const char *locales[] = { "C.UTF-8", "en_US.UTF-8", "de_DE.UTF-8", "sv_SE.UTF-8", "fr_FR.UTF-8", "ru_RU.UTF-8" };
+  for (const char *name : locales)
+  {
+    std::locale locale;
+    try
+    {
+      locale = std::locale(name);
+    }
+    catch (std::runtime_error&)
+    {
+      continue;
+    }
+
+    SCOPED_TRACE(name);
+    for (const wchar_t *left : labels)
+    {
+      std::string leftKey = StringUtils::AlphaNumericCollationKey(left, locale);
+      for (const wchar_t *right : labels)
+      {
+        int64_t expected = StringUtils::AlphaNumericCompare(left, right, locale);
+        int actual = leftKey.compare(StringUtils::AlphaNumericCollationKey(right, locale));
+        EXPECT_EQ(expected < 0, actual < 0);
+        EXPECT_EQ(expected > 0, actual > 0);
+      }
+    }
+  }
+}
+
 TEST(TestStringUtils, TimeStringToSeconds)
 {
   EXPECT_EQ(77455, StringUtils::TimeStringToSeconds("21:30:55"));
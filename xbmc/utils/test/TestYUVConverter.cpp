@@ -0,0 +1,162 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/YUVConverter.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+class TestYUVConverter : public testing::Test
+{
+protected:
+  // random planes of a width x height picture in the given format
+  void Fill(CYUVConverter::Format format, unsigned int width, unsigned int height)
+  {
+    unsigned int chromaWidth = (width + 1) / 2;
+    unsigned int chromaHeight = (height + 1) / 2;
+    unsigned int sampleSize = format == CYUVConverter::Format::P010 ? 2 : 1;
+
+    // odd strides and padding make sure rows are addressed through the strides
+    strides[0] = width * sampleSize + 7;
+    strides[1] = (format == CYUVConverter::Format::YUV420P ? chromaWidth : chromaWidth * 2) * sampleSize + 5;
+    strides[2] = format == CYUVConverter::Format::YUV420P ? chromaWidth + 3 : 0;
+
+    srand(width * height);
+    for (int plane = 0; plane < 3; plane++)
+    {
+      data[plane].resize(strides[plane] * (plane == 0 ? height : chromaHeight));
+      for (auto &byte : data[plane])
+        byte = rand() & 0xFF;
+      planes[plane] = data[plane].empty() ? nullptr : data[plane].data();
+    }
+  }
+
+  std::vector<uint8_t> Convert(CYUVConverter::Format format, unsigned int width, unsigned int height,
+                               CYUVConverter::Output output, CYUVConverter::Matrix matrix, unsigned int slices)
+  {
+    std::vector<uint8_t> pixels(width * height * 4);
+    CYUVConverter::Convert(format, planes, strides, width, height, pixels.data(), width * 4, output, matrix, slices);
+    return pixels;
+  }
+
+  // floating point conversion of the pixel at x, y
+  void Reference(CYUVConverter::Format format, CYUVConverter::Matrix matrix, unsigned int x, unsigned int y, int rgb[3])
+  {
+    double luma, cu, cv;
+    switch (format)
+    {
+    case CYUVConverter::Format::YUV420P:
+      luma = planes[0][y * strides[0] + x];
+      cu = planes[1][y / 2 * strides[1] + x / 2];
+      cv = planes[2][y / 2 * strides[2] + x / 2];
+      break;
+    case CYUVConverter::Format::NV12:
+      luma = planes[0][y * strides[0] + x];
+      cu = planes[1][y / 2 * strides[1] + x / 2 * 2];
+      cv = planes[1][y / 2 * strides[1] + x / 2 * 2 + 1];
+      break;
+    default:
+      // P010 samples are reduced to their upper byte
+      luma = planes[0][y * strides[0] + x * 2 + 1];
+      cu = planes[1][y / 2 * strides[1] + x / 2 * 4 + 1];
+      cv = planes[1][y / 2 * strides[1] + x / 2 * 4 + 3];
+      break;
+    }
+
+    double kr = matrix == CYUVConverter::Matrix::BT709 ? 0.2126 : 0.299;
+    double kb = matrix == CYUVConverter::Matrix::BT709 ? 0.0722 : 0.114;
+    double kg = 1.0 - kr - kb;
+
+    double yv = (luma - 16.0) * 255.0 / 219.0;
+    double pb = (cu - 128.0) * 255.0 / 224.0;
+    double pr = (cv - 128.0) * 255.0 / 224.0;
+
+    rgb[0] = static_cast<int>(std::lround(std::min(std::max(yv + 2.0 * (1.0 - kr) * pr, 0.0), 255.0)));
+    rgb[1] = static_cast<int>(std::lround(std::min(std::max(yv - 2.0 * (kb * (1.0 - kb) * pb + kr * (1.0 - kr) * pr) / kg, 0.0), 255.0)));
+    rgb[2] = static_cast<int>(std::lround(std::min(std::max(yv + 2.0 * (1.0 - kb) * pb, 0.0), 255.0)));
+  }
+
+  void ExpectReference(CYUVConverter::Format format, CYUVConverter::Output output, CYUVConverter::Matrix matrix)
+  {
+    // a width that isn't a multiple of the simd width and odd dimensions
+    const unsigned int width = 71;
+    const unsigned int height = 35;
+    Fill(format, width, height);
+    std::vector<uint8_t> pixels = Convert(format, width, height, output, matrix, 1);
+
+    for (unsigned int y = 0; y < height; y++)
+    {
+      for (unsigned int x = 0; x < width; x++)
+      {
+        int rgb[3];
+        Reference(format, matrix, x, y, rgb);
+        const uint8_t *pixel = &pixels[(y * width + x) * 4];
+        int r = output == CYUVConverter::Output::BGRA ? pixel[2] : pixel[0];
+        int b = output == CYUVConverter::Output::BGRA ? pixel[0] : pixel[2];
+        ASSERT_NEAR(rgb[0], r, 1) << "x " << x << " y " << y;
+        ASSERT_NEAR(rgb[1], pixel[1], 1) << "x " << x << " y " << y;
+        ASSERT_NEAR(rgb[2], b, 1) << "x " << x << " y " << y;
+        ASSERT_EQ(0xFF, pixel[3]);
+      }
+    }
+  }
+
+  std::vector<uint8_t> data[3];
+  const uint8_t *planes[3];
+  int strides[3];
+};
+
+TEST_F(TestYUVConverter, YUV420P)
+{
+  ExpectReference(CYUVConverter::Format::YUV420P, CYUVConverter::Output::BGRA, CYUVConverter::Matrix::BT601);
+  ExpectReference(CYUVConverter::Format::YUV420P, CYUVConverter::Output::RGBA, CYUVConverter::Matrix::BT709);
+}
+
+TEST_F(TestYUVConverter, NV12)
+{
+  ExpectReference(CYUVConverter::Format::NV12, CYUVConverter::Output::BGRA, CYUVConverter::Matrix::BT709);
+  ExpectReference(CYUVConverter::Format::NV12, CYUVConverter::Output::RGBA, CYUVConverter::Matrix::BT601);
+}
+
+TEST_F(TestYUVConverter, P010)
+{
+  ExpectReference(CYUVConverter::Format::P010, CYUVConverter::Output::BGRA, CYUVConverter::Matrix::BT601);
+  ExpectReference(CYUVConverter::Format::P010, CYUVConverter::Output::RGBA, CYUVConverter::Matrix::BT709);
+}
+
+TEST_F(TestYUVConverter, Slices)
+{
+  const unsigned int width = 640;
+  const unsigned int height = 361;
+  Fill(CYUVConverter::Format::YUV420P, width, height);
+
+  std::vector<uint8_t> single = Convert(CYUVConverter::Format::YUV420P, width, height,
+                                        CYUVConverter::Output::BGRA, CYUVConverter::Matrix::BT601, 1);
+  for (unsigned int slices : { 0u, 2u, 7u, 16u })
+  {
+    std::vector<uint8_t> sliced = Convert(CYUVConverter::Format::YUV420P, width, height,
+                                          CYUVConverter::Output::BGRA, CYUVConverter::Matrix::BT601, slices);
+    EXPECT_TRUE(single == sliced) << slices << " slices";
+  }
+}
@@ -77,6 +77,39 @@ using namespace VIDEO;
 using namespace ADDON;
 using namespace KODI::MESSAGING;
 
+// link tables whose library nodes are served from the navsummary table
+static const char *NavSummaryTypes[] = { "genre", "country", "studio", "tag" };
+
+// media types with a watched state, and how to get from their id to their file
+static const struct
+{
+  const char *mediaType;
+  const char *idColumn;
+} NavSummaryWatched[] = { { "movie", "idMovie" }, { "musicvideo", "idMVideo" } };
+
+// whether a sort uses fields of the files or streamdetails tables. Their changes don't bump the library
+// version as playing an item would drop every cached order, so these sorts are never served from it.
+static bool IsSortOnFileFields(SortBy sortBy)
+{
+  switch (sortBy)
+  {
+  case SortByFile:
+  case SortByDateAdded:
+  case SortByLastPlayed:
+  case SortByPlaycount:
+  case SortByVideoResolution:
+  case SortByVideoCodec:
+  case SortByVideoAspectRatio:
+  case SortByAudioChannels:
+  case SortByAudioCodec:
+  case SortByAudioLanguage:
+  case SortBySubtitleLanguage:
+    return true;
+  default:
+    return false;
+  }
+}
+
 //********************************************************************************************************************************
 CVideoDatabase::CVideoDatabase(void) = default;
 
@@ -195,6 +228,12 @@ void CVideoDatabase::CreateTables()
   m_pDS->exec("CREATE TABLE tag (tag_id integer primary key, name TEXT)");
   m_pDS->exec("CREATE TABLE tag_link (tag_id integer, media_id integer, media_type TEXT)");
 
+  CLog::Log(LOGINFO, "create navsummary table");
+  m_pDS->exec("CREATE TABLE navsummary (type TEXT, type_id INTEGER, media_type TEXT, total INTEGER, watched INTEGER)");
+
+  CLog::Log(LOGINFO, "create libraryversion table");
+  m_pDS->exec("CREATE TABLE libraryversion (iVersion INTEGER)");
+
   CLog::Log(LOGINFO, "create rating table");
   m_pDS->exec("CREATE TABLE rating (rating_id INTEGER PRIMARY KEY, media_id INTEGER, media_type TEXT, rating_type TEXT, rating FLOAT, votes INTEGER)");
 
@@ -279,6 +318,8 @@ void CVideoDatabase::CreateAnalytics()
   CreateLinkIndex("genre");
   CreateLinkIndex("country");
 
+  m_pDS->exec("CREATE UNIQUE INDEX ix_navsummary ON navsummary (type(20), type_id, media_type(20))");
+
   CLog::Log(LOGINFO, "%s - creating triggers", __FUNCTION__);
   m_pDS->exec("CREATE TRIGGER delete_movie AFTER DELETE ON movie FOR EACH ROW BEGIN "
               "DELETE FROM genre_link WHERE media_id=old.idMovie AND media_type='movie'; "
@@ -331,9 +372,6 @@ void CVideoDatabase::CreateAnalytics()
   m_pDS->exec("CREATE TRIGGER delete_person AFTER DELETE ON actor FOR EACH ROW BEGIN "
               "DELETE FROM art WHERE media_id=old.actor_id AND media_type IN ('actor','artist','writer','director'); "
               "END");
-  m_pDS->exec("CREATE TRIGGER delete_tag AFTER DELETE ON tag_link FOR EACH ROW BEGIN "
-              "DELETE FROM tag WHERE tag_id=old.tag_id AND tag_id NOT IN (SELECT DISTINCT tag_id FROM tag_link); "
-              "END");
   m_pDS->exec("CREATE TRIGGER delete_file AFTER DELETE ON files FOR EACH ROW BEGIN "
               "DELETE FROM bookmark WHERE idFile=old.idFile; "
               "DELETE FROM settings WHERE idFile=old.idFile; "
@@ -341,9 +379,126 @@ void CVideoDatabase::CreateAnalytics()
               "DELETE FROM streamdetails WHERE idFile=old.idFile; "
               "END");
 
+  CreateNavSummaryTriggers();
+  RebuildNavSummaries();
+
+  // invalidates the cached orders of the library, see GetSortedPage()
+  CreateLibraryVersionTriggers({ "movie", "tvshow", "seasons", "episode", "musicvideo", "path", "sets", "rating", "uniqueid" });
+
+  // full-text indexes for the search dialog
+  CreateFullTextIndex("moviesearch", "movie", "idMovie", { StringUtils::Format("c%02d", VIDEODB_ID_TITLE), StringUtils::Format("c%02d", VIDEODB_ID_PLOT),
+                                                           StringUtils::Format("c%02d", VIDEODB_ID_PLOTOUTLINE), StringUtils::Format("c%02d", VIDEODB_ID_TAGLINE) });
+  CreateFullTextIndex("tvshowsearch", "tvshow", "idShow", { StringUtils::Format("c%02d", VIDEODB_ID_TV_TITLE) });
+  CreateFullTextIndex("episodesearch", "episode", "idEpisode", { StringUtils::Format("c%02d", VIDEODB_ID_EPISODE_TITLE), StringUtils::Format("c%02d", VIDEODB_ID_EPISODE_PLOT) });
+  CreateFullTextIndex("musicvideosearch", "musicvideo", "idMVideo", { StringUtils::Format("c%02d", VIDEODB_ID_MUSICVIDEO_TITLE) });
+
   CreateViews();
 }
 
+void CVideoDatabase::CreateNavSummaryTriggers()
+{
+  for (const char *type : NavSummaryTypes)
+  {
+    // every item gets a row per media type, so the link triggers only ever have to update
+    m_pDS->exec(PrepareSQL("CREATE TRIGGER navsummary_%s_insert AFTER INSERT ON %s FOR EACH ROW BEGIN "
+                           "DELETE FROM navsummary WHERE type='%s' AND type_id=new.%s_id; "
+                           "INSERT INTO navsummary (type, type_id, media_type, total, watched) VALUES ('%s', new.%s_id, 'movie', 0, 0); "
+                           "INSERT INTO navsummary (type, type_id, media_type, total, watched) VALUES ('%s', new.%s_id, 'tvshow', 0, 0); "
+                           "INSERT INTO navsummary (type, type_id, media_type, total, watched) VALUES ('%s', new.%s_id, 'musicvideo', 0, 0); "
+                           "END", type, type, type, type, type, type, type, type, type, type));
+    m_pDS->exec(PrepareSQL("CREATE TRIGGER navsummary_%s_delete AFTER DELETE ON %s FOR EACH ROW BEGIN "
+                           "DELETE FROM navsummary WHERE type='%s' AND type_id=old.%s_id; "
+                           "END", type, type, type, type));
+
+    // the watched count of a link is the play state of the item it points to
+    std::string watchedNew, watchedOld;
+    for (const auto &media : NavSummaryWatched)
+    {
+      watchedNew += PrepareSQL("WHEN '%s' THEN (SELECT COUNT(files.playCount) FROM %s JOIN files ON files.idFile = %s.idFile WHERE %s.%s = new.media_id) ",
+                               media.mediaType, media.mediaType, media.mediaType, media.mediaType, media.idColumn);
+      watchedOld += PrepareSQL("WHEN '%s' THEN (SELECT COUNT(files.playCount) FROM %s JOIN files ON files.idFile = %s.idFile WHERE %s.%s = old.media_id) ",
+                               media.mediaType, media.mediaType, media.mediaType, media.mediaType, media.idColumn);
+    }
+    m_pDS->exec(StringUtils::Format("CREATE TRIGGER navsummary_%s_link_insert AFTER INSERT ON %s_link FOR EACH ROW BEGIN "
+                                    "UPDATE navsummary SET total = total + 1, watched = watched + CASE new.media_type %sELSE 0 END "
+                                    "WHERE type='%s' AND type_id=new.%s_id AND media_type=new.media_type; "
+                                    "END", type, type, watchedNew.c_str(), type, type));
+    std::string linkDelete = StringUtils::Format("UPDATE navsummary SET total = total - 1, watched = watched - CASE old.media_type %sELSE 0 END "
+                                                 "WHERE type='%s' AND type_id=old.%s_id AND media_type=old.media_type; ",
+                                                 watchedOld.c_str(), type, type);
+
+    // MySQL before 5.7.2 allows a single trigger per table, timing and event, so the
+    // unused tags are removed by the same trigger
+    if (StringUtils::EqualsNoCase(type, "tag"))
+      m_pDS->exec("CREATE TRIGGER delete_tag AFTER DELETE ON tag_link FOR EACH ROW BEGIN " + linkDelete +
+                  "DELETE FROM tag WHERE tag_id=old.tag_id AND tag_id NOT IN (SELECT DISTINCT tag_id FROM tag_link); "
+                  "END");
+    else
+      m_pDS->exec(StringUtils::Format("CREATE TRIGGER navsummary_%s_link_delete AFTER DELETE ON %s_link FOR EACH ROW BEGIN ", type, type) + linkDelete + "END");
+  }
+
+  std::string playCountUpdates;
+  for (const auto &media : NavSummaryWatched)
+  {
+    std::string linked, linkedByFile;
+    for (const char *type : NavSummaryTypes)
+    {
+      if (!linked.empty())
+      {
+        linked += " OR ";
+        linkedByFile += " OR ";
+      }
+      linked += PrepareSQL("(type='%s' AND type_id IN (SELECT %s_id FROM %s_link WHERE media_id=old.%s AND media_type='%s'))",
+                           type, type, type, media.idColumn, media.mediaType);
+      linkedByFile += PrepareSQL("(type='%s' AND type_id IN (SELECT %s_link.%s_id FROM %s_link JOIN %s ON %s.%s = %s_link.media_id WHERE %s_link.media_type='%s' AND %s.idFile=new.idFile))",
+                                 type, type, type, type, media.mediaType, media.mediaType, media.idColumn, type, type, media.mediaType, media.mediaType);
+    }
+
+    // once the item is gone its links can no longer find the play state, so take it out beforehand
+    m_pDS->exec(StringUtils::Format("CREATE TRIGGER navsummary_%s_delete BEFORE DELETE ON %s FOR EACH ROW BEGIN "
+                                    "UPDATE navsummary SET watched = watched - (SELECT COUNT(playCount) FROM files WHERE idFile=old.idFile) "
+                                    "WHERE media_type='%s' AND (%s); "
+                                    "END", media.mediaType, media.mediaType, media.mediaType, linked.c_str()));
+
+    playCountUpdates += StringUtils::Format("UPDATE navsummary SET watched = watched + CASE WHEN new.playCount IS NULL THEN -1 ELSE 1 END "
+                                            "WHERE (old.playCount IS NULL) <> (new.playCount IS NULL) AND media_type='%s' AND (%s); ",
+                                            media.mediaType, linkedByFile.c_str());
+  }
+  m_pDS->exec("CREATE TRIGGER navsummary_playcount AFTER UPDATE ON files FOR EACH ROW BEGIN " + playCountUpdates + "END");
+}
+
+bool CVideoDatabase::RebuildNavSummaries()
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    CLog::Log(LOGDEBUG, LOGDATABASE, "%s: Rebuilding navigation summaries", __FUNCTION__);
+    m_pDS->exec("DELETE FROM navsummary");
+    for (const char *type : NavSummaryTypes)
+    {
+      for (const char *mediaType : { "movie", "tvshow", "musicvideo" })
+        m_pDS->exec(PrepareSQL("INSERT INTO navsummary (type, type_id, media_type, total, watched) SELECT '%s', %s_id, '%s', 0, 0 FROM %s",
+                               type, type, mediaType, type));
+      m_pDS->exec(PrepareSQL("UPDATE navsummary SET total = (SELECT COUNT(1) FROM %s_link WHERE %s_link.%s_id = navsummary.type_id AND %s_link.media_type = navsummary.media_type) "
+                             "WHERE type='%s'", type, type, type, type, type));
+      for (const auto &media : NavSummaryWatched)
+        m_pDS->exec(PrepareSQL("UPDATE navsummary SET watched = (SELECT COUNT(files.playCount) FROM %s_link JOIN %s ON %s.%s = %s_link.media_id JOIN files ON files.idFile = %s.idFile "
+                                                        "WHERE %s_link.%s_id = navsummary.type_id AND %s_link.media_type = '%s') "
+                               "WHERE type='%s' AND media_type='%s'",
+                               type, media.mediaType, media.mediaType, media.idColumn, type, media.mediaType,
+                               type, type, type, media.mediaType, type, media.mediaType));
+    }
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
+  }
+  return false;
+}
+
 void CVideoDatabase::CreateViews()
 {
   CLog::Log(LOGINFO, "create episode_view");
@@ -527,8 +682,8 @@ int CVideoDatabase::GetPathId(const std::string& strPath)
 
     URIUtils::AddSlashAtEnd(strPath1);
 
-    strSQL=PrepareSQL("select idPath from path where strPath='%s'",strPath1.c_str());
-    m_pDS->query(strSQL);
+    strSQL = "select idPath from path where strPath=?";
+    m_pDS->query_bound(strSQL, { field_value(strPath1) });
     if (!m_pDS->eof())
       idPath = m_pDS->fv("path.idPath").get_asInt();
 
@@ -729,22 +884,16 @@ int CVideoDatabase::AddPath(const std::string& strPath, const std::string &paren
 
     int idParentPath = GetPathId(parentPath.empty() ? (std::string)URIUtils::GetParentPath(strPath1) : parentPath);
 
-    // add the path
+    // add the path, unset values are bound as NULL
+    field_value parent(idParentPath);
     if (idParentPath < 0)
-    {
-      if (dateAdded.IsValid())
-        strSQL=PrepareSQL("insert into path (idPath, strPath, dateAdded) values (NULL, '%s', '%s')", strPath1.c_str(), dateAdded.GetAsDBDateTime().c_str());
-      else
-        strSQL=PrepareSQL("insert into path (idPath, strPath) values (NULL, '%s')", strPath1.c_str());
-    }
-    else
-    {
-      if (dateAdded.IsValid())
-        strSQL = PrepareSQL("insert into path (idPath, strPath, dateAdded, idParentPath) values (NULL, '%s', '%s', %i)", strPath1.c_str(), dateAdded.GetAsDBDateTime().c_str(), idParentPath);
-      else
-        strSQL=PrepareSQL("insert into path (idPath, strPath, idParentPath) values (NULL, '%s', %i)", strPath1.c_str(), idParentPath);
-    }
-    m_pDS->exec(strSQL);
+      parent.set_isNull();
+    field_value added(dateAdded.IsValid() ? dateAdded.GetAsDBDateTime() : "");
+    if (!dateAdded.IsValid())
+      added.set_isNull();
+
+    strSQL = "insert into path (idPath, strPath, dateAdded, idParentPath) values (NULL, ?, ?, ?)";
+    m_pDS->exec_bound(strSQL, { field_value(strPath1), added, parent });
     idPath = (int)m_pDS->lastinsertid();
     return idPath;
   }
@@ -876,9 +1025,8 @@ int CVideoDatabase::AddFile(const std::string& strFileNameAndPath)
     if (idPath < 0)
       return -1;
 
-    std::string strSQL=PrepareSQL("select idFile from files where strFileName='%s' and idPath=%i", strFileName.c_str(),idPath);
-
-    m_pDS->query(strSQL);
+    strSQL = "select idFile from files where strFileName=? and idPath=?";
+    m_pDS->query_bound(strSQL, { field_value(strFileName), field_value(idPath) });
     if (m_pDS->num_rows() > 0)
     {
       idFile = m_pDS->fv("idFile").get_asInt() ;
@@ -887,8 +1035,8 @@ int CVideoDatabase::AddFile(const std::string& strFileNameAndPath)
     }
     m_pDS->close();
 
-    strSQL=PrepareSQL("insert into files (idFile, idPath, strFileName) values(NULL, %i, '%s')", idPath, strFileName.c_str());
-    m_pDS->exec(strSQL);
+    strSQL = "insert into files (idFile, idPath, strFileName) values(NULL, ?, ?)";
+    m_pDS->exec_bound(strSQL, { field_value(idPath), field_value(strFileName) });
     idFile = (int)m_pDS->lastinsertid();
     return idFile;
   }
@@ -1406,14 +1554,15 @@ int CVideoDatabase::AddToTable(const std::string& table, const std::string& firs
     if (NULL == m_pDB.get()) return -1;
     if (NULL == m_pDS.get()) return -1;
 
-    std::string strSQL = PrepareSQL("select %s from %s where %s like '%s'", firstField.c_str(), table.c_str(), secondField.c_str(), value.substr(0, 255).c_str());
-    m_pDS->query(strSQL);
+    const field_value name(value.substr(0, 255));
+    std::string strSQL = PrepareSQL("select %s from %s where %s like ?", firstField.c_str(), table.c_str(), secondField.c_str());
+    m_pDS->query_bound(strSQL, { name });
     if (m_pDS->num_rows() == 0)
     {
       m_pDS->close();
       // doesnt exists, add it
-      strSQL = PrepareSQL("insert into %s (%s, %s) values(NULL, '%s')", table.c_str(), firstField.c_str(), secondField.c_str(), value.substr(0, 255).c_str());
-      m_pDS->exec(strSQL);
+      strSQL = PrepareSQL("insert into %s (%s, %s) values(NULL, ?)", table.c_str(), firstField.c_str(), secondField.c_str());
+      m_pDS->exec_bound(strSQL, { name });
       int id = (int)m_pDS->lastinsertid();
       return id;
     }
@@ -1609,14 +1758,13 @@ int CVideoDatabase::AddActor(const std::string& name, const std::string& thumbUR
     std::string trimmedName = name.c_str();
     StringUtils::Trim(trimmedName);
 
-    std::string strSQL=PrepareSQL("select actor_id from actor where name like '%s'", trimmedName.substr(0, 255).c_str());
-    m_pDS->query(strSQL);
+    const field_value actorName(trimmedName.substr(0, 255));
+    m_pDS->query_bound("select actor_id from actor where name like ?", { actorName });
     if (m_pDS->num_rows() == 0)
     {
       m_pDS->close();
       // doesnt exists, add it
-      strSQL=PrepareSQL("insert into actor (actor_id, name, art_urls) values(NULL, '%s', '%s')", trimmedName.substr(0,255).c_str(), thumbURLs.c_str());
-      m_pDS->exec(strSQL);
+      m_pDS->exec_bound("insert into actor (actor_id, name, art_urls) values(NULL, ?, ?)", { actorName, field_value(thumbURLs) });
       idActor = (int)m_pDS->lastinsertid();
     }
     else
@@ -1625,10 +1773,7 @@ int CVideoDatabase::AddActor(const std::string& name, const std::string& thumbUR
       m_pDS->close();
       // update the thumb url's
       if (!thumbURLs.empty())
-      {
-        strSQL=PrepareSQL("update actor set art_urls = '%s' where actor_id = %i", thumbURLs.c_str(), idActor);
-        m_pDS->exec(strSQL);
-      }
+        m_pDS->exec_bound("update actor set art_urls = ? where actor_id = ?", { field_value(thumbURLs), field_value(idActor) });
     }
     // add artwork
     if (!thumb.empty())
@@ -1646,24 +1791,24 @@ int CVideoDatabase::AddActor(const std::string& name, const std::string& thumbUR
 
 void CVideoDatabase::AddLinkToActor(int mediaId, const char *mediaType, int actorId, const std::string &role, int order)
 {
-  std::string sql=PrepareSQL("SELECT 1 FROM actor_link WHERE actor_id=%i AND media_id=%i AND media_type='%s'", actorId, mediaId, mediaType);
-
-  if (GetSingleValue(sql).empty())
+  if (GetSingleValue("SELECT 1 FROM actor_link WHERE actor_id=? AND media_id=? AND media_type=?",
+                     { field_value(actorId), field_value(mediaId), field_value(mediaType) }).empty())
   { // doesnt exists, add it
-    sql = PrepareSQL("INSERT INTO actor_link (actor_id, media_id, media_type, role, cast_order) VALUES(%i,%i,'%s','%s',%i)", actorId, mediaId, mediaType, role.c_str(), order);
-    ExecuteQuery(sql);
+    ExecuteQuery("INSERT INTO actor_link (actor_id, media_id, media_type, role, cast_order) VALUES(?,?,?,?,?)",
+                 { field_value(actorId), field_value(mediaId), field_value(mediaType), field_value(role), field_value(order) });
   }
 }
 
 void CVideoDatabase::AddToLinkTable(int mediaId, const std::string& mediaType, const std::string& table, int valueId, const char *foreignKey)
 {
   const char *key = foreignKey ? foreignKey : table.c_str();
-  std::string sql = PrepareSQL("SELECT 1 FROM %s_link WHERE %s_id=%i AND media_id=%i AND media_type='%s'", table.c_str(), key, valueId, mediaId, mediaType.c_str());
+  const BoundParams params = { field_value(valueId), field_value(mediaId), field_value(mediaType) };
+  std::string sql = PrepareSQL("SELECT 1 FROM %s_link WHERE %s_id=? AND media_id=? AND media_type=?", table.c_str(), key);
 
-  if (GetSingleValue(sql).empty())
+  if (GetSingleValue(sql, params).empty())
   { // doesnt exists, add it
-    sql = PrepareSQL("INSERT INTO %s_link (%s_id,media_id,media_type) VALUES(%i,%i,'%s')", table.c_str(), key, valueId, mediaId, mediaType.c_str());
-    ExecuteQuery(sql);
+    sql = PrepareSQL("INSERT INTO %s_link (%s_id,media_id,media_type) VALUES(?,?,?)", table.c_str(), key);
+    ExecuteQuery(sql, params);
   }
 }
 
@@ -5253,11 +5398,20 @@ void CVideoDatabase::UpdateTables(int iVersion)
     m_pDS->exec("DROP TABLE settings");
     m_pDS->exec("ALTER TABLE settingsnew RENAME TO settings");
   }
+
+  if (iVersion < 110)
+  {
+    // filled by RebuildNavSummaries() once CreateAnalytics() has set up the triggers
+    m_pDS->exec("CREATE TABLE navsummary (type TEXT, type_id INTEGER, media_type TEXT, total INTEGER, watched INTEGER)");
+  }
+
+  if (iVersion < 112)
+    m_pDS->exec("CREATE TABLE libraryversion (iVersion INTEGER)");
 }
 
 int CVideoDatabase::GetSchemaVersion() const
 {
-  return 109;
+  return 114;
 }
 
 bool CVideoDatabase::LookupByFolders(const std::string &path, bool shows)
@@ -5663,14 +5817,25 @@ bool CVideoDatabase::GetNavCommon(const std::string& strBaseDir, CFileItemList&
       else
         return false;
 
-      strSQL = "SELECT %s " + PrepareSQL("FROM %s ", type);
-      extFilter.fields = PrepareSQL("%s.%s_id, %s.name", type, type, type);
-      extFilter.AppendField(extraField);
-      extFilter.AppendJoin(PrepareSQL("JOIN %s_link ON %s.%s_id = %s_link.%s_id", type, type, type, type, type));
-      extFilter.AppendJoin(PrepareSQL("JOIN %s_view ON %s_link.media_id = %s_view.%s AND %s_link.media_type='%s'",
-                                      view.c_str(), type, view.c_str(), view_id.c_str(), type, media_type.c_str()));
-      extFilter.AppendJoin(extraJoin);
-      extFilter.AppendGroup(PrepareSQL("%s.%s_id", type, type));
+      if (CanUseNavSummary(strBaseDir, type, extFilter))
+      {
+        // unfiltered node, the counts are already maintained in navsummary
+        strSQL = "SELECT %s FROM navsummary ";
+        extFilter.fields = PrepareSQL("navsummary.type_id, %s.name, navsummary.total, navsummary.watched", type);
+        extFilter.AppendJoin(PrepareSQL("JOIN %s ON %s.%s_id = navsummary.type_id", type, type, type));
+        extFilter.AppendWhere(PrepareSQL("navsummary.type = '%s' AND navsummary.media_type = '%s' AND navsummary.total > 0", type, media_type.c_str()));
+      }
+      else
+      {
+        strSQL = "SELECT %s " + PrepareSQL("FROM %s ", type);
+        extFilter.fields = PrepareSQL("%s.%s_id, %s.name", type, type, type);
+        extFilter.AppendField(extraField);
+        extFilter.AppendJoin(PrepareSQL("JOIN %s_link ON %s.%s_id = %s_link.%s_id", type, type, type, type, type));
+        extFilter.AppendJoin(PrepareSQL("JOIN %s_view ON %s_link.media_id = %s_view.%s AND %s_link.media_type='%s'",
+                                        view.c_str(), type, view.c_str(), view_id.c_str(), type, media_type.c_str()));
+        extFilter.AppendJoin(extraJoin);
+        extFilter.AppendGroup(PrepareSQL("%s.%s_id", type, type));
+      }
     }
 
     if (countOnly)
@@ -5779,6 +5944,23 @@ bool CVideoDatabase::GetNavCommon(const std::string& strBaseDir, CFileItemList&
   return false;
 }
 
+bool CVideoDatabase::CanUseNavSummary(const std::string &strBaseDir, const std::string &type, const Filter &filter)
+{
+  if (std::find(std::begin(NavSummaryTypes), std::end(NavSummaryTypes), type) == std::end(NavSummaryTypes))
+    return false;
+  if (!filter.where.empty() || !filter.join.empty())
+    return false;
+
+  // the path may carry its own filter (e.g. a year or an actor), which the summary can't answer
+  CVideoDbUrl videoUrl;
+  Filter urlFilter;
+  SortDescription sorting;
+  if (!videoUrl.FromString(strBaseDir) || !GetFilter(videoUrl, urlFilter, sorting))
+    return false;
+
+  return urlFilter.where.empty() && urlFilter.join.empty();
+}
+
 bool CVideoDatabase::GetTagsNav(const std::string& strBaseDir, CFileItemList& items, int idContent /* = -1 */, const Filter &filter /* = Filter() */, bool countOnly /* = false */)
 {
   return GetNavCommon(strBaseDir, items, "tag", idContent, filter, countOnly);
@@ -6733,6 +6915,34 @@ bool CVideoDatabase::GetMoviesByWhere(const std::string& strBaseDir, const Filte
     if (!CDatabase::BuildSQL(strSQLExtra, extFilter, strSQLExtra))
       return false;
 
+    auto addMovie = [&](const dbiplus::sql_record* const record)
+    {
+      CVideoInfoTag movie = GetDetailsForMovie(record, getDetails);
+      if (m_profileManager.GetMasterProfile().getLockMode() == LOCK_MODE_EVERYONE ||
+          g_passwordManager.bMasterUser                                   ||
+          g_passwordManager.IsDatabasePathUnlocked(movie.m_strPath, *CMediaSourceSettings::GetInstance().GetSources("video")))
+      {
+        CFileItemPtr pItem(new CFileItem(movie));
+
+        CVideoDbUrl itemUrl = videoUrl;
+        std::string path = StringUtils::Format("%i", movie.m_iDbId);
+        itemUrl.AppendPath(path);
+        pItem->SetPath(itemUrl.ToString());
+
+        pItem->SetOverlayImage(CGUIListItem::ICON_OVERLAY_UNWATCHED,movie.GetPlayCount() > 0);
+        items.Add(pItem);
+      }
+    };
+
+    // with the cached order of the library only the ids of the listing and the rows on the page are read
+    if (extFilter.limit.empty() && extFilter.fields == "*" && !IsSortOnFileFields(sortDescription.sortBy) &&
+        GetSortedPage(MediaTypeMovie, strSQL, strSQLExtra, sortDescription, total, addMovie))
+    {
+      if (total > 0)
+        items.SetProperty("total", total);
+      return true;
+    }
+
     // Apply the limiting directly here if there's no special sorting but limiting
     if (extFilter.limit.empty() &&
         sorting.sortBy == SortByNone &&
@@ -6744,6 +6954,21 @@ bool CVideoDatabase::GetMoviesByWhere(const std::string& strBaseDir, const Filte
 
     strSQL = PrepareSQL(strSQL, !extFilter.fields.empty() ? extFilter.fields.c_str() : "*") + strSQLExtra;
 
+    // without sorting the rows are used in database order, so stream them
+    // instead of materializing the whole result set first
+    if (sortDescription.sortBy == SortByNone)
+    {
+      int iRowsFound = StreamQuery(strSQL, [&](const dbiplus::sql_record& record) { addMovie(&record); });
+      if (iRowsFound < 0)
+        return false;
+
+      if (total < iRowsFound)
+        total = iRowsFound;
+      if (iRowsFound > 0)
+        items.SetProperty("total", total);
+      return true;
+    }
+
     int iRowsFound = RunQuery(strSQL);
     if (iRowsFound <= 0)
       return iRowsFound == 0;
@@ -6765,23 +6990,7 @@ bool CVideoDatabase::GetMoviesByWhere(const std::string& strBaseDir, const Filte
     for (const auto &i : results)
     {
       unsigned int targetRow = (unsigned int)i.at(FieldRow).asInteger();
-      const dbiplus::sql_record* const record = data.at(targetRow);
-
-      CVideoInfoTag movie = GetDetailsForMovie(record, getDetails);
-      if (m_profileManager.GetMasterProfile().getLockMode() == LOCK_MODE_EVERYONE ||
-          g_passwordManager.bMasterUser                                   ||
-          g_passwordManager.IsDatabasePathUnlocked(movie.m_strPath, *CMediaSourceSettings::GetInstance().GetSources("video")))
-      {
-        CFileItemPtr pItem(new CFileItem(movie));
-
-        CVideoDbUrl itemUrl = videoUrl;
-        std::string path = StringUtils::Format("%i", movie.m_iDbId);
-        itemUrl.AppendPath(path);
-        pItem->SetPath(itemUrl.ToString());
-
-        pItem->SetOverlayImage(CGUIListItem::ICON_OVERLAY_UNWATCHED,movie.GetPlayCount() > 0);
-        items.Add(pItem);
-      }
+      addMovie(data.at(targetRow));
     }
 
     // cleanup
@@ -6967,6 +7176,43 @@ bool CVideoDatabase::GetEpisodesByWhere(const std::string& strBaseDir, const Fil
     if (!BuildSQL(strBaseDir, strSQLExtra, extFilter, strSQLExtra, videoUrl, sorting))
       return false;
 
+    CLabelFormatter formatter("%H. %T", "");
+    auto addEpisode = [&](const dbiplus::sql_record* const record)
+    {
+      CVideoInfoTag movie = GetDetailsForEpisode(record, getDetails);
+      if (m_profileManager.GetMasterProfile().getLockMode() == LOCK_MODE_EVERYONE ||
+          g_passwordManager.bMasterUser                                     ||
+          g_passwordManager.IsDatabasePathUnlocked(movie.m_strPath, *CMediaSourceSettings::GetInstance().GetSources("video")))
+      {
+        CFileItemPtr pItem(new CFileItem(movie));
+        formatter.FormatLabel(pItem.get());
+
+        int idEpisode = record->at(0).get_asInt();
+
+        CVideoDbUrl itemUrl = videoUrl;
+        std::string path;
+        if (appendFullShowPath && videoUrl.GetItemType() != "episodes")
+          path = StringUtils::Format("%i/%i/%i", record->at(VIDEODB_DETAILS_EPISODE_TVSHOW_ID).get_asInt(), movie.m_iSeason, idEpisode);
+        else
+          path = StringUtils::Format("%i", idEpisode);
+        itemUrl.AppendPath(path);
+        pItem->SetPath(itemUrl.ToString());
+
+        pItem->SetOverlayImage(CGUIListItem::ICON_OVERLAY_UNWATCHED, movie.GetPlayCount() > 0);
+        pItem->m_dateTime = movie.m_firstAired;
+        items.Add(pItem);
+      }
+    };
+
+    // with the cached order of the library only the ids of the listing and the rows on the page are read
+    if (extFilter.limit.empty() && extFilter.fields == "*" && !IsSortOnFileFields(sorting.sortBy) &&
+        GetSortedPage(MediaTypeEpisode, strSQL, strSQLExtra, sorting, total, addEpisode))
+    {
+      if (total > 0)
+        items.SetProperty("total", total);
+      return true;
+    }
+
     // Apply the limiting directly here if there's no special sorting but limiting
     if (extFilter.limit.empty() &&
       sorting.sortBy == SortByNone &&
@@ -6994,37 +7240,11 @@ bool CVideoDatabase::GetEpisodesByWhere(const std::string& strBaseDir, const Fil
     
     // get data from returned rows
     items.Reserve(results.size());
-    CLabelFormatter formatter("%H. %T", "");
-
     const query_data &data = m_pDS->get_result_set().records;
     for (const auto &i : results)
     {
       unsigned int targetRow = (unsigned int)i.at(FieldRow).asInteger();
-      const dbiplus::sql_record* const record = data.at(targetRow);
-
-      CVideoInfoTag movie = GetDetailsForEpisode(record, getDetails);
-      if (m_profileManager.GetMasterProfile().getLockMode() == LOCK_MODE_EVERYONE ||
-          g_passwordManager.bMasterUser                                     ||
-          g_passwordManager.IsDatabasePathUnlocked(movie.m_strPath, *CMediaSourceSettings::GetInstance().GetSources("video")))
-      {
-        CFileItemPtr pItem(new CFileItem(movie));
-        formatter.FormatLabel(pItem.get());
-      
-        int idEpisode = record->at(0).get_asInt();
-
-        CVideoDbUrl itemUrl = videoUrl;
-        std::string path;
-        if (appendFullShowPath && videoUrl.GetItemType() != "episodes")
-          path = StringUtils::Format("%i/%i/%i", record->at(VIDEODB_DETAILS_EPISODE_TVSHOW_ID).get_asInt(), movie.m_iSeason, idEpisode);
-        else
-          path = StringUtils::Format("%i", idEpisode);
-        itemUrl.AppendPath(path);
-        pItem->SetPath(itemUrl.ToString());
-
-        pItem->SetOverlayImage(CGUIListItem::ICON_OVERLAY_UNWATCHED, movie.GetPlayCount() > 0);
-        pItem->m_dateTime = movie.m_firstAired;
-        items.Add(pItem);
-      }
+      addEpisode(data.at(targetRow));
     }
 
     // cleanup
@@ -7986,6 +8206,30 @@ int CVideoDatabase::GetMatchingMusicVideo(const std::string& strArtist, const st
   return -1;
 }
 
+std::string CVideoDatabase::PrepareSearchCondition(const std::string &strSearch, const std::string &table, const std::string &idColumn, const std::vector<int> &columns)
+{
+  std::vector<std::string> columnNames;
+  for (int column : columns)
+    columnNames.push_back(StringUtils::Format("c%02d", column));
+
+  std::string index = table + "search";
+  if (HasFullTextIndex(index))
+  {
+    std::string query = PrepareFullTextQuery(strSearch, false, columnNames);
+    if (!query.empty())
+      return PrepareSQL("%s.%s IN (SELECT rowid FROM %s WHERE %s MATCH '%s')", table.c_str(), idColumn.c_str(), index.c_str(), index.c_str(), query.c_str());
+  }
+
+  std::string condition;
+  for (const auto &column : columnNames)
+  {
+    if (!condition.empty())
+      condition += " OR ";
+    condition += PrepareSQL("%s.%s LIKE '%%%s%%'", table.c_str(), column.c_str(), strSearch.c_str());
+  }
+  return "(" + condition + ")";
+}
+
 void CVideoDatabase::GetMoviesByName(const std::string& strSearch, CFileItemList& items)
 {
   std::string strSQL;
@@ -7996,9 +8240,10 @@ void CVideoDatabase::GetMoviesByName(const std::string& strSearch, CFileItemList
     if (NULL == m_pDS.get()) return;
 
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT movie.idMovie, movie.c%02d, path.strPath, movie.idSet FROM movie INNER JOIN files ON files.idFile=movie.idFile INNER JOIN path ON path.idPath=files.idPath WHERE movie.c%02d LIKE '%%%s%%'", VIDEODB_ID_TITLE, VIDEODB_ID_TITLE, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT movie.idMovie, movie.c%02d, path.strPath, movie.idSet FROM movie INNER JOIN files ON files.idFile=movie.idFile INNER JOIN path ON path.idPath=files.idPath WHERE ", VIDEODB_ID_TITLE);
     else
-      strSQL = PrepareSQL("select movie.idMovie,movie.c%02d, movie.idSet from movie where movie.c%02d like '%%%s%%'",VIDEODB_ID_TITLE,VIDEODB_ID_TITLE,strSearch.c_str());
+      strSQL = PrepareSQL("select movie.idMovie,movie.c%02d, movie.idSet from movie where ",VIDEODB_ID_TITLE);
+    strSQL += PrepareSearchCondition(strSearch, MediaTypeMovie, "idMovie", { VIDEODB_ID_TITLE });
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -8041,9 +8286,10 @@ void CVideoDatabase::GetTvShowsByName(const std::string& strSearch, CFileItemLis
     if (NULL == m_pDS.get()) return;
 
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT tvshow.idShow, tvshow.c%02d, path.strPath FROM tvshow INNER JOIN tvshowlinkpath ON tvshowlinkpath.idShow=tvshow.idShow INNER JOIN path ON path.idPath=tvshowlinkpath.idPath WHERE tvshow.c%02d LIKE '%%%s%%'", VIDEODB_ID_TV_TITLE, VIDEODB_ID_TV_TITLE, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT tvshow.idShow, tvshow.c%02d, path.strPath FROM tvshow INNER JOIN tvshowlinkpath ON tvshowlinkpath.idShow=tvshow.idShow INNER JOIN path ON path.idPath=tvshowlinkpath.idPath WHERE ", VIDEODB_ID_TV_TITLE);
     else
-      strSQL = PrepareSQL("select tvshow.idShow,tvshow.c%02d from tvshow where tvshow.c%02d like '%%%s%%'",VIDEODB_ID_TV_TITLE,VIDEODB_ID_TV_TITLE,strSearch.c_str());
+      strSQL = PrepareSQL("select tvshow.idShow,tvshow.c%02d from tvshow where ",VIDEODB_ID_TV_TITLE);
+    strSQL += PrepareSearchCondition(strSearch, MediaTypeTvShow, "idShow", { VIDEODB_ID_TV_TITLE });
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -8082,9 +8328,10 @@ void CVideoDatabase::GetEpisodesByName(const std::string& strSearch, CFileItemLi
     if (NULL == m_pDS.get()) return;
 
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d, path.strPath FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow INNER JOIN files ON files.idFile=episode.idFile INNER JOIN path ON path.idPath=files.idPath WHERE episode.c%02d LIKE '%%%s%%'", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE, VIDEODB_ID_EPISODE_TITLE, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d, path.strPath FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow INNER JOIN files ON files.idFile=episode.idFile INNER JOIN path ON path.idPath=files.idPath WHERE ", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE);
     else
-      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow WHERE episode.c%02d like '%%%s%%'", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE, VIDEODB_ID_EPISODE_TITLE, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow WHERE ", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE);
+    strSQL += PrepareSearchCondition(strSearch, MediaTypeEpisode, "idEpisode", { VIDEODB_ID_EPISODE_TITLE });
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -8125,9 +8372,10 @@ void CVideoDatabase::GetMusicVideosByName(const std::string& strSearch, CFileIte
     if (NULL == m_pDS.get()) return;
 
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT musicvideo.idMVideo, musicvideo.c%02d, path.strPath FROM musicvideo INNER JOIN files ON files.idFile=musicvideo.idFile INNER JOIN path ON path.idPath=files.idPath WHERE musicvideo.c%02d LIKE '%%%s%%'", VIDEODB_ID_MUSICVIDEO_TITLE, VIDEODB_ID_MUSICVIDEO_TITLE, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT musicvideo.idMVideo, musicvideo.c%02d, path.strPath FROM musicvideo INNER JOIN files ON files.idFile=musicvideo.idFile INNER JOIN path ON path.idPath=files.idPath WHERE ", VIDEODB_ID_MUSICVIDEO_TITLE);
     else
-      strSQL = PrepareSQL("select musicvideo.idMVideo,musicvideo.c%02d from musicvideo where musicvideo.c%02d like '%%%s%%'",VIDEODB_ID_MUSICVIDEO_TITLE,VIDEODB_ID_MUSICVIDEO_TITLE,strSearch.c_str());
+      strSQL = PrepareSQL("select musicvideo.idMVideo,musicvideo.c%02d from musicvideo where ",VIDEODB_ID_MUSICVIDEO_TITLE);
+    strSQL += PrepareSearchCondition(strSearch, MediaTypeMusicVideo, "idMVideo", { VIDEODB_ID_MUSICVIDEO_TITLE });
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -8172,9 +8420,10 @@ void CVideoDatabase::GetEpisodesByPlot(const std::string& strSearch, CFileItemLi
     if (NULL == m_pDS.get()) return;
 
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d, path.strPath FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow INNER JOIN files ON files.idFile=episode.idFile INNER JOIN path ON path.idPath=files.idPath WHERE episode.c%02d LIKE '%%%s%%'", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE, VIDEODB_ID_EPISODE_PLOT, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d, path.strPath FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow INNER JOIN files ON files.idFile=episode.idFile INNER JOIN path ON path.idPath=files.idPath WHERE ", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE);
     else
-      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow WHERE episode.c%02d LIKE '%%%s%%'", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE, VIDEODB_ID_EPISODE_PLOT, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow WHERE ", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE);
+    strSQL += PrepareSearchCondition(strSearch, MediaTypeEpisode, "idEpisode", { VIDEODB_ID_EPISODE_PLOT });
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -8211,9 +8460,10 @@ void CVideoDatabase::GetMoviesByPlot(const std::string& strSearch, CFileItemList
     if (NULL == m_pDS.get()) return;
 
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("select movie.idMovie, movie.c%02d, path.strPath FROM movie INNER JOIN files ON files.idFile=movie.idFile INNER JOIN path ON path.idPath=files.idPath WHERE movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%'", VIDEODB_ID_TITLE,VIDEODB_ID_PLOT, strSearch.c_str(), VIDEODB_ID_PLOTOUTLINE, strSearch.c_str(), VIDEODB_ID_TAGLINE,strSearch.c_str());
+      strSQL = PrepareSQL("select movie.idMovie, movie.c%02d, path.strPath FROM movie INNER JOIN files ON files.idFile=movie.idFile INNER JOIN path ON path.idPath=files.idPath WHERE ", VIDEODB_ID_TITLE);
     else
-      strSQL = PrepareSQL("SELECT movie.idMovie, movie.c%02d FROM movie WHERE (movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%')", VIDEODB_ID_TITLE, VIDEODB_ID_PLOT, strSearch.c_str(), VIDEODB_ID_PLOTOUTLINE, strSearch.c_str(), VIDEODB_ID_TAGLINE, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT movie.idMovie, movie.c%02d FROM movie WHERE ", VIDEODB_ID_TITLE);
+    strSQL += PrepareSearchCondition(strSearch, MediaTypeMovie, "idMovie", { VIDEODB_ID_PLOT, VIDEODB_ID_PLOTOUTLINE, VIDEODB_ID_TAGLINE });
 
     m_pDS->query( strSQL );
 
@@ -8634,6 +8884,8 @@ void CVideoDatabase::CleanDatabase(CGUIDialogProgressBarHandle* handle, const st
     sql = "DELETE FROM sets WHERE NOT EXISTS (SELECT 1 FROM movie WHERE movie.idSet = sets.idSet)";
     m_pDS->exec(sql);
 
+    RebuildNavSummaries();
+
     CommitTransaction();
 
     if (handle)
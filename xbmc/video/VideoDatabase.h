@@ -751,6 +751,12 @@ public:
 
   void CleanDatabase(CGUIDialogProgressBarHandle* handle = NULL, const std::set<int>& paths = std::set<int>(), bool showProgress = true);
 
+  /*! \brief Recompute the navsummary table from the link tables.
+   The table is maintained by triggers, this brings it back in line should it ever have drifted.
+   \return true if the summaries were rebuilt, false otherwise.
+   */
+  bool RebuildNavSummaries();
+
   /*! \brief Add a file to the database, if necessary
    If the file is already in the database, we simply return its id.
    \param url - full path of the file to add.
@@ -940,6 +946,31 @@ private:
   void CreateLinkIndex(const char *table);
   void CreateForeignLinkIndex(const char *table, const char *foreignkey);
 
+  /*! \brief Create the triggers keeping the navsummary table up to date.
+   navsummary holds the number of linked items and how many of them are watched for
+   each genre, country, studio and tag, so the library nodes don't need to aggregate the link tables.
+   \sa RebuildNavSummaries
+   */
+  void CreateNavSummaryTriggers();
+
+  /*! \brief Check whether a navigation node can be served from the navsummary table.
+   \param strBaseDir the path of the node being listed.
+   \param type the link type being listed, e.g. genre.
+   \param filter the filter passed in by the caller.
+   \return true if neither the caller nor the path restricts the items being counted.
+   */
+  bool CanUseNavSummary(const std::string &strBaseDir, const std::string &type, const Filter &filter);
+
+  /*! \brief Build the condition matching the search dialog text against columns of a media table.
+   Uses the full-text index of the table where there is one, a LIKE scan otherwise.
+   \param strSearch the text to search for.
+   \param table the media table, e.g. movie.
+   \param idColumn the primary key of the table.
+   \param columns the VIDEODB_ID_* columns to search in.
+   \return the condition to use in the WHERE clause.
+   */
+  std::string PrepareSearchCondition(const std::string &strSearch, const std::string &table, const std::string &idColumn, const std::vector<int> &columns);
+
   /*! \brief (Re)Create the generic database views for movies, tvshows,
      episodes and music videos
    */
@@ -67,6 +67,20 @@ using KODI::MESSAGING::HELPERS::DialogResponse;
 
 namespace VIDEO
 {
+  namespace
+  {
+    /*! \brief Commits the scan batch and holds no transaction while a scraper is called,
+     so that other writers don't wait on the network.
+     */
+    class CScraperCallGuard
+    {
+    public:
+      explicit CScraperCallGuard(CDatabase &database) : m_database(database) { m_database.PauseBatch(); }
+      ~CScraperCallGuard() { m_database.ResumeBatch(); }
+    private:
+      CDatabase &m_database;
+    };
+  }
 
   CVideoInfoScanner::CVideoInfoScanner()
   {
@@ -109,6 +123,7 @@ namespace VIDEO
       unsigned int tick = XbmcThreads::SystemClockMillis();
 
       m_database.Open();
+      StartScanRate();
 
       m_bCanInterrupt = true;
 
@@ -120,6 +135,12 @@ namespace VIDEO
       // result in unexpected behaviour.
       m_bCanInterrupt = false;
 
+      // group the writes of the scan into a few transactions, committed between
+      // items so an interrupted scan resumes where it stopped. The transaction
+      // isn't held while scrapers are called, see CScraperCallGuard
+      m_database.BeginBatch(g_advancedSettings.m_iVideoLibraryScanBatchItems,
+                            g_advancedSettings.m_iVideoLibraryScanBatchTime);
+
       bool bCancelled = false;
       while (!bCancelled && !m_pathsToScan.empty())
       {
@@ -148,6 +169,8 @@ namespace VIDEO
           bCancelled = true;
       }
 
+      m_database.EndBatch();
+
       if (!bCancelled)
       {
         if (m_bClean)
@@ -165,6 +188,7 @@ namespace VIDEO
 
       tick = XbmcThreads::SystemClockMillis() - tick;
       CLog::Log(LOGNOTICE, "VideoInfoScanner: Finished scan. Scanning for video info took %s", StringUtils::SecondsToTimeString(tick / 1000).c_str());
+      CLog::Log(LOGNOTICE, "VideoInfoScanner: Added %u items (%.1f items/s)", m_scannedItems, GetScanRate());
     }
     catch (...)
     {
@@ -367,6 +391,9 @@ namespace VIDEO
       m_database.SetPathHash(strDirectory, hash);
     }
 
+    // the folder and its hash are complete
+    m_database.BatchCheckpoint(0);
+
     if (m_handle)
       OnDirectoryScanned(strDirectory);
 
@@ -473,6 +500,11 @@ namespace VIDEO
 
       pURL = NULL;
 
+      // the item is complete, so the batch may be committed here
+      if (ret == INFO_ADDED)
+        AddScannedItems(1);
+      m_database.BatchCheckpoint(ret == INFO_ADDED ? 1 : 0);
+
       // Keep track of directories we've seen
       if (m_bClean && pItem->m_bIsFolder)
         seenPaths.push_back(m_database.GetPathId(pItem->GetPath()));
@@ -524,7 +556,7 @@ namespace VIDEO
       return INFO_CANCELLED;
 
     if (m_handle)
-      m_handle->SetText(pItem->GetMovieName(bDirNames));
+      m_handle->SetText(FormatScanRate(pItem->GetMovieName(bDirNames)));
 
     CInfoScanner::INFO_TYPE result=CInfoScanner::NO_NFO;
     CScraperUrl scrUrl;
@@ -618,7 +650,7 @@ namespace VIDEO
       return INFO_HAVE_ALREADY;
 
     if (m_handle)
-      m_handle->SetText(pItem->GetMovieName(bDirNames));
+      m_handle->SetText(FormatScanRate(pItem->GetMovieName(bDirNames)));
 
     CInfoScanner::INFO_TYPE result = CInfoScanner::NO_NFO;
     CScraperUrl scrUrl;
@@ -696,7 +728,7 @@ namespace VIDEO
       return INFO_HAVE_ALREADY;
 
     if (m_handle)
-      m_handle->SetText(pItem->GetMovieName(bDirNames));
+      m_handle->SetText(FormatScanRate(pItem->GetMovieName(bDirNames)));
 
     CInfoScanner::INFO_TYPE result = CInfoScanner::NO_NFO;
     CScraperUrl scrUrl;
@@ -794,8 +826,11 @@ namespace VIDEO
 
       if (updateSeasonArt)
       {
-        CVideoInfoDownloader loader(scraper);
-        loader.GetArtwork(showInfo);
+        {
+          CScraperCallGuard guard(m_database);
+          CVideoInfoDownloader loader(scraper);
+          loader.GetArtwork(showInfo);
+        }
         GetSeasonThumbs(showInfo, seasonArt, CVideoThumbLoader::GetArtTypes(MediaTypeSeason), useLocal);
         for (std::map<int, std::map<std::string, std::string> >::const_iterator i = seasonArt.begin(); i != seasonArt.end(); ++i)
         {
@@ -1597,7 +1632,12 @@ namespace VIDEO
           }
 
           CVideoInfoDownloader imdb(scraper);
-          if (!imdb.GetEpisodeList(url, episodes))
+          bool found;
+          {
+            CScraperCallGuard guard(m_database);
+            found = imdb.GetEpisodeList(url, episodes);
+          }
+          if (!found)
             return INFO_NOT_FOUND;
 
           hasEpisodeGuide = true;
@@ -1697,7 +1737,12 @@ namespace VIDEO
         CVideoInfoDownloader imdb(scraper);
         CFileItem item;
         item.SetPath(file->strPath);
-        if (!imdb.GetEpisodeDetails(guide->cScraperUrl, *item.GetVideoInfoTag(), pDlgProgress))
+        bool found;
+        {
+          CScraperCallGuard guard(m_database);
+          found = imdb.GetEpisodeDetails(guide->cScraperUrl, *item.GetVideoInfoTag(), pDlgProgress);
+        }
+        if (!found)
           return INFO_NOT_FOUND; //! @todo should we just skip to the next episode?
           
         // Only set season/epnum from filename when it is not already set by a scraper
@@ -1730,7 +1775,11 @@ namespace VIDEO
       m_handle->SetText(url.strTitle);
 
     CVideoInfoDownloader imdb(scraper);
-    bool ret = imdb.GetDetails(url, movieDetails, pDialog);
+    bool ret;
+    {
+      CScraperCallGuard guard(m_database);
+      ret = imdb.GetDetails(url, movieDetails, pDialog);
+    }
 
     if (ret)
     {
@@ -2001,7 +2050,11 @@ namespace VIDEO
   {
     MOVIELIST movielist;
     CVideoInfoDownloader imdb(scraper);
-    int returncode = imdb.FindMovie(title, year, movielist, progress);
+    int returncode;
+    {
+      CScraperCallGuard guard(m_database);
+      returncode = imdb.FindMovie(title, year, movielist, progress);
+    }
     if (returncode < 0 || (returncode == 0 && (m_bStop || !DownloadFailed(progress))))
     { // scraper reported an error, or we had an error and user wants to cancel the scan
       m_bStop = true;
@@ -20,6 +20,7 @@
 
 #include "VideoThumbLoader.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <utility>
 
@@ -38,6 +39,9 @@
 #include "cores/VideoSettings.h"
 #include "TextureCache.h"
 #include "URL.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/CPUInfo.h"
 #include "utils/log.h"
 #include "utils/EmbeddedArt.h"
 #include "utils/StringUtils.h"
@@ -49,6 +53,44 @@
 using namespace XFILE;
 using namespace VIDEO;
 
+// maximum number of files extracted at the same time, memory is bounded by CDVDFileInfo
+#define VIDEO_THUMB_MAX_PARALLEL_JOBS 4
+
+namespace
+{
+bool IsExtractable(const CFileItem &item)
+{
+  if (item.IsLiveTV()
+  // Due to a pvr addon api design flaw (no support for multiple concurrent streams
+  // per addon instance), pvr recording thumbnail extraction does not work (reliably).
+  ||  item.IsPVRRecording()
+  ||  URIUtils::IsUPnP(item.GetPath())
+  ||  URIUtils::IsBluray(item.GetPath())
+  ||  item.IsBDFile()
+  ||  item.IsDVD()
+  ||  item.IsDiscImage()
+  ||  item.IsDVDFile(false, true)
+  ||  item.IsInternetStream()
+  ||  item.IsDiscStub()
+  ||  item.IsPlayList())
+    return false;
+
+  // For HTTP/FTP we only allow extraction when on a LAN
+  if (URIUtils::IsRemote(item.GetPath()) &&
+     !URIUtils::IsOnLAN(item.GetPath())  &&
+     (URIUtils::IsFTP(item.GetPath())    ||
+      URIUtils::IsHTTP(item.GetPath())))
+    return false;
+
+  return true;
+}
+
+unsigned int GetParallelJobs()
+{
+  return std::max(1, std::min(g_cpuInfo.getCPUCount(), VIDEO_THUMB_MAX_PARALLEL_JOBS));
+}
+}
+
 CThumbExtractor::CThumbExtractor(const CFileItem& item,
                                  const std::string& listpath,
                                  bool thumb,
@@ -86,26 +128,7 @@ bool CThumbExtractor::operator==(const CJob* job) const
 
 bool CThumbExtractor::DoWork()
 {
-  if (m_item.IsLiveTV()
-  // Due to a pvr addon api design flaw (no support for multiple concurrent streams
-  // per addon instance), pvr recording thumbnail extraction does not work (reliably).
-  ||  m_item.IsPVRRecording()
-  ||  URIUtils::IsUPnP(m_item.GetPath())
-  ||  URIUtils::IsBluray(m_item.GetPath())
-  ||  m_item.IsBDFile()
-  ||  m_item.IsDVD()
-  ||  m_item.IsDiscImage()
-  ||  m_item.IsDVDFile(false, true)
-  ||  m_item.IsInternetStream()
-  ||  m_item.IsDiscStub()
-  ||  m_item.IsPlayList())
-    return false;
-
-  // For HTTP/FTP we only allow extraction when on a LAN
-  if (URIUtils::IsRemote(m_item.GetPath()) &&
-     !URIUtils::IsOnLAN(m_item.GetPath())  &&
-     (URIUtils::IsFTP(m_item.GetPath())    ||
-      URIUtils::IsHTTP(m_item.GetPath())))
+  if (!IsExtractable(m_item))
     return false;
 
   bool result=false;
@@ -182,8 +205,60 @@ bool CThumbExtractor::DoWork()
   return false;
 }
 
+CThumbBatchExtractor::CThumbBatchExtractor(const CFileItem& item,
+                                           const std::vector<int64_t>& positions,
+                                           const std::vector<std::string>& targets)
+  : m_item(item),
+    m_positions(positions),
+    m_targets(targets)
+{
+  if (m_item.IsStack())
+    m_item.SetPath(CStackDirectory::GetFirstStackedFile(m_item.GetPath()));
+}
+
+CThumbBatchExtractor::~CThumbBatchExtractor() = default;
+
+bool CThumbBatchExtractor::operator==(const CJob* job) const
+{
+  if (strcmp(job->GetType(), GetType()) == 0)
+  {
+    const CThumbBatchExtractor* jobExtract = dynamic_cast<const CThumbBatchExtractor*>(job);
+    if (jobExtract && jobExtract->m_item.GetPath() == m_item.GetPath()
+                   && jobExtract->m_targets == m_targets)
+      return true;
+  }
+  return false;
+}
+
+bool CThumbBatchExtractor::DoWork()
+{
+  if (!IsExtractable(m_item))
+    return false;
+
+  CLog::Log(LOGDEBUG, "%s - trying to extract %u thumbs from video file %s", __FUNCTION__,
+            static_cast<unsigned int>(m_targets.size()), CURL::GetRedacted(m_item.GetPath()).c_str());
+
+  std::vector<int> positions;
+  std::vector<CTextureDetails> details(m_targets.size());
+  for (size_t i = 0; i < m_targets.size(); i++)
+  {
+    positions.push_back(static_cast<int>(m_positions[i]));
+    details[i].file = CTextureCache::GetCacheFile(m_targets[i]) + ".jpg";
+  }
+
+  if (CDVDFileInfo::ExtractThumbs(m_item.GetPath(), positions, details) == 0)
+    return false;
+
+  for (size_t i = 0; i < details.size(); i++)
+  {
+    if (details[i].width > 0)
+      CTextureCache::GetInstance().AddCachedTexture(m_targets[i], details[i]);
+  }
+  return true;
+}
+
 CVideoThumbLoader::CVideoThumbLoader() :
-  CThumbLoader(), CJobQueue(true, 1, CJob::PRIORITY_LOW_PAUSABLE)
+  CThumbLoader(), CJobQueue(true, GetParallelJobs(), CJob::PRIORITY_LOW_PAUSABLE)
 {
   m_videoDatabase = new CVideoDatabase();
 }
@@ -415,7 +490,7 @@ bool CVideoThumbLoader::LoadItemLookup(CFileItem* pItem)
           SetupRarOptions(item,path);
 
         CThumbExtractor* extract = new CThumbExtractor(item, path, true, thumbURL);
-        AddJob(extract);
+        AddExtractJob(extract);
 
         m_videoDatabase->Close();
         return true;
@@ -432,7 +507,7 @@ bool CVideoThumbLoader::LoadItemLookup(CFileItem* pItem)
       if (URIUtils::IsInRAR(item.GetPath()))
         SetupRarOptions(item,path);
       CThumbExtractor* extract = new CThumbExtractor(item,path,false);
-      AddJob(extract);
+      AddExtractJob(extract);
     }
   }
 
@@ -621,8 +696,21 @@ bool CVideoThumbLoader::GetEmbeddedThumb(const std::string& path,
   return !art.Empty();
 }
 
+void CVideoThumbLoader::AddExtractJob(CThumbExtractor *job)
+{
+  CSingleLock lock(m_jobSection);
+  if (!IsProcessing())
+  {
+    m_extractStart = XbmcThreads::SystemClockMillis();
+    m_extractedFiles = 0;
+  }
+  AddJob(job);
+}
+
 void CVideoThumbLoader::OnJobComplete(unsigned int jobID, bool success, CJob* job)
 {
+  // jobs run in parallel, observers are called one at a time
+  CSingleLock lock(m_jobSection);
   if (success)
   {
     CThumbExtractor* loader = static_cast<CThumbExtractor*>(job);
@@ -634,7 +722,15 @@ void CVideoThumbLoader::OnJobComplete(unsigned int jobID, bool success, CJob* jo
     CGUIMessage msg(GUI_MSG_NOTIFY_ALL, 0, 0, GUI_MSG_UPDATE_ITEM, 0, pItem);
     g_windowManager.SendThreadMessage(msg);
   }
+  m_extractedFiles++;
   CJobQueue::OnJobComplete(jobID, success, job);
+
+  if (!IsProcessing())
+  {
+    unsigned int elapsed = std::max(XbmcThreads::SystemClockMillis() - m_extractStart, 1u);
+    CLog::Log(LOGDEBUG, "CVideoThumbLoader - extracted %u files in %u ms (%.1f files/s)",
+              m_extractedFiles, elapsed, m_extractedFiles * 1000.0 / elapsed);
+  }
 }
 
 void CVideoThumbLoader::DetectAndAddMissingItemData(CFileItem &item)
@@ -63,6 +63,37 @@ public:
   bool m_fillStreamDetails; ///< fill in stream details? 
 };
 
+/*!
+ \ingroup thumbs,jobs
+ \brief Job class extracting thumbs at several positions of one file
+
+ The file is opened once and all positions are extracted in a single pass.
+
+ \sa CDVDFileInfo::ExtractThumbs and CJob
+ */
+class CThumbBatchExtractor : public CJob
+{
+public:
+  CThumbBatchExtractor(const CFileItem& item, const std::vector<int64_t>& positions, const std::vector<std::string>& targets);
+  ~CThumbBatchExtractor() override;
+
+  /*!
+   \brief Work function that extracts the thumbs.
+   */
+  bool DoWork() override;
+
+  const char* GetType() const override
+  {
+    return kJobTypeMediaFlags;
+  }
+
+  bool operator==(const CJob* job) const override;
+
+  CFileItem m_item;
+  std::vector<int64_t> m_positions; ///< positions to extract thumbs from
+  std::vector<std::string> m_targets; ///< thumbpath of each position
+};
+
 class CVideoThumbLoader : public CThumbLoader, public CJobQueue
 {
 public:
@@ -142,4 +173,13 @@ protected:
    \return void
    */
   void DetectAndAddMissingItemData(CFileItem &item);
+
+  /*! \brief Queue an extraction job, starting a new measurement if the queue is idle
+   \param job the CThumbExtractor to queue
+   */
+  void AddExtractJob(CThumbExtractor *job);
+
+  CCriticalSection m_jobSection;
+  unsigned int m_extractStart = 0; ///< time the current run of extractions started
+  unsigned int m_extractedFiles = 0; ///< files processed in the current run
 };
@@ -268,7 +268,10 @@ void CGUIDialogVideoBookmarks::OnRefreshList()
     items.push_back(item);
   }
 
-  // add chapters if around
+  // add chapters if around, missing thumbs are extracted in one pass over the file
+  std::vector<int64_t> thumbPositions;
+  std::vector<std::string> thumbTargets;
+  std::vector<unsigned int> thumbChapters;
   for (int i = 1; i <= g_application.GetAppPlayer().GetChapterCount(); ++i)
   {
     std::string chapterName;
@@ -291,10 +294,9 @@ void CGUIDialogVideoBookmarks::OnRefreshList()
       item->SetArt("thumb", cachefile);
     else if (i > m_jobsStarted && CServiceBroker::GetSettings().GetBool(CSettings::SETTING_MYVIDEOS_EXTRACTCHAPTERTHUMBS))
     {
-      CFileItem item(m_filePath, false);
-      CJob* job = new CThumbExtractor(item, m_filePath, true, chapterPath, pos * 1000, false);
-      AddJob(job);
-      m_mapJobsChapter[job] = i;
+      thumbPositions.push_back(pos * 1000);
+      thumbTargets.push_back(chapterPath);
+      thumbChapters.push_back(i);
       m_jobsStarted++;
     }
 
@@ -304,6 +306,13 @@ void CGUIDialogVideoBookmarks::OnRefreshList()
     items.push_back(item);
   }
 
+  if (!thumbChapters.empty())
+  {
+    CJob* job = new CThumbBatchExtractor(CFileItem(m_filePath, false), thumbPositions, thumbTargets);
+    AddJob(job);
+    m_mapJobsChapter[job] = thumbChapters;
+  }
+
   // sort items by resume point
   std::sort(items.begin(), items.end(), [](const CFileItemPtr &item1, const CFileItemPtr &item2) {
     return item1->GetProperty("resumepoint").asDouble() < item2->GetProperty("resumepoint").asDouble();
@@ -573,9 +582,11 @@ void CGUIDialogVideoBookmarks::OnJobComplete(unsigned int jobID,
     MAPJOBSCHAPS::iterator iter = m_mapJobsChapter.find(job);
     if (iter != m_mapJobsChapter.end())
     {
-      unsigned int chapterIdx = (*iter).second;
-      CGUIMessage m(GUI_MSG_REFRESH_LIST, GetID(), 0, 1, chapterIdx);
-      CApplicationMessenger::GetInstance().SendGUIMessage(m);
+      for (unsigned int chapterIdx : iter->second)
+      {
+        CGUIMessage m(GUI_MSG_REFRESH_LIST, GetID(), 0, 1, chapterIdx);
+        CApplicationMessenger::GetInstance().SendGUIMessage(m);
+      }
       m_mapJobsChapter.erase(iter);
     }
   }
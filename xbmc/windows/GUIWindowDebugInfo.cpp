@@ -18,6 +18,8 @@
  *
  */
 
+#include <algorithm>
+
 #include "GUIWindowDebugInfo.h"
 #include "settings/AdvancedSettings.h"
 #include "addons/Skin.h"
@@ -32,6 +34,7 @@
 #include "guilib/GUIWindowManager.h"
 #include "guilib/GUIControlProfiler.h"
 #include "GUIInfoManager.h"
+#include "GUILargeTextureManager.h"
 #include "utils/Variant.h"
 #include "utils/StringUtils.h"
 
@@ -120,6 +123,18 @@ void CGUIWindowDebugInfo::Process(unsigned int currentTime, CDirtyRegionList &di
                                 stat.ullAvailPhys/1024, stat.ullTotalPhys/1024, g_infoManager.GetFPS(),
                                 strCores.c_str(), ucAppName.c_str(), dCPU, profiling.c_str());
 #endif
+
+    const CGUILargeTextureManager::Statistics art = g_largeTextureManager.GetStatistics();
+    info += StringUtils::Format("\nART: %u requested, %u prefetched (%u hits) - first pixel avg %u ms, max %u ms",
+                                art.requests, art.prefetched, art.prefetchHits,
+                                art.loaded ? static_cast<unsigned int>(art.totalTimeToFirstPixel / art.loaded) : 0,
+                                art.maxTimeToFirstPixel);
+
+    const CGUIWindowManager::RenderStatistics &render = g_windowManager.GetRenderStatistics();
+    info += StringUtils::Format("\nGUI: %u dirty regions, %u passes, %.0f%% of screen - solve %.2f ms, render %.2f ms",
+                                render.markedRegions, render.renderPasses,
+                                100.0f * render.pixelsRendered / std::max(g_graphicsContext.GetViewWindow().Area(), 1.0f),
+                                render.solveTime, render.renderTime);
   }
 
   // render the skin debug info